@@ -10,6 +10,7 @@
  *       - ADC采样并显示波形
  *       - 蓝牙数据透传
  *       - PWM呼吸灯效果
+ *       - 输入捕获频率计 (PA15, 按频率自动切换测量方法)
  *       - TFT/OLED显示
  *       - 所有任务由伪调度器管理
  */
@@ -25,12 +26,20 @@
 #include "bsp/bsp_bluetooth.h"
 #include "bsp/bsp_pwm.h"
 #include "bsp/bsp_timer.h"
+#include "bsp/bsp_capture.h"
 #include "bsp/bsp_tft_st7789.h"
 
 /* 中间件 */
 #include "middleware/scheduler.h"
 #include "middleware/menu_core.h"
+#include "middleware/menu_animation.h"
 #include "middleware/waveform_display.h"
+#include "middleware/bin_log.h"
+#include "middleware/frame_transport.h"
+#include "middleware/param_registry.h"
+#include "middleware/input_queue.h"
+#include "middleware/freq_meter.h"
+#include "middleware/kv_store.h"
 
 /*=============================================================================
  *                              全局变量
@@ -51,6 +60,9 @@ typedef enum {
 
 static app_mode_t current_mode = APP_MODE_MENU;
 
+/* 蓝牙可靠传输端点 */
+static frame_transport_t bt_link;
+
 /* 系统参数 */
 static struct {
     uint8_t led_brightness;     /* LED亮度 0-100 */
@@ -64,16 +76,39 @@ static struct {
     .display_brightness = 100
 };
 
+/* 只读遥测量 (供远程订阅) */
+static struct {
+    uint16_t adc_value;         /* 最近一次ADC值 */
+    float cpu_usage;            /* CPU占用率 */
+    float capture_freq;         /* 输入捕获频率 (Hz), 无信号为0 */
+    uint16_t capture_duty;      /* 输入捕获占空比 (0.1%), 0xFFFF为未知 */
+} telemetry;
+
+/* 输入捕获频率计 */
+#define CAPTURE_GATE_US         100000      /* 闸门时间 */
+#define CAPTURE_TIMEOUT_MS      2000        /* 超过该时间无结果视为无信号 (最低约0.5Hz) */
+#define CAPTURE_PWM_MAX_HZ      1000        /* 低于它用PWM输入 (带占空比) */
+#define CAPTURE_COUNT_MIN_HZ    40000       /* 高于它用闸门计数 */
+#define CAPTURE_STAMP_PSC       8           /* 时间戳模式每8个周期一个时间戳 */
+
+static freq_meter_t capture_meter;
+static timer_entry_t capture_gate_timer;
+static volatile uint32_t capture_gate_pulses;
+static volatile uint8_t capture_gate_ready;
+static uint32_t capture_gate_last;
+static uint32_t capture_result_tick;
+
 /*=============================================================================
  *                              任务函数声明
  *============================================================================*/
 
 static void task_ec11_scan(void *arg);
 static void task_key_scan(void *arg);
+static void task_input(void *arg);
 static void task_adc_sample(void *arg);
 static void task_display_update(void *arg);
 static void task_bluetooth_process(void *arg);
-static void task_led_breath(void *arg);
+static void task_capture(void *arg);
 static void task_system_monitor(void *arg);
 
 /*=============================================================================
@@ -81,19 +116,90 @@ static void task_system_monitor(void *arg);
  *============================================================================*/
 
 /**
- * @brief EC11事件回调
+ * @brief EC11事件回调 (旋转在EXTI中断中触发, 只入队)
+ */
+static void ec11_event_push(ec11_event_t event)
+{
+    input_event_t ev = {0};
+    int16_t dir;
+
+    /* 按键事件由扫描任务从返回值入队, 这里只处理旋转 */
+    if (event == EC11_EVENT_ROTATE_RIGHT) {
+        dir = 1;
+    } else if (event == EC11_EVENT_ROTATE_LEFT) {
+        dir = -1;
+    } else {
+        return;
+    }
+
+    ev.time = scheduler_get_tick();
+    ev.source = INPUT_SRC_EC11;
+    ev.type = INPUT_TYPE_ROTATE;
+    ev.delta = dir;
+    ev.steps = (int16_t)(dir * (int16_t)bsp_ec11_get_accel());
+    input_queue_push(INPUT_LANE_ISR, &ev);
+}
+
+/**
+ * @brief 按键事件回调 (在扫描任务中触发)
  */
-static void ec11_event_handler(ec11_event_t event)
+static void key_event_push(key_id_t key_id, key_event_t event)
 {
+    input_event_t ev = {0};
+
+    ev.time = scheduler_get_tick();
+    ev.source = INPUT_SRC_KEY;
+    ev.id = (uint8_t)key_id;
+    ev.type = INPUT_TYPE_KEY;
+    ev.code = (uint8_t)event;
+    input_queue_push(INPUT_LANE_TASK, &ev);
+}
+
+/**
+ * @brief 旋转处理 (已合并, delta可能大于1)
+ */
+static void rotate_handler(const input_event_t *ev)
+{
+    int16_t n = (ev->delta < 0) ? -ev->delta : ev->delta;
+
     switch (current_mode) {
     case APP_MODE_MENU:
-        switch (event) {
-        case EC11_EVENT_ROTATE_LEFT:
-            menu_move_up();
-            break;
-        case EC11_EVENT_ROTATE_RIGHT:
-            menu_move_down();
+        if (menu_get_state()->edit_mode) {
+            menu_value_adjust(ev->steps);
             break;
+        }
+        while (n-- > 0) {
+            if (ev->delta < 0) {
+                menu_move_up();
+            } else {
+                menu_move_down();
+            }
+        }
+        break;
+
+    case APP_MODE_OSCILLOSCOPE:
+        while (n-- > 0) {
+            if (ev->delta < 0) {
+                waveform_timebase_decrease();
+            } else {
+                waveform_timebase_increase();
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief EC11按键处理
+ */
+static void ec11_key_handler(ec11_event_t event)
+{
+    switch (current_mode) {
+    case APP_MODE_MENU:
+        switch (event) {
         case EC11_EVENT_KEY_SHORT_PRESS:
             menu_enter();
             break;
@@ -107,18 +213,13 @@ static void ec11_event_handler(ec11_event_t event)
 
     case APP_MODE_OSCILLOSCOPE:
         switch (event) {
-        case EC11_EVENT_ROTATE_LEFT:
-            waveform_timebase_decrease();
-            break;
-        case EC11_EVENT_ROTATE_RIGHT:
-            waveform_timebase_increase();
-            break;
         case EC11_EVENT_KEY_SHORT_PRESS:
             waveform_toggle_measurement();
             break;
         case EC11_EVENT_KEY_LONG_PRESS:
             current_mode = APP_MODE_MENU;
             waveform_stop();
+            menu_invalidate();
             break;
         default:
             break;
@@ -128,49 +229,66 @@ static void ec11_event_handler(ec11_event_t event)
     case APP_MODE_BLUETOOTH:
         if (event == EC11_EVENT_KEY_LONG_PRESS) {
             current_mode = APP_MODE_MENU;
+            menu_invalidate();
         }
         break;
     }
 }
 
 /**
- * @brief 蓝牙数据帧回调
+ * @brief 输入事件处理 (在输入任务中按发生顺序调用)
  */
-static void bluetooth_frame_handler(const bt_frame_t *frame)
+static void input_event_handler(const input_event_t *ev)
 {
-    switch (frame->cmd) {
-    case BT_CMD_SET_PARAM:
-        if (frame->len >= 2) {
-            uint8_t param_id = frame->data[0];
-            uint8_t value = frame->data[1];
-
-            switch (param_id) {
-            case 0: /* LED亮度 */
-                system_params.led_brightness = value;
-                bsp_pwm_set_duty_percent(led_pwm_channel, value);
-                break;
-            case 1: /* 显示亮度 */
-                system_params.display_brightness = value;
-                bsp_tft_set_brightness(value);
-                break;
-            }
+    if (ev->type == INPUT_TYPE_ROTATE) {
+        rotate_handler(ev);
+    } else if (ev->source == INPUT_SRC_EC11) {
+        ec11_key_handler((ec11_event_t)ev->code);
+    } else if (ev->id == KEY_ID_0 && ev->code == KEY_EVENT_SHORT_PRESS &&
+               current_mode == APP_MODE_MENU) {
+        menu_back();
+    }
+}
 
-            /* 回复ACK */
-            bsp_bluetooth_send_frame(BT_CMD_ACK, NULL, 0);
+/**
+ * @brief 蓝牙消息处理 (传输层按序交付)
+ */
+static int bluetooth_message_handler(void *ctx, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    (void)ctx;
+
+    switch (cmd) {
+    case BT_CMD_SET_PARAM:
+        /* 旧协议: 单个参数, uint8_t值 */
+        if (len >= 2) {
+            param_value_t value;
+            value.i = data[1];
+            param_set(data[0], value);
         }
         break;
 
     case BT_CMD_GET_PARAM:
         {
             uint8_t resp[4];
+
+            /* 发送窗口已满时反压, 请求留在接收窗口中稍后重试 */
+            if (frame_transport_tx_free(&bt_link) == 0) {
+                return -1;
+            }
+
             resp[0] = system_params.led_brightness;
             resp[1] = system_params.display_brightness;
             resp[2] = (uint8_t)(system_params.adc_sample_rate >> 8);
             resp[3] = (uint8_t)(system_params.adc_sample_rate & 0xFF);
-            bsp_bluetooth_send_frame(BT_CMD_GET_PARAM, resp, 4);
+            frame_transport_send(&bt_link, BT_CMD_GET_PARAM, resp, 4);
         }
         break;
 
+    case PARAM_CMD_GET:
+    case PARAM_CMD_SET:
+    case PARAM_CMD_SUBSCRIBE:
+        return param_server_handle(cmd, data, len);
+
     case BT_CMD_START:
         current_mode = APP_MODE_OSCILLOSCOPE;
         waveform_start();
@@ -180,6 +298,67 @@ static void bluetooth_frame_handler(const bt_frame_t *frame)
         waveform_stop();
         break;
     }
+
+    return 0;
+}
+
+/**
+ * @brief 参数协议帧发送
+ */
+static int param_link_send(void *ctx, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    (void)ctx;
+    return frame_transport_send(&bt_link, cmd, data, len);
+}
+
+/**
+ * @brief 蓝牙数据帧回调
+ */
+static void bluetooth_frame_handler(const bt_frame_t *frame)
+{
+    frame_transport_input(&bt_link, frame);
+}
+
+/**
+ * @brief 传输层帧输出
+ */
+static int bluetooth_link_output(void *ctx, uint8_t seq, uint8_t cmd,
+                                 const uint8_t *data, uint8_t len)
+{
+    (void)ctx;
+    return bsp_bluetooth_send_frame_seq(seq, cmd, data, len);
+}
+
+/**
+ * @brief 传输层链路失败回调
+ */
+static void bluetooth_link_fail(void *ctx)
+{
+    (void)ctx;
+    BIN_LOG("Bluetooth link lost, resync.\r\n");
+    frame_transport_reset(&bt_link);
+}
+
+/**
+ * @brief 传输层轮询定时器
+ */
+static void bluetooth_link_timer(timer_id_t timer_id, void *arg)
+{
+    (void)timer_id;
+    (void)arg;
+    frame_transport_poll(&bt_link, scheduler_get_tick());
+}
+
+/**
+ * @brief 蓝牙波特率协商完成回调
+ */
+static void bluetooth_baud_handler(int result, uint32_t baudrate)
+{
+    if (result == 0) {
+        BIN_LOG("Bluetooth UART: %lu bps\r\n", baudrate);
+    } else {
+        BIN_LOG("Bluetooth baud negotiation failed, keep %lu bps\r\n", baudrate);
+    }
 }
 
 /**
@@ -188,9 +367,11 @@ static void bluetooth_frame_handler(const bt_frame_t *frame)
 static void bluetooth_state_handler(bt_state_t state)
 {
     if (state == BT_STATE_CONNECTED) {
-        DEBUG_PRINT("Bluetooth connected!\r\n");
+        BIN_LOG("Bluetooth connected!\r\n");
+        frame_transport_reset(&bt_link);
     } else if (state == BT_STATE_DISCONNECTED) {
-        DEBUG_PRINT("Bluetooth disconnected.\r\n");
+        BIN_LOG("Bluetooth disconnected.\r\n");
+        param_server_unsubscribe();
     }
 }
 
@@ -227,6 +408,45 @@ static void menu_value_display_brightness(int32_t value)
     bsp_tft_set_brightness(value);
 }
 
+/*=============================================================================
+ *                              远程参数表
+ *============================================================================*/
+
+/* 远程写入后的硬件动作, 与菜单回调一致; 菜单上显示的值已变, 需要重绘 */
+static void param_led_brightness_changed(uint8_t id, param_value_t value)
+{
+    (void)id;
+    bsp_pwm_set_duty_percent(led_pwm_channel, value.i);
+    menu_invalidate();
+}
+
+static void param_display_brightness_changed(uint8_t id, param_value_t value)
+{
+    (void)id;
+    bsp_tft_set_brightness(value.i);
+    menu_invalidate();
+}
+
+/* 参数直接指向system_params, 菜单修改的值远程订阅时自动推送 */
+static const param_desc_t param_table[] = {
+    { 0, PARAM_TYPE_U8, 0, "led_brightness", &system_params.led_brightness,
+      0, 100, param_led_brightness_changed },
+    { 1, PARAM_TYPE_U8, 0, "display_brightness", &system_params.display_brightness,
+      0, 100, param_display_brightness_changed },
+    { 2, PARAM_TYPE_U16, PARAM_FLAG_READONLY, "adc_sample_rate", &system_params.adc_sample_rate,
+      0, 0, NULL },
+    { 3, PARAM_TYPE_BOOL, PARAM_FLAG_READONLY, "bt_enable", &system_params.bt_enable,
+      0, 1, NULL },
+    { 16, PARAM_TYPE_U16, PARAM_FLAG_READONLY, "adc_value", &telemetry.adc_value,
+      0, 0, NULL },
+    { 17, PARAM_TYPE_FLOAT, PARAM_FLAG_READONLY, "cpu_usage", &telemetry.cpu_usage,
+      0, 100, NULL },
+    { 18, PARAM_TYPE_FLOAT, PARAM_FLAG_READONLY, "capture_freq", &telemetry.capture_freq,
+      0, 0, NULL },
+    { 19, PARAM_TYPE_U16, PARAM_FLAG_READONLY, "capture_duty", &telemetry.capture_duty,
+      0, 0, NULL },
+};
+
 /* 子菜单项 */
 static menu_item_t settings_items[] = {
     {
@@ -329,6 +549,22 @@ static const waveform_data_source_t waveform_adc_source = {
     .set_sample_rate = waveform_adc_set_rate
 };
 
+/* 频率测量取自输入捕获, 比采样波形的过零检测精确 */
+static int waveform_capture_freq(waveform_measurement_t *m)
+{
+    const freq_result_t *r = freq_meter_get(&capture_meter);
+
+    if (!r->valid || r->freq_mhz == 0) {
+        return -1;
+    }
+
+    m->frequency = (uint32_t)((r->freq_mhz + 500) / 1000);
+    m->period = r->period_ns / 1000;
+    m->duty_cycle = (r->duty_permille != FREQ_METER_DUTY_UNKNOWN) ? (uint8_t)((r->duty_permille + 5) / 10) : 0;
+
+    return 0;
+}
+
 /* TFT显示接口 */
 static void waveform_display_clear(void)
 {
@@ -405,12 +641,18 @@ static void task_ec11_scan(void *arg)
     (void)arg;
     ec11_event_t event = bsp_ec11_scan();
     if (event != EC11_EVENT_NONE) {
-        ec11_event_handler(event);
+        input_event_t ev = {0};
+
+        ev.time = scheduler_get_tick();
+        ev.source = INPUT_SRC_EC11;
+        ev.type = INPUT_TYPE_KEY;
+        ev.code = (uint8_t)event;
+        input_queue_push(INPUT_LANE_TASK, &ev);
     }
 }
 
 /**
- * @brief 按键扫描任务 (20ms周期)
+ * @brief 按键扫描任务 (KEY_SCAN_PERIOD_MS周期)
  */
 static void task_key_scan(void *arg)
 {
@@ -418,6 +660,15 @@ static void task_key_scan(void *arg)
     bsp_key_scan();
 }
 
+/**
+ * @brief 输入任务 (10ms周期): 按时间顺序处理编码器和按键事件
+ */
+static void task_input(void *arg)
+{
+    (void)arg;
+    input_queue_poll(input_event_handler);
+}
+
 /**
  * @brief ADC采样任务 (根据模式运行)
  */
@@ -432,15 +683,20 @@ static void task_adc_sample(void *arg)
 }
 
 /**
- * @brief 显示更新任务 (50ms周期)
+ * @brief 显示更新任务 (MENU_FRAME_PERIOD_MS周期)
  */
 static void task_display_update(void *arg)
 {
+    static app_mode_t last_mode = APP_MODE_MENU;
+    static uint8_t last_connected = 0xFF;
+    uint8_t connected;
+
     (void)arg;
 
     switch (current_mode) {
     case APP_MODE_MENU:
-        menu_refresh();
+        /* 只在菜单失效时重绘, 一帧内的多次操作合并为一次 */
+        menu_render_frame(scheduler_get_tick());
         break;
 
     case APP_MODE_OSCILLOSCOPE:
@@ -448,20 +704,29 @@ static void task_display_update(void *arg)
         break;
 
     case APP_MODE_BLUETOOTH:
+        /* 刚进入该模式或连接状态变化时才重绘 */
+        connected = bsp_bluetooth_is_connected();
+        if (last_mode == APP_MODE_BLUETOOTH && connected == last_connected) {
+            break;
+        }
+        last_connected = connected;
+
         /* 显示蓝牙状态 */
         bsp_tft_clear(TFT_BLACK);
         bsp_tft_draw_string(20, 100, "Bluetooth Mode", &font_8x16, TFT_CYAN, TFT_BLACK);
-        if (bsp_bluetooth_is_connected()) {
+        if (connected) {
             bsp_tft_draw_string(40, 130, "Connected", &font_8x16, TFT_GREEN, TFT_BLACK);
         } else {
             bsp_tft_draw_string(40, 130, "Waiting...", &font_8x16, TFT_YELLOW, TFT_BLACK);
         }
         break;
     }
+
+    last_mode = current_mode;
 }
 
 /**
- * @brief 蓝牙处理任务 (100ms周期)
+ * @brief 蓝牙处理任务 (20ms周期)
  */
 static void task_bluetooth_process(void *arg)
 {
@@ -470,23 +735,147 @@ static void task_bluetooth_process(void *arg)
     if (system_params.bt_enable) {
         bsp_bluetooth_process();
 
+        /* 刷新遥测量, 推送订阅参数中变化的部分 */
+        telemetry.adc_value = bsp_adc_read();
+        telemetry.cpu_usage = scheduler_get_cpu_usage();
+        param_server_poll(scheduler_get_tick());
+
         /* 示波器模式下定时发送波形数据 */
-        if (current_mode == APP_MODE_OSCILLOSCOPE && bsp_bluetooth_is_connected()) {
-            /* 发送ADC数据 (简化: 只发当前值) */
+        if (current_mode == APP_MODE_OSCILLOSCOPE && bsp_bluetooth_is_connected() &&
+            frame_transport_tx_free(&bt_link) > 0) {
+            /* 发送ADC数据 (简化: 只发当前值), 窗口满时跳过本次 */
             uint16_t adc_val = bsp_adc_read();
             uint8_t data[2] = {adc_val >> 8, adc_val & 0xFF};
-            bsp_bluetooth_send_frame(BT_CMD_ADC_DATA, data, 2);
+            frame_transport_send(&bt_link, BT_CMD_ADC_DATA, data, 2);
         }
     }
 }
 
+/*=============================================================================
+ *                              输入捕获频率计
+ *============================================================================*/
+
 /**
- * @brief LED呼吸灯任务 (20ms周期)
+ * @brief 闸门定时器 (比较中断中执行): 读取一个闸门时间内的脉冲数
  */
-static void task_led_breath(void *arg)
+static void capture_gate_expired(timer_entry_t *timer, void *arg)
 {
+    uint32_t count = bsp_capture_get_count();
+
+    (void)timer;
     (void)arg;
-    bsp_pwm_breath_update();
+
+    capture_gate_pulses = count - capture_gate_last;
+    capture_gate_last = count;
+    capture_gate_ready = 1;
+}
+
+/**
+ * @brief 切换捕获模式, 频率计重新开始
+ */
+static void capture_switch(capture_mode_t mode)
+{
+    uint8_t psc = (mode == CAPTURE_MODE_TIMESTAMP) ? CAPTURE_STAMP_PSC : 1;
+
+    timer_service_stop(&capture_gate_timer);
+    bsp_capture_start(mode, psc);
+    freq_meter_set_prescaler(&capture_meter, psc);
+
+    if (mode == CAPTURE_MODE_COUNT) {
+        capture_gate_last = bsp_capture_get_count();
+        capture_gate_ready = 0;
+        timer_service_start(&capture_gate_timer, CAPTURE_GATE_US, CAPTURE_GATE_US);
+    }
+}
+
+/**
+ * @brief 按测得的频率选择测量方法 (20%滞回)
+ * @note 低频用PWM输入 (周期+占空比); 中频用时间戳倒数法, 时间戳速率不超过
+ *       CAPTURE_COUNT_MIN_HZ / CAPTURE_STAMP_PSC, 轮询间隔内不会写满DMA缓冲区;
+ *       高频用闸门计数
+ */
+static void capture_autorange(uint32_t freq_hz)
+{
+    switch (bsp_capture_get_mode()) {
+    case CAPTURE_MODE_PWM:
+        if (freq_hz > CAPTURE_COUNT_MIN_HZ) {
+            capture_switch(CAPTURE_MODE_COUNT);
+        } else if (freq_hz > CAPTURE_PWM_MAX_HZ * 6 / 5) {
+            capture_switch(CAPTURE_MODE_TIMESTAMP);
+        }
+        break;
+
+    case CAPTURE_MODE_TIMESTAMP:
+        if (freq_hz > CAPTURE_COUNT_MIN_HZ * 6 / 5) {
+            capture_switch(CAPTURE_MODE_COUNT);
+        } else if (freq_hz < CAPTURE_PWM_MAX_HZ * 4 / 5) {
+            capture_switch(CAPTURE_MODE_PWM);
+        }
+        break;
+
+    case CAPTURE_MODE_COUNT:
+        if (freq_hz < CAPTURE_PWM_MAX_HZ) {
+            capture_switch(CAPTURE_MODE_PWM);
+        } else if (freq_hz < CAPTURE_COUNT_MIN_HZ * 4 / 5) {
+            capture_switch(CAPTURE_MODE_TIMESTAMP);
+        }
+        break;
+    }
+}
+
+/**
+ * @brief 输入捕获任务 (10ms周期): 读取捕获数据, 更新频率计和遥测量
+ */
+static void task_capture(void *arg)
+{
+    uint32_t stamps[64];
+    uint32_t period, high;
+    int n;
+    int updated = 0;
+    uint32_t now = scheduler_get_tick();
+    const freq_result_t *r;
+
+    (void)arg;
+
+    switch (bsp_capture_get_mode()) {
+    case CAPTURE_MODE_PWM:
+        if (bsp_capture_read_pwm(&period, &high) == 0) {
+            updated = freq_meter_feed_pwm(&capture_meter, period, high);
+        }
+        break;
+
+    case CAPTURE_MODE_TIMESTAMP:
+        while ((n = bsp_capture_read_stamps(stamps, 64)) > 0) {
+            updated |= freq_meter_feed_stamps(&capture_meter, stamps, (uint16_t)n);
+        }
+        if (n < 0) {
+            /* 时间戳被覆盖: 窗口内混有新旧数据, 丢弃后从下一个时间戳重新开始 */
+            freq_meter_reset(&capture_meter);
+            updated = 0;
+        }
+        break;
+
+    case CAPTURE_MODE_COUNT:
+        if (capture_gate_ready) {
+            capture_gate_ready = 0;
+            updated = freq_meter_feed_count(&capture_meter, capture_gate_pulses, CAPTURE_GATE_US);
+        }
+        break;
+    }
+
+    if (updated) {
+        capture_result_tick = now;
+        r = freq_meter_get(&capture_meter);
+        telemetry.capture_freq = (float)r->freq_mhz / 1000.0f;
+        telemetry.capture_duty = r->duty_permille;
+        capture_autorange((uint32_t)(r->freq_mhz / 1000));
+    } else if (now - capture_result_tick > CAPTURE_TIMEOUT_MS) {
+        /* 信号中断: 丢弃窗口, 恢复后不把停顿算作一个周期 */
+        capture_result_tick = now;
+        freq_meter_reset(&capture_meter);
+        telemetry.capture_freq = 0.0f;
+        telemetry.capture_duty = FREQ_METER_DUTY_UNKNOWN;
+    }
 }
 
 /**
@@ -499,9 +888,60 @@ static void task_system_monitor(void *arg)
     uint32_t hours, minutes, seconds;
     bsp_timer_get_uptime(&hours, &minutes, &seconds);
 
-    DEBUG_PRINT("Uptime: %02lu:%02lu:%02lu, CPU: %.1f%%\r\n",
-                hours, minutes, seconds,
-                scheduler_get_cpu_usage());
+    /* 周期日志走二进制通道, 由上位机格式化 */
+    BIN_LOG("Uptime: %02lu:%02lu:%02lu, CPU: %.1f%%\r\n",
+            hours, minutes, seconds,
+            BIN_LOG_FLOAT(scheduler_get_cpu_usage()));
+}
+
+/*=============================================================================
+ *                              日志输出
+ *============================================================================*/
+
+/**
+ * @brief 日志输出: 只交给空闲的发送DMA, 忙时返回0, 空闲钩子不等待串口
+ */
+static uint16_t bin_log_uart_output(const uint8_t *data, uint16_t len)
+{
+    if (len > BSP_UART_TX_BUF_SIZE) {
+        len = BSP_UART_TX_BUF_SIZE;
+    }
+
+    return (bsp_uart_send_dma(UART_PORT_1, data, len) == 0) ? len : 0;
+}
+
+/*=============================================================================
+ *                              蓝牙波特率保存
+ *============================================================================*/
+
+/* 协商结果在kv_store中的键 ("BTBD") */
+#define BT_BAUD_KV_KEY      0x42544244
+
+/**
+ * @brief 重写bsp_bluetooth的弱函数: 从kv_store读取上次协商的波特率
+ * @note 候选值检查在bsp_bluetooth_init()中完成
+ */
+uint32_t bsp_bluetooth_baud_load(void)
+{
+    uint32_t baud;
+
+    if (kv_store_init() != 0 ||
+        kv_get(BT_BAUD_KV_KEY, &baud, sizeof(baud), NULL) != sizeof(baud)) {
+        return 0;
+    }
+
+    return baud;
+}
+
+/**
+ * @brief 重写bsp_bluetooth的弱函数: 协商成功后写入kv_store
+ * @note kv_set对未变化的值不写Flash; 失败时下次上电从默认波特率重新协商
+ */
+void bsp_bluetooth_baud_store(uint32_t baudrate)
+{
+    if (kv_store_init() == 0) {
+        kv_set(BT_BAUD_KV_KEY, KV_TYPE_RAW, &baudrate, sizeof(baudrate));
+    }
 }
 
 /*=============================================================================
@@ -573,8 +1013,13 @@ int main(void)
     /* 定时器初始化 */
     bsp_timer_init();
 
-    /* 调度器初始化 */
+    /* 调度器初始化, 时基取自64位单调时钟 */
     scheduler_init();
+    scheduler_set_clock(bsp_timer_get_us64);
+
+    /* 定时服务 (软件定时器) 由TIM5比较在最近的到期时间唤醒, 不再轮询 */
+    bsp_timer_alarm_set_callback(timer_service_isr);
+    timer_service_set_alarm(bsp_timer_alarm_set);
 
     /* TFT初始化 */
     bsp_tft_init();
@@ -584,10 +1029,17 @@ int main(void)
 
     /* 串口初始化 (调试) */
     bsp_uart_init(UART_PORT_1, NULL);
-    DEBUG_PRINT("\r\n=== System Starting ===\r\n");
 
-    /* EC11初始化 */
+    /* 二进制日志 (空闲时输出), 独占UART1: 本文件的调试输出都用BIN_LOG, 不用DEBUG_PRINT */
+    bin_log_init(bin_log_uart_output);
+    scheduler_set_idle_hook(bin_log_idle_hook);
+    BIN_LOG("\r\n=== System Starting ===\r\n");
+
+    /* EC11和按键初始化, 事件统一进入输入队列 */
+    input_queue_init();
     bsp_ec11_init();
+    bsp_ec11_register_callback(ec11_event_push);
+    bsp_key_register_callback(key_event_push);
 
     /* ADC初始化 */
     adc_channel_config_t adc_cfg = bsp_adc_get_default_config();
@@ -604,13 +1056,33 @@ int main(void)
         bsp_bluetooth_init();
         bsp_bluetooth_set_frame_callback(bluetooth_frame_handler);
         bsp_bluetooth_set_state_callback(bluetooth_state_handler);
+
+        /* 未连接时把串口提升到模块支持的最高波特率 (异步, 由BT任务推进) */
+        bsp_bluetooth_baud_negotiate(bluetooth_baud_handler);
+
+        /* 可靠传输层 */
+        frame_transport_init(&bt_link, bluetooth_link_output, bluetooth_message_handler, NULL);
+        frame_transport_set_fail_callback(&bt_link, bluetooth_link_fail);
+        param_registry_init(param_table, sizeof(param_table) / sizeof(param_table[0]));
+        param_server_init(param_link_send, NULL);
+        timer_id_t link_timer = scheduler_timer_create(FRAME_TRANSPORT_POLL_MS,
+                                                       bluetooth_link_timer, NULL, 1);
+        scheduler_timer_start(link_timer);
     }
 
+    /* 输入捕获频率计, 从闸门计数开始自动选择测量方法 */
+    freq_meter_init(&capture_meter, CAPTURE_CLOCK_HZ, CAPTURE_GATE_US);
+    timer_entry_init(&capture_gate_timer, capture_gate_expired, NULL, TIMER_MODE_ISR);
+    telemetry.capture_duty = FREQ_METER_DUTY_UNKNOWN;
+    capture_switch(CAPTURE_MODE_COUNT);
+
     /* 波形显示模块初始化 */
     waveform_init(&waveform_adc_source, &waveform_tft_display);
+    waveform_set_freq_source(waveform_capture_freq);
 
     /* 菜单初始化 */
     menu_init(main_menu_ptr, sizeof(main_menu_ptr) / sizeof(main_menu_ptr[0]), menu_display_callback);
+    menu_anim_init();
 
     /* 创建任务 */
     task_config_t task_cfg;
@@ -619,31 +1091,39 @@ int main(void)
     task_cfg = (task_config_t)TASK_PERIODIC("EC11", task_ec11_scan, 10, TASK_PRIORITY_HIGH);
     scheduler_task_create(&task_cfg);
 
-    /* 按键扫描 - 普通优先级, 20ms */
-    task_cfg = (task_config_t)TASK_PERIODIC("Key", task_key_scan, 20, TASK_PRIORITY_NORMAL);
+    /* 按键扫描 - 普通优先级, 消抖需连续4次采样 */
+    task_cfg = (task_config_t)TASK_PERIODIC("Key", task_key_scan, KEY_SCAN_PERIOD_MS, TASK_PRIORITY_NORMAL);
+    scheduler_task_create(&task_cfg);
+
+    /* 输入处理 - 高优先级, 10ms */
+    task_cfg = (task_config_t)TASK_PERIODIC("Input", task_input, 10, TASK_PRIORITY_HIGH);
     scheduler_task_create(&task_cfg);
 
     /* ADC采样 - 高优先级, 20ms */
     task_cfg = (task_config_t)TASK_PERIODIC("ADC", task_adc_sample, 20, TASK_PRIORITY_HIGH);
     scheduler_task_create(&task_cfg);
 
-    /* 显示更新 - 普通优先级, 50ms */
-    task_cfg = (task_config_t)TASK_PERIODIC("Display", task_display_update, 50, TASK_PRIORITY_NORMAL);
+    /* 显示更新 - 普通优先级, 每帧检查一次是否需要重绘 */
+    task_cfg = (task_config_t)TASK_PERIODIC("Display", task_display_update, MENU_FRAME_PERIOD_MS, TASK_PRIORITY_NORMAL);
     scheduler_task_create(&task_cfg);
 
-    /* 蓝牙处理 - 低优先级, 100ms */
-    task_cfg = (task_config_t)TASK_PERIODIC("BT", task_bluetooth_process, 100, TASK_PRIORITY_LOW);
+    /* 菜单动画 - 普通优先级, 按动画帧率驱动所有补间 */
+    task_cfg = (task_config_t)TASK_PERIODIC("Anim", menu_anim_task, MENU_ANIM_PERIOD_MS, TASK_PRIORITY_NORMAL);
     scheduler_task_create(&task_cfg);
 
-    /* LED呼吸灯 - 低优先级, 20ms */
-    task_cfg = (task_config_t)TASK_PERIODIC("LED", task_led_breath, 20, TASK_PRIORITY_LOW);
+    /* 蓝牙处理 - 低优先级, 20ms (收帧及时才能尽快应答) */
+    task_cfg = (task_config_t)TASK_PERIODIC("BT", task_bluetooth_process, 20, TASK_PRIORITY_LOW);
+    scheduler_task_create(&task_cfg);
+
+    /* 输入捕获 - 普通优先级, 10ms (时间戳缓冲区在两次读取之间不会写满) */
+    task_cfg = (task_config_t)TASK_PERIODIC("Capture", task_capture, 10, TASK_PRIORITY_NORMAL);
     scheduler_task_create(&task_cfg);
 
     /* 系统监控 - 空闲优先级, 1000ms */
     task_cfg = (task_config_t)TASK_PERIODIC("Monitor", task_system_monitor, 1000, TASK_PRIORITY_IDLE);
     scheduler_task_create(&task_cfg);
 
-    DEBUG_PRINT("All tasks created. Starting scheduler...\r\n");
+    BIN_LOG("All tasks created. Starting scheduler...\r\n");
 
     /* 启动调度器 (不返回) */
     scheduler_start();
@@ -652,11 +1132,3 @@ int main(void)
     while (1);
 }
 
-/*=============================================================================
- *                              SysTick中断
- *============================================================================*/
-
-void SysTick_Handler(void)
-{
-    scheduler_tick();
-}
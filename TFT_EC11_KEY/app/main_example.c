@@ -11,6 +11,7 @@
 #include "bsp_ec11.h"
 #include "bsp_key.h"
 #include "menu_core.h"
+#include "input_queue.h"
 #include <stdio.h>
 
 /* 全局变量 ----------------------------------------------------------------*/
@@ -178,45 +179,71 @@ menu_item_t* root_items[] = {
     &menu_system_info
 };
 
-/* EC11事件处理回调 --------------------------------------------------------*/
+/* EC11旋转回调 (EXTI中断中调用, 只入队) --------------------------------*/
 void ec11_event_handler(ec11_event_t event)
 {
-    menu_state_t *state = menu_get_state();
+    input_event_t ev = {0};
 
-    switch (event) {
-        case EC11_EVENT_ROTATE_LEFT:
-            if (state->edit_mode) {
-                menu_value_decrease();  /* 编辑模式: 减小数值 */
-            } else {
-                menu_move_up();         /* 普通模式: 向上移动 */
-            }
-            break;
+    if (event != EC11_EVENT_ROTATE_LEFT && event != EC11_EVENT_ROTATE_RIGHT) {
+        return;  /* 按键事件由主循环从 bsp_ec11_scan() 返回值入队 */
+    }
 
-        case EC11_EVENT_ROTATE_RIGHT:
-            if (state->edit_mode) {
-                menu_value_increase();  /* 编辑模式: 增加数值 */
-            } else {
-                menu_move_down();       /* 普通模式: 向下移动 */
-            }
-            break;
+    ev.time = system_tick;
+    ev.source = INPUT_SRC_EC11;
+    ev.type = INPUT_TYPE_ROTATE;
+    ev.delta = (event == EC11_EVENT_ROTATE_RIGHT) ? 1 : -1;
+    ev.steps = (int16_t)(ev.delta * (int16_t)bsp_ec11_get_accel());
+    input_queue_push(INPUT_LANE_ISR, &ev);
+}
 
-        case EC11_EVENT_KEY_SHORT_PRESS:
-            menu_enter();  /* 短按: 确认/进入 */
-            break;
+/* 独立按键事件回调 (主循环中调用) ----------------------------------------*/
+void key_event_handler(key_id_t key_id, key_event_t event)
+{
+    input_event_t ev = {0};
+
+    ev.time = system_tick;
+    ev.source = INPUT_SRC_KEY;
+    ev.id = (uint8_t)key_id;
+    ev.type = INPUT_TYPE_KEY;
+    ev.code = (uint8_t)event;
+    input_queue_push(INPUT_LANE_TASK, &ev);
+}
 
-        case EC11_EVENT_KEY_LONG_PRESS:
-            printf("EC11长按检测\n");
-            break;
+/* 输入事件处理 (主循环中按发生顺序调用) ----------------------------------*/
+void input_event_handler(const input_event_t *ev)
+{
+    menu_state_t *state = menu_get_state();
+    int16_t n;
 
-        default:
-            break;
+    if (ev->type == INPUT_TYPE_ROTATE) {
+        if (state->edit_mode) {
+            menu_value_adjust(ev->steps);  /* 编辑模式: 调整数值, 快速旋转时一格多步 */
+            return;
+        }
+        /* 普通模式: 上下移动 (合并后的事件可能包含多格) */
+        for (n = ev->delta; n < 0; n++) {
+            menu_move_up();
+        }
+        for (; n > 0; n--) {
+            menu_move_down();
+        }
+        return;
     }
-}
 
-/* 独立按键事件处理回调 ----------------------------------------------------*/
-void key_event_handler(key_id_t key_id, key_event_t event)
-{
-    if (key_id == KEY_ID_0 && event == KEY_EVENT_SHORT_PRESS) {
+    if (ev->source == INPUT_SRC_EC11) {
+        switch ((ec11_event_t)ev->code) {
+            case EC11_EVENT_KEY_SHORT_PRESS:
+                menu_enter();  /* 短按: 确认/进入 */
+                break;
+
+            case EC11_EVENT_KEY_LONG_PRESS:
+                printf("EC11长按检测\n");
+                break;
+
+            default:
+                break;
+        }
+    } else if (ev->id == KEY_ID_0 && ev->code == KEY_EVENT_SHORT_PRESS) {
         menu_back();  /* KEY0: 返回 */
     }
 }
@@ -226,15 +253,30 @@ void menu_display_callback(menu_state_t *state)
 {
     uint8_t i;
     menu_item_t **items = state->stack[state->depth];
-    uint8_t count = state->count_stack[state->depth];
-    uint8_t current_index = state->index_stack[state->depth];
+    uint16_t count = state->count_stack[state->depth];
+    uint16_t current_index = state->index_stack[state->depth];
 
     printf("\n========== 菜单显示 ==========\n");
     printf("层级: %d\n", state->depth);
 
+    /* 虚拟列表: 条目从页缓存中取 */
+    if (state->provider_stack[state->depth] != NULL) {
+        for (i = 0; i < MENU_MAX_ITEMS_PER_PAGE; i++) {
+            const menu_list_entry_t *entry = menu_list_get_row(i);
+
+            if (entry == NULL) {
+                break;
+            }
+            printf("%s%s%s\n", (state->scroll_offset + i == current_index) ? "> " : "  ",
+                   entry->name, (entry->flags & MENU_LIST_FLAG_BRANCH) ? " >" : "");
+        }
+        printf("(%u/%u)\n", current_index + 1, count);
+        return;
+    }
+
     /* 显示可见菜单项 */
     for (i = 0; i < count && i < MENU_MAX_ITEMS_PER_PAGE; i++) {
-        uint8_t item_index = state->scroll_offset + i;
+        uint16_t item_index = state->scroll_offset + i;
 
         if (item_index >= count) {
             break;
@@ -291,7 +333,8 @@ int main(void)
     printf("  TFT_EC11_KEY 菜单系统示例\n");
     printf("======================================\n\n");
 
-    /* 初始化EC11编码器 */
+    /* 初始化EC11编码器, 事件进入输入队列 */
+    input_queue_init();
     bsp_ec11_init();
     bsp_ec11_register_callback(ec11_event_handler);
 
@@ -314,9 +357,24 @@ int main(void)
     /* 主循环 */
     while (1) {
         /* 周期扫描 */
-        bsp_ec11_scan();
+        ec11_event_t ec11_event = bsp_ec11_scan();
+        if (ec11_event != EC11_EVENT_NONE) {
+            input_event_t ev = {0};
+
+            ev.time = system_tick;
+            ev.source = INPUT_SRC_EC11;
+            ev.type = INPUT_TYPE_KEY;
+            ev.code = (uint8_t)ec11_event;
+            input_queue_push(INPUT_LANE_TASK, &ev);
+        }
         bsp_key_scan();
 
+        /* 按发生顺序处理输入 */
+        input_queue_poll(input_event_handler);
+
+        /* 菜单有变化时按帧重绘 */
+        menu_render_frame(bsp_ec11_get_tick());
+
         /* 延时 */
         delay_ms(10);
     }
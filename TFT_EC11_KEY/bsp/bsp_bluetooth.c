@@ -11,6 +11,41 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <ctype.h>
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+/* HC-05/DX-BT311的应答以CRLF结尾, 按行匹配; 其他模块按静默时间判断结束 */
+#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
+#define BT_AT_LINE_MODE         1
+#define BT_AT_TERMINATOR        "\r\n"
+#else
+#define BT_AT_LINE_MODE         0
+#define BT_AT_TERMINATOR        ""
+#endif
+
+/**
+ * @brief AT命令请求
+ */
+typedef struct {
+    char cmd[BT_AT_CMD_MAX + 1];    /**< 命令 (不含"AT+") */
+    uint32_t timeout_ms;            /**< 超时 */
+    uint32_t baudrate;              /**< 成功后切换本地波特率, 0:不切换 */
+    bt_at_callback_t callback;      /**< 完成回调 */
+    void *arg;                      /**< 回调参数 */
+} bt_at_request_t;
+
+/**
+ * @brief 阻塞调用的完成状态
+ */
+typedef struct {
+    volatile uint8_t done;
+    bt_at_result_t result;
+    char *response;
+    uint16_t resp_size;
+} bt_at_sync_t;
 
 /*=============================================================================
  *                              私有变量
@@ -27,32 +62,103 @@ static bt_rx_callback_t rx_callback = NULL;
 static bt_frame_callback_t frame_callback = NULL;
 static bt_state_callback_t state_callback = NULL;
 
-/* 帧接收状态机 */
-static enum {
-    FRAME_STATE_IDLE,
-    FRAME_STATE_CMD,
-    FRAME_STATE_LEN,
-    FRAME_STATE_DATA,
-    FRAME_STATE_TAIL
-} frame_state = FRAME_STATE_IDLE;
-
-static bt_frame_t rx_frame;
-static uint8_t frame_data_idx = 0;
+/* 帧解析器与发送序号 */
+static frame_codec_parser_t frame_parser;
+static uint8_t tx_seq = 0;
 
 /* AT模式标志 */
 static uint8_t in_at_mode = 0;
 
+/* AT命令队列, 队首为正在执行的命令 */
+static bt_at_request_t at_queue[BT_AT_QUEUE_SIZE];
+static uint8_t at_q_head = 0;
+static uint8_t at_q_count = 0;
+static uint8_t at_active = 0;
+static uint32_t at_start_tick = 0;
+static uint32_t at_last_rx_tick = 0;
+
+/* 当前命令的应答 */
+static char at_resp[BT_AT_RESP_MAX];
+static uint16_t at_resp_len = 0;
+static uint16_t at_line_start = 0;
+
+/* 异步应用配置 */
+static struct {
+    uint8_t busy;
+    bt_at_result_t result;
+    bt_at_callback_t callback;
+    void *arg;
+} apply_ctx;
+
+/* 本地串口当前波特率 / 模块工作波特率 */
+static uint32_t bt_uart_baud = BT_DEFAULT_BAUD;
+static uint32_t bt_work_baud = BT_DEFAULT_BAUD;
+
+/* 波特率协商候选 (升序) */
+static const uint32_t bt_baud_table[] = {
+    9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600
+};
+#define BT_BAUD_TABLE_SIZE      (sizeof(bt_baud_table) / sizeof(bt_baud_table[0]))
+
+/* 波特率协商状态 */
+typedef enum {
+    BT_BAUD_IDLE = 0,
+    BT_BAUD_PROBE,              /**< 逐个波特率发AT, 找到模块当前波特率 */
+    BT_BAUD_SWITCH,             /**< 等待模块应答波特率设置 */
+    BT_BAUD_VERIFY              /**< 新波特率下回环校验 */
+} bt_baud_phase_t;
+
+static struct {
+    bt_baud_phase_t phase;
+    uint8_t order[BT_BAUD_TABLE_SIZE];      /**< 探测顺序 (表索引) */
+    uint8_t order_count;
+    uint8_t probe_pos;
+    uint8_t probe_tries;        /**< 当前候选已探测次数 */
+    uint8_t target;             /**< 目标表索引 */
+    uint8_t verified;           /**< 校验通过次数 */
+    uint8_t verify_errors;      /**< 校验失败次数 */
+    uint16_t failed_mask;       /**< 已判定不稳定的表索引 */
+    uint32_t current;           /**< 模块已确认的波特率 */
+    bt_baud_callback_t callback;
+} baud_ctx;
+
 /* 延时函数 */
 extern void delay_ms(uint32_t ms);
 
+/* 系统时基 (ms) */
+extern uint32_t scheduler_get_tick(void);
+
 /*=============================================================================
  *                              私有函数声明
  *============================================================================*/
 
 static void bt_gpio_init(void);
 static void bt_uart_rx_handler(uart_port_t port, uint8_t *data, uint16_t len);
-static void bt_process_frame_byte(uint8_t byte);
+static void bt_parse_rx_frames(void);
+static void bt_frame_dispatch(const frame_codec_frame_t *frame, void *arg);
 static void bt_update_state(void);
+static int bt_at_enqueue(const char *cmd, uint32_t timeout_ms, uint32_t baudrate,
+                         bt_at_callback_t callback, void *arg);
+static int bt_at_cmd_sync(const char *cmd, uint32_t baudrate, char *response,
+                          uint16_t resp_size, uint32_t timeout_ms);
+static void bt_at_sync_callback(bt_at_result_t result, const char *response, void *arg);
+static void bt_at_poll(void);
+static void bt_at_start(uint32_t now);
+static void bt_at_finish(bt_at_result_t result);
+static int bt_at_classify(const char *text);
+static void bt_apply_step_callback(bt_at_result_t result, const char *response, void *arg);
+static void bt_format_cmd_name(char *cmd, uint16_t size, const char *name);
+static void bt_format_cmd_pin(char *cmd, uint16_t size, const char *pin);
+static void bt_format_cmd_baudrate(char *cmd, uint16_t size, uint32_t baudrate);
+static int bt_copy_field(const char *response, const char *key, char *out, uint16_t size);
+static int bt_format_address(const char *raw, char *addr, uint16_t size);
+static void bt_set_local_baud(uint32_t baudrate);
+static void bt_baud_reprobe(uint32_t first, uint32_t second);
+static void bt_baud_probe_next(void);
+static void bt_baud_select(void);
+static void bt_baud_verify(void);
+static void bt_baud_finish(int result);
+static void bt_baud_callback(bt_at_result_t result, const char *response, void *arg);
 
 /*=============================================================================
  *                              公共函数实现
@@ -64,17 +170,31 @@ static void bt_update_state(void);
 int bsp_bluetooth_init(void)
 {
     uart_config_t uart_cfg;
+    uint32_t saved_baud;
+    uint8_t i;
 
     /* 初始化GPIO */
     bt_gpio_init();
 
     /* 初始化串口 */
     uart_cfg = bsp_uart_get_default_config();
-    uart_cfg.baudrate = BT_DEFAULT_BAUD;
+
+    /* 只接受协商候选值, 损坏或旧格式的保存值按无保存值处理 */
+    bt_work_baud = BT_DEFAULT_BAUD;
+    saved_baud = bsp_bluetooth_baud_load();
+    for (i = 0; i < BT_BAUD_TABLE_SIZE; i++) {
+        if (bt_baud_table[i] == saved_baud) {
+            bt_work_baud = saved_baud;
+            break;
+        }
+    }
+    uart_cfg.baudrate = bt_work_baud;
+    uart_cfg.use_dma = BT_UART_USE_DMA;
 
     if (bsp_uart_init(BT_UART_PORT, &uart_cfg) != 0) {
         return -1;
     }
+    bt_uart_baud = bt_work_baud;
 
     /* 设置接收回调 */
     bsp_uart_set_rx_callback(BT_UART_PORT, bt_uart_rx_handler);
@@ -83,8 +203,10 @@ int bsp_bluetooth_init(void)
     bt_state = BT_STATE_DISCONNECTED;
     rx_head = 0;
     rx_tail = 0;
-    frame_state = FRAME_STATE_IDLE;
+    frame_codec_parser_init(&frame_parser, bt_frame_dispatch, NULL);
+    tx_seq = 0;
     in_at_mode = 0;
+    bsp_bluetooth_at_cancel();
 
     /* EN引脚低电平 (正常工作模式) */
     BT_EN_LOW();
@@ -119,6 +241,13 @@ void bsp_bluetooth_reset(void)
  */
 void bsp_bluetooth_process(void)
 {
+    /* AT命令执行期间接收数据归AT引擎, 否则解析数据帧 */
+    if (at_q_count > 0) {
+        bt_at_poll();
+    } else if (!in_at_mode && frame_callback != NULL) {
+        bt_parse_rx_frames();
+    }
+
     /* 更新连接状态 */
     bt_update_state();
 
@@ -183,33 +312,42 @@ void bsp_bluetooth_printf(const char *fmt, ...)
  */
 int bsp_bluetooth_send_frame(uint8_t cmd, const uint8_t *data, uint8_t len)
 {
-    uint8_t frame[BT_FRAME_MAX_DATA + 4];
-    uint8_t checksum = 0;
-    uint8_t i;
-
-    if (len > BT_FRAME_MAX_DATA) {
+    if (bsp_bluetooth_send_frame_seq(tx_seq, cmd, data, len) != 0) {
         return -1;
     }
 
-    /* 组装帧 */
-    frame[0] = BT_FRAME_HEADER;
-    frame[1] = cmd;
-    frame[2] = len;
+    tx_seq++;
+    return 0;
+}
 
-    checksum = cmd ^ len;
-    for (i = 0; i < len; i++) {
-        frame[3 + i] = data[i];
-        checksum ^= data[i];
+/**
+ * @brief 发送指定序号的数据帧
+ */
+int bsp_bluetooth_send_frame_seq(uint8_t seq, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    uint8_t frame[FRAME_CODEC_ENCODED_MAX(BT_FRAME_MAX_DATA)];
+    uint16_t frame_len;
+
+    /* 组装帧 (CRC16 + 转义) */
+    frame_len = frame_codec_encode(seq, cmd, data, len, frame, sizeof(frame));
+    if (frame_len == 0) {
+        return -1;
     }
-    frame[3 + len] = checksum;
-    frame[4 + len] = BT_FRAME_TAIL;
 
     /* 发送 */
-    bsp_bluetooth_send(frame, 5 + len);
+    bsp_bluetooth_send(frame, frame_len);
 
     return 0;
 }
 
+/**
+ * @brief 获取帧解析统计
+ */
+const frame_codec_stats_t* bsp_bluetooth_get_frame_stats(void)
+{
+    return &frame_parser.stats;
+}
+
 /**
  * @brief 接收数据
  */
@@ -238,8 +376,8 @@ uint16_t bsp_bluetooth_get_rx_count(void)
  */
 void bsp_bluetooth_flush_rx(void)
 {
-    rx_head = 0;
-    rx_tail = 0;
+    rx_tail = rx_head;
+    frame_codec_parser_reset(&frame_parser);
 }
 
 /**
@@ -281,7 +419,7 @@ int bsp_bluetooth_enter_at_mode(void)
     delay_ms(100);
 
     /* 切换波特率到38400 (HC-05 AT模式默认波特率) */
-    bsp_uart_set_baudrate(BT_UART_PORT, 38400);
+    bt_set_local_baud(38400);
     delay_ms(100);
 
     /* 测试AT通信 */
@@ -293,7 +431,7 @@ int bsp_bluetooth_enter_at_mode(void)
 
     /* 失败，恢复 */
     BT_EN_LOW();
-    bsp_uart_set_baudrate(BT_UART_PORT, BT_DEFAULT_BAUD);
+    bt_set_local_baud(bt_work_baud);
     return -1;
 
 #elif BT_MODULE_TYPE == BT_MODULE_DX_BT311
@@ -303,7 +441,7 @@ int bsp_bluetooth_enter_at_mode(void)
     delay_ms(200);
 
     /* 切换波特率到38400 (DX-BT311 AT模式波特率) */
-    bsp_uart_set_baudrate(BT_UART_PORT, BT_DX311_AT_BAUD);
+    bt_set_local_baud(BT_DX311_AT_BAUD);
     delay_ms(100);
 
     /* 测试AT通信 */
@@ -314,7 +452,7 @@ int bsp_bluetooth_enter_at_mode(void)
     }
 
     /* 尝试工作模式波特率 */
-    bsp_uart_set_baudrate(BT_UART_PORT, BT_DX311_WORK_BAUD);
+    bt_set_local_baud(bt_work_baud);
     delay_ms(100);
 
     if (bsp_bluetooth_test_at() == 0) {
@@ -325,7 +463,7 @@ int bsp_bluetooth_enter_at_mode(void)
 
     /* 失败，恢复 */
     BT_EN_LOW();
-    bsp_uart_set_baudrate(BT_UART_PORT, BT_DEFAULT_BAUD);
+    bt_set_local_baud(bt_work_baud);
     return -1;
 
 #else
@@ -347,53 +485,46 @@ void bsp_bluetooth_exit_at_mode(void)
 #if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
     BT_EN_LOW();
     delay_ms(100);
-    bsp_uart_set_baudrate(BT_UART_PORT, BT_DEFAULT_BAUD);
+    bt_set_local_baud(bt_work_baud);
 #endif
     in_at_mode = 0;
     bt_state = BT_STATE_DISCONNECTED;
 }
 
 /**
- * @brief 发送AT命令
+ * @brief 异步提交AT命令
  */
-int bsp_bluetooth_at_cmd(const char *cmd, char *response, uint16_t resp_size, uint32_t timeout_ms)
+int bsp_bluetooth_at_submit(const char *cmd, uint32_t timeout_ms,
+                            bt_at_callback_t callback, void *arg)
 {
-    char at_cmd[64];
-    uint16_t idx = 0;
-    uint8_t byte;
-
-    /* 清空接收缓冲区 */
-    bsp_uart_flush_rx(BT_UART_PORT);
-
-    /* 发送AT命令 */
-#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
-    snprintf(at_cmd, sizeof(at_cmd), "AT+%s\r\n", cmd);
-#else
-    snprintf(at_cmd, sizeof(at_cmd), "AT+%s", cmd);
-#endif
-    bsp_uart_send_string(BT_UART_PORT, at_cmd);
-
-    if (response != NULL && resp_size > 0) {
-        response[0] = '\0';
-
-        /* 简单超时等待 */
-        delay_ms(timeout_ms);
+    return bt_at_enqueue(cmd, timeout_ms, 0, callback, arg);
+}
 
-        /* 读取响应 */
-        while (bsp_uart_receive_byte(BT_UART_PORT, &byte) == 0 && idx < resp_size - 1) {
-            response[idx++] = byte;
-        }
-        response[idx] = '\0';
+/**
+ * @brief 获取未完成的AT命令数
+ */
+uint8_t bsp_bluetooth_at_pending(void)
+{
+    return at_q_count;
+}
 
-        /* 检查是否包含OK */
-        if (strstr(response, "OK") != NULL) {
-            return 0;
-        } else if (strstr(response, "ERROR") != NULL || strstr(response, "FAIL") != NULL) {
-            return -2;
-        }
-    }
+/**
+ * @brief 取消所有未完成的AT命令
+ */
+void bsp_bluetooth_at_cancel(void)
+{
+    at_q_head = 0;
+    at_q_count = 0;
+    at_active = 0;
+    apply_ctx.busy = 0;
+}
 
-    return -1;
+/**
+ * @brief 发送AT命令 (阻塞)
+ */
+int bsp_bluetooth_at_cmd(const char *cmd, char *response, uint16_t resp_size, uint32_t timeout_ms)
+{
+    return bt_at_cmd_sync(cmd, 0, response, resp_size, timeout_ms);
 }
 
 /**
@@ -401,25 +532,7 @@ int bsp_bluetooth_at_cmd(const char *cmd, char *response, uint16_t resp_size, ui
  */
 int bsp_bluetooth_test_at(void)
 {
-    char response[32];
-
-#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
-    /* HC-05/DX-BT311: AT返回OK */
-    bsp_uart_send_string(BT_UART_PORT, "AT\r\n");
-#else
-    bsp_uart_send_string(BT_UART_PORT, "AT");
-#endif
-
-    delay_ms(500);
-
-    uint16_t len = bsp_uart_receive(BT_UART_PORT, (uint8_t*)response, sizeof(response) - 1);
-    response[len] = '\0';
-
-    if (strstr(response, "OK") != NULL) {
-        return 0;
-    }
-
-    return -1;
+    return (bsp_bluetooth_at_cmd("", NULL, 0, 500) == 0) ? 0 : -1;
 }
 
 /**
@@ -427,34 +540,40 @@ int bsp_bluetooth_test_at(void)
  */
 int bsp_bluetooth_set_name(const char *name)
 {
-    char cmd[48];
-
-#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
-    snprintf(cmd, sizeof(cmd), "NAME=%s", name);
-#elif BT_MODULE_TYPE == BT_MODULE_HC06
-    snprintf(cmd, sizeof(cmd), "NAME%s", name);
-#else /* HM-10 BLE */
-    snprintf(cmd, sizeof(cmd), "NAME%s", name);
-#endif
+    char cmd[BT_AT_CMD_MAX + 1];
 
+    bt_format_cmd_name(cmd, sizeof(cmd), name);
     return bsp_bluetooth_at_cmd(cmd, NULL, 0, BT_AT_TIMEOUT);
 }
 
 /**
- * @brief 设置配对密码
+ * @brief 获取蓝牙名称
  */
-int bsp_bluetooth_set_pin(const char *pin)
+int bsp_bluetooth_get_name(char *name, uint16_t size)
 {
-    char cmd[16];
-
-#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
-    snprintf(cmd, sizeof(cmd), "PSWD=%s", pin);
-#elif BT_MODULE_TYPE == BT_MODULE_HC06
-    snprintf(cmd, sizeof(cmd), "PIN%s", pin);
+#if BT_MODULE_TYPE == BT_MODULE_HC06
+    (void)name;
+    (void)size;
+    return -1; /* 不支持查询 */
 #else
-    snprintf(cmd, sizeof(cmd), "PASS%s", pin);
+    char response[BT_AT_RESP_MAX];
+
+    if (bsp_bluetooth_at_cmd("NAME?", response, sizeof(response), BT_AT_TIMEOUT) != 0) {
+        return -1;
+    }
+
+    return bt_copy_field(response, "NAME", name, size);
 #endif
+}
 
+/**
+ * @brief 设置配对密码
+ */
+int bsp_bluetooth_set_pin(const char *pin)
+{
+    char cmd[BT_AT_CMD_MAX + 1];
+
+    bt_format_cmd_pin(cmd, sizeof(cmd), pin);
     return bsp_bluetooth_at_cmd(cmd, NULL, 0, BT_AT_TIMEOUT);
 }
 
@@ -463,24 +582,11 @@ int bsp_bluetooth_set_pin(const char *pin)
  */
 int bsp_bluetooth_set_baudrate(uint32_t baudrate)
 {
-    char cmd[24];
-    int ret;
-
-#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
-    /* HC-05/DX-BT311: UART=波特率,停止位,校验位 */
-    snprintf(cmd, sizeof(cmd), "UART=%lu,0,0", baudrate);
-#else
-    snprintf(cmd, sizeof(cmd), "BAUD%lu", baudrate);
-#endif
-
-    ret = bsp_bluetooth_at_cmd(cmd, NULL, 0, BT_AT_TIMEOUT);
+    char cmd[BT_AT_CMD_MAX + 1];
 
-    if (ret == 0) {
-        /* 更新本地波特率 */
-        bsp_uart_set_baudrate(BT_UART_PORT, baudrate);
-    }
-
-    return ret;
+    /* 模块应答OK后再切换本地波特率 */
+    bt_format_cmd_baudrate(cmd, sizeof(cmd), baudrate);
+    return bt_at_cmd_sync(cmd, baudrate, NULL, 0, BT_AT_TIMEOUT);
 }
 
 /**
@@ -498,6 +604,31 @@ int bsp_bluetooth_set_role(bt_role_t role)
 #endif
 }
 
+/**
+ * @brief 获取蓝牙地址
+ */
+int bsp_bluetooth_get_address(char *addr, uint16_t size)
+{
+#if BT_MODULE_TYPE == BT_MODULE_HC06
+    (void)addr;
+    (void)size;
+    return -1; /* 不支持查询 */
+#else
+    char response[BT_AT_RESP_MAX];
+    char raw[24];
+
+    if (bsp_bluetooth_at_cmd("ADDR?", response, sizeof(response), BT_AT_TIMEOUT) != 0) {
+        return -1;
+    }
+
+    if (bt_copy_field(response, "ADDR", raw, sizeof(raw)) != 0) {
+        return -1;
+    }
+
+    return bt_format_address(raw, addr, size);
+#endif
+}
+
 /**
  * @brief 恢复出厂设置
  */
@@ -514,6 +645,155 @@ int bsp_bluetooth_factory_reset(void)
 #endif
 }
 
+/**
+ * @brief 应用配置
+ */
+int bsp_bluetooth_apply_config(const bt_config_t *config)
+{
+    if (config == NULL) {
+        return -1;
+    }
+
+    if (config->name[0] != '\0' && bsp_bluetooth_set_name(config->name) != 0) {
+        return -1;
+    }
+
+    if (config->pin[0] != '\0' && bsp_bluetooth_set_pin(config->pin) != 0) {
+        return -1;
+    }
+
+#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
+    if (bsp_bluetooth_set_role(config->role) != 0) {
+        return -1;
+    }
+#endif
+
+    /* 波特率最后修改, 之后的命令都要用新波特率 */
+    if (config->baudrate != 0 && bsp_bluetooth_set_baudrate(config->baudrate) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 异步应用配置
+ */
+int bsp_bluetooth_apply_config_async(const bt_config_t *config,
+                                     bt_at_callback_t callback, void *arg)
+{
+    char cmd[BT_AT_CMD_MAX + 1];
+    uint8_t need = 0;
+
+    if (config == NULL || apply_ctx.busy) {
+        return -1;
+    }
+
+    need += (config->name[0] != '\0');
+    need += (config->pin[0] != '\0');
+#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
+    need++;
+#endif
+    need += (config->baudrate != 0);
+
+    if (need == 0 || BT_AT_QUEUE_SIZE - at_q_count < need) {
+        return -1;
+    }
+
+    apply_ctx.busy = 1;
+    apply_ctx.result = BT_AT_RESULT_OK;
+    apply_ctx.callback = callback;
+    apply_ctx.arg = arg;
+
+    /* 最后一条命令的回调参数非空, 作为整体完成的标志 */
+    if (config->name[0] != '\0') {
+        bt_format_cmd_name(cmd, sizeof(cmd), config->name);
+        bt_at_enqueue(cmd, BT_AT_TIMEOUT, 0, bt_apply_step_callback,
+                      (--need == 0) ? &apply_ctx : NULL);
+    }
+
+    if (config->pin[0] != '\0') {
+        bt_format_cmd_pin(cmd, sizeof(cmd), config->pin);
+        bt_at_enqueue(cmd, BT_AT_TIMEOUT, 0, bt_apply_step_callback,
+                      (--need == 0) ? &apply_ctx : NULL);
+    }
+
+#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
+    snprintf(cmd, sizeof(cmd), "ROLE=%d", config->role);
+    bt_at_enqueue(cmd, BT_AT_TIMEOUT, 0, bt_apply_step_callback,
+                  (--need == 0) ? &apply_ctx : NULL);
+#endif
+
+    if (config->baudrate != 0) {
+        bt_format_cmd_baudrate(cmd, sizeof(cmd), config->baudrate);
+        bt_at_enqueue(cmd, BT_AT_TIMEOUT, config->baudrate, bt_apply_step_callback,
+                      (--need == 0) ? &apply_ctx : NULL);
+    }
+
+    return 0;
+}
+
+/*=============================================================================
+ *                              波特率协商
+ *============================================================================*/
+
+/**
+ * @brief 读取保存的工作波特率 (弱函数, 用户可重写)
+ */
+__weak uint32_t bsp_bluetooth_baud_load(void)
+{
+    return 0;
+}
+
+/**
+ * @brief 保存工作波特率 (弱函数, 用户可重写)
+ */
+__weak void bsp_bluetooth_baud_store(uint32_t baudrate)
+{
+    (void)baudrate;
+}
+
+/**
+ * @brief 获取本地串口当前波特率
+ */
+uint32_t bsp_bluetooth_get_baudrate(void)
+{
+    return bt_uart_baud;
+}
+
+/**
+ * @brief 波特率协商是否进行中
+ */
+uint8_t bsp_bluetooth_baud_busy(void)
+{
+    return (baud_ctx.phase != BT_BAUD_IDLE) ? 1 : 0;
+}
+
+/**
+ * @brief 启动波特率协商
+ */
+int bsp_bluetooth_baud_negotiate(bt_baud_callback_t callback)
+{
+#if BT_MODULE_TYPE == BT_MODULE_HC05
+    /* HC-05的AT口固定38400, 设置的波特率只在数据模式生效, 无法在线校验 */
+    (void)callback;
+    return -1;
+#else
+    if (baud_ctx.phase != BT_BAUD_IDLE || at_q_count > 0 || bt_state == BT_STATE_CONNECTED) {
+        return -1;
+    }
+
+    baud_ctx.failed_mask = 0;
+    baud_ctx.current = 0;
+    baud_ctx.callback = callback;
+
+    /* 本地当前波特率最可能与模块一致, 优先探测 */
+    bt_baud_reprobe(bt_uart_baud, bt_work_baud);
+
+    return 0;
+#endif
+}
+
 /*=============================================================================
  *                              私有函数实现
  *============================================================================*/
@@ -554,18 +834,14 @@ static void bt_uart_rx_handler(uart_port_t port, uint8_t *data, uint16_t len)
 
     (void)port;
 
+    /* 中断中只做拷贝, 帧解析在bsp_bluetooth_process()中进行 */
     for (i = 0; i < len; i++) {
-        /* 存入缓冲区 */
         uint16_t next = (rx_head + 1) % BT_RX_BUFFER_SIZE;
-        if (next != rx_tail) {
-            rx_buffer[rx_head] = data[i];
-            rx_head = next;
-        }
-
-        /* 帧解析 */
-        if (!in_at_mode) {
-            bt_process_frame_byte(data[i]);
+        if (next == rx_tail) {
+            break;
         }
+        rx_buffer[rx_head] = data[i];
+        rx_head = next;
     }
 
     /* 原始数据回调 */
@@ -575,50 +851,30 @@ static void bt_uart_rx_handler(uart_port_t port, uint8_t *data, uint16_t len)
 }
 
 /**
- * @brief 帧解析状态机
+ * @brief 解析接收缓冲区中的数据帧
+ * @note 按连续片段交给解析器, 环形回绕时分两次
  */
-static void bt_process_frame_byte(uint8_t byte)
+static void bt_parse_rx_frames(void)
 {
-    switch (frame_state) {
-    case FRAME_STATE_IDLE:
-        if (byte == BT_FRAME_HEADER) {
-            frame_state = FRAME_STATE_CMD;
-        }
-        break;
+    while (rx_tail != rx_head) {
+        uint16_t head = rx_head;
+        uint16_t tail = rx_tail;
+        uint16_t len = (head > tail) ? (head - tail) : (BT_RX_BUFFER_SIZE - tail);
 
-    case FRAME_STATE_CMD:
-        rx_frame.cmd = byte;
-        frame_state = FRAME_STATE_LEN;
-        break;
-
-    case FRAME_STATE_LEN:
-        rx_frame.len = byte;
-        if (rx_frame.len > BT_FRAME_MAX_DATA) {
-            frame_state = FRAME_STATE_IDLE;
-        } else if (rx_frame.len == 0) {
-            frame_state = FRAME_STATE_TAIL;
-        } else {
-            frame_data_idx = 0;
-            frame_state = FRAME_STATE_DATA;
-        }
-        break;
+        frame_codec_parse(&frame_parser, &rx_buffer[tail], len);
+        rx_tail = (tail + len) % BT_RX_BUFFER_SIZE;
+    }
+}
 
-    case FRAME_STATE_DATA:
-        rx_frame.data[frame_data_idx++] = byte;
-        if (frame_data_idx >= rx_frame.len) {
-            frame_state = FRAME_STATE_TAIL;
-        }
-        break;
+/**
+ * @brief 解析器帧回调
+ */
+static void bt_frame_dispatch(const frame_codec_frame_t *frame, void *arg)
+{
+    (void)arg;
 
-    case FRAME_STATE_TAIL:
-        if (byte == BT_FRAME_TAIL) {
-            /* 帧接收完成 */
-            if (frame_callback != NULL) {
-                frame_callback(&rx_frame);
-            }
-        }
-        frame_state = FRAME_STATE_IDLE;
-        break;
+    if (frame_callback != NULL) {
+        frame_callback(frame);
     }
 }
 
@@ -644,3 +900,523 @@ static void bt_update_state(void)
     /* 简单方案：通过数据收发判断 */
 #endif
 }
+
+/**
+ * @brief AT命令入队
+ */
+static int bt_at_enqueue(const char *cmd, uint32_t timeout_ms, uint32_t baudrate,
+                         bt_at_callback_t callback, void *arg)
+{
+    bt_at_request_t *req;
+
+    if (cmd == NULL || strlen(cmd) > BT_AT_CMD_MAX || at_q_count >= BT_AT_QUEUE_SIZE) {
+        return -1;
+    }
+
+    req = &at_queue[(at_q_head + at_q_count) % BT_AT_QUEUE_SIZE];
+    strcpy(req->cmd, cmd);
+    req->timeout_ms = timeout_ms;
+    req->baudrate = baudrate;
+    req->callback = callback;
+    req->arg = arg;
+    at_q_count++;
+
+    return 0;
+}
+
+/**
+ * @brief 阻塞执行AT命令: 入队后原地推进引擎直到本命令完成
+ */
+static int bt_at_cmd_sync(const char *cmd, uint32_t baudrate, char *response,
+                          uint16_t resp_size, uint32_t timeout_ms)
+{
+    bt_at_sync_t sync;
+
+    sync.done = 0;
+    sync.result = BT_AT_RESULT_TIMEOUT;
+    sync.response = response;
+    sync.resp_size = resp_size;
+
+    if (response != NULL && resp_size > 0) {
+        response[0] = '\0';
+    }
+
+    if (bt_at_enqueue(cmd, timeout_ms, baudrate, bt_at_sync_callback, &sync) != 0) {
+        return -1;
+    }
+
+    while (!sync.done) {
+        bt_at_poll();
+        if (!sync.done) {
+            delay_ms(1);
+        }
+    }
+
+    if (sync.result == BT_AT_RESULT_OK) {
+        return 0;
+    }
+
+    return (sync.result == BT_AT_RESULT_ERROR) ? -2 : -1;
+}
+
+/**
+ * @brief 阻塞调用的完成回调
+ */
+static void bt_at_sync_callback(bt_at_result_t result, const char *response, void *arg)
+{
+    bt_at_sync_t *sync = (bt_at_sync_t *)arg;
+
+    if (sync->response != NULL && sync->resp_size > 0) {
+        strncpy(sync->response, response, sync->resp_size - 1);
+        sync->response[sync->resp_size - 1] = '\0';
+    }
+
+    sync->result = result;
+    sync->done = 1;
+}
+
+/**
+ * @brief 推进AT引擎: 发送队首命令, 消费应答, 检查超时
+ */
+static void bt_at_poll(void)
+{
+    uint32_t now = scheduler_get_tick();
+
+    if (at_q_count == 0) {
+        return;
+    }
+
+    if (!at_active) {
+        bt_at_start(now);
+    }
+
+    while (rx_tail != rx_head) {
+        char c = (char)rx_buffer[rx_tail];
+        rx_tail = (rx_tail + 1) % BT_RX_BUFFER_SIZE;
+        at_last_rx_tick = now;
+
+        /* 缓冲区满时保留开头, 继续检测结束行 */
+        if (at_resp_len < BT_AT_RESP_MAX - 1) {
+            at_resp[at_resp_len++] = c;
+            at_resp[at_resp_len] = '\0';
+        }
+
+#if BT_AT_LINE_MODE
+        if (c == '\n') {
+            int result = bt_at_classify(&at_resp[at_line_start]);
+            at_line_start = at_resp_len;
+            if (result >= 0) {
+                bt_at_finish((bt_at_result_t)result);
+                return;
+            }
+        }
+#endif
+    }
+
+#if !BT_AT_LINE_MODE
+    if (at_resp_len > 0 && now - at_last_rx_tick >= BT_AT_QUIET_MS) {
+        int result = bt_at_classify(at_resp);
+        if (result >= 0) {
+            bt_at_finish((bt_at_result_t)result);
+            return;
+        }
+    }
+#endif
+
+    if (now - at_start_tick >= at_queue[at_q_head].timeout_ms) {
+        bt_at_finish(BT_AT_RESULT_TIMEOUT);
+    }
+}
+
+/**
+ * @brief 发送队首命令
+ */
+static void bt_at_start(uint32_t now)
+{
+    char line[BT_AT_CMD_MAX + 8];
+    const char *cmd = at_queue[at_q_head].cmd;
+
+    /* 丢弃上一条命令之后残留的数据 */
+    rx_tail = rx_head;
+    at_resp_len = 0;
+    at_line_start = 0;
+    at_resp[0] = '\0';
+
+    if (cmd[0] == '\0') {
+        snprintf(line, sizeof(line), "AT%s", BT_AT_TERMINATOR);
+    } else {
+        snprintf(line, sizeof(line), "AT+%s%s", cmd, BT_AT_TERMINATOR);
+    }
+    bsp_uart_send_string(BT_UART_PORT, line);
+
+    at_active = 1;
+    at_start_tick = now;
+    at_last_rx_tick = now;
+}
+
+/**
+ * @brief 队首命令完成: 出队, 回调, 立即发送下一条
+ */
+static void bt_at_finish(bt_at_result_t result)
+{
+    bt_at_request_t req = at_queue[at_q_head];
+
+    at_q_head = (at_q_head + 1) % BT_AT_QUEUE_SIZE;
+    at_q_count--;
+    at_active = 0;
+
+    if (result == BT_AT_RESULT_OK && req.baudrate != 0) {
+        bt_set_local_baud(req.baudrate);
+    }
+
+    if (req.callback != NULL) {
+        req.callback(result, at_resp, req.arg);
+    }
+
+    if (at_q_count > 0 && !at_active) {
+        bt_at_start(scheduler_get_tick());
+    }
+}
+
+/**
+ * @brief 判断应答结果
+ * @retval BT_AT_RESULT_OK / BT_AT_RESULT_ERROR, -1:尚未结束
+ */
+static int bt_at_classify(const char *text)
+{
+#if BT_AT_LINE_MODE
+    if (strncmp(text, "OK", 2) == 0) {
+        return BT_AT_RESULT_OK;
+    }
+#else
+    if (strstr(text, "OK") != NULL) {
+        return BT_AT_RESULT_OK;
+    }
+#endif
+
+    if (strstr(text, "ERROR") != NULL || strstr(text, "FAIL") != NULL) {
+        return BT_AT_RESULT_ERROR;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief 异步应用配置的单步回调
+ */
+static void bt_apply_step_callback(bt_at_result_t result, const char *response, void *arg)
+{
+    if (result != BT_AT_RESULT_OK && apply_ctx.result == BT_AT_RESULT_OK) {
+        apply_ctx.result = result;
+    }
+
+    if (arg != NULL) {
+        apply_ctx.busy = 0;
+        if (apply_ctx.callback != NULL) {
+            apply_ctx.callback(apply_ctx.result, response, apply_ctx.arg);
+        }
+    }
+}
+
+/**
+ * @brief 组装设置名称命令
+ */
+static void bt_format_cmd_name(char *cmd, uint16_t size, const char *name)
+{
+#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
+    snprintf(cmd, size, "NAME=%s", name);
+#else /* HC-06 / HM-10 */
+    snprintf(cmd, size, "NAME%s", name);
+#endif
+}
+
+/**
+ * @brief 组装设置密码命令
+ */
+static void bt_format_cmd_pin(char *cmd, uint16_t size, const char *pin)
+{
+#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
+    snprintf(cmd, size, "PSWD=%s", pin);
+#elif BT_MODULE_TYPE == BT_MODULE_HC06
+    snprintf(cmd, size, "PIN%s", pin);
+#else
+    snprintf(cmd, size, "PASS%s", pin);
+#endif
+}
+
+/**
+ * @brief 组装设置波特率命令
+ */
+static void bt_format_cmd_baudrate(char *cmd, uint16_t size, uint32_t baudrate)
+{
+#if BT_MODULE_TYPE == BT_MODULE_HC05 || BT_MODULE_TYPE == BT_MODULE_DX_BT311
+    /* HC-05/DX-BT311: UART=波特率,停止位,校验位 */
+    snprintf(cmd, size, "UART=%lu,0,0", (unsigned long)baudrate);
+#else
+    snprintf(cmd, size, "BAUD%lu", (unsigned long)baudrate);
+#endif
+}
+
+/**
+ * @brief 从应答中提取字段值 ("+NAME:xxx" / "OK+NAME:xxx" / "+NAME=xxx")
+ */
+static int bt_copy_field(const char *response, const char *key, char *out, uint16_t size)
+{
+    const char *p = strstr(response, key);
+    uint16_t n = 0;
+
+    if (p == NULL || out == NULL || size == 0) {
+        return -1;
+    }
+
+    p += strlen(key);
+    if (*p != ':' && *p != '=') {
+        return -1;
+    }
+    p++;
+
+    while (*p != '\0' && *p != '\r' && *p != '\n' && n < size - 1) {
+        out[n++] = *p++;
+    }
+    out[n] = '\0';
+
+    return 0;
+}
+
+/**
+ * @brief 地址格式化为 XX:XX:XX:XX:XX:XX
+ * @note HC-05返回 NAP:UAP:LAP (如 98d3:31:fd5e4f, 各段省略前导0), HM-10返回12位十六进制
+ */
+static int bt_format_address(const char *raw, char *addr, uint16_t size)
+{
+    static const uint8_t part_digits[3] = {4, 2, 6};
+    char hex[13];
+    uint8_t pos = 0;
+    uint8_t part = 0;
+    const char *p = raw;
+    uint8_t i;
+
+    if (addr == NULL || size < 18) {
+        return -1;
+    }
+
+    if (strchr(raw, ':') != NULL) {
+        /* NAP:UAP:LAP, 每段右对齐补0 */
+        while (part < 3) {
+            const char *end = strchr(p, ':');
+            uint8_t len = (end != NULL) ? (uint8_t)(end - p) : (uint8_t)strlen(p);
+
+            if (len == 0 || len > part_digits[part]) {
+                return -1;
+            }
+            for (i = len; i < part_digits[part]; i++) {
+                hex[pos++] = '0';
+            }
+            memcpy(&hex[pos], p, len);
+            pos += len;
+            part++;
+
+            if (end == NULL) {
+                break;
+            }
+            p = end + 1;
+        }
+        if (part != 3) {
+            return -1;
+        }
+    } else {
+        if (strlen(raw) != 12) {
+            return -1;
+        }
+        memcpy(hex, raw, 12);
+        pos = 12;
+    }
+    hex[pos] = '\0';
+
+    for (i = 0; i < 6; i++) {
+        addr[i * 3] = (char)toupper((unsigned char)hex[i * 2]);
+        addr[i * 3 + 1] = (char)toupper((unsigned char)hex[i * 2 + 1]);
+        addr[i * 3 + 2] = (i < 5) ? ':' : '\0';
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 切换本地串口波特率并记录
+ */
+static void bt_set_local_baud(uint32_t baudrate)
+{
+    bsp_uart_set_baudrate(BT_UART_PORT, baudrate);
+    bt_uart_baud = baudrate;
+}
+
+/**
+ * @brief 重新开始探测
+ * @param first 优先探测的波特率
+ * @param second 其次探测的波特率
+ * @note 其余候选从高到低
+ */
+static void bt_baud_reprobe(uint32_t first, uint32_t second)
+{
+    uint8_t i;
+    uint8_t n = 0;
+
+    for (i = 0; i < BT_BAUD_TABLE_SIZE; i++) {
+        if (bt_baud_table[i] == first) {
+            baud_ctx.order[n++] = i;
+        }
+    }
+    for (i = 0; i < BT_BAUD_TABLE_SIZE; i++) {
+        if (bt_baud_table[i] == second && second != first) {
+            baud_ctx.order[n++] = i;
+        }
+    }
+    for (i = BT_BAUD_TABLE_SIZE; i > 0; i--) {
+        if (bt_baud_table[i - 1] != first && bt_baud_table[i - 1] != second) {
+            baud_ctx.order[n++] = i - 1;
+        }
+    }
+
+    baud_ctx.order_count = n;
+    baud_ctx.probe_pos = 0;
+    bt_baud_probe_next();
+}
+
+/**
+ * @brief 以下一个候选波特率探测模块
+ */
+static void bt_baud_probe_next(void)
+{
+    if (baud_ctx.probe_pos >= baud_ctx.order_count) {
+        bt_baud_finish(-1);
+        return;
+    }
+
+    baud_ctx.phase = BT_BAUD_PROBE;
+    baud_ctx.probe_tries = 1;
+    bt_set_local_baud(bt_baud_table[baud_ctx.order[baud_ctx.probe_pos++]]);
+    bt_at_enqueue("", BT_BAUD_PROBE_TIMEOUT, 0, bt_baud_callback, NULL);
+}
+
+/**
+ * @brief 选择不超过上限且未失败的最高波特率, 与当前不同则切换
+ */
+static void bt_baud_select(void)
+{
+    char cmd[BT_AT_CMD_MAX + 1];
+    uint8_t i = BT_BAUD_TABLE_SIZE;
+
+    while (i > 0) {
+        i--;
+        if (bt_baud_table[i] <= BT_BAUD_MAX && !(baud_ctx.failed_mask & (1U << i))) {
+            break;
+        }
+        if (i == 0) {
+            bt_baud_finish(-1);
+            return;
+        }
+    }
+
+    if (bt_baud_table[i] == baud_ctx.current) {
+        bt_baud_finish(0);
+        return;
+    }
+
+    /* 模块应答OK后本地随之切换 (见bt_at_finish) */
+    baud_ctx.target = i;
+    baud_ctx.phase = BT_BAUD_SWITCH;
+    bt_format_cmd_baudrate(cmd, sizeof(cmd), bt_baud_table[i]);
+    bt_at_enqueue(cmd, BT_AT_TIMEOUT, bt_baud_table[i], bt_baud_callback, NULL);
+}
+
+/**
+ * @brief 新波特率下发送一次回环校验
+ */
+static void bt_baud_verify(void)
+{
+    baud_ctx.phase = BT_BAUD_VERIFY;
+    bt_at_enqueue("", BT_BAUD_PROBE_TIMEOUT, 0, bt_baud_callback, NULL);
+}
+
+/**
+ * @brief 协商结束
+ */
+static void bt_baud_finish(int result)
+{
+    baud_ctx.phase = BT_BAUD_IDLE;
+
+    if (result == 0) {
+        bt_work_baud = baud_ctx.current;
+        bsp_bluetooth_baud_store(bt_work_baud);
+    } else {
+        /* 未找到模块, 恢复原工作波特率 */
+        bt_set_local_baud(bt_work_baud);
+    }
+
+    if (baud_ctx.callback != NULL) {
+        baud_ctx.callback(result, bt_uart_baud);
+    }
+}
+
+/**
+ * @brief 协商各步骤的AT完成回调
+ */
+static void bt_baud_callback(bt_at_result_t result, const char *response, void *arg)
+{
+    (void)response;
+    (void)arg;
+
+    switch (baud_ctx.phase) {
+    case BT_BAUD_PROBE:
+        if (result == BT_AT_RESULT_OK) {
+            baud_ctx.current = bt_uart_baud;
+            bt_baud_select();
+        } else if (baud_ctx.probe_tries < BT_BAUD_PROBE_TRIES) {
+            /* 误码较多的波特率可能偶尔无应答, 同一候选再试一次 */
+            baud_ctx.probe_tries++;
+            bt_at_enqueue("", BT_BAUD_PROBE_TIMEOUT, 0, bt_baud_callback, NULL);
+        } else {
+            bt_baud_probe_next();
+        }
+        break;
+
+    case BT_BAUD_SWITCH:
+        if (result == BT_AT_RESULT_OK) {
+            baud_ctx.verified = 0;
+            baud_ctx.verify_errors = 0;
+            bt_baud_verify();
+        } else {
+            baud_ctx.failed_mask |= 1U << baud_ctx.target;
+            if (result == BT_AT_RESULT_ERROR) {
+                /* 模块拒绝该波特率, 仍在原波特率 */
+                bt_baud_select();
+            } else {
+                /* 无应答: 模块可能已切换也可能未切换, 重新探测 */
+                bt_baud_reprobe(bt_baud_table[baud_ctx.target], baud_ctx.current);
+            }
+        }
+        break;
+
+    case BT_BAUD_VERIFY:
+        if (result == BT_AT_RESULT_OK) {
+            if (++baud_ctx.verified >= BT_BAUD_VERIFY_COUNT) {
+                baud_ctx.current = bt_baud_table[baud_ctx.target];
+                bt_baud_finish(0);
+            } else {
+                bt_baud_verify();
+            }
+        } else if (++baud_ctx.verify_errors <= 1) {
+            /* 模块切换波特率需要少许时间, 允许一次失败 */
+            bt_baud_verify();
+        } else {
+            /* 新波特率不稳定: 标记后重新探测, 再选次高的波特率 */
+            baud_ctx.failed_mask |= 1U << baud_ctx.target;
+            bt_baud_reprobe(bt_baud_table[baud_ctx.target], baud_ctx.current);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
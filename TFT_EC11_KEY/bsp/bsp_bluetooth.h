@@ -8,11 +8,13 @@
  * @note 功能特性:
  *       - 支持HC-05/HC-06 SPP蓝牙
  *       - 支持HM-10/CC2541 BLE蓝牙
- *       - AT命令配置
+ *       - AT命令配置 (异步队列, 收到OK/ERROR即完成, 不阻塞调度器)
+ *       - 波特率自动协商 (探测当前波特率, 提升到最高稳定值并校验, 失败回退)
  *       - 透传模式
  *       - 自动重连
  *       - 连接状态检测
- *       - 数据帧协议
+ *       - 数据帧协议 (CRC16 + 字节填充 + 序号, 见frame_codec.h)
+ *       - 串口DMA接收, 帧解析在任务上下文中按数据片段进行
  */
 
 #ifndef __BSP_BLUETOOTH_H
@@ -23,6 +25,7 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include "frame_codec.h"
 
 /*=============================================================================
  *                              宏定义配置
@@ -40,6 +43,9 @@ extern "C" {
 /* 蓝牙使用的串口 */
 #define BT_UART_PORT            UART_PORT_2
 
+/* 串口接收使用DMA */
+#define BT_UART_USE_DMA         1
+
 /* 缓冲区大小 */
 #define BT_RX_BUFFER_SIZE       256
 #define BT_TX_BUFFER_SIZE       256
@@ -50,14 +56,38 @@ extern "C" {
 /* AT命令超时 (ms) */
 #define BT_AT_TIMEOUT           1000
 
+/* AT命令队列深度 */
+#define BT_AT_QUEUE_SIZE        8
+
+/* AT命令最大长度 (不含"AT+"前缀和结束符) */
+#define BT_AT_CMD_MAX           40
+
+/* AT应答缓冲区大小 */
+#define BT_AT_RESP_MAX          96
+
+/* 无行结束符的模块 (HC-06/HM-10): 应答静默多久视为结束 (ms) */
+#define BT_AT_QUIET_MS          30
+
+/* 波特率协商上限 (受模块和串口时钟限制) */
+#define BT_BAUD_MAX             921600
+
+/* 探测/校验单次AT超时 (ms) */
+#define BT_BAUD_PROBE_TIMEOUT   200
+
+/* 每个候选波特率的探测次数 */
+#define BT_BAUD_PROBE_TRIES     2
+
+/* 切换后连续校验成功次数 */
+#define BT_BAUD_VERIFY_COUNT    3
+
 /* DX-BT311特有配置 */
 #define BT_DX311_AT_BAUD        38400   /* AT模式波特率 */
 #define BT_DX311_WORK_BAUD      9600    /* 工作模式波特率 */
 
 /* 数据帧配置 */
-#define BT_FRAME_HEADER         0xAA
-#define BT_FRAME_TAIL           0x55
-#define BT_FRAME_MAX_DATA       200
+#define BT_FRAME_HEADER         FRAME_CODEC_HEADER
+#define BT_FRAME_TAIL           FRAME_CODEC_TAIL
+#define BT_FRAME_MAX_DATA       FRAME_CODEC_MAX_DATA
 
 /*=============================================================================
  *                              引脚配置
@@ -112,13 +142,34 @@ typedef struct {
 } bt_config_t;
 
 /**
- * @brief 数据帧结构
+ * @brief AT命令结果
  */
-typedef struct {
-    uint8_t cmd;                /**< 命令码 */
-    uint8_t data[BT_FRAME_MAX_DATA];  /**< 数据 */
-    uint8_t len;                /**< 数据长度 */
-} bt_frame_t;
+typedef enum {
+    BT_AT_RESULT_OK = 0,        /**< 收到OK */
+    BT_AT_RESULT_ERROR,         /**< 收到ERROR/FAIL */
+    BT_AT_RESULT_TIMEOUT        /**< 超时 */
+} bt_at_result_t;
+
+/**
+ * @brief AT命令完成回调
+ * @param result 结果
+ * @param response 收到的应答原文 (仅在回调期间有效)
+ * @param arg 用户参数
+ * @note 在bsp_bluetooth_process()中调用, 不在中断上下文
+ */
+typedef void (*bt_at_callback_t)(bt_at_result_t result, const char *response, void *arg);
+
+/**
+ * @brief 波特率协商完成回调
+ * @param result 0:成功 -1:失败 (未找到模块)
+ * @param baudrate 最终使用的波特率
+ */
+typedef void (*bt_baud_callback_t)(int result, uint32_t baudrate);
+
+/**
+ * @brief 数据帧结构 (seq/cmd/len/data)
+ */
+typedef frame_codec_frame_t bt_frame_t;
 
 /**
  * @brief 接收回调
@@ -129,7 +180,8 @@ typedef void (*bt_rx_callback_t)(uint8_t *data, uint16_t len);
 
 /**
  * @brief 帧接收回调
- * @param frame 数据帧
+ * @param frame 数据帧 (已通过CRC校验)
+ * @note 在bsp_bluetooth_process()中调用, 不在中断上下文
  */
 typedef void (*bt_frame_callback_t)(const bt_frame_t *frame);
 
@@ -163,7 +215,7 @@ void bsp_bluetooth_reset(void);
 
 /**
  * @brief 周期处理 (主循环调用)
- * @note 处理接收数据和状态更新
+ * @note 处理接收数据和状态更新; 设置了帧回调时在此解析接收缓冲区中的数据帧
  */
 void bsp_bluetooth_process(void);
 
@@ -214,9 +266,27 @@ void bsp_bluetooth_printf(const char *fmt, ...);
  * @param data 数据
  * @param len 数据长度
  * @retval 0:成功 -1:失败
+ * @note 序号自动递增
  */
 int bsp_bluetooth_send_frame(uint8_t cmd, const uint8_t *data, uint8_t len);
 
+/**
+ * @brief 发送指定序号的数据帧
+ * @param seq 序号
+ * @param cmd 命令码
+ * @param data 数据
+ * @param len 数据长度
+ * @retval 0:成功 -1:失败
+ * @note 供可靠传输层重传使用
+ */
+int bsp_bluetooth_send_frame_seq(uint8_t seq, uint8_t cmd, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 获取帧解析统计
+ * @retval 统计信息指针
+ */
+const frame_codec_stats_t* bsp_bluetooth_get_frame_stats(void);
+
 /**
  * @brief 接收数据
  * @param data 缓冲区
@@ -247,6 +317,7 @@ void bsp_bluetooth_set_rx_callback(bt_rx_callback_t callback);
 /**
  * @brief 设置帧接收回调
  * @param callback 回调函数
+ * @note 设置后接收缓冲区由帧解析器消费, bsp_bluetooth_receive()不再返回数据
  */
 void bsp_bluetooth_set_frame_callback(bt_frame_callback_t callback);
 
@@ -270,12 +341,38 @@ int bsp_bluetooth_enter_at_mode(void);
 void bsp_bluetooth_exit_at_mode(void);
 
 /**
- * @brief 发送AT命令
+ * @brief 异步提交AT命令
+ * @param cmd AT命令 (不含"AT+"前缀, 空字符串表示单独的"AT")
+ * @param timeout_ms 超时时间
+ * @param callback 完成回调 (可为NULL)
+ * @param arg 回调参数
+ * @retval 0:已入队 -1:队列满或命令过长
+ * @note 命令按提交顺序逐条执行, 收到OK/ERROR后立即开始下一条;
+ *       执行期间接收数据由AT引擎消费, 不进行帧解析
+ */
+int bsp_bluetooth_at_submit(const char *cmd, uint32_t timeout_ms,
+                            bt_at_callback_t callback, void *arg);
+
+/**
+ * @brief 获取未完成的AT命令数 (含正在执行的)
+ * @retval 命令数
+ */
+uint8_t bsp_bluetooth_at_pending(void);
+
+/**
+ * @brief 取消所有未完成的AT命令
+ * @note 被取消的命令不会回调
+ */
+void bsp_bluetooth_at_cancel(void);
+
+/**
+ * @brief 发送AT命令 (阻塞, 收到应答即返回)
  * @param cmd AT命令 (不含"AT+"前缀)
- * @param response 响应缓冲区
+ * @param response 响应缓冲区 (可为NULL)
  * @param resp_size 缓冲区大小
- * @param timeout_ms 超时时间
+ * @param timeout_ms 超时时间 (上限, 收到OK/ERROR后提前返回)
  * @retval 0:成功 -1:超时 -2:错误
+ * @note 不能在AT完成回调中调用
  */
 int bsp_bluetooth_at_cmd(const char *cmd, char *response, uint16_t resp_size, uint32_t timeout_ms);
 
@@ -342,6 +439,54 @@ int bsp_bluetooth_factory_reset(void);
  */
 int bsp_bluetooth_apply_config(const bt_config_t *config);
 
+/**
+ * @brief 异步应用配置 (名称/密码/角色/波特率依次入队)
+ * @param config 配置结构体 (name/pin为空字符串时跳过该项, baudrate为0时不修改)
+ * @param callback 全部完成后回调, 任一条失败则结果为该条的错误
+ * @param arg 回调参数
+ * @retval 0:已入队 -1:队列空间不足
+ */
+int bsp_bluetooth_apply_config_async(const bt_config_t *config,
+                                     bt_at_callback_t callback, void *arg);
+
+/*----------------------- 波特率协商 -----------------------*/
+
+/**
+ * @brief 启动波特率协商
+ * @param callback 完成回调
+ * @retval 0:已启动 -1:不支持/正忙/已连接
+ * @note 过程: 从本地当前波特率开始逐个探测模块 -> 设置为不超过BT_BAUD_MAX的最高波特率
+ *       -> 新波特率下连续BT_BAUD_VERIFY_COUNT次AT回环校验 -> 失败则标记该波特率并回退到次高值;
+ *       成功后调用bsp_bluetooth_baud_store()保存. 需在未连接时调用, 全程异步, 由bsp_bluetooth_process()推进.
+ *       HC-05的AT口波特率固定, 不支持.
+ */
+int bsp_bluetooth_baud_negotiate(bt_baud_callback_t callback);
+
+/**
+ * @brief 波特率协商是否进行中
+ * @retval 1:是 0:否
+ */
+uint8_t bsp_bluetooth_baud_busy(void);
+
+/**
+ * @brief 获取本地串口当前波特率
+ * @retval 波特率
+ */
+uint32_t bsp_bluetooth_get_baudrate(void);
+
+/**
+ * @brief 读取保存的工作波特率 (弱函数, 用户可重写)
+ * @retval 波特率, 0表示无保存值 (使用BT_DEFAULT_BAUD)
+ * @note bsp_bluetooth_init()调用; 不是协商候选值时按无保存值处理
+ */
+uint32_t bsp_bluetooth_baud_load(void);
+
+/**
+ * @brief 保存工作波特率 (弱函数, 用户可重写)
+ * @param baudrate 协商结果
+ */
+void bsp_bluetooth_baud_store(uint32_t baudrate);
+
 /*=============================================================================
  *                              预定义命令码
  *============================================================================*/
@@ -350,6 +495,7 @@ int bsp_bluetooth_apply_config(const bt_config_t *config);
 #define BT_CMD_HEARTBEAT        0x00    /**< 心跳 */
 #define BT_CMD_ACK              0x01    /**< 应答 */
 #define BT_CMD_ERROR            0x02    /**< 错误 */
+#define BT_CMD_SYNC             0x03    /**< 传输层同步 */
 
 /* 数据命令 */
 #define BT_CMD_ADC_DATA         0x10    /**< ADC数据 */
@@ -0,0 +1,292 @@
+/**
+ * @file bsp_capture.c
+ * @brief 输入捕获驱动实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "bsp_capture.h"
+#include "bsp_dma.h"
+#include <stddef.h>
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+static capture_mode_t capture_mode = CAPTURE_MODE_PWM;
+static uint8_t capture_running = 0;
+
+/* 时间戳环形缓冲区 (DMA循环写入) */
+static uint32_t stamp_buf[CAPTURE_BUF_SIZE];
+static uint16_t stamp_read = 0;
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static void capture_gpio_init(void);
+static void capture_tim_base_init(void);
+static void capture_dma_init(void);
+static uint16_t capture_prescaler(uint8_t prescaler);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 按模式配置并启动捕获
+ */
+int bsp_capture_start(capture_mode_t mode, uint8_t prescaler)
+{
+    TIM_ICInitTypeDef TIM_ICInitStructure;
+    uint16_t icpsc = capture_prescaler(prescaler);
+
+    if (mode > CAPTURE_MODE_COUNT || (mode == CAPTURE_MODE_TIMESTAMP && icpsc == 0xFFFF)) {
+        return -1;
+    }
+
+    bsp_capture_stop();
+
+    /* 时间戳DMA流与TIM4的PWM波形/序列共用 */
+    if (mode == CAPTURE_MODE_TIMESTAMP && bsp_dma_claim(CAPTURE_DMA_STREAM, DMA_OWNER_CAPTURE) != 0) {
+        return -1;
+    }
+
+    capture_gpio_init();
+    capture_tim_base_init();
+
+    TIM_ICStructInit(&TIM_ICInitStructure);
+    TIM_ICInitStructure.TIM_ICFilter = CAPTURE_INPUT_FILTER;
+
+    switch (mode) {
+    case CAPTURE_MODE_PWM:
+        /* CH1上升沿捕获周期, CH2 (间接TI1) 下降沿捕获高电平时间, 上升沿复位计数器 */
+        TIM_ICInitStructure.TIM_Channel = TIM_Channel_1;
+        TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;
+        TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+        TIM_PWMIConfig(CAPTURE_TIM, &TIM_ICInitStructure);
+
+        TIM_SelectInputTrigger(CAPTURE_TIM, TIM_TS_TI1FP1);
+        TIM_SelectSlaveMode(CAPTURE_TIM, TIM_SlaveMode_Reset);
+        TIM_SelectMasterSlaveMode(CAPTURE_TIM, TIM_MasterSlaveMode_Enable);
+        break;
+
+    case CAPTURE_MODE_TIMESTAMP:
+        /* CH1只用于设置TI1的输入滤波 */
+        TIM_ICInitStructure.TIM_Channel = TIM_Channel_1;
+        TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;
+        TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+        TIM_ICInit(CAPTURE_TIM, &TIM_ICInitStructure);
+
+        /* CH2间接捕获TI1, 每prescaler个上升沿产生一次DMA请求 */
+        TIM_ICInitStructure.TIM_Channel = TIM_Channel_2;
+        TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_IndirectTI;
+        TIM_ICInitStructure.TIM_ICPrescaler = icpsc;
+        TIM_ICInit(CAPTURE_TIM, &TIM_ICInitStructure);
+
+        capture_dma_init();
+        TIM_DMACmd(CAPTURE_TIM, TIM_DMA_CC2, ENABLE);
+        break;
+
+    case CAPTURE_MODE_COUNT:
+        /* TI1上升沿作为计数时钟 (外部时钟模式1) */
+        TIM_TIxExternalClockConfig(CAPTURE_TIM, TIM_TIxExternalCLK1Source_TI1,
+                                   TIM_ICPolarity_Rising, CAPTURE_INPUT_FILTER);
+        break;
+    }
+
+    capture_mode = mode;
+    capture_running = 1;
+
+    TIM_ClearFlag(CAPTURE_TIM, TIM_FLAG_Update | TIM_FLAG_CC1 | TIM_FLAG_CC2 |
+                               TIM_FLAG_CC1OF | TIM_FLAG_CC2OF);
+    TIM_SetCounter(CAPTURE_TIM, 0);
+    TIM_Cmd(CAPTURE_TIM, ENABLE);
+
+    return 0;
+}
+
+/**
+ * @brief 停止捕获
+ */
+void bsp_capture_stop(void)
+{
+    if (!capture_running) {
+        return;
+    }
+
+    TIM_Cmd(CAPTURE_TIM, DISABLE);
+
+    if (capture_mode == CAPTURE_MODE_TIMESTAMP) {
+        TIM_DMACmd(CAPTURE_TIM, TIM_DMA_CC2, DISABLE);
+        DMA_Cmd(CAPTURE_DMA_STREAM, DISABLE);
+        bsp_dma_release(CAPTURE_DMA_STREAM, DMA_OWNER_CAPTURE);
+    }
+
+    capture_running = 0;
+}
+
+/**
+ * @brief 当前模式
+ */
+capture_mode_t bsp_capture_get_mode(void)
+{
+    return capture_mode;
+}
+
+/**
+ * @brief 读取最近一个完整周期
+ * @note 读CCR1清除CC1IF; CCR2可能已是下一个周期的下降沿, 对稳定信号无影响
+ */
+int bsp_capture_read_pwm(uint32_t *period, uint32_t *high)
+{
+    if (!capture_running || capture_mode != CAPTURE_MODE_PWM ||
+        TIM_GetFlagStatus(CAPTURE_TIM, TIM_FLAG_CC1) == RESET) {
+        return -1;
+    }
+
+    *period = TIM_GetCapture1(CAPTURE_TIM);
+    *high = TIM_GetCapture2(CAPTURE_TIM);
+
+    return 0;
+}
+
+/**
+ * @brief 读取新的时间戳
+ * @note 写位置由NDTR推算, 不需要DMA中断.
+ *       半满/全满标志只在读空时清除: 此后写满一圈必然越过两个边界, 两个标志都置位时
+ *       未读数据可能已被覆盖; 先读标志再读NDTR, 读到的标志一定发生在写位置之前
+ */
+int bsp_capture_read_stamps(uint32_t *stamps, uint16_t max)
+{
+    uint16_t write, count = 0;
+    uint8_t half, full;
+
+    if (!capture_running || capture_mode != CAPTURE_MODE_TIMESTAMP) {
+        return 0;
+    }
+
+    half = (DMA_GetFlagStatus(CAPTURE_DMA_STREAM, CAPTURE_DMA_FLAG_HT) != RESET);
+    full = (DMA_GetFlagStatus(CAPTURE_DMA_STREAM, CAPTURE_DMA_FLAG_TC) != RESET);
+    write = (uint16_t)((CAPTURE_BUF_SIZE - DMA_GetCurrDataCounter(CAPTURE_DMA_STREAM)) % CAPTURE_BUF_SIZE);
+
+    if (half && full) {
+        /* 丢弃全部未读数据, 从当前写位置重新开始 */
+        stamp_read = write;
+        DMA_ClearFlag(CAPTURE_DMA_STREAM, CAPTURE_DMA_FLAG_HT | CAPTURE_DMA_FLAG_TC);
+        return -1;
+    }
+
+    while (stamp_read != write && count < max) {
+        stamps[count++] = stamp_buf[stamp_read];
+        stamp_read = (uint16_t)((stamp_read + 1) % CAPTURE_BUF_SIZE);
+    }
+
+    if (stamp_read == write) {
+        DMA_ClearFlag(CAPTURE_DMA_STREAM, CAPTURE_DMA_FLAG_HT | CAPTURE_DMA_FLAG_TC);
+    }
+
+    return count;
+}
+
+/**
+ * @brief 当前脉冲计数
+ */
+uint32_t bsp_capture_get_count(void)
+{
+    if (!capture_running || capture_mode != CAPTURE_MODE_COUNT) {
+        return 0;
+    }
+
+    return TIM_GetCounter(CAPTURE_TIM);
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 输入引脚复用为TIM2_CH1, 下拉 (悬空时不产生边沿)
+ */
+static void capture_gpio_init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(CAPTURE_GPIO_CLK, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin = CAPTURE_GPIO_PIN;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;
+    GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_DOWN;
+    GPIO_Init(CAPTURE_GPIO_PORT, &GPIO_InitStructure);
+
+    GPIO_PinAFConfig(CAPTURE_GPIO_PORT, CAPTURE_GPIO_PINSOURCE, CAPTURE_GPIO_AF);
+}
+
+/**
+ * @brief 定时器复位为默认状态, 不分频, 32位满量程计数
+ */
+static void capture_tim_base_init(void)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+
+    RCC_APB1PeriphClockCmd(CAPTURE_TIM_CLK, ENABLE);
+    TIM_DeInit(CAPTURE_TIM);
+
+    TIM_TimeBaseStructure.TIM_Prescaler = 0;
+    TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFF;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(CAPTURE_TIM, &TIM_TimeBaseStructure);
+}
+
+/**
+ * @brief 时间戳DMA: CCR2 -> stamp_buf, 循环模式
+ */
+static void capture_dma_init(void)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(CAPTURE_DMA_CLK, ENABLE);
+
+    DMA_Cmd(CAPTURE_DMA_STREAM, DISABLE);
+    DMA_DeInit(CAPTURE_DMA_STREAM);
+
+    DMA_InitStructure.DMA_Channel = CAPTURE_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&CAPTURE_TIM->CCR2;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)stamp_buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = CAPTURE_BUF_SIZE;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(CAPTURE_DMA_STREAM, &DMA_InitStructure);
+
+    stamp_read = 0;
+    DMA_ClearFlag(CAPTURE_DMA_STREAM, CAPTURE_DMA_FLAG_HT | CAPTURE_DMA_FLAG_TC);
+    DMA_Cmd(CAPTURE_DMA_STREAM, ENABLE);
+}
+
+/**
+ * @brief 边沿预分频换算为TIM_ICPSC_DIVx, 无效时返回0xFFFF
+ */
+static uint16_t capture_prescaler(uint8_t prescaler)
+{
+    switch (prescaler) {
+    case 1: return TIM_ICPSC_DIV1;
+    case 2: return TIM_ICPSC_DIV2;
+    case 4: return TIM_ICPSC_DIV4;
+    case 8: return TIM_ICPSC_DIV8;
+    default: return 0xFFFF;
+    }
+}
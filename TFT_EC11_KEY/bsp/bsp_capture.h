@@ -0,0 +1,130 @@
+/**
+ * @file bsp_capture.h
+ * @brief 输入捕获驱动 - 数字信号的周期、占空比和脉冲计数
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 硬件平台: STM32F407VGT6
+ * @note 功能特性:
+ *       - 32位TIM2以84MHz计数, 分辨率约11.9ns, 最长约51秒一个周期
+ *       - PWM输入模式: 上升沿捕获周期并复位计数器, 下降沿捕获高电平时间, 硬件完成无中断
+ *       - 时间戳模式: 每个 (或每N个) 上升沿的计数值由DMA写入循环缓冲区,
+ *         配合 middleware/freq_meter 做倒数法测频, 分辨率与信号频率无关
+ *       - 计数模式: 输入作为外部时钟, 计数器累计脉冲数, 闸门时间由调用者控制
+ *       - 三种模式都无中断, 数据在任务中读取
+ *
+ * @note 资源占用: TIM2 (与 bsp_pwm 的TIM2通道互斥),
+ *       PA15 (TIM2_CH1), DMA1_Stream6 CH3 (TIM2_CH2, 与TIM4的PWM波形/序列互斥, 由 bsp_dma 登记检查)
+ *       TIM2_CH1的DMA请求在DMA1_Stream5上, 被UART2接收占用, 因此时间戳由IC2间接捕获TI1
+ * @note PA15复位后为JTAG的JTDI, 启动捕获后只能用SWD调试
+ */
+
+#ifndef __BSP_CAPTURE_H
+#define __BSP_CAPTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx.h"
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 输入引脚 */
+#define CAPTURE_GPIO_PORT           GPIOA
+#define CAPTURE_GPIO_PIN            GPIO_Pin_15
+#define CAPTURE_GPIO_PINSOURCE      GPIO_PinSource15
+#define CAPTURE_GPIO_AF             GPIO_AF_TIM2
+#define CAPTURE_GPIO_CLK            RCC_AHB1Periph_GPIOA
+
+/* 定时器 (32位) */
+#define CAPTURE_TIM                 TIM2
+#define CAPTURE_TIM_CLK             RCC_APB1Periph_TIM2
+
+/* 计数时钟 (APB1定时器时钟, 不分频) */
+#define CAPTURE_CLOCK_HZ            84000000
+
+/* 输入滤波 (0~15), 4: fCK_INT/N=8, 连续8个采样一致, 约95ns */
+#define CAPTURE_INPUT_FILTER        4
+
+/* 时间戳DMA */
+#define CAPTURE_DMA_STREAM          DMA1_Stream6    /* TIM2_CH2 */
+#define CAPTURE_DMA_CHANNEL         DMA_Channel_3
+#define CAPTURE_DMA_CLK             RCC_AHB1Periph_DMA1
+#define CAPTURE_DMA_FLAG_HT         DMA_FLAG_HTIF6
+#define CAPTURE_DMA_FLAG_TC         DMA_FLAG_TCIF6
+
+/**
+ * @brief 时间戳缓冲区大小 (个)
+ * @note 两次读空之间的时间戳数应少于一半, 否则按覆盖处理 (见 bsp_capture_read_stamps)
+ */
+#define CAPTURE_BUF_SIZE            256
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 捕获模式
+ */
+typedef enum {
+    CAPTURE_MODE_PWM = 0,       /**< PWM输入: 周期和高电平时间 */
+    CAPTURE_MODE_TIMESTAMP,     /**< 上升沿时间戳 (DMA) */
+    CAPTURE_MODE_COUNT          /**< 脉冲计数 */
+} capture_mode_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 按模式配置并启动捕获
+ * @param mode 捕获模式
+ * @param prescaler 时间戳模式下每几个上升沿记录一次 (1/2/4/8), 高频信号用大值减少DMA传输; 其他模式忽略
+ * @retval 0:成功 -1:参数无效, 或时间戳DMA流正被TIM4的PWM波形/序列占用
+ */
+int bsp_capture_start(capture_mode_t mode, uint8_t prescaler);
+
+/**
+ * @brief 停止捕获
+ */
+void bsp_capture_stop(void);
+
+/**
+ * @brief 当前模式
+ * @retval 捕获模式
+ */
+capture_mode_t bsp_capture_get_mode(void);
+
+/**
+ * @brief 读取最近一个完整周期 (PWM输入模式)
+ * @param period 周期 (计数时钟数)
+ * @param high 高电平时间 (计数时钟数)
+ * @retval 0:成功 -1:上次读取后没有新的上升沿
+ */
+int bsp_capture_read_pwm(uint32_t *period, uint32_t *high);
+
+/**
+ * @brief 读取新的时间戳 (时间戳模式)
+ * @param stamps 输出缓冲区, 每个为上升沿时的计数值 (32位回绕)
+ * @param max 最多读取个数
+ * @retval 读取个数, -1:未读数据可能已被DMA覆盖, 已全部丢弃 (调用者应丢弃测量窗口)
+ * @note 用DMA半满/全满标志检测覆盖 (不开中断): 上次读空后两个标志都置位即视为覆盖,
+ *       因此读空的间隔应少于 CAPTURE_BUF_SIZE/2 个时间戳
+ */
+int bsp_capture_read_stamps(uint32_t *stamps, uint16_t max);
+
+/**
+ * @brief 当前脉冲计数 (计数模式, 32位回绕, 求差值用无符号减法)
+ * @retval 计数值
+ */
+uint32_t bsp_capture_get_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_CAPTURE_H */
@@ -0,0 +1,112 @@
+/**
+ * @file bsp_dma.c
+ * @brief DMA流占用登记实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "bsp_dma.h"
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define DMA_STREAM_COUNT        16      /* DMA1 8个 + DMA2 8个 */
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+static uint8_t dma_owner[DMA_STREAM_COUNT];
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static int stream_index(const DMA_Stream_TypeDef *stream);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 申请DMA流
+ */
+int bsp_dma_claim(DMA_Stream_TypeDef *stream, dma_owner_t owner)
+{
+    int index = stream_index(stream);
+    uint32_t primask;
+    int ret = -1;
+
+    if (index < 0 || owner == DMA_OWNER_NONE) {
+        return -1;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (dma_owner[index] == DMA_OWNER_NONE || dma_owner[index] == owner) {
+        dma_owner[index] = (uint8_t)owner;
+        ret = 0;
+    }
+
+    __set_PRIMASK(primask);
+
+    return ret;
+}
+
+/**
+ * @brief 释放DMA流
+ */
+void bsp_dma_release(DMA_Stream_TypeDef *stream, dma_owner_t owner)
+{
+    int index = stream_index(stream);
+    uint32_t primask;
+
+    if (index < 0) {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (dma_owner[index] == owner) {
+        dma_owner[index] = DMA_OWNER_NONE;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 查询DMA流的占用者
+ */
+dma_owner_t bsp_dma_owner(DMA_Stream_TypeDef *stream)
+{
+    int index = stream_index(stream);
+
+    return (index < 0) ? DMA_OWNER_NONE : (dma_owner_t)dma_owner[index];
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief DMA流在登记表中的下标
+ * @note 同一控制器的8个流寄存器组等间距排列
+ */
+static int stream_index(const DMA_Stream_TypeDef *stream)
+{
+    uint32_t addr = (uint32_t)stream;
+    uint32_t stride = (uint32_t)DMA1_Stream1 - (uint32_t)DMA1_Stream0;
+
+    if (addr >= (uint32_t)DMA1_Stream0 && addr <= (uint32_t)DMA1_Stream7) {
+        return (int)((addr - (uint32_t)DMA1_Stream0) / stride);
+    }
+    if (addr >= (uint32_t)DMA2_Stream0 && addr <= (uint32_t)DMA2_Stream7) {
+        return (int)((addr - (uint32_t)DMA2_Stream0) / stride) + 8;
+    }
+
+    return -1;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file bsp_dma.h
+ * @brief DMA流占用登记 - 多个驱动共用同一DMA流时的运行时互斥
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 硬件平台: STM32F407VGT6
+ * @note 功能特性:
+ *       - 每个DMA流 (DMA1/DMA2各8个) 记录一个占用者
+ *       - 驱动启动DMA前申请, 停止后释放; 流已被其他驱动占用时申请失败
+ *       - 同一占用者重复申请视为成功, 可直接用于重启
+ * @note 当前登记的共用流: DMA1_Stream6 (输入捕获时间戳 / TIM4 PWM波形和序列)
+ */
+
+#ifndef __BSP_DMA_H
+#define __BSP_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx.h"
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief DMA流占用者
+ */
+typedef enum {
+    DMA_OWNER_NONE = 0,
+    DMA_OWNER_PWM,              /**< bsp_pwm 波形/序列 */
+    DMA_OWNER_CAPTURE           /**< bsp_capture 时间戳 */
+} dma_owner_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 申请DMA流
+ * @param stream DMA流 (如 DMA1_Stream6)
+ * @param owner 占用者
+ * @retval 0:成功 (空闲或已由owner占用) -1:被其他驱动占用或参数无效
+ */
+int bsp_dma_claim(DMA_Stream_TypeDef *stream, dma_owner_t owner);
+
+/**
+ * @brief 释放DMA流
+ * @param stream DMA流
+ * @param owner 占用者, 不是当前占用者时不做任何事
+ */
+void bsp_dma_release(DMA_Stream_TypeDef *stream, dma_owner_t owner);
+
+/**
+ * @brief 查询DMA流的占用者
+ * @param stream DMA流
+ * @retval 占用者, 空闲为 DMA_OWNER_NONE
+ */
+dma_owner_t bsp_dma_owner(DMA_Stream_TypeDef *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_DMA_H */
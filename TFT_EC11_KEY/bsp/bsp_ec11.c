@@ -14,10 +14,42 @@
 #include "stm32f4xx_syscfg.h"
 #include "misc.h"
 
+/* Private defines -----------------------------------------------------------*/
+/* 定位点: 4变化/格时只有A=B=1, 2变化/格时A=B的两个状态都是 */
+#if EC11_STEPS_PER_DETENT == 4
+#define EC11_IS_DETENT(ab)      ((ab) == 0x3)
+#else
+#define EC11_IS_DETENT(ab)      (((ab) == 0x0) || ((ab) == 0x3))
+#endif
+
 /* Private variables ---------------------------------------------------------*/
 static ec11_state_t ec11_state = {0};
 static ec11_event_callback_t event_callback = NULL;
-static volatile uint32_t last_exti_time = 0;  /* 用于消抖 */
+static uint8_t ec11_ab_state = 0;  /* 上一次的 (A<<1)|B */
+
+/*
+ * 格雷码状态转移表, 下标为 (上次AB<<2)|本次AB
+ * 右旋序列 11->01->00->10->11 记+1, 反向记-1;
+ * 状态未变或两相同时变化 (丢失中间状态) 记0
+ */
+static const int8_t ec11_transition_table[16] = {
+     0, -1,  1,  0,
+     1,  0,  0, -1,
+    -1,  0,  0,  1,
+     0,  1, -1,  0
+};
+
+/* 加速曲线: 速度(格/秒)达到门限时每格的步数, 按门限升序 */
+static const struct {
+    uint16_t velocity;
+    uint16_t steps;
+} ec11_accel_curve[] = {
+    {  0,  1 },
+    {  8,  2 },
+    { 15,  5 },
+    { 25, 10 },
+    { 40, 25 }
+};
 
 /* 弱定义系统时间戳函数，用户需要在外部重新实现 ------------------------------*/
 __weak uint32_t bsp_ec11_get_tick(void)
@@ -34,6 +66,7 @@ static void ec11_nvic_config(void);
 static uint8_t ec11_read_pin_a(void);
 static uint8_t ec11_read_pin_b(void);
 static uint8_t ec11_read_pin_key(void);
+static void ec11_detent(int8_t dir, uint32_t now);
 
 /**
   * @brief  EC11编码器初始化
@@ -57,6 +90,11 @@ void bsp_ec11_init(void)
     ec11_state.key_press_time = 0;
     ec11_state.last_a_state = ec11_read_pin_a();
     ec11_state.last_b_state = ec11_read_pin_b();
+    ec11_state.sub_steps = 0;
+    ec11_state.last_dir = 0;
+    ec11_state.interval_avg = 0;
+    ec11_state.accel_steps = 0;
+    ec11_ab_state = (uint8_t)((ec11_state.last_a_state << 1) | ec11_state.last_b_state);
 }
 
 /**
@@ -98,17 +136,19 @@ static void ec11_exti_config(void)
 
     /* 连接EXTI线到GPIO引脚 */
     SYSCFG_EXTILineConfig(EC11_A_EXTI_PORT_SOURCE, EC11_A_EXTI_PIN_SOURCE);
+    SYSCFG_EXTILineConfig(EC11_B_EXTI_PORT_SOURCE, EC11_B_EXTI_PIN_SOURCE);
     SYSCFG_EXTILineConfig(EC11_KEY_EXTI_PORT_SOURCE, EC11_KEY_EXTI_PIN_SOURCE);
 
-    /* 配置EXTI线 - EC11 A相 (下降沿触发) */
-    EXTI_InitStructure.EXTI_Line = EC11_A_EXTI_LINE;
+    /* 配置EXTI线 - EC11 A/B相 (双边沿触发, 每次状态变化都解码) */
+    EXTI_InitStructure.EXTI_Line = EC11_A_EXTI_LINE | EC11_B_EXTI_LINE;
     EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
-    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising_Falling;
     EXTI_InitStructure.EXTI_LineCmd = ENABLE;
     EXTI_Init(&EXTI_InitStructure);
 
     /* 配置EXTI线 - EC11按键 (下降沿触发) */
     EXTI_InitStructure.EXTI_Line = EC11_KEY_EXTI_LINE;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
     EXTI_Init(&EXTI_InitStructure);
 }
 
@@ -131,6 +171,10 @@ static void ec11_nvic_config(void)
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
 
+    /* 配置EXTI1中断 - EC11 B相 (与A相同一抢占优先级, 解码不会被打断) */
+    NVIC_InitStructure.NVIC_IRQChannel = EC11_B_EXTI_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
     /* 配置EXTI2中断 - EC11按键 */
     NVIC_InitStructure.NVIC_IRQChannel = EC11_KEY_EXTI_IRQn;
     NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
@@ -215,47 +259,131 @@ ec11_event_t bsp_ec11_scan(void)
 }
 
 /**
-  * @brief  EXTI中断回调函数
+  * @brief  EXTI中断回调函数 (A/B相任一边沿)
   * @param  exti_line: 中断线
   * @retval None
+  * @note   每次读取两相电平查状态表; 抖动只会在相邻状态间来回,
+  *         正负抵消, 回到定位点时累计值不足半格即丢弃
   */
 void bsp_ec11_exti_callback(uint32_t exti_line)
 {
-    uint32_t current_time = bsp_ec11_get_tick();
-    ec11_event_t event = EC11_EVENT_NONE;
+    uint8_t a_state;
+    uint8_t b_state;
+    uint8_t ab;
 
-    /* 软件消抖 */
-    if ((current_time - last_exti_time) < EC11_DEBOUNCE_TIME_MS) {
+    if (exti_line != EC11_A_EXTI_LINE && exti_line != EC11_B_EXTI_LINE) {
         return;
     }
-    last_exti_time = current_time;
-
-    /* EC11 A相中断 - 检测旋转方向 */
-    if (exti_line == EC11_A_EXTI_LINE) {
-        uint8_t a_state = ec11_read_pin_a();
-        uint8_t b_state = ec11_read_pin_b();
-
-        /* EC11编码器正交解码 */
-        if (a_state == 0) {  /* A相下降沿 */
-            if (b_state == 1) {
-                /* 顺时针旋转 (右旋) */
-                ec11_state.count++;
-                event = EC11_EVENT_ROTATE_RIGHT;
-            } else {
-                /* 逆时针旋转 (左旋) */
-                ec11_state.count--;
-                event = EC11_EVENT_ROTATE_LEFT;
-            }
+
+    a_state = ec11_read_pin_a();
+    b_state = ec11_read_pin_b();
+    ab = (uint8_t)((a_state << 1) | b_state);
+
+    ec11_state.sub_steps += ec11_transition_table[(ec11_ab_state << 2) | ab];
+    ec11_ab_state = ab;
+    ec11_state.last_a_state = a_state;
+    ec11_state.last_b_state = b_state;
+
+    if (!EC11_IS_DETENT(ab)) {
+        return;
+    }
+
+    /* 到达定位点: 累计超过半格才算转过一格 */
+    if (ec11_state.sub_steps >= EC11_STEPS_PER_DETENT / 2) {
+        ec11_detent(1, bsp_ec11_get_tick());
+    } else if (ec11_state.sub_steps <= -(EC11_STEPS_PER_DETENT / 2)) {
+        ec11_detent(-1, bsp_ec11_get_tick());
+    }
+    ec11_state.sub_steps = 0;
+}
+
+/**
+  * @brief  转过一格: 更新计数和速度, 触发回调
+  * @param  dir: 1-右旋, -1-左旋
+  * @param  now: 当前时间(ms)
+  * @retval None
+  */
+static void ec11_detent(int8_t dir, uint32_t now)
+{
+    uint32_t interval = now - ec11_state.last_detent_time;
+
+    /* 速度估计: 格间隔做 3/4 指数平滑; 换向或停顿后重新开始 */
+    if (dir != ec11_state.last_dir || interval > EC11_VELOCITY_TIMEOUT_MS) {
+        ec11_state.interval_avg = 0;
+    } else {
+        if (interval == 0) {
+            interval = 1;
+        }
+        if (ec11_state.interval_avg == 0) {
+            ec11_state.interval_avg = (uint16_t)(interval * 4);
+        } else {
+            ec11_state.interval_avg = (uint16_t)((ec11_state.interval_avg * 3 + interval * 4) / 4);
         }
+    }
+    ec11_state.last_dir = dir;
+    ec11_state.last_detent_time = now;
 
-        ec11_state.last_a_state = a_state;
-        ec11_state.last_b_state = b_state;
+    ec11_state.count += dir;
+    ec11_state.accel_steps += dir * (int32_t)bsp_ec11_get_accel();
+
+    if (event_callback != NULL) {
+        event_callback((dir > 0) ? EC11_EVENT_ROTATE_RIGHT : EC11_EVENT_ROTATE_LEFT);
     }
+}
 
-    /* 触发回调 */
-    if (event != EC11_EVENT_NONE && event_callback != NULL) {
-        event_callback(event);
+/**
+  * @brief  获取当前旋转速度
+  * @param  None
+  * @retval 每秒格数
+  */
+uint16_t bsp_ec11_get_velocity(void)
+{
+    uint16_t avg = ec11_state.interval_avg;
+
+    if (avg == 0 ||
+        (bsp_ec11_get_tick() - ec11_state.last_detent_time) > EC11_VELOCITY_TIMEOUT_MS) {
+        return 0;
+    }
+
+    return (uint16_t)(4000U / avg);
+}
+
+/**
+  * @brief  获取当前速度对应的每格步数
+  * @param  None
+  * @retval 步数 (>=1)
+  */
+uint16_t bsp_ec11_get_accel(void)
+{
+#if EC11_ACCEL_ENABLE
+    uint16_t velocity = bsp_ec11_get_velocity();
+    uint8_t i = sizeof(ec11_accel_curve) / sizeof(ec11_accel_curve[0]);
+
+    while (--i > 0 && velocity < ec11_accel_curve[i].velocity) {
     }
+
+    return ec11_accel_curve[i].steps;
+#else
+    return 1;
+#endif
+}
+
+/**
+  * @brief  取走加速后的累计步数
+  * @param  None
+  * @retval 步数 (右旋为正)
+  */
+int32_t bsp_ec11_take_steps(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    int32_t steps;
+
+    __disable_irq();
+    steps = ec11_state.accel_steps;
+    ec11_state.accel_steps = 0;
+    __set_PRIMASK(primask);
+
+    return steps;
 }
 
 /**
@@ -306,8 +434,23 @@ void bsp_ec11_register_callback(ec11_event_callback_t callback)
 void EXTI0_IRQHandler(void)
 {
     if (EXTI_GetITStatus(EC11_A_EXTI_LINE) != RESET) {
-        bsp_ec11_exti_callback(EC11_A_EXTI_LINE);
+        /* 先清标志再读引脚, 读取期间的新边沿会再次进入中断 */
         EXTI_ClearITPendingBit(EC11_A_EXTI_LINE);
+        bsp_ec11_exti_callback(EC11_A_EXTI_LINE);
+    }
+}
+
+/**
+  * @brief  EXTI1中断服务函数 (EC11 B相)
+  * @param  None
+  * @retval None
+  */
+void EXTI1_IRQHandler(void)
+{
+    if (EXTI_GetITStatus(EC11_B_EXTI_LINE) != RESET) {
+        /* 先清标志再读引脚, 读取期间的新边沿会再次进入中断 */
+        EXTI_ClearITPendingBit(EC11_B_EXTI_LINE);
+        bsp_ec11_exti_callback(EC11_B_EXTI_LINE);
     }
 }
 
@@ -9,15 +9,15 @@
   * @attention
   *
   * 本驱动提供EC11旋转编码器的完整功能:
-  * - 左旋/右旋检测
+  * - 左旋/右旋检测 (A/B两相双边沿中断, 格雷码状态表解码)
+  * - 旋转速度估计与加速曲线 (快速旋转时一格对应多步)
   * - 按键检测(短按/长按)
-  * - 硬件消抖
   * - 事件回调机制
   *
   * 移植说明:
   * 1. 根据使用的库修改 BSP_EC11_USE_HAL 宏定义
   * 2. 修改引脚定义 (EC11_A_PIN, EC11_B_PIN, EC11_KEY_PIN)
-  * 3. 在中断服务函数中调用 bsp_ec11_exti_callback()
+  * 3. 在中断服务函数中调用 bsp_ec11_exti_callback() (A、B相两条中断线)
   * 4. 在主循环或定时器中调用 bsp_ec11_scan()
   *
   ******************************************************************************
@@ -55,6 +55,10 @@ extern "C" {
 #define EC11_B_GPIO_PORT        GPIOA
 #define EC11_B_GPIO_PIN         GPIO_Pin_1
 #define EC11_B_GPIO_CLK         RCC_AHB1Periph_GPIOA
+#define EC11_B_EXTI_LINE        EXTI_Line1
+#define EC11_B_EXTI_PORT_SOURCE EXTI_PortSourceGPIOA
+#define EC11_B_EXTI_PIN_SOURCE  EXTI_PinSource1
+#define EC11_B_EXTI_IRQn        EXTI1_IRQn
 
 #define EC11_KEY_GPIO_PORT      GPIOA
 #define EC11_KEY_GPIO_PIN       GPIO_Pin_2
@@ -64,10 +68,22 @@ extern "C" {
 #define EC11_KEY_EXTI_PIN_SOURCE  EXTI_PinSource2
 #define EC11_KEY_EXTI_IRQn      EXTI2_IRQn
 
-/* 消抖和长按时间配置 --------------------------------------------------------*/
-#define EC11_DEBOUNCE_TIME_MS   20    /* 消抖时间(毫秒) */
+/* 长按时间配置 --------------------------------------------------------------*/
 #define EC11_LONG_PRESS_TIME_MS 1000  /* 长按判定时间(毫秒) */
 
+/* 正交解码配置 --------------------------------------------------------------*/
+/*
+ * 每个定位格经过的格雷码状态变化数:
+ * 4 - 一格一个完整周期 (20格/20脉冲, 定位点A=B=1)
+ * 2 - 一格半个周期 (30格/15脉冲, 定位点A=B)
+ * 抖动产生的来回跳变在状态表中相互抵消, 不需要时间消抖
+ */
+#define EC11_STEPS_PER_DETENT   4
+
+/* 速度估计与加速配置 --------------------------------------------------------*/
+#define EC11_VELOCITY_TIMEOUT_MS 150  /* 两格间隔超过该值视为重新起转, 速度清零 */
+#define EC11_ACCEL_ENABLE       1     /* 0: 关闭加速, 每格固定1步 */
+
 /* EC11事件类型定义 ----------------------------------------------------------*/
 typedef enum {
     EC11_EVENT_NONE = 0,        /* 无事件 */
@@ -85,6 +101,11 @@ typedef struct {
     uint32_t key_press_time;     /* 按键按下时间戳(ms) */
     uint8_t  last_a_state;       /* 上一次A相状态 */
     uint8_t  last_b_state;       /* 上一次B相状态 */
+    int8_t   sub_steps;          /* 当前格内累计的状态变化 (带方向) */
+    int8_t   last_dir;           /* 上一格方向: 1-右旋, -1-左旋, 0-静止 */
+    uint32_t last_detent_time;   /* 上一格时间戳(ms) */
+    uint16_t interval_avg;       /* 平滑后的格间隔 (ms*4, 0表示无速度) */
+    int32_t  accel_steps;        /* 加速后累计步数, 由 bsp_ec11_take_steps() 取走 */
 } ec11_state_t;
 
 /* 事件回调函数类型 ----------------------------------------------------------*/
@@ -120,6 +141,29 @@ int32_t bsp_ec11_get_count(void);
  */
 void bsp_ec11_set_count(int32_t count);
 
+/**
+ * @brief  获取当前旋转速度
+ * @param  None
+ * @retval 每秒格数 (停转超过 EC11_VELOCITY_TIMEOUT_MS 后为0)
+ */
+uint16_t bsp_ec11_get_velocity(void);
+
+/**
+ * @brief  获取当前速度对应的每格步数 (加速曲线)
+ * @param  None
+ * @retval 步数 (>=1)
+ * @note   在旋转事件回调中调用, 得到这一格应调整的步数
+ */
+uint16_t bsp_ec11_get_accel(void);
+
+/**
+ * @brief  取走自上次调用以来加速后的累计步数
+ * @param  None
+ * @retval 步数 (右旋为正, 左旋为负)
+ * @note   供轮询使用, 与事件回调二选一
+ */
+int32_t bsp_ec11_take_steps(void);
+
 /**
  * @brief  获取EC11按键状态
  * @param  None
@@ -11,12 +11,23 @@
 #include "stm32f4xx_gpio.h"
 #include "stm32f4xx_rcc.h"
 
+#if KEY_NUM_MAX > 32
+#error "KEY_NUM_MAX must not exceed 32"
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+#define KEY_PORT_MAX            9     /* GPIOA ~ GPIOI */
+
+/* 单键标志 */
+#define KEY_FLAG_LONG           0x01  /* 本次按下已上报长按 */
+
 /* Private typedef -----------------------------------------------------------*/
 typedef struct {
-    uint8_t  current_state;   /* 当前状态: 0-释放, 1-按下 */
-    uint8_t  last_state;      /* 上次状态 */
     uint32_t press_time;      /* 按下时间戳(ms) */
-    uint8_t  long_press_flag; /* 长按标志 */
+    uint32_t release_time;    /* 释放时间戳(ms), 双击判定用 */
+    uint32_t next_repeat;     /* 下次连发时间(ms) */
+    uint16_t repeat_interval; /* 当前连发间隔(ms) */
+    uint8_t  flags;           /* KEY_FLAG_x */
 } key_state_t;
 
 /* Private variables ---------------------------------------------------------*/
@@ -25,32 +36,180 @@ static key_state_t  key_states[KEY_NUM_MAX];
 static uint8_t      key_num = 0;
 static key_event_callback_t event_callback = NULL;
 
+/* 按端口分组读取: 每个端口每次扫描只读一次IDR */
+static GPIO_TypeDef *key_ports[KEY_PORT_MAX];
+static uint8_t       key_port_num = 0;
+static uint8_t       key_port_index[KEY_NUM_MAX];
+static uint32_t      key_active_high = 0;   /* 高电平有效的按键 */
+
+/* 垂直计数器: cnt1:cnt0 组成每个按键一个2位计数器 */
+static uint32_t key_debounced = 0;          /* 消抖后的状态, 1为按下 */
+static uint32_t key_cnt0 = 0xFFFFFFFF;
+static uint32_t key_cnt1 = 0xFFFFFFFF;
+
+/* 手势 */
+static uint32_t key_double_click_mask = 0;
+static uint32_t key_repeat_mask = 0;
+static uint32_t key_pending_mask = 0;       /* 单击待定的按键 */
+static uint32_t key_chord_keys = 0;         /* 组合窗口内按下的按键 */
+static uint32_t key_chord_start = 0;
+static uint8_t  key_chord_open = 0;
+static uint32_t key_chorded = 0;            /* 属于组合键、尚未释放的按键 */
+static uint32_t key_chord_last = 0;         /* 最近一次组合键 */
+
 /* 外部时间戳函数(需要用户实现) */
 extern uint32_t bsp_ec11_get_tick(void);  /* 复用EC11的时间戳函数 */
 
 /* Private functions ---------------------------------------------------------*/
 
 /**
- * @brief  读取按键引脚状态
+ * @brief  上报事件
  * @param  key_id: 按键ID
- * @retval 按键状态: 0-未按下, 1-按下
+ * @param  event: 事件
+ * @retval None
  */
-static uint8_t key_read_pin(key_id_t key_id)
+static void key_emit(uint8_t key_id, key_event_t event)
 {
-    uint8_t pin_state;
+    if (event_callback != NULL) {
+        event_callback((key_id_t)key_id, event);
+    }
+}
 
-    if (key_id >= key_num) {
-        return 0;
+/**
+ * @brief  读取所有按键的原始状态
+ * @param  None
+ * @retval 位掩码, 1为按下 (未消抖)
+ */
+static uint32_t key_read_raw(void)
+{
+    uint16_t idr[KEY_PORT_MAX];
+    uint32_t level = 0;
+    uint8_t i;
+
+    for (i = 0; i < key_port_num; i++) {
+        idr[i] = GPIO_ReadInputData(key_ports[i]);
+    }
+
+    for (i = 0; i < key_num; i++) {
+        if (idr[key_port_index[i]] & key_configs[i].gpio_pin) {
+            level |= 1UL << i;
+        }
+    }
+
+    /* 低电平有效的按键取反 */
+    return ~(level ^ key_active_high) & ((key_num < 32) ? ((1UL << key_num) - 1) : 0xFFFFFFFF);
+}
+
+/**
+ * @brief  取最低位的按键ID
+ * @param  mask: 非0掩码
+ * @retval 按键ID
+ */
+static uint8_t key_lowest(uint32_t mask)
+{
+    return (uint8_t)__CLZ(__RBIT(mask));
+}
+
+/**
+ * @brief  组合键判定: 窗口结束或有按键释放时, 窗口内按下了两个以上按键即为组合键
+ * @param  released: 本次释放的按键
+ * @param  now: 当前时间
+ * @retval None
+ */
+static void key_chord_check(uint32_t released, uint32_t now)
+{
+    uint32_t keys = key_chord_keys;
+
+    if (!key_chord_open) {
+        return;
+    }
+
+    if ((now - key_chord_start) < KEY_CHORD_TIME_MS && (released & keys) == 0) {
+        return;
+    }
+
+    key_chord_open = 0;
+
+    if (keys & (keys - 1)) {
+        key_chorded = keys;
+        key_chord_last = keys;
+        key_pending_mask &= ~keys;
+        key_emit(key_lowest(keys), KEY_EVENT_CHORD);
+    }
+}
+
+/**
+ * @brief  单个按键的手势处理
+ * @param  i: 按键ID
+ * @param  bit: 按键位
+ * @param  pressed/released: 本次按下/释放的按键
+ * @param  now: 当前时间
+ * @retval None
+ */
+static void key_gesture(uint8_t i, uint32_t bit, uint32_t pressed, uint32_t released, uint32_t now)
+{
+    key_state_t *ks = &key_states[i];
+
+    /* 双击窗口已过: 补报单击 */
+    if ((key_pending_mask & bit) && (now - ks->release_time) > KEY_DOUBLE_CLICK_TIME_MS) {
+        key_pending_mask &= ~bit;
+        key_emit(i, KEY_EVENT_SHORT_PRESS);
+    }
+
+    if (pressed & bit) {
+        ks->press_time = now;
+        ks->flags &= (uint8_t)~KEY_FLAG_LONG;
+        return;
+    }
+
+    if (released & bit) {
+        if (key_chorded & bit) {
+            key_chorded &= ~bit;
+        } else if (ks->flags & KEY_FLAG_LONG) {
+            /* 长按之后释放, 不再上报短按 */
+        } else if (key_double_click_mask & bit) {
+            if (key_pending_mask & bit) {
+                key_pending_mask &= ~bit;
+                key_emit(i, KEY_EVENT_DOUBLE_CLICK);
+            } else {
+                key_pending_mask |= bit;    /* 单击待定, 等待双击窗口结束 */
+                ks->release_time = now;
+            }
+        } else {
+            key_emit(i, KEY_EVENT_SHORT_PRESS);
+        }
+        key_emit(i, KEY_EVENT_RELEASE);
+        return;
     }
 
-    pin_state = GPIO_ReadInputDataBit(key_configs[key_id].gpio_port,
-                                      key_configs[key_id].gpio_pin);
+    if ((key_debounced & bit) == 0) {
+        return;
+    }
+
+    /* 保持按下 */
+    if ((key_chorded & bit) || (key_chord_open && (key_chord_keys & bit))) {
+        return;
+    }
 
-    /* 根据有效电平返回逻辑状态 */
-    if (key_configs[key_id].active_level == 0) {
-        return (pin_state == 0) ? 1 : 0;  /* 低电平有效 */
-    } else {
-        return (pin_state == 1) ? 1 : 0;  /* 高电平有效 */
+    if (!(ks->flags & KEY_FLAG_LONG)) {
+        if ((now - ks->press_time) >= KEY_LONG_PRESS_TIME_MS) {
+            ks->flags |= KEY_FLAG_LONG;
+            if (key_pending_mask & bit) {
+                /* 第二次按下变成长按: 先补报第一次单击 */
+                key_pending_mask &= ~bit;
+                key_emit(i, KEY_EVENT_SHORT_PRESS);
+            }
+            key_emit(i, KEY_EVENT_LONG_PRESS);
+            ks->repeat_interval = KEY_REPEAT_START_MS;
+            ks->next_repeat = now + KEY_REPEAT_START_MS;
+        }
+    } else if ((key_repeat_mask & bit) && (int32_t)(now - ks->next_repeat) >= 0) {
+        key_emit(i, KEY_EVENT_REPEAT);
+        ks->repeat_interval = (uint16_t)(ks->repeat_interval * 3 / 4);
+        if (ks->repeat_interval < KEY_REPEAT_MIN_MS) {
+            ks->repeat_interval = KEY_REPEAT_MIN_MS;
+        }
+        ks->next_repeat += ks->repeat_interval;
     }
 }
 
@@ -64,24 +223,47 @@ void bsp_key_init(const key_config_t *config, uint8_t num)
 {
     GPIO_InitTypeDef GPIO_InitStructure;
     uint8_t i;
+    uint8_t j;
 
     if (num > KEY_NUM_MAX) {
         num = KEY_NUM_MAX;
     }
 
     key_num = num;
+    key_port_num = 0;
+    key_active_high = 0;
 
     /* 保存配置 */
     for (i = 0; i < num; i++) {
         key_configs[i] = config[i];
 
         /* 初始化状态 */
-        key_states[i].current_state = 0;
-        key_states[i].last_state = 0;
         key_states[i].press_time = 0;
-        key_states[i].long_press_flag = 0;
+        key_states[i].release_time = 0;
+        key_states[i].next_repeat = 0;
+        key_states[i].repeat_interval = 0;
+        key_states[i].flags = 0;
+
+        if (key_configs[i].active_level != 0) {
+            key_active_high |= 1UL << i;
+        }
+
+        /* 端口分组 */
+        for (j = 0; j < key_port_num && key_ports[j] != key_configs[i].gpio_port; j++) {
+        }
+        if (j == key_port_num && key_port_num < KEY_PORT_MAX) {
+            key_ports[key_port_num++] = key_configs[i].gpio_port;
+        }
+        key_port_index[i] = j;
     }
 
+    key_debounced = 0;
+    key_cnt0 = 0xFFFFFFFF;
+    key_cnt1 = 0xFFFFFFFF;
+    key_pending_mask = 0;
+    key_chord_open = 0;
+    key_chorded = 0;
+
     /* 配置GPIO */
     for (i = 0; i < num; i++) {
         /* 使能GPIO时钟 (这里简化处理，实际应根据端口判断) */
@@ -115,57 +297,45 @@ void bsp_key_init(const key_config_t *config, uint8_t num)
  */
 void bsp_key_scan(void)
 {
-    uint8_t i;
-    uint32_t current_time = bsp_ec11_get_tick();
+    uint32_t now = bsp_ec11_get_tick();
+    uint32_t changed;
+    uint32_t pressed;
+    uint32_t released;
+    uint32_t active;
 
-    for (i = 0; i < key_num; i++) {
-        uint8_t key_pin = key_read_pin((key_id_t)i);
-
-        /* 更新当前状态 */
-        key_states[i].current_state = key_pin;
-
-        /* 检测按键事件 */
-        if (key_states[i].current_state == 1) {
-            /* 按键按下 */
-            if (key_states[i].last_state == 0) {
-                /* 按键刚按下 */
-                key_states[i].press_time = current_time;
-                key_states[i].long_press_flag = 0;
-            } else {
-                /* 按键保持按下 - 检测长按 */
-                uint32_t press_duration = current_time - key_states[i].press_time;
+    /*
+     * 垂直计数器消抖: 与消抖状态不同的位计数, 相同的位复位为3,
+     * 连续4次不同后计数回绕, 翻转该位的消抖状态
+     */
+    changed = key_debounced ^ key_read_raw();
+    key_cnt0 = ~(key_cnt0 & changed);
+    key_cnt1 = key_cnt0 ^ (key_cnt1 & changed);
+    changed &= key_cnt0 & key_cnt1;
+    key_debounced ^= changed;
 
-                if (press_duration >= KEY_LONG_PRESS_TIME_MS && !key_states[i].long_press_flag) {
-                    /* 触发长按事件 */
-                    key_states[i].long_press_flag = 1;
+    pressed = key_debounced & changed;
+    released = ~key_debounced & changed;
 
-                    if (event_callback != NULL) {
-                        event_callback((key_id_t)i, KEY_EVENT_LONG_PRESS);
-                    }
-                }
-            }
-        } else {
-            /* 按键释放 */
-            if (key_states[i].last_state == 1) {
-                /* 按键刚释放 */
-                uint32_t press_duration = current_time - key_states[i].press_time;
-
-                if (!key_states[i].long_press_flag) {
-                    /* 触发短按事件 */
-                    if (event_callback != NULL) {
-                        event_callback((key_id_t)i, KEY_EVENT_SHORT_PRESS);
-                    }
-                }
-
-                /* 触发释放事件 */
-                if (event_callback != NULL) {
-                    event_callback((key_id_t)i, KEY_EVENT_RELEASE);
-                }
-            }
+    /* 从全部释放开始的第一次按下打开组合窗口, 窗口内按下的都记入 */
+    if (pressed != 0) {
+        if (!key_chord_open && (key_debounced & ~pressed) == 0) {
+            key_chord_open = 1;
+            key_chord_start = now;
+            key_chord_keys = pressed;
+        } else if (key_chord_open) {
+            key_chord_keys |= pressed;
         }
+    }
+    key_chord_check(released, now);
+
+    /* 只处理有变化、按住或单击待定的按键, 空闲时不循环 */
+    active = changed | key_debounced | key_pending_mask;
+    while (active != 0) {
+        uint8_t i = key_lowest(active);
+        uint32_t bit = 1UL << i;
 
-        /* 更新上次状态 */
-        key_states[i].last_state = key_states[i].current_state;
+        active &= ~bit;
+        key_gesture(i, bit, pressed, released, now);
     }
 }
 
@@ -180,7 +350,39 @@ uint8_t bsp_key_get_state(key_id_t key_id)
         return 0;
     }
 
-    return key_states[key_id].current_state;
+    return (key_debounced >> key_id) & 1U;
+}
+
+/**
+ * @brief  获取所有按键的消抖后状态
+ * @param  None
+ * @retval 位掩码
+ */
+uint32_t bsp_key_get_mask(void)
+{
+    return key_debounced;
+}
+
+/**
+ * @brief  设置启用双击和连发的按键
+ * @param  double_click_mask: 识别双击的按键掩码
+ * @param  repeat_mask: 长按后连发的按键掩码
+ * @retval None
+ */
+void bsp_key_set_gesture(uint32_t double_click_mask, uint32_t repeat_mask)
+{
+    key_double_click_mask = double_click_mask;
+    key_repeat_mask = repeat_mask;
+}
+
+/**
+ * @brief  获取最近一次组合键的成员
+ * @param  None
+ * @retval 按键掩码
+ */
+uint32_t bsp_key_get_chord(void)
+{
+    return key_chord_last;
 }
 
 /**
@@ -5,6 +5,17 @@
   * @brief   独立按键驱动头文件 - 硬件抽象层
   *          支持多按键扫描、长按检测
   ******************************************************************************
+  * @attention
+  *
+  * 消抖采用垂直计数器: 所有按键的状态按位存放在一个32位字中,
+  * 每次扫描用几条位运算同时为全部按键计数, 连续 4 次采样一致才认为状态改变,
+  * 耗时与按键数无关。在消抖后的状态上识别:
+  * - 短按 / 长按 / 释放
+  * - 双击 (按 bsp_key_set_gesture() 中的掩码启用, 启用后短按延迟到双击窗口结束)
+  * - 按住连发, 间隔逐渐缩短 (按掩码启用)
+  * - 组合键: 多个按键在 KEY_CHORD_TIME_MS 内相继按下
+  *
+  ******************************************************************************
   */
 
 #ifndef __BSP_KEY_H
@@ -18,14 +29,26 @@ extern "C" {
 #include "stm32f4xx.h"
 
 /* 按键配置 ------------------------------------------------------------------*/
-#define KEY_NUM_MAX     4    /* 最多支持的按键数量 */
+#ifndef KEY_NUM_MAX
+#define KEY_NUM_MAX     4    /* 最多支持的按键数量 (不超过32) */
+#endif
 
-/* 按键扫描周期(ms) */
+/* 按键扫描周期(ms), 消抖时间为4个周期 */
 #define KEY_SCAN_PERIOD_MS      10
 
 /* 长按时间阈值(ms) */
 #define KEY_LONG_PRESS_TIME_MS  1000
 
+/* 双击: 两次单击的最大间隔(ms) */
+#define KEY_DOUBLE_CLICK_TIME_MS 300
+
+/* 连发: 长按后首次间隔与最小间隔(ms), 每次间隔缩短为3/4 */
+#define KEY_REPEAT_START_MS     200
+#define KEY_REPEAT_MIN_MS       40
+
+/* 组合键: 相继按下的最大时间差(ms) */
+#define KEY_CHORD_TIME_MS       60
+
 /* 按键ID定义 ----------------------------------------------------------------*/
 typedef enum {
     KEY_ID_0 = 0,
@@ -39,7 +62,10 @@ typedef enum {
     KEY_EVENT_NONE = 0,      /* 无事件 */
     KEY_EVENT_SHORT_PRESS,   /* 短按 */
     KEY_EVENT_LONG_PRESS,    /* 长按 */
-    KEY_EVENT_RELEASE        /* 释放 */
+    KEY_EVENT_RELEASE,       /* 释放 */
+    KEY_EVENT_DOUBLE_CLICK,  /* 双击 (第二次释放时) */
+    KEY_EVENT_REPEAT,        /* 按住连发 (长按之后) */
+    KEY_EVENT_CHORD          /* 组合键, key_id为其中最小的ID, 成员见 bsp_key_get_chord() */
 } key_event_t;
 
 /* 按键配置结构体 ------------------------------------------------------------*/
@@ -76,6 +102,29 @@ void bsp_key_scan(void);
  */
 uint8_t bsp_key_get_state(key_id_t key_id);
 
+/**
+ * @brief  获取所有按键的消抖后状态
+ * @param  None
+ * @retval 位掩码, bit n 为1表示按键n按下
+ */
+uint32_t bsp_key_get_mask(void);
+
+/**
+ * @brief  设置启用双击和连发的按键
+ * @param  double_click_mask: 识别双击的按键掩码 (这些按键的短按延迟 KEY_DOUBLE_CLICK_TIME_MS 上报)
+ * @param  repeat_mask: 长按后连发的按键掩码
+ * @retval None
+ */
+void bsp_key_set_gesture(uint32_t double_click_mask, uint32_t repeat_mask);
+
+/**
+ * @brief  获取最近一次组合键的成员
+ * @param  None
+ * @retval 按键掩码
+ * @note   组合键成员在全部释放前不再单独产生短按/长按/双击/连发事件
+ */
+uint32_t bsp_key_get_chord(void);
+
 /**
  * @brief  注册按键事件回调函数
  * @param  callback: 回调函数指针
@@ -0,0 +1,298 @@
+/**
+ * @file bsp_keypad.c
+ * @brief 矩阵键盘驱动实现 - 标准库版本
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "bsp_keypad.h"
+#include <stddef.h>
+
+#if KEYPAD_ROWS > 8 || KEYPAD_COLS > 8
+#error "KEYPAD_ROWS and KEYPAD_COLS must not exceed 8"
+#endif
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define ROW_MASK                (((1UL << KEYPAD_ROWS) - 1) << KEYPAD_ROW_PIN0)
+#define COL_MASK                ((1UL << KEYPAD_COLS) - 1)
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+/* 行驱动字 (写BSRR): 第k个在第k个行周期结束时写入, 驱动第k+1行 */
+static uint32_t row_drive[KEYPAD_ROWS];
+
+/* 列采样 (读IDR): 第k个为驱动第k行时的列端口 */
+static volatile uint16_t col_samples[KEYPAD_ROWS];
+
+/* 垂直计数器消抖 */
+static keypad_mask_t key_debounced = 0;
+static keypad_mask_t key_cnt0 = (keypad_mask_t)~0;
+static keypad_mask_t key_cnt1 = (keypad_mask_t)~0;
+static keypad_mask_t key_ghost = 0;
+
+static keypad_callback_t event_callback = NULL;
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static void keypad_gpio_init(void);
+static void keypad_dma_init(void);
+static void keypad_tim_init(void);
+static keypad_mask_t keypad_read_raw(void);
+static keypad_mask_t keypad_find_ghost(keypad_mask_t raw);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 矩阵键盘初始化
+ */
+void bsp_keypad_init(void)
+{
+    uint8_t r;
+
+    /* 驱动第r+1行: 该行置低, 其余行释放 (开漏, 由上拉拉高) */
+    for (r = 0; r < KEYPAD_ROWS; r++) {
+        uint8_t next = (uint8_t)((r + 1) % KEYPAD_ROWS);
+        uint32_t low = 1UL << (KEYPAD_ROW_PIN0 + next);
+
+        row_drive[r] = (low << 16) | (ROW_MASK & ~low);
+        col_samples[r] = 0xFFFF;
+    }
+
+    key_debounced = 0;
+    key_cnt0 = (keypad_mask_t)~0;
+    key_cnt1 = (keypad_mask_t)~0;
+    key_ghost = 0;
+
+    keypad_gpio_init();
+
+    /* 先驱动第0行, 第一个行周期中点采样的就是它 */
+    GPIO_ResetBits(KEYPAD_ROW_PORT, (uint16_t)(1UL << KEYPAD_ROW_PIN0));
+
+    keypad_dma_init();
+    keypad_tim_init();
+}
+
+/**
+ * @brief 停止扫描
+ */
+void bsp_keypad_stop(void)
+{
+    TIM_Cmd(KEYPAD_TIM, DISABLE);
+    TIM_DMACmd(KEYPAD_TIM, TIM_DMA_Update | TIM_DMA_CC1, DISABLE);
+    DMA_Cmd(KEYPAD_ROW_DMA_STREAM, DISABLE);
+    DMA_Cmd(KEYPAD_COL_DMA_STREAM, DISABLE);
+    GPIO_SetBits(KEYPAD_ROW_PORT, (uint16_t)ROW_MASK);
+}
+
+/**
+ * @brief 处理最新的扫描结果
+ */
+void bsp_keypad_scan(void)
+{
+    keypad_mask_t raw = keypad_read_raw();
+    keypad_mask_t changed;
+    uint8_t i;
+
+    /* 无法确定的按键保持原状态 */
+    key_ghost = keypad_find_ghost(raw);
+    raw = (raw & ~key_ghost) | (key_debounced & key_ghost);
+
+    /* 垂直计数器: 连续4次与消抖状态不同才翻转 */
+    changed = key_debounced ^ raw;
+    key_cnt0 = ~(key_cnt0 & changed);
+    key_cnt1 = key_cnt0 ^ (key_cnt1 & changed);
+    changed &= key_cnt0 & key_cnt1;
+    key_debounced ^= changed;
+
+    if (changed == 0 || event_callback == NULL) {
+        return;
+    }
+
+    for (i = 0; i < KEYPAD_KEYS; i++) {
+        if ((changed >> i) & 1U) {
+            event_callback(i, ((key_debounced >> i) & 1U) ? KEYPAD_EVENT_PRESS : KEYPAD_EVENT_RELEASE);
+        }
+    }
+}
+
+/**
+ * @brief 获取消抖后的按键状态
+ */
+keypad_mask_t bsp_keypad_get_state(void)
+{
+    return key_debounced;
+}
+
+/**
+ * @brief 获取无法确定的按键
+ */
+keypad_mask_t bsp_keypad_get_ghost(void)
+{
+    return key_ghost;
+}
+
+/**
+ * @brief 注册事件回调函数
+ */
+void bsp_keypad_register_callback(keypad_callback_t callback)
+{
+    event_callback = callback;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 行开漏输出 (默认释放), 列上拉输入
+ */
+static void keypad_gpio_init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(KEYPAD_ROW_CLK | KEYPAD_COL_CLK, ENABLE);
+
+    GPIO_SetBits(KEYPAD_ROW_PORT, (uint16_t)ROW_MASK);
+
+    GPIO_InitStructure.GPIO_Pin = (uint16_t)ROW_MASK;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_OUT;
+    GPIO_InitStructure.GPIO_OType = GPIO_OType_OD;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_2MHz;
+    GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP;
+    GPIO_Init(KEYPAD_ROW_PORT, &GPIO_InitStructure);
+
+    GPIO_InitStructure.GPIO_Pin = (uint16_t)(COL_MASK << KEYPAD_COL_PIN0);
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN;
+    GPIO_Init(KEYPAD_COL_PORT, &GPIO_InitStructure);
+}
+
+/**
+ * @brief 行驱动DMA (内存->BSRR) 和列采样DMA (IDR->内存), 均为循环模式
+ */
+static void keypad_dma_init(void)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+
+    /* 行驱动: 更新事件, 32位写BSRR (BSRRL/BSRRH一次写入) */
+    DMA_DeInit(KEYPAD_ROW_DMA_STREAM);
+    DMA_InitStructure.DMA_Channel = KEYPAD_ROW_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&KEYPAD_ROW_PORT->BSRRL;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)row_drive;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStructure.DMA_BufferSize = KEYPAD_ROWS;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(KEYPAD_ROW_DMA_STREAM, &DMA_InitStructure);
+
+    /* 列采样: CC1事件, 16位读IDR */
+    DMA_DeInit(KEYPAD_COL_DMA_STREAM);
+    DMA_InitStructure.DMA_Channel = KEYPAD_COL_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&KEYPAD_COL_PORT->IDR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)col_samples;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_Init(KEYPAD_COL_DMA_STREAM, &DMA_InitStructure);
+
+    DMA_Cmd(KEYPAD_ROW_DMA_STREAM, ENABLE);
+    DMA_Cmd(KEYPAD_COL_DMA_STREAM, ENABLE);
+}
+
+/**
+ * @brief TIM1: 1MHz计数, 周期为行周期, CC1在中点 (行电平稳定后) 产生采样请求
+ */
+static void keypad_tim_init(void)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+
+    RCC_APB2PeriphClockCmd(KEYPAD_TIM_CLK, ENABLE);
+
+    /* APB2定时器时钟为系统时钟 */
+    TIM_TimeBaseStructure.TIM_Prescaler = (uint16_t)(SystemCoreClock / 1000000 - 1);
+    TIM_TimeBaseStructure.TIM_Period = KEYPAD_ROW_PERIOD_US - 1;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(KEYPAD_TIM, &TIM_TimeBaseStructure);
+
+    /* 只用比较事件, 不输出 */
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OCInitStructure.TIM_Pulse = KEYPAD_ROW_PERIOD_US / 2;
+    TIM_OC1Init(KEYPAD_TIM, &TIM_OCInitStructure);
+
+    TIM_ClearFlag(KEYPAD_TIM, TIM_FLAG_Update | TIM_FLAG_CC1);
+    TIM_SetCounter(KEYPAD_TIM, 0);
+    TIM_DMACmd(KEYPAD_TIM, TIM_DMA_Update | TIM_DMA_CC1, ENABLE);
+    TIM_Cmd(KEYPAD_TIM, ENABLE);
+}
+
+/**
+ * @brief 把各行的列采样拼成按键掩码 (列为低表示按下)
+ */
+static keypad_mask_t keypad_read_raw(void)
+{
+    keypad_mask_t raw = 0;
+    uint8_t r;
+
+    for (r = 0; r < KEYPAD_ROWS; r++) {
+        uint32_t cols = (~(uint32_t)col_samples[r] >> KEYPAD_COL_PIN0) & COL_MASK;
+
+        raw |= (keypad_mask_t)cols << (r * KEYPAD_COLS);
+    }
+
+    return raw;
+}
+
+/**
+ * @brief 幽灵键检测: 两行的按下列有两列以上相同时, 这两行上的这些列都不可信
+ * @note 无二极管时按下的键把行列连成一片, 读数中同一连通区域的行读到相同的列,
+ *       因此只需两两比较行
+ */
+static keypad_mask_t keypad_find_ghost(keypad_mask_t raw)
+{
+    keypad_mask_t ghost = 0;
+    uint8_t r1;
+    uint8_t r2;
+
+    for (r1 = 0; r1 + 1 < KEYPAD_ROWS; r1++) {
+        uint32_t row1 = (uint32_t)(raw >> (r1 * KEYPAD_COLS)) & COL_MASK;
+
+        if ((row1 & (row1 - 1)) == 0) {
+            continue;   /* 不足两列, 不构成矩形 */
+        }
+
+        for (r2 = r1 + 1; r2 < KEYPAD_ROWS; r2++) {
+            uint32_t common = row1 & (uint32_t)(raw >> (r2 * KEYPAD_COLS));
+
+            common &= COL_MASK;
+            if (common & (common - 1)) {
+                ghost |= ((keypad_mask_t)common << (r1 * KEYPAD_COLS)) |
+                         ((keypad_mask_t)common << (r2 * KEYPAD_COLS));
+            }
+        }
+    }
+
+    return ghost;
+}
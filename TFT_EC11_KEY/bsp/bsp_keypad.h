@@ -0,0 +1,130 @@
+/**
+ * @file bsp_keypad.h
+ * @brief 矩阵键盘驱动 - 定时器触发DMA扫描
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 硬件平台: STM32F407VGT6
+ * @note 功能特性:
+ *       - TIM1更新事件触发DMA把下一行的驱动字写入行端口BSRR, CC1 (行周期中点) 触发DMA读取列端口IDR,
+ *         两路DMA循环运行, 逐行扫描不占用CPU
+ *       - bsp_keypad_scan() 对整个矩阵做一次垂直计数器消抖, 全部按键同时处理
+ *       - 幽灵键检测: 无二极管矩阵中两行共有两列以上按下时 (矩形), 四个角无法区分真假,
+ *         这些按键保持原状态, 不产生事件
+ *       - 行为开漏输出, 多键按下时行与行之间不会短路
+ *
+ * @note 资源占用: TIM1, DMA2_Stream5 (TIM1_UP), DMA2_Stream1 (TIM1_CH1), 无中断
+ *       只有DMA2的外设端口能访问AHB1上的GPIO, 因此必须用DMA2可触发的TIM1或TIM8
+ */
+
+#ifndef __BSP_KEYPAD_H
+#define __BSP_KEYPAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx.h"
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 矩阵尺寸 (行、列各不超过8) */
+#define KEYPAD_ROWS             4
+#define KEYPAD_COLS             4
+#define KEYPAD_KEYS             (KEYPAD_ROWS * KEYPAD_COLS)
+
+/* 行引脚: 开漏输出, 从 KEYPAD_ROW_PIN0 开始连续 */
+#define KEYPAD_ROW_PORT         GPIOE
+#define KEYPAD_ROW_CLK          RCC_AHB1Periph_GPIOE
+#define KEYPAD_ROW_PIN0         0
+
+/* 列引脚: 上拉输入, 从 KEYPAD_COL_PIN0 开始连续 */
+#define KEYPAD_COL_PORT         GPIOE
+#define KEYPAD_COL_CLK          RCC_AHB1Periph_GPIOE
+#define KEYPAD_COL_PIN0         8
+
+/* 每行驱动时间(us), 列在中点采样; 整个矩阵扫描一遍为 KEYPAD_ROWS 倍 */
+#define KEYPAD_ROW_PERIOD_US    50
+
+/* 定时器与DMA */
+#define KEYPAD_TIM              TIM1
+#define KEYPAD_TIM_CLK          RCC_APB2Periph_TIM1
+#define KEYPAD_ROW_DMA_STREAM   DMA2_Stream5    /* TIM1_UP */
+#define KEYPAD_ROW_DMA_CHANNEL  DMA_Channel_6
+#define KEYPAD_COL_DMA_STREAM   DMA2_Stream1    /* TIM1_CH1 */
+#define KEYPAD_COL_DMA_CHANNEL  DMA_Channel_6
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 按键位掩码, bit (行*KEYPAD_COLS+列)
+ */
+#if KEYPAD_KEYS > 32
+typedef uint64_t keypad_mask_t;
+#else
+typedef uint32_t keypad_mask_t;
+#endif
+
+/**
+ * @brief 矩阵键盘事件
+ */
+typedef enum {
+    KEYPAD_EVENT_PRESS = 1,     /**< 按下 */
+    KEYPAD_EVENT_RELEASE        /**< 释放 */
+} keypad_event_t;
+
+/**
+ * @brief 事件回调函数类型
+ * @param key 按键编号 (行*KEYPAD_COLS+列)
+ * @param event 事件
+ */
+typedef void (*keypad_callback_t)(uint8_t key, keypad_event_t event);
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 矩阵键盘初始化, 启动DMA扫描
+ */
+void bsp_keypad_init(void);
+
+/**
+ * @brief 停止扫描 (释放全部行)
+ */
+void bsp_keypad_stop(void);
+
+/**
+ * @brief 处理最新的扫描结果 (需周期调用, 建议10ms)
+ * @note 消抖需连续4次调用结果一致; 状态变化的按键依次回调
+ */
+void bsp_keypad_scan(void);
+
+/**
+ * @brief 获取消抖后的按键状态
+ * @retval 按键掩码, 1为按下
+ */
+keypad_mask_t bsp_keypad_get_state(void);
+
+/**
+ * @brief 获取最近一次扫描中无法确定的按键 (幽灵键矩形的四个角)
+ * @retval 按键掩码
+ */
+keypad_mask_t bsp_keypad_get_ghost(void);
+
+/**
+ * @brief 注册事件回调函数
+ * @param callback 回调函数
+ */
+void bsp_keypad_register_callback(keypad_callback_t callback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_KEYPAD_H */
@@ -7,8 +7,38 @@
  */
 
 #include "bsp_pwm.h"
+#include "bsp_dma.h"
 #include <string.h>
 
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define WAVE_SLOT_NONE          0xFF
+
+/**
+ * @brief 定时器更新事件的DMA请求
+ */
+typedef struct {
+    DMA_Stream_TypeDef *stream;
+    uint32_t channel;
+    uint8_t irqn;
+    uint32_t it_ht;
+    uint32_t it_tc;
+} pwm_dma_t;
+
+/**
+ * @brief 同步序列状态 (每个定时器一个)
+ */
+typedef struct {
+    uint8_t active;
+    uint8_t channels;
+    uint16_t frames;
+    uint16_t *buffer;
+    pwm_seq_refill_t refill;
+    void *user_data;
+} pwm_seq_info_t;
+
 /*=============================================================================
  *                              私有变量
  *============================================================================*/
@@ -18,17 +48,36 @@ typedef struct {
     pwm_config_t config;
     TIM_TypeDef *timer;
     uint16_t current_duty;
-    /* 呼吸灯状态 */
-    uint8_t breath_active;
-    uint8_t breath_direction; /* 0:增加 1:减少 */
-    pwm_breath_param_t breath_param;
-    uint32_t breath_last_tick;
+    /* 波形状态 */
+    uint8_t wave_active;
+    uint8_t wave_slot;              /**< 占用的内部缓冲区, WAVE_SLOT_NONE为用户表 */
 } pwm_channel_info_t;
 
 static pwm_channel_info_t pwm_channels[PWM_MAX_CHANNELS] = {0};
 
-/* 延时函数 */
-extern uint32_t scheduler_get_tick(void);
+/* 内部波形缓冲区 (DMA读取, 不能放在CCM RAM中) */
+static uint16_t pwm_wave_pool[PWM_WAVE_SLOTS][PWM_WAVE_MAX_SAMPLES];
+static uint8_t pwm_wave_owner[PWM_WAVE_SLOTS];     /**< 所属通道+1, 0为空闲 */
+
+/* 各定时器更新请求的DMA, NULL为不支持:
+ * TIM1/TIM8的DMA2_Stream5/Stream1被矩阵键盘占用;
+ * TIM2/TIM5的CCR和DMAR是32位的, 半字DMA写入会被复制到高低两半 (CCR = v*65537), 输出恒为100% */
+static const pwm_dma_t pwm_up_dma[PWM_TIMER_COUNT] = {
+    [PWM_TIMER_1] = { NULL,         0,             0,                 0,            0            },
+    [PWM_TIMER_2] = { NULL,         0,             0,                 0,            0            },
+    [PWM_TIMER_3] = { DMA1_Stream2, DMA_Channel_5, DMA1_Stream2_IRQn, DMA_IT_HTIF2, DMA_IT_TCIF2 },
+    [PWM_TIMER_4] = { DMA1_Stream6, DMA_Channel_2, DMA1_Stream6_IRQn, DMA_IT_HTIF6, DMA_IT_TCIF6 },
+    [PWM_TIMER_5] = { NULL,         0,             0,                 0,            0            },
+    [PWM_TIMER_8] = { NULL,         0,             0,                 0,            0            },
+};
+
+static pwm_seq_info_t pwm_seqs[PWM_TIMER_COUNT];
+
+/* 突发传输长度 (通道数-1为下标) */
+static const uint16_t pwm_burst_len[4] = {
+    TIM_DMABurstLength_1Transfer, TIM_DMABurstLength_2Transfers,
+    TIM_DMABurstLength_3Transfers, TIM_DMABurstLength_4Transfers
+};
 
 /*=============================================================================
  *                              私有函数声明
@@ -38,6 +87,12 @@ static TIM_TypeDef* get_timer_instance(pwm_timer_t timer);
 static uint32_t get_timer_clk(pwm_timer_t timer);
 static void enable_timer_clk(pwm_timer_t timer);
 static void config_timer_channel(TIM_TypeDef *tim, pwm_ch_t ch, uint16_t pulse);
+static volatile uint32_t* get_ccr(pwm_channel_t channel);
+static uint16_t* wave_alloc(pwm_channel_t channel, uint32_t samples);
+static int wave_play(pwm_channel_t channel, const uint16_t *table, uint16_t len, uint8_t loop);
+static void dma_stream_config(const pwm_dma_t *dma, uint32_t periph, const uint16_t *mem,
+                              uint32_t len, uint8_t loop);
+static void seq_irq_handler(pwm_timer_t timer);
 
 /*=============================================================================
  *                              公共函数实现
@@ -56,7 +111,8 @@ pwm_channel_t bsp_pwm_init(const pwm_config_t *config)
     uint32_t timer_clk;
     uint16_t prescaler, period;
 
-    if (config == NULL) {
+    /* TIM5是系统单调时钟和定时服务的硬件比较, 改写PSC/ARR会破坏所有时间 */
+    if (config == NULL || config->timer == PWM_TIMER_5) {
         return 0xFF;
     }
 
@@ -115,7 +171,8 @@ pwm_channel_t bsp_pwm_init(const pwm_config_t *config)
     pwm_channels[channel].config = *config;
     pwm_channels[channel].timer = tim;
     pwm_channels[channel].current_duty = 0;
-    pwm_channels[channel].breath_active = 0;
+    pwm_channels[channel].wave_active = 0;
+    pwm_channels[channel].wave_slot = WAVE_SLOT_NONE;
 
     return channel;
 }
@@ -129,6 +186,7 @@ void bsp_pwm_deinit(pwm_channel_t channel)
         return;
     }
 
+    bsp_pwm_wave_stop(channel);
     bsp_pwm_stop(channel);
     pwm_channels[channel].is_used = 0;
 }
@@ -145,6 +203,9 @@ void bsp_pwm_set_duty(pwm_channel_t channel, uint16_t duty)
         return;
     }
 
+    /* 手动设置覆盖正在运行的波形 */
+    bsp_pwm_wave_stop(channel);
+
     tim = pwm_channels[channel].timer;
     ch = pwm_channels[channel].config.channel;
 
@@ -191,6 +252,11 @@ uint16_t bsp_pwm_get_duty(pwm_channel_t channel)
         return 0;
     }
 
+    /* 波形或序列播放中, 占空比由DMA写入 */
+    if (pwm_channels[channel].wave_active || pwm_seqs[pwm_channels[channel].config.timer].active) {
+        return (uint16_t)*get_ccr(channel);
+    }
+
     return pwm_channels[channel].current_duty;
 }
 
@@ -215,8 +281,9 @@ int bsp_pwm_set_frequency(pwm_channel_t channel, uint32_t freq)
     prescaler = (timer_clk / (freq * resolution)) - 1;
     period = resolution - 1;
 
+    /* ARR和PSC都在下一个更新事件生效: 不复位计数器, 与DMA写入的CCR同一周期切换 */
     TIM_SetAutoreload(tim, period);
-    TIM_PrescalerConfig(tim, prescaler, TIM_PSCReloadMode_Immediate);
+    TIM_PrescalerConfig(tim, prescaler, TIM_PSCReloadMode_Update);
 
     pwm_channels[channel].config.frequency = freq;
 
@@ -235,6 +302,18 @@ uint32_t bsp_pwm_get_frequency(pwm_channel_t channel)
     return pwm_channels[channel].config.frequency;
 }
 
+/**
+ * @brief 获取分辨率
+ */
+uint16_t bsp_pwm_get_resolution(pwm_channel_t channel)
+{
+    if (channel >= PWM_MAX_CHANNELS || !pwm_channels[channel].is_used) {
+        return 0;
+    }
+
+    return pwm_channels[channel].config.resolution;
+}
+
 /**
  * @brief 启动PWM输出
  */
@@ -281,31 +360,98 @@ void bsp_pwm_stop(pwm_channel_t channel)
     }
 }
 
+/**
+ * @brief 渐变到目标占空比
+ * @note 在感知亮度上线性插值: 起点和终点先经伽马反变换, 中间各采样再做伽马校正
+ */
+int bsp_pwm_fade_to(pwm_channel_t channel, uint16_t target_duty, uint32_t duration_ms)
+{
+    pwm_channel_info_t *info;
+    uint16_t *table;
+    uint32_t samples, resolution, i;
+    int32_t from, to;
+
+    if (channel >= PWM_MAX_CHANNELS || !pwm_channels[channel].is_used) {
+        return -1;
+    }
+
+    info = &pwm_channels[channel];
+    resolution = info->config.resolution;
+    if (target_duty > resolution) {
+        target_duty = (uint16_t)resolution;
+    }
+
+    samples = (uint32_t)((uint64_t)duration_ms * info->config.frequency / 1000);
+    if (samples == 0) {
+        bsp_pwm_set_duty(channel, target_duty);
+        return 0;
+    }
+
+    /* 先停止旧波形 (缓冲区可能正被DMA读取), 从停下时的占空比开始 */
+    bsp_pwm_wave_stop(channel);
+    from = bsp_pwm_get_duty(channel);
+
+    table = wave_alloc(channel, samples);
+    if (table == NULL) {
+        return -1;
+    }
+
+    from = (int32_t)bsp_pwm_gamma_inverse(((uint32_t)from << 16) / resolution);
+    to = (int32_t)bsp_pwm_gamma_inverse(((uint32_t)target_duty << 16) / resolution);
+
+    for (i = 1; i <= samples; i++) {
+        int32_t level = from + (to - from) * (int32_t)i / (int32_t)samples;
+        table[i - 1] = (uint16_t)((bsp_pwm_gamma((uint32_t)level) * resolution + 32768) >> 16);
+    }
+    table[samples - 1] = target_duty;
+
+    return wave_play(channel, table, (uint16_t)samples, 0);
+}
+
 /**
  * @brief 启动呼吸灯效果
  */
-void bsp_pwm_breath_start(pwm_channel_t channel, const pwm_breath_param_t *param)
+int bsp_pwm_breath_start(pwm_channel_t channel, const pwm_breath_param_t *param)
 {
+    pwm_channel_info_t *info;
+    pwm_breath_param_t def;
+    uint16_t *table;
+    uint32_t samples;
+
     if (channel >= PWM_MAX_CHANNELS || !pwm_channels[channel].is_used) {
-        return;
+        return -1;
     }
 
-    if (param != NULL) {
-        pwm_channels[channel].breath_param = *param;
-    } else {
-        /* 默认参数 */
-        pwm_channels[channel].breath_param.min_duty = 0;
-        pwm_channels[channel].breath_param.max_duty = pwm_channels[channel].config.resolution;
-        pwm_channels[channel].breath_param.step = pwm_channels[channel].config.resolution / 100;
-        pwm_channels[channel].breath_param.interval_ms = 20;
+    info = &pwm_channels[channel];
+
+    if (param == NULL) {
+        def.min_duty = 0;
+        def.max_duty = info->config.resolution;
+        def.period_ms = PWM_BREATH_PERIOD_MS;
+        param = &def;
+    }
+
+    samples = (uint32_t)param->period_ms * info->config.frequency / 1000;
+    if (samples < 2) {
+        return -1;
+    }
+
+    bsp_pwm_wave_stop(channel);
+
+    table = wave_alloc(channel, samples);
+    if (table == NULL) {
+        return -1;
     }
 
-    pwm_channels[channel].breath_active = 1;
-    pwm_channels[channel].breath_direction = 0;
-    pwm_channels[channel].breath_last_tick = 0;
+    bsp_pwm_breath_table(table, (uint16_t)samples, param->min_duty, param->max_duty);
+
+    if (wave_play(channel, table, (uint16_t)samples, 1) != 0) {
+        return -1;
+    }
 
-    bsp_pwm_set_duty(channel, pwm_channels[channel].breath_param.min_duty);
     bsp_pwm_start(channel);
+
+    return 0;
 }
 
 /**
@@ -313,53 +459,241 @@ void bsp_pwm_breath_start(pwm_channel_t channel, const pwm_breath_param_t *param
  */
 void bsp_pwm_breath_stop(pwm_channel_t channel)
 {
+    bsp_pwm_wave_stop(channel);
+}
+
+/**
+ * @brief 播放用户波形表
+ */
+int bsp_pwm_wave_start(pwm_channel_t channel, const uint16_t *table, uint16_t len, uint8_t loop)
+{
+    if (channel >= PWM_MAX_CHANNELS || !pwm_channels[channel].is_used ||
+        table == NULL || len == 0) {
+        return -1;
+    }
+
+    bsp_pwm_wave_stop(channel);
+
+    return wave_play(channel, table, len, loop);
+}
+
+/**
+ * @brief 停止波形
+ */
+void bsp_pwm_wave_stop(pwm_channel_t channel)
+{
+    pwm_channel_info_t *info;
+    const pwm_dma_t *dma;
+
     if (channel >= PWM_MAX_CHANNELS || !pwm_channels[channel].is_used) {
         return;
     }
 
-    pwm_channels[channel].breath_active = 0;
+    info = &pwm_channels[channel];
+    if (!info->wave_active) {
+        return;
+    }
+
+    dma = &pwm_up_dma[info->config.timer];
+
+    TIM_DMACmd(info->timer, TIM_DMA_Update, DISABLE);
+    DMA_Cmd(dma->stream, DISABLE);
+    while (DMA_GetCmdStatus(dma->stream) != DISABLE);
+    bsp_dma_release(dma->stream, DMA_OWNER_PWM);
+
+    info->wave_active = 0;
+    info->current_duty = (uint16_t)*get_ccr(channel);
+
+    if (info->wave_slot != WAVE_SLOT_NONE) {
+        pwm_wave_owner[info->wave_slot] = 0;
+        info->wave_slot = WAVE_SLOT_NONE;
+    }
+}
+
+/**
+ * @brief 波形是否正在播放
+ */
+uint8_t bsp_pwm_wave_busy(pwm_channel_t channel)
+{
+    if (channel >= PWM_MAX_CHANNELS || !pwm_channels[channel].is_used ||
+        !pwm_channels[channel].wave_active) {
+        return 0;
+    }
+
+    /* 单次播放结束后DMA自动关闭 */
+    return DMA_GetCmdStatus(pwm_up_dma[pwm_channels[channel].config.timer].stream) == ENABLE;
 }
 
 /**
- * @brief 呼吸灯更新
+ * @brief 启动多通道同步序列
+ * @note 每个更新事件触发一次突发: DMA经DMAR连续写入channels个CCR, 它们在下一个更新事件一起生效
  */
-void bsp_pwm_breath_update(void)
+int bsp_pwm_seq_start(pwm_channel_t first, uint8_t channels, uint16_t *buffer, uint16_t frames,
+                      pwm_seq_refill_t refill, void *user_data)
 {
+    pwm_channel_info_t *info;
+    pwm_seq_info_t *seq;
+    const pwm_dma_t *dma;
+#if PWM_SEQ_IRQ_ENABLE
+    NVIC_InitTypeDef NVIC_InitStructure;
+#endif
     uint8_t i;
-    uint32_t current_tick = scheduler_get_tick();
-    pwm_breath_param_t *param;
-    uint16_t duty;
 
+    if (first >= PWM_MAX_CHANNELS || !pwm_channels[first].is_used || buffer == NULL ||
+        channels == 0 || frames == 0) {
+        return -1;
+    }
+
+    info = &pwm_channels[first];
+    seq = &pwm_seqs[info->config.timer];
+    dma = &pwm_up_dma[info->config.timer];
+
+    if (dma->stream == NULL || seq->active || info->config.channel + channels > 4 ||
+        (uint32_t)frames * channels > 0xFFFF) {
+        return -1;
+    }
+
+#if PWM_SEQ_IRQ_ENABLE
+    if (refill != NULL && (frames & 1) != 0) {
+        return -1;
+    }
+#else
+    if (refill != NULL) {
+        return -1;
+    }
+#endif
+
+    for (i = 0; i < PWM_MAX_CHANNELS; i++) {
+        if (pwm_channels[i].is_used && pwm_channels[i].wave_active &&
+            pwm_channels[i].timer == info->timer) {
+            return -1;
+        }
+    }
+
+    /* DMA流可能被其他驱动占用 (TIM4的DMA1_Stream6与输入捕获共用) */
+    if (bsp_dma_claim(dma->stream, DMA_OWNER_PWM) != 0) {
+        return -1;
+    }
+
+    seq->channels = channels;
+    seq->frames = frames;
+    seq->buffer = buffer;
+    seq->refill = refill;
+    seq->user_data = user_data;
+
+    if (refill != NULL) {
+        refill(buffer, frames, user_data);
+    }
+
+    TIM_DMAConfig(info->timer, TIM_DMABase_CCR1 + info->config.channel, pwm_burst_len[channels - 1]);
+    dma_stream_config(dma, (uint32_t)&info->timer->DMAR, buffer, (uint32_t)frames * channels, 1);
+
+#if PWM_SEQ_IRQ_ENABLE
+    if (refill != NULL) {
+        DMA_ClearITPendingBit(dma->stream, dma->it_ht | dma->it_tc);
+        DMA_ITConfig(dma->stream, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+        NVIC_InitStructure.NVIC_IRQChannel = dma->irqn;
+        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = PWM_SEQ_IRQ_PRIORITY;
+        NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+        NVIC_Init(&NVIC_InitStructure);
+    }
+#endif
+
+    seq->active = 1;
+
+    DMA_Cmd(dma->stream, ENABLE);
+    TIM_DMACmd(info->timer, TIM_DMA_Update, ENABLE);
+
+    return 0;
+}
+
+/**
+ * @brief 停止序列
+ */
+void bsp_pwm_seq_stop(pwm_channel_t first)
+{
+    pwm_channel_info_t *info;
+    pwm_seq_info_t *seq;
+    const pwm_dma_t *dma;
+    uint8_t i;
+
+    if (first >= PWM_MAX_CHANNELS || !pwm_channels[first].is_used) {
+        return;
+    }
+
+    info = &pwm_channels[first];
+    seq = &pwm_seqs[info->config.timer];
+    if (!seq->active) {
+        return;
+    }
+
+    dma = &pwm_up_dma[info->config.timer];
+
+    TIM_DMACmd(info->timer, TIM_DMA_Update, DISABLE);
+    DMA_ITConfig(dma->stream, DMA_IT_HT | DMA_IT_TC, DISABLE);
+    DMA_Cmd(dma->stream, DISABLE);
+    while (DMA_GetCmdStatus(dma->stream) != DISABLE);
+    DMA_ClearITPendingBit(dma->stream, dma->it_ht | dma->it_tc);
+    bsp_dma_release(dma->stream, DMA_OWNER_PWM);
+
+    seq->active = 0;
+
+    /* 同步各通道记录的占空比 */
     for (i = 0; i < PWM_MAX_CHANNELS; i++) {
-        if (pwm_channels[i].is_used && pwm_channels[i].breath_active) {
-            param = &pwm_channels[i].breath_param;
-
-            if (current_tick - pwm_channels[i].breath_last_tick >= param->interval_ms) {
-                pwm_channels[i].breath_last_tick = current_tick;
-
-                duty = pwm_channels[i].current_duty;
-
-                if (pwm_channels[i].breath_direction == 0) {
-                    /* 增加 */
-                    if (duty + param->step >= param->max_duty) {
-                        duty = param->max_duty;
-                        pwm_channels[i].breath_direction = 1;
-                    } else {
-                        duty += param->step;
-                    }
-                } else {
-                    /* 减少 */
-                    if (duty <= param->min_duty + param->step) {
-                        duty = param->min_duty;
-                        pwm_channels[i].breath_direction = 0;
-                    } else {
-                        duty -= param->step;
-                    }
-                }
-
-                bsp_pwm_set_duty(i, duty);
-            }
+        if (pwm_channels[i].is_used && pwm_channels[i].timer == info->timer) {
+            pwm_channels[i].current_duty = (uint16_t)*get_ccr(i);
+        }
+    }
+}
+
+/**
+ * @brief 序列是否正在播放
+ */
+uint8_t bsp_pwm_seq_busy(pwm_channel_t first)
+{
+    if (first >= PWM_MAX_CHANNELS || !pwm_channels[first].is_used) {
+        return 0;
+    }
+
+    return pwm_seqs[pwm_channels[first].config.timer].active;
+}
+
+/**
+ * @brief 生成一个周期的呼吸波形表
+ */
+void bsp_pwm_breath_table(uint16_t *table, uint16_t len, uint16_t min_duty, uint16_t max_duty)
+{
+    uint32_t half, i, span;
+
+    if (table == NULL || len < 2) {
+        return;
+    }
+
+    if (max_duty < min_duty) {
+        uint16_t t = max_duty;
+        max_duty = min_duty;
+        min_duty = t;
+    }
+
+    half = len / 2;
+    span = max_duty - min_duty;
+
+    for (i = 0; i < len; i++) {
+        uint32_t x, s;
+
+        /* 三角波 (Q16): 0 → 1 (第half个) → 0 */
+        if (i <= half) {
+            x = (i << 16) / half;
+        } else {
+            x = ((len - i) << 16) / (len - half);
         }
+
+        /* smoothstep 3x^2 - 2x^3, 两端斜率为0, 接近余弦 */
+        s = (uint32_t)(((uint64_t)x * x * (3 * 65536 - 2 * x)) >> 32);
+
+        table[i] = (uint16_t)(min_duty + ((bsp_pwm_gamma(s) * span + 32768) >> 16));
     }
 }
 
@@ -416,7 +750,6 @@ static TIM_TypeDef* get_timer_instance(pwm_timer_t timer)
     case PWM_TIMER_2: return TIM2;
     case PWM_TIMER_3: return TIM3;
     case PWM_TIMER_4: return TIM4;
-    case PWM_TIMER_5: return TIM5;
     case PWM_TIMER_8: return TIM8;
     default: return NULL;
     }
@@ -441,7 +774,6 @@ static void enable_timer_clk(pwm_timer_t timer)
     case PWM_TIMER_2: RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE); break;
     case PWM_TIMER_3: RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE); break;
     case PWM_TIMER_4: RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM4, ENABLE); break;
-    case PWM_TIMER_5: RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM5, ENABLE); break;
     case PWM_TIMER_8: RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM8, ENABLE); break;
     default: break;
     }
@@ -482,3 +814,139 @@ static void config_timer_channel(TIM_TypeDef *tim, pwm_ch_t ch, uint16_t pulse)
         TIM_CtrlPWMOutputs(tim, ENABLE);
     }
 }
+
+/**
+ * @brief 通道的CCR寄存器地址 (CCR1~CCR4连续排列)
+ */
+static volatile uint32_t* get_ccr(pwm_channel_t channel)
+{
+    return &pwm_channels[channel].timer->CCR1 + pwm_channels[channel].config.channel;
+}
+
+/**
+ * @brief 分配内部波形缓冲区 (调用前波形须已停止)
+ */
+static uint16_t* wave_alloc(pwm_channel_t channel, uint32_t samples)
+{
+    uint8_t i;
+
+    if (samples > PWM_WAVE_MAX_SAMPLES) {
+        return NULL;
+    }
+
+    for (i = 0; i < PWM_WAVE_SLOTS; i++) {
+        if (pwm_wave_owner[i] == 0) {
+            pwm_wave_owner[i] = channel + 1;
+            pwm_channels[channel].wave_slot = i;
+            return pwm_wave_pool[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 启动更新事件DMA, 把波形表逐个写入CCR
+ * @note CCR预装载已使能, 每个采样在写入后的下一个更新事件生效, 不会出现半个周期的毛刺
+ */
+static int wave_play(pwm_channel_t channel, const uint16_t *table, uint16_t len, uint8_t loop)
+{
+    pwm_channel_info_t *info = &pwm_channels[channel];
+    const pwm_dma_t *dma = &pwm_up_dma[info->config.timer];
+    uint8_t i;
+
+    /* 定时器不支持, 或同一定时器已有其他通道在播放 */
+    for (i = 0; i < PWM_MAX_CHANNELS; i++) {
+        if (i != channel && pwm_channels[i].is_used && pwm_channels[i].wave_active &&
+            pwm_channels[i].timer == info->timer) {
+            break;
+        }
+    }
+
+    if (dma->stream == NULL || i < PWM_MAX_CHANNELS || pwm_seqs[info->config.timer].active ||
+        bsp_dma_claim(dma->stream, DMA_OWNER_PWM) != 0) {
+        if (info->wave_slot != WAVE_SLOT_NONE) {
+            pwm_wave_owner[info->wave_slot] = 0;
+            info->wave_slot = WAVE_SLOT_NONE;
+        }
+        return -1;
+    }
+
+    dma_stream_config(dma, (uint32_t)get_ccr(channel), table, len, loop);
+
+    DMA_Cmd(dma->stream, ENABLE);
+    TIM_DMACmd(info->timer, TIM_DMA_Update, ENABLE);
+
+    info->wave_active = 1;
+
+    return 0;
+}
+
+/**
+ * @brief 配置定时器更新请求的DMA (存储器到外设, 半字)
+ */
+static void dma_stream_config(const pwm_dma_t *dma, uint32_t periph, const uint16_t *mem,
+                              uint32_t len, uint8_t loop)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+
+    DMA_DeInit(dma->stream);
+    DMA_InitStructure.DMA_Channel = dma->channel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = periph;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)mem;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStructure.DMA_BufferSize = len;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = loop ? DMA_Mode_Circular : DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(dma->stream, &DMA_InitStructure);
+}
+
+/**
+ * @brief 序列DMA中断: 刚播完的一半缓冲区交给回调重新填充
+ */
+static void seq_irq_handler(pwm_timer_t timer)
+{
+    pwm_seq_info_t *seq = &pwm_seqs[timer];
+    const pwm_dma_t *dma = &pwm_up_dma[timer];
+    uint16_t half = seq->frames / 2;
+
+    if (DMA_GetITStatus(dma->stream, dma->it_ht) != RESET) {
+        DMA_ClearITPendingBit(dma->stream, dma->it_ht);
+        if (seq->active && seq->refill != NULL) {
+            seq->refill(seq->buffer, half, seq->user_data);
+        }
+    }
+
+    if (DMA_GetITStatus(dma->stream, dma->it_tc) != RESET) {
+        DMA_ClearITPendingBit(dma->stream, dma->it_tc);
+        if (seq->active && seq->refill != NULL) {
+            seq->refill(seq->buffer + (uint32_t)half * seq->channels, half, seq->user_data);
+        }
+    }
+}
+
+/*=============================================================================
+ *                              中断服务函数
+ *============================================================================*/
+
+#if PWM_SEQ_IRQ_ENABLE
+void DMA1_Stream2_IRQHandler(void)
+{
+    seq_irq_handler(PWM_TIMER_3);
+}
+
+void DMA1_Stream6_IRQHandler(void)
+{
+    seq_irq_handler(PWM_TIMER_4);
+}
+#endif
@@ -11,8 +11,22 @@
  *       - 频率/占空比可调
  *       - 支持互补输出
  *       - 支持死区时间
- *       - 渐变效果
- *       - 呼吸灯效果
+ *       - 渐变与呼吸灯效果: 预先计算伽马校正的波形表, 定时器更新事件触发DMA
+ *         每个PWM周期把一个采样写入CCR, 运行时不占用CPU
+ *       - 支持用户自定义波形表 (可放在Flash中)
+ *       - 多通道同步序列: DMA突发传输 (DCR/DMAR) 在一个更新事件中写入同一定时器的多个CCR,
+ *         各通道同一周期生效; 双缓冲半满/全满中断回调补充后续帧
+ *       - 改频率时预分频和自动重装载都在更新事件生效, 与CCR更新同步
+ *
+ * @note 波形DMA (定时器更新请求): TIM3 DMA1_Stream2,
+ *       TIM4 DMA1_Stream6 (与UART2发送DMA共用, 串口发送未使用DMA);
+ *       TIM1/TIM8的更新请求所在的DMA2_Stream5/Stream1被矩阵键盘占用, 不支持波形;
+ *       TIM2/TIM5的CCR为32位, 半字DMA会写坏高16位, 不支持波形。
+ *       更新请求属于整个定时器, 同一定时器同时只能运行一个波形或一个序列
+ * @note TIM5是系统单调时钟 (bsp_timer), bsp_pwm_init() 拒绝 PWM_TIMER_5
+ * @note 输入捕获 (bsp_capture) 运行时占用TIM2和DMA1_Stream6, TIM2不能输出PWM;
+ *       时间戳模式运行时TIM4的波形/序列启动失败, 反之亦然 (bsp_dma 登记);
+ *       单次波形播完后仍占用DMA流, 调用 bsp_pwm_wave_stop() 释放
  */
 
 #ifndef __BSP_PWM_H
@@ -23,6 +37,8 @@ extern "C" {
 #endif
 
 #include "stm32f4xx.h"
+#include "bsp_pwm_types.h"
+#include "bsp_pwm_gamma.h"
 
 /*=============================================================================
  *                              宏定义配置
@@ -37,6 +53,19 @@ extern "C" {
 /* 默认分辨率 */
 #define PWM_DEFAULT_RESOLUTION  1000    /* 0.1%分辨率 */
 
+/* 内部波形缓冲区 (呼吸灯/渐变) 个数, 即可同时运行的内部效果数 */
+#define PWM_WAVE_SLOTS          1
+
+/* 每个内部波形的最大采样数; 每个PWM周期一个采样, 1kHz时2048个约2s */
+#define PWM_WAVE_MAX_SAMPLES    2048
+
+/* 默认呼吸周期 (ms) */
+#define PWM_BREATH_PERIOD_MS    2000
+
+/* 序列补充帧中断 (DMA1_Stream2/6_IRQHandler), 不用补充回调时可关闭以释放这些中断 */
+#define PWM_SEQ_IRQ_ENABLE      1
+#define PWM_SEQ_IRQ_PRIORITY    2
+
 /*=============================================================================
  *                              预定义通道配置
  *============================================================================*/
@@ -69,11 +98,6 @@ extern "C" {
  *                              类型定义
  *============================================================================*/
 
-/**
- * @brief PWM通道ID
- */
-typedef uint8_t pwm_channel_t;
-
 /**
  * @brief PWM定时器枚举
  */
@@ -82,7 +106,7 @@ typedef enum {
     PWM_TIMER_2,
     PWM_TIMER_3,
     PWM_TIMER_4,
-    PWM_TIMER_5,
+    PWM_TIMER_5,                /**< 系统单调时钟占用, 保留枚举值, 初始化会失败 */
     PWM_TIMER_8,
     PWM_TIMER_COUNT
 } pwm_timer_t;
@@ -117,8 +141,7 @@ typedef struct {
 typedef struct {
     uint16_t min_duty;              /**< 最小占空比 */
     uint16_t max_duty;              /**< 最大占空比 */
-    uint16_t step;                  /**< 步进值 */
-    uint16_t interval_ms;           /**< 步进间隔 (ms) */
+    uint16_t period_ms;             /**< 呼吸周期 (暗→亮→暗, ms) */
 } pwm_breath_param_t;
 
 /*=============================================================================
@@ -128,7 +151,7 @@ typedef struct {
 /**
  * @brief PWM初始化
  * @param config 配置参数
- * @retval 通道ID，失败返回0xFF
+ * @retval 通道ID，失败返回0xFF (含 PWM_TIMER_5)
  */
 pwm_channel_t bsp_pwm_init(const pwm_config_t *config);
 
@@ -174,6 +197,13 @@ int bsp_pwm_set_frequency(pwm_channel_t channel, uint32_t freq);
  */
 uint32_t bsp_pwm_get_frequency(pwm_channel_t channel);
 
+/**
+ * @brief 获取分辨率
+ * @param channel 通道ID
+ * @retval 分辨率 (占空比上限)
+ */
+uint16_t bsp_pwm_get_resolution(pwm_channel_t channel);
+
 /**
  * @brief 启动PWM输出
  * @param channel 通道ID
@@ -187,30 +217,94 @@ void bsp_pwm_start(pwm_channel_t channel);
 void bsp_pwm_stop(pwm_channel_t channel);
 
 /**
- * @brief 渐变到目标占空比
+ * @brief 渐变到目标占空比 (按感知亮度线性变化)
  * @param channel 通道ID
  * @param target_duty 目标占空比
- * @param duration_ms 渐变时间 (ms)
+ * @param duration_ms 渐变时间 (ms), 0为立即设置
+ * @retval 0:成功 -1:失败 (定时器不支持波形、同一定时器已有波形、缓冲区不足或采样数超过上限)
+ * @note 结束后占空比停在目标值
  */
-void bsp_pwm_fade_to(pwm_channel_t channel, uint16_t target_duty, uint32_t duration_ms);
+int bsp_pwm_fade_to(pwm_channel_t channel, uint16_t target_duty, uint32_t duration_ms);
 
 /**
  * @brief 启动呼吸灯效果
  * @param channel 通道ID
- * @param param 呼吸参数 (NULL使用默认)
+ * @param param 呼吸参数 (NULL使用默认: 0~resolution, PWM_BREATH_PERIOD_MS)
+ * @retval 0:成功 -1:失败 (同 bsp_pwm_fade_to)
+ * @note 周期按PWM频率换算成采样数, 不能超过 PWM_WAVE_MAX_SAMPLES
  */
-void bsp_pwm_breath_start(pwm_channel_t channel, const pwm_breath_param_t *param);
+int bsp_pwm_breath_start(pwm_channel_t channel, const pwm_breath_param_t *param);
 
 /**
  * @brief 停止呼吸灯效果
  * @param channel 通道ID
+ * @note 占空比停在当前值
  */
 void bsp_pwm_breath_stop(pwm_channel_t channel);
 
 /**
- * @brief 呼吸灯更新 (主循环调用)
+ * @brief 播放用户波形表
+ * @param channel 通道ID
+ * @param table 占空比采样表, 每个PWM周期一个; 播放期间必须保持有效 (不能放在CCM RAM中)
+ * @param len 采样数 (1~65535)
+ * @param loop 1:循环播放 0:播放一遍后停在最后一个值
+ * @retval 0:成功 -1:失败
+ */
+int bsp_pwm_wave_start(pwm_channel_t channel, const uint16_t *table, uint16_t len, uint8_t loop);
+
+/**
+ * @brief 停止波形 (渐变/呼吸/用户波形)
+ * @param channel 通道ID
+ * @note 占空比停在当前值; bsp_pwm_set_duty() 也会先停止波形
+ */
+void bsp_pwm_wave_stop(pwm_channel_t channel);
+
+/**
+ * @brief 波形是否正在播放
+ * @param channel 通道ID
+ * @retval 1:播放中 0:空闲或单次播放已结束
+ */
+uint8_t bsp_pwm_wave_busy(pwm_channel_t channel);
+
+/**
+ * @brief 启动多通道同步序列
+ * @param first 第一个通道 (已用 bsp_pwm_init 初始化), 序列覆盖同一定时器从它开始的连续通道
+ * @param channels 通道数 (1~4, 不能超过CH4)
+ * @param buffer 帧缓冲区, frames帧, 每帧channels个占空比; 播放期间必须保持有效 (不能放在CCM RAM中)
+ * @param frames 帧数, 每个PWM周期播放一帧
+ * @param refill 补充回调: NULL时循环播放buffer;
+ *               否则启动前先回调填满整个缓冲区, 之后每播完一半回调填充这一半 (frames须为偶数)
+ * @param user_data 回调的用户数据
+ * @retval 0:成功 -1:失败 (定时器不支持、已有波形或序列、参数无效)
+ * @note 其他通道号的CCR也会被写入, 只要不是PWM输出就没有影响;
+ *       播放期间 bsp_pwm_set_duty() 设置的值会被下一帧覆盖
+ */
+int bsp_pwm_seq_start(pwm_channel_t first, uint8_t channels, uint16_t *buffer, uint16_t frames,
+                      pwm_seq_refill_t refill, void *user_data);
+
+/**
+ * @brief 停止序列
+ * @param first 启动时的第一个通道
+ * @note 各通道占空比停在当前值
+ */
+void bsp_pwm_seq_stop(pwm_channel_t first);
+
+/**
+ * @brief 序列是否正在播放
+ * @param first 启动时的第一个通道
+ * @retval 1:播放中 0:空闲
+ */
+uint8_t bsp_pwm_seq_busy(pwm_channel_t first);
+
+/**
+ * @brief 生成一个周期的呼吸波形表
+ * @param table 输出表
+ * @param len 采样数 (>=2), 从暗开始, 第 len/2 个采样最亮
+ * @param min_duty 最小占空比
+ * @param max_duty 最大占空比
+ * @note 感知亮度按平滑三角波 (smoothstep) 变化, 再经伽马校正得到占空比
  */
-void bsp_pwm_breath_update(void);
+void bsp_pwm_breath_table(uint16_t *table, uint16_t len, uint16_t min_duty, uint16_t max_duty);
 
 /**
  * @brief 获取预定义配置
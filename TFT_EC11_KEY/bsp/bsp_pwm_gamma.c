@@ -0,0 +1,83 @@
+/**
+ * @file bsp_pwm_gamma.c
+ * @brief PWM伽马校正实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "bsp_pwm_gamma.h"
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define GAMMA_SEG_SHIFT         10      /* 65536 / PWM_GAMMA_LUT_SEGMENTS */
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+/**
+ * @brief 伽马校正查找表 (Q16)
+ * 由 tools/gen_gamma_lut.py 生成, 修改gamma后请重新生成, 不要手工编辑
+ */
+/* gamma = 2.20 */
+static const uint32_t pwm_gamma_lut[PWM_GAMMA_LUT_SEGMENTS + 1] = {
+        0,     7,    32,    78,   147,   240,   359,   504,
+      676,   875,  1104,  1361,  1648,  1966,  2314,  2693,
+     3104,  3547,  4022,  4530,  5072,  5646,  6255,  6897,
+     7574,  8286,  9033,  9815, 10632, 11486, 12375, 13301,
+    14263, 15262, 16298, 17371, 18482, 19630, 20817, 22041,
+    23303, 24604, 25944, 27322, 28740, 30196, 31692, 33228,
+    34803, 36418, 38073, 39768, 41504, 43280, 45097, 46955,
+    48854, 50794, 52775, 54797, 56861, 58967, 61115, 63304,
+    65536,
+};
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 伽马校正
+ */
+uint32_t bsp_pwm_gamma(uint32_t level)
+{
+    uint32_t idx, frac;
+
+    if (level >= 65536) {
+        return 65536;
+    }
+
+    idx = level >> GAMMA_SEG_SHIFT;
+    frac = level & ((1UL << GAMMA_SEG_SHIFT) - 1);
+
+    return pwm_gamma_lut[idx] +
+           (((pwm_gamma_lut[idx + 1] - pwm_gamma_lut[idx]) * frac) >> GAMMA_SEG_SHIFT);
+}
+
+/**
+ * @brief 伽马反变换
+ */
+uint32_t bsp_pwm_gamma_inverse(uint32_t duty)
+{
+    uint32_t lo = 0, hi = PWM_GAMMA_LUT_SEGMENTS;
+
+    if (duty >= 65536) {
+        return 65536;
+    }
+
+    /* 二分查找 lut[lo] <= duty < lut[lo+1] */
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+        if (pwm_gamma_lut[mid] <= duty) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return (lo << GAMMA_SEG_SHIFT) +
+           ((duty - pwm_gamma_lut[lo]) << GAMMA_SEG_SHIFT) / (pwm_gamma_lut[hi] - pwm_gamma_lut[lo]);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file bsp_pwm_gamma.h
+ * @brief PWM伽马校正 - 感知亮度与占空比互换
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - Q16定点, 查找表分段线性插值, 不用浮点
+ *       - 不依赖标准库, 与 tools/pwm_pattern.py 的仿真逐位一致, 可在PC上编译对照
+ *       - 查找表由 tools/gen_gamma_lut.py 生成
+ */
+
+#ifndef __BSP_PWM_GAMMA_H
+#define __BSP_PWM_GAMMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 伽马查找表段数 (与 tools/gen_gamma_lut.py 一致) */
+#define PWM_GAMMA_LUT_SEGMENTS  64
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 伽马校正
+ * @param level 感知亮度 (Q16, 65536为1.0)
+ * @retval 占空比比例 (Q16)
+ */
+uint32_t bsp_pwm_gamma(uint32_t level);
+
+/**
+ * @brief 伽马反变换
+ * @param duty 占空比比例 (Q16)
+ * @retval 感知亮度 (Q16)
+ */
+uint32_t bsp_pwm_gamma_inverse(uint32_t duty);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_PWM_GAMMA_H */
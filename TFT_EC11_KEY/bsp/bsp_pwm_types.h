@@ -0,0 +1,39 @@
+/**
+ * @file bsp_pwm_types.h
+ * @brief PWM驱动的公共类型 - 不依赖标准库, 中间件和PC工具可直接包含
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#ifndef __BSP_PWM_TYPES_H
+#define __BSP_PWM_TYPES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief PWM通道ID
+ */
+typedef uint8_t pwm_channel_t;
+
+/**
+ * @brief 序列补充回调 (在DMA中断中调用)
+ * @param frames 需要重新填充的帧, 每帧依次为各通道占空比
+ * @param count 帧数 (缓冲区帧数的一半)
+ * @param user_data 启动时传入的用户数据
+ */
+typedef void (*pwm_seq_refill_t)(uint16_t *frames, uint16_t count, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_PWM_TYPES_H */
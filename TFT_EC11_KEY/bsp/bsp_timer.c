@@ -7,37 +7,16 @@
  */
 
 #include "bsp_timer.h"
-#include <string.h>
 
 /*=============================================================================
  *                              私有变量
  *============================================================================*/
 
-static volatile uint32_t timestamp_ms = 0;
-static volatile uint32_t timestamp_us_base = 0;
+/* 单调时钟高32位 (溢出次数), 只在溢出中断中修改 */
+static volatile uint32_t clock_hi = 0;
 
-static timer_callback_t periodic_callback = NULL;
-
-/* 单次定时器 */
-typedef struct {
-    uint8_t active;
-    uint32_t expire_tick;
-    timer_callback_t callback;
-} oneshot_timer_t;
-
-static oneshot_timer_t oneshot_timers[TIMER_CHANNEL_MAX] = {0};
-
-/* 超时检测 */
-#define MAX_TIMEOUT_COUNT   8
-
-typedef struct {
-    uint8_t active;
-    uint32_t timeout_ms;
-    uint32_t last_feed_tick;
-    timeout_callback_t callback;
-} timeout_entry_t;
-
-static timeout_entry_t timeout_entries[MAX_TIMEOUT_COUNT] = {0};
+static timer_isr_callback_t periodic_callback = NULL;
+static timer_isr_callback_t alarm_callback = NULL;
 
 /* 时间测量 */
 static uint32_t measure_start_us = 0;
@@ -52,44 +31,39 @@ static uint32_t measure_start_us = 0;
 void bsp_timer_init(void)
 {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
     NVIC_InitTypeDef NVIC_InitStructure;
 
-    /* 初始化时间戳定时器 TIM6 */
-    RCC_APB1PeriphClockCmd(TIMER_TIMESTAMP_CLK, ENABLE);
+    /* 初始化单调时钟 TIM5: 32位自由运行, 溢出中断扩展高32位 */
+    RCC_APB1PeriphClockCmd(TIMER_CLOCK_CLK, ENABLE);
 
-    /* 1ms中断 */
-    TIM_TimeBaseStructure.TIM_Period = 1000 - 1;
+    TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFF;
     TIM_TimeBaseStructure.TIM_Prescaler = 84 - 1;  /* 84MHz / 84 = 1MHz */
     TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
     TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_TimeBaseInit(TIMER_TIMESTAMP_TIM, &TIM_TimeBaseStructure);
+    TIM_TimeBaseInit(TIMER_CLOCK_TIM, &TIM_TimeBaseStructure);
 
-    TIM_ITConfig(TIMER_TIMESTAMP_TIM, TIM_IT_Update, ENABLE);
+    /* CC1用作闹钟: 冻结模式不驱动引脚, 关闭预装载使比较值立即生效 */
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OC1Init(TIMER_CLOCK_TIM, &TIM_OCInitStructure);
+    TIM_OC1PreloadConfig(TIMER_CLOCK_TIM, TIM_OCPreload_Disable);
 
-    NVIC_InitStructure.NVIC_IRQChannel = TIMER_TIMESTAMP_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    /* TIM_TimeBaseInit产生的更新事件会置位UIF, 不能当成一次溢出 */
+    TIM_ClearFlag(TIMER_CLOCK_TIM, TIM_FLAG_Update);
+    clock_hi = 0;
+
+    TIM_ITConfig(TIMER_CLOCK_TIM, TIM_IT_Update, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = TIMER_CLOCK_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = TIMER_CLOCK_IRQ_PRIORITY;
     NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
 
-    TIM_Cmd(TIMER_TIMESTAMP_TIM, ENABLE);
-
-    /* 初始化微秒定时器 TIM7 */
-    RCC_APB1PeriphClockCmd(TIMER_US_CLK, ENABLE);
-
-    TIM_TimeBaseStructure.TIM_Period = 0xFFFF;
-    TIM_TimeBaseStructure.TIM_Prescaler = 84 - 1;  /* 1MHz, 1us精度 */
-    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
-    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_TimeBaseInit(TIMER_US_TIM, &TIM_TimeBaseStructure);
-
-    TIM_Cmd(TIMER_US_TIM, ENABLE);
+    TIM_Cmd(TIMER_CLOCK_TIM, ENABLE);
 
-    /* 清空状态 */
-    timestamp_ms = 0;
-    timestamp_us_base = 0;
-    memset(oneshot_timers, 0, sizeof(oneshot_timers));
-    memset(timeout_entries, 0, sizeof(timeout_entries));
+    alarm_callback = NULL;
 }
 
 /**
@@ -97,10 +71,33 @@ void bsp_timer_init(void)
  */
 void bsp_timer_deinit(void)
 {
-    TIM_Cmd(TIMER_TIMESTAMP_TIM, DISABLE);
-    TIM_Cmd(TIMER_US_TIM, DISABLE);
-    TIM_DeInit(TIMER_TIMESTAMP_TIM);
-    TIM_DeInit(TIMER_US_TIM);
+    TIM_Cmd(TIMER_CLOCK_TIM, DISABLE);
+    TIM_ITConfig(TIMER_CLOCK_TIM, TIM_IT_Update | TIM_IT_CC1, DISABLE);
+    TIM_DeInit(TIMER_CLOCK_TIM);
+}
+
+/**
+ * @brief 获取64位单调时间 (us)
+ * @note 前后两次读到的高位相同, 说明读计数器和状态寄存器期间溢出中断没有执行;
+ *       此时UIF置位且计数器在前半程, 表示计数器已回绕而中断还没来得及处理
+ *       (关中断或在同级中断中读取), 高位补1. 溢出中断是最高优先级,
+ *       中断内"清UIF、高位加1"两步不会被读取方看到中间状态
+ */
+uint64_t bsp_timer_get_us64(void)
+{
+    uint32_t hi, lo, sr;
+
+    do {
+        hi = clock_hi;
+        lo = TIMER_CLOCK_TIM->CNT;
+        sr = TIMER_CLOCK_TIM->SR;
+    } while (hi != clock_hi);
+
+    if ((sr & TIM_SR_UIF) && lo < 0x80000000UL) {
+        hi++;
+    }
+
+    return ((uint64_t)hi << 32) | lo;
 }
 
 /**
@@ -108,7 +105,7 @@ void bsp_timer_deinit(void)
  */
 uint32_t bsp_timer_get_ms(void)
 {
-    return timestamp_ms;
+    return (uint32_t)(bsp_timer_get_us64() / 1000);
 }
 
 /**
@@ -116,19 +113,26 @@ uint32_t bsp_timer_get_ms(void)
  */
 uint32_t bsp_timer_get_us(void)
 {
-    uint32_t ms = timestamp_ms;
-    uint16_t us = TIM_GetCounter(TIMER_US_TIM);
-    return ms * 1000 + us;
+    return (uint32_t)bsp_timer_get_us64();
 }
 
 /**
- * @brief 时间戳中断处理
+ * @brief 时钟中断处理
+ * @note 先处理溢出, 闹钟回调里读到的时间已包含本次溢出
  */
 void bsp_timer_timestamp_isr(void)
 {
-    if (TIM_GetITStatus(TIMER_TIMESTAMP_TIM, TIM_IT_Update) != RESET) {
-        TIM_ClearITPendingBit(TIMER_TIMESTAMP_TIM, TIM_IT_Update);
-        timestamp_ms++;
+    if (TIM_GetITStatus(TIMER_CLOCK_TIM, TIM_IT_Update) != RESET) {
+        TIM_ClearITPendingBit(TIMER_CLOCK_TIM, TIM_IT_Update);
+        clock_hi++;
+    }
+
+    if (TIM_GetITStatus(TIMER_CLOCK_TIM, TIM_IT_CC1) != RESET) {
+        TIM_ClearITPendingBit(TIMER_CLOCK_TIM, TIM_IT_CC1);
+
+        if (alarm_callback != NULL) {
+            alarm_callback();
+        }
     }
 }
 
@@ -137,23 +141,9 @@ void bsp_timer_timestamp_isr(void)
  */
 void bsp_timer_delay_us(uint32_t us)
 {
-    uint32_t start = TIM_GetCounter(TIMER_US_TIM);
-    uint32_t target;
-
-    while (us > 0) {
-        uint32_t delay = (us > 60000) ? 60000 : us;
-        target = (start + delay) % 65536;
-
-        if (target > start) {
-            while (TIM_GetCounter(TIMER_US_TIM) < target);
-        } else {
-            while (TIM_GetCounter(TIMER_US_TIM) >= start);
-            while (TIM_GetCounter(TIMER_US_TIM) < target);
-        }
+    uint64_t start = bsp_timer_get_us64();
 
-        us -= delay;
-        start = target;
-    }
+    while ((bsp_timer_get_us64() - start) < us);
 }
 
 /**
@@ -161,14 +151,15 @@ void bsp_timer_delay_us(uint32_t us)
  */
 void bsp_timer_delay_ms(uint32_t ms)
 {
-    uint32_t start = timestamp_ms;
-    while ((timestamp_ms - start) < ms);
+    uint64_t start = bsp_timer_get_us64();
+
+    while ((bsp_timer_get_us64() - start) < (uint64_t)ms * 1000);
 }
 
 /**
  * @brief 启动周期定时器
  */
-int bsp_timer_start_periodic(uint32_t period_us, timer_callback_t callback)
+int bsp_timer_start_periodic(uint32_t period_us, timer_isr_callback_t callback)
 {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
     NVIC_InitTypeDef NVIC_InitStructure;
@@ -251,112 +242,31 @@ void bsp_timer_periodic_isr(void)
 }
 
 /**
- * @brief 启动单次定时器
+ * @brief 设置闹钟回调
  */
-int bsp_timer_start_oneshot(timer_channel_t channel, uint32_t delay_ms, timer_callback_t callback)
+void bsp_timer_alarm_set_callback(timer_isr_callback_t callback)
 {
-    if (channel >= TIMER_CHANNEL_MAX || callback == NULL) {
-        return -1;
-    }
-
-    oneshot_timers[channel].active = 1;
-    oneshot_timers[channel].expire_tick = timestamp_ms + delay_ms;
-    oneshot_timers[channel].callback = callback;
-
-    return 0;
+    alarm_callback = callback;
 }
 
 /**
- * @brief 取消单次定时器
+ * @brief 设置闹钟
+ * @note 先写比较值再清标志, 两者之间的匹配会被清掉, 所以最后再比较一次时间,
+ *       已过则软件产生CC1事件
  */
-void bsp_timer_cancel_oneshot(timer_channel_t channel)
+void bsp_timer_alarm_set(uint64_t at_us)
 {
-    if (channel >= TIMER_CHANNEL_MAX) {
+    if (at_us == TIMER_ALARM_NEVER) {
+        TIM_ITConfig(TIMER_CLOCK_TIM, TIM_IT_CC1, DISABLE);
         return;
     }
 
-    oneshot_timers[channel].active = 0;
-}
+    TIM_SetCompare1(TIMER_CLOCK_TIM, (uint32_t)at_us);
+    TIM_ClearITPendingBit(TIMER_CLOCK_TIM, TIM_IT_CC1);
+    TIM_ITConfig(TIMER_CLOCK_TIM, TIM_IT_CC1, ENABLE);
 
-/**
- * @brief 单次定时器检查
- */
-void bsp_timer_oneshot_process(void)
-{
-    uint8_t i;
-    uint32_t current_tick = timestamp_ms;
-
-    for (i = 0; i < TIMER_CHANNEL_MAX; i++) {
-        if (oneshot_timers[i].active) {
-            if ((int32_t)(current_tick - oneshot_timers[i].expire_tick) >= 0) {
-                oneshot_timers[i].active = 0;
-                if (oneshot_timers[i].callback != NULL) {
-                    oneshot_timers[i].callback();
-                }
-            }
-        }
-    }
-}
-
-/**
- * @brief 启动超时检测
- */
-int bsp_timer_timeout_start(uint8_t id, uint32_t timeout_ms, timeout_callback_t callback)
-{
-    if (id >= MAX_TIMEOUT_COUNT || callback == NULL) {
-        return -1;
-    }
-
-    timeout_entries[id].active = 1;
-    timeout_entries[id].timeout_ms = timeout_ms;
-    timeout_entries[id].last_feed_tick = timestamp_ms;
-    timeout_entries[id].callback = callback;
-
-    return 0;
-}
-
-/**
- * @brief 喂狗
- */
-void bsp_timer_timeout_feed(uint8_t id)
-{
-    if (id >= MAX_TIMEOUT_COUNT) {
-        return;
-    }
-
-    timeout_entries[id].last_feed_tick = timestamp_ms;
-}
-
-/**
- * @brief 停止超时检测
- */
-void bsp_timer_timeout_stop(uint8_t id)
-{
-    if (id >= MAX_TIMEOUT_COUNT) {
-        return;
-    }
-
-    timeout_entries[id].active = 0;
-}
-
-/**
- * @brief 超时检测处理
- */
-void bsp_timer_timeout_process(void)
-{
-    uint8_t i;
-    uint32_t current_tick = timestamp_ms;
-
-    for (i = 0; i < MAX_TIMEOUT_COUNT; i++) {
-        if (timeout_entries[i].active) {
-            if ((current_tick - timeout_entries[i].last_feed_tick) >= timeout_entries[i].timeout_ms) {
-                if (timeout_entries[i].callback != NULL) {
-                    timeout_entries[i].callback(i);
-                }
-                /* 重置 */
-                timeout_entries[i].last_feed_tick = current_tick;
-            }
-        }
+    if (bsp_timer_get_us64() >= at_us) {
+        TIM_GenerateEvent(TIMER_CLOCK_TIM, TIM_EventSource_CC1);
     }
 }
 
@@ -381,7 +291,7 @@ uint32_t bsp_timer_measure_stop(void)
  */
 uint32_t bsp_timer_get_uptime_sec(void)
 {
-    return timestamp_ms / 1000;
+    return (uint32_t)(bsp_timer_get_us64() / 1000000);
 }
 
 /**
@@ -389,7 +299,7 @@ uint32_t bsp_timer_get_uptime_sec(void)
  */
 void bsp_timer_get_uptime(uint32_t *hours, uint32_t *minutes, uint32_t *seconds)
 {
-    uint32_t total_sec = timestamp_ms / 1000;
+    uint32_t total_sec = bsp_timer_get_uptime_sec();
 
     if (hours) *hours = total_sec / 3600;
     if (minutes) *minutes = (total_sec % 3600) / 60;
@@ -400,12 +310,12 @@ void bsp_timer_get_uptime(uint32_t *hours, uint32_t *minutes, uint32_t *seconds)
  *                              中断服务函数
  *============================================================================*/
 
-void TIM6_DAC_IRQHandler(void)
+void TIM5_IRQHandler(void)
 {
     bsp_timer_timestamp_isr();
 }
 
-void TIM2_IRQHandler(void)
+void TIM7_IRQHandler(void)
 {
     bsp_timer_periodic_isr();
 }
@@ -8,10 +8,11 @@
  * @note 硬件平台: STM32F407VGT6
  * @note 功能特性:
  *       - 基本定时中断
+ *       - 64位单调微秒时钟: TIM5 32位计数器 + 溢出中断扩展高32位, 读取无锁
  *       - 微秒级精确延时
- *       - 时间戳功能
- *       - 输入捕获
- *       - 超时检测
+ *       - 时间戳功能 (毫秒/微秒均由同一时钟派生)
+ *       - 硬件比较闹钟: TIM5 CC1 在指定的64位时间触发中断, 供 middleware/timer_service 使用
+ *         (单次定时、超时检测用定时服务实现)
  */
 
 #ifndef __BSP_TIMER_H
@@ -30,45 +31,34 @@ extern "C" {
 /* 系统时钟频率 */
 #define TIMER_SYSCLK_MHZ        168
 
-/* 基本定时器配置 (用于时间戳) */
-#define TIMER_TIMESTAMP_TIM     TIM6
-#define TIMER_TIMESTAMP_CLK     RCC_APB1Periph_TIM6
-#define TIMER_TIMESTAMP_IRQn    TIM6_DAC_IRQn
+/* 单调时钟配置 (32位定时器, 1MHz自由运行, 约71.6分钟溢出一次) */
+#define TIMER_CLOCK_TIM         TIM5
+#define TIMER_CLOCK_CLK         RCC_APB1Periph_TIM5
+#define TIMER_CLOCK_IRQn        TIM5_IRQn
 
-/* 微秒定时器配置 */
-#define TIMER_US_TIM            TIM7
-#define TIMER_US_CLK            RCC_APB1Periph_TIM7
+/**
+ * @brief 时钟溢出中断抢占优先级
+ * @note 必须是系统中最高的 (0): 其他中断无法打断溢出处理, 读取时才能把
+ *       "计数器已回绕但中断未处理" 与 "中断已处理" 区分开
+ */
+#define TIMER_CLOCK_IRQ_PRIORITY    0
 
-/* 周期定时器配置 */
-#define TIMER_PERIODIC_TIM      TIM2
-#define TIMER_PERIODIC_CLK      RCC_APB1Periph_TIM2
-#define TIMER_PERIODIC_IRQn     TIM2_IRQn
+/* 关闭闹钟 */
+#define TIMER_ALARM_NEVER       0xFFFFFFFFFFFFFFFFULL
+
+/* 周期定时器配置 (基本定时器TIM7, 不与输入捕获和PWM冲突) */
+#define TIMER_PERIODIC_TIM      TIM7
+#define TIMER_PERIODIC_CLK      RCC_APB1Periph_TIM7
+#define TIMER_PERIODIC_IRQn     TIM7_IRQn
 
 /*=============================================================================
  *                              类型定义
  *============================================================================*/
 
 /**
- * @brief 定时器回调函数类型
- */
-typedef void (*timer_callback_t)(void);
-
-/**
- * @brief 超时回调函数类型
- * @param id 超时ID
- */
-typedef void (*timeout_callback_t)(uint8_t id);
-
-/**
- * @brief 定时器通道
+ * @brief 定时器中断回调函数类型 (周期定时器、闹钟)
  */
-typedef enum {
-    TIMER_CHANNEL_0 = 0,
-    TIMER_CHANNEL_1,
-    TIMER_CHANNEL_2,
-    TIMER_CHANNEL_3,
-    TIMER_CHANNEL_MAX
-} timer_channel_t;
+typedef void (*timer_isr_callback_t)(void);
 
 /*=============================================================================
  *                              函数声明
@@ -89,20 +79,28 @@ void bsp_timer_deinit(void);
 
 /*----------------------- 时间戳函数 -----------------------*/
 
+/**
+ * @brief 获取64位单调时间 (us)
+ * @retval 上电以来的微秒数, 不回绕
+ * @note 无锁, 可在任意上下文 (包括关中断和任意优先级的中断) 中调用;
+ *       关中断期间只能正确跨越一次溢出, 关中断不能超过约35分钟
+ */
+uint64_t bsp_timer_get_us64(void);
+
 /**
  * @brief 获取当前时间戳 (ms)
- * @retval 时间戳 (ms)
+ * @retval 时间戳 (ms), 约49.7天回绕
  */
 uint32_t bsp_timer_get_ms(void);
 
 /**
  * @brief 获取当前时间戳 (us)
- * @retval 时间戳 (us)
+ * @retval 64位时间的低32位, 约71.6分钟回绕, 求差值时用无符号减法
  */
 uint32_t bsp_timer_get_us(void);
 
 /**
- * @brief 时间戳中断处理 (在TIM6中断中调用)
+ * @brief 时钟中断处理: 溢出和闹钟比较 (在TIM5中断中调用)
  */
 void bsp_timer_timestamp_isr(void);
 
@@ -128,7 +126,7 @@ void bsp_timer_delay_ms(uint32_t ms);
  * @param callback 回调函数
  * @retval 0:成功 -1:失败
  */
-int bsp_timer_start_periodic(uint32_t period_us, timer_callback_t callback);
+int bsp_timer_start_periodic(uint32_t period_us, timer_isr_callback_t callback);
 
 /**
  * @brief 停止周期定时器
@@ -142,59 +140,25 @@ void bsp_timer_stop_periodic(void);
 void bsp_timer_set_periodic_period(uint32_t period_us);
 
 /**
- * @brief 周期定时器中断处理 (在TIM2中断中调用)
+ * @brief 周期定时器中断处理 (在TIM7中断中调用)
  */
 void bsp_timer_periodic_isr(void);
 
-/*----------------------- 单次定时器 -----------------------*/
-
-/**
- * @brief 启动单次定时器
- * @param channel 通道
- * @param delay_ms 延时 (ms)
- * @param callback 回调函数
- * @retval 0:成功 -1:失败
- */
-int bsp_timer_start_oneshot(timer_channel_t channel, uint32_t delay_ms, timer_callback_t callback);
-
-/**
- * @brief 取消单次定时器
- * @param channel 通道
- */
-void bsp_timer_cancel_oneshot(timer_channel_t channel);
-
-/**
- * @brief 单次定时器检查 (主循环调用)
- */
-void bsp_timer_oneshot_process(void);
-
-/*----------------------- 超时检测 -----------------------*/
-
-/**
- * @brief 启动超时检测
- * @param id 超时ID (0~7)
- * @param timeout_ms 超时时间 (ms)
- * @param callback 超时回调
- * @retval 0:成功 -1:失败
- */
-int bsp_timer_timeout_start(uint8_t id, uint32_t timeout_ms, timeout_callback_t callback);
-
-/**
- * @brief 喂狗 (重置超时)
- * @param id 超时ID
- */
-void bsp_timer_timeout_feed(uint8_t id);
+/*----------------------- 闹钟 -----------------------*/
 
 /**
- * @brief 停止超时检测
- * @param id 超时ID
+ * @brief 设置闹钟回调
+ * @param callback 到时在TIM5中断 (最高优先级) 中调用
  */
-void bsp_timer_timeout_stop(uint8_t id);
+void bsp_timer_alarm_set_callback(timer_isr_callback_t callback);
 
 /**
- * @brief 超时检测处理 (主循环调用)
+ * @brief 设置闹钟
+ * @param at_us 触发时间 (bsp_timer_get_us64() 的时间), TIMER_ALARM_NEVER 关闭
+ * @note 时间已过时立即触发; 比较只用低32位, 超过约71.6分钟的闹钟会提前触发,
+ *       回调需检查时间并重新设置
  */
-void bsp_timer_timeout_process(void);
+void bsp_timer_alarm_set(uint64_t at_us);
 
 /*----------------------- 时间测量 -----------------------*/
 
@@ -19,6 +19,7 @@ typedef struct {
     uint8_t buffer[BSP_UART_RX_BUF_SIZE];
     volatile uint16_t head;
     volatile uint16_t tail;
+    uint16_t notify;            /* DMA模式: 已回调通知到的位置 */
 } ring_buffer_t;
 
 /*=============================================================================
@@ -31,6 +32,7 @@ static uint8_t uart1_tx_buf[BSP_UART_TX_BUF_SIZE];
 static volatile uint8_t uart1_tx_busy = 0;
 static uart_rx_callback_t uart1_rx_cb = NULL;
 static uart_tx_callback_t uart1_tx_cb = NULL;
+static uint8_t uart1_rx_dma = 0;
 #endif
 
 #if BSP_UART2_ENABLE
@@ -39,6 +41,7 @@ static uint8_t uart2_tx_buf[BSP_UART_TX_BUF_SIZE];
 static volatile uint8_t uart2_tx_busy = 0;
 static uart_rx_callback_t uart2_rx_cb = NULL;
 static uart_tx_callback_t uart2_tx_cb = NULL;
+static uint8_t uart2_rx_dma = 0;
 #endif
 
 static const USART_TypeDef* uart_instances[] = {
@@ -55,6 +58,16 @@ static void ring_buffer_put(ring_buffer_t *rb, uint8_t data);
 static int ring_buffer_get(ring_buffer_t *rb, uint8_t *data);
 static uint16_t ring_buffer_count(ring_buffer_t *rb);
 static void ring_buffer_flush(ring_buffer_t *rb);
+#if BSP_UART_USE_DMA
+static void uart_rx_dma_init(USART_TypeDef *uart, DMA_Stream_TypeDef *stream,
+                             uint32_t channel, uint32_t dma_clk,
+                             IRQn_Type dma_irq, ring_buffer_t *rb);
+static void uart_rx_dma_sync(ring_buffer_t *rb, DMA_Stream_TypeDef *stream);
+static void uart_rx_dma_notify(uart_port_t port, ring_buffer_t *rb,
+                               DMA_Stream_TypeDef *stream, uart_rx_callback_t cb);
+static void uart_tx_dma_init(USART_TypeDef *uart, DMA_Stream_TypeDef *stream,
+                             uint32_t channel, uint32_t dma_clk, uint8_t *buf);
+#endif
 
 /*=============================================================================
  *                              公共函数实现
@@ -108,8 +121,27 @@ int bsp_uart_init(uart_port_t port, const uart_config_t *config)
         USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
         USART_Init(USART1, &USART_InitStructure);
 
-        /* 使能接收中断 */
-        USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+        /* 清空缓冲区 */
+        ring_buffer_flush(&uart1_rx_buf);
+        uart1_tx_busy = 0;
+
+#if BSP_UART_USE_DMA
+        /* 发送DMA (单次模式, 由bsp_uart_send_dma启动) */
+        uart_tx_dma_init(USART1, UART1_TX_DMA_STREAM, UART1_TX_DMA_CHANNEL,
+                         UART1_RX_DMA_CLK, uart1_tx_buf);
+
+        uart1_rx_dma = cfg.use_dma;
+        if (uart1_rx_dma) {
+            /* 循环DMA接收, 空闲中断通知 */
+            uart_rx_dma_init(USART1, UART1_RX_DMA_STREAM, UART1_RX_DMA_CHANNEL,
+                             UART1_RX_DMA_CLK, UART1_RX_DMA_IRQn, &uart1_rx_buf);
+            USART_ITConfig(USART1, USART_IT_IDLE, ENABLE);
+        } else
+#endif
+        {
+            /* 使能接收中断 */
+            USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+        }
 
         /* NVIC配置 */
         NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
@@ -120,10 +152,6 @@ int bsp_uart_init(uart_port_t port, const uart_config_t *config)
 
         /* 使能USART */
         USART_Cmd(USART1, ENABLE);
-
-        /* 清空缓冲区 */
-        ring_buffer_flush(&uart1_rx_buf);
-        uart1_tx_busy = 0;
         break;
 #endif
 
@@ -144,8 +172,23 @@ int bsp_uart_init(uart_port_t port, const uart_config_t *config)
         USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
         USART_Init(USART2, &USART_InitStructure);
 
-        /* 使能接收中断 */
-        USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);
+        /* 清空缓冲区 */
+        ring_buffer_flush(&uart2_rx_buf);
+        uart2_tx_busy = 0;
+
+#if BSP_UART_USE_DMA
+        uart2_rx_dma = cfg.use_dma;
+        if (uart2_rx_dma) {
+            /* 循环DMA接收, 空闲中断通知 */
+            uart_rx_dma_init(USART2, UART2_RX_DMA_STREAM, UART2_RX_DMA_CHANNEL,
+                             UART2_RX_DMA_CLK, UART2_RX_DMA_IRQn, &uart2_rx_buf);
+            USART_ITConfig(USART2, USART_IT_IDLE, ENABLE);
+        } else
+#endif
+        {
+            /* 使能接收中断 */
+            USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);
+        }
 
         /* NVIC配置 */
         NVIC_InitStructure.NVIC_IRQChannel = USART2_IRQn;
@@ -156,10 +199,6 @@ int bsp_uart_init(uart_port_t port, const uart_config_t *config)
 
         /* 使能USART */
         USART_Cmd(USART2, ENABLE);
-
-        /* 清空缓冲区 */
-        ring_buffer_flush(&uart2_rx_buf);
-        uart2_tx_busy = 0;
         break;
 #endif
 
@@ -179,12 +218,27 @@ void bsp_uart_deinit(uart_port_t port)
 #if BSP_UART1_ENABLE
     case UART_PORT_1:
         USART_Cmd(USART1, DISABLE);
+#if BSP_UART_USE_DMA
+        DMA_Cmd(UART1_TX_DMA_STREAM, DISABLE);
+        USART_DMACmd(USART1, USART_DMAReq_Tx, DISABLE);
+        uart1_tx_busy = 0;
+        if (uart1_rx_dma) {
+            DMA_Cmd(UART1_RX_DMA_STREAM, DISABLE);
+            USART_DMACmd(USART1, USART_DMAReq_Rx, DISABLE);
+        }
+#endif
         USART_DeInit(USART1);
         break;
 #endif
 #if BSP_UART2_ENABLE
     case UART_PORT_2:
         USART_Cmd(USART2, DISABLE);
+#if BSP_UART_USE_DMA
+        if (uart2_rx_dma) {
+            DMA_Cmd(UART2_RX_DMA_STREAM, DISABLE);
+            USART_DMACmd(USART2, USART_DMAReq_Rx, DISABLE);
+        }
+#endif
         USART_DeInit(USART2);
         break;
 #endif
@@ -253,6 +307,38 @@ void bsp_uart_printf(uart_port_t port, const char *fmt, ...)
     bsp_uart_send_string(port, buf);
 }
 
+/**
+ * @brief DMA发送
+ */
+int bsp_uart_send_dma(uart_port_t port, const uint8_t *data, uint16_t len)
+{
+    switch (port) {
+#if BSP_UART1_ENABLE && BSP_UART_USE_DMA
+    case UART_PORT_1:
+        if (uart1_tx_busy || len == 0 || len > BSP_UART_TX_BUF_SIZE) {
+            return -1;
+        }
+
+        uart1_tx_busy = 1;
+        memcpy(uart1_tx_buf, data, len);
+
+        /* 单次模式每次传输后流自动关闭, 只需重装计数并清标志 */
+        DMA_ClearFlag(UART1_TX_DMA_STREAM, UART1_TX_DMA_FLAGS);
+        DMA_SetCurrDataCounter(UART1_TX_DMA_STREAM, len);
+
+        /* 最后一个字节移出后TC中断清除忙标志 */
+        USART_ClearITPendingBit(USART1, USART_IT_TC);
+        USART_ITConfig(USART1, USART_IT_TC, ENABLE);
+        DMA_Cmd(UART1_TX_DMA_STREAM, ENABLE);
+        return 0;
+#endif
+    default:
+        (void)data;
+        (void)len;
+        return -1;
+    }
+}
+
 /**
  * @brief 接收单字节
  */
@@ -261,10 +347,20 @@ int bsp_uart_receive_byte(uart_port_t port, uint8_t *data)
     switch (port) {
 #if BSP_UART1_ENABLE
     case UART_PORT_1:
+#if BSP_UART_USE_DMA
+        if (uart1_rx_dma) {
+            uart_rx_dma_sync(&uart1_rx_buf, UART1_RX_DMA_STREAM);
+        }
+#endif
         return ring_buffer_get(&uart1_rx_buf, data);
 #endif
 #if BSP_UART2_ENABLE
     case UART_PORT_2:
+#if BSP_UART_USE_DMA
+        if (uart2_rx_dma) {
+            uart_rx_dma_sync(&uart2_rx_buf, UART2_RX_DMA_STREAM);
+        }
+#endif
         return ring_buffer_get(&uart2_rx_buf, data);
 #endif
     default:
@@ -298,10 +394,20 @@ uint16_t bsp_uart_get_rx_count(uart_port_t port)
     switch (port) {
 #if BSP_UART1_ENABLE
     case UART_PORT_1:
+#if BSP_UART_USE_DMA
+        if (uart1_rx_dma) {
+            uart_rx_dma_sync(&uart1_rx_buf, UART1_RX_DMA_STREAM);
+        }
+#endif
         return ring_buffer_count(&uart1_rx_buf);
 #endif
 #if BSP_UART2_ENABLE
     case UART_PORT_2:
+#if BSP_UART_USE_DMA
+        if (uart2_rx_dma) {
+            uart_rx_dma_sync(&uart2_rx_buf, UART2_RX_DMA_STREAM);
+        }
+#endif
         return ring_buffer_count(&uart2_rx_buf);
 #endif
     default:
@@ -317,11 +423,27 @@ void bsp_uart_flush_rx(uart_port_t port)
     switch (port) {
 #if BSP_UART1_ENABLE
     case UART_PORT_1:
+#if BSP_UART_USE_DMA
+        if (uart1_rx_dma) {
+            /* DMA写位置不可复位, 丢弃已收到的数据即可 */
+            uart_rx_dma_sync(&uart1_rx_buf, UART1_RX_DMA_STREAM);
+            uart1_rx_buf.tail = uart1_rx_buf.head;
+            break;
+        }
+#endif
         ring_buffer_flush(&uart1_rx_buf);
         break;
 #endif
 #if BSP_UART2_ENABLE
     case UART_PORT_2:
+#if BSP_UART_USE_DMA
+        if (uart2_rx_dma) {
+            /* DMA写位置不可复位, 丢弃已收到的数据即可 */
+            uart_rx_dma_sync(&uart2_rx_buf, UART2_RX_DMA_STREAM);
+            uart2_rx_buf.tail = uart2_rx_buf.head;
+            break;
+        }
+#endif
         ring_buffer_flush(&uart2_rx_buf);
         break;
 #endif
@@ -351,6 +473,67 @@ void bsp_uart_set_rx_callback(uart_port_t port, uart_rx_callback_t callback)
     }
 }
 
+/**
+ * @brief 设置发送完成回调
+ */
+void bsp_uart_set_tx_callback(uart_port_t port, uart_tx_callback_t callback)
+{
+    switch (port) {
+#if BSP_UART1_ENABLE
+    case UART_PORT_1:
+        uart1_tx_cb = callback;
+        break;
+#endif
+#if BSP_UART2_ENABLE
+    case UART_PORT_2:
+        uart2_tx_cb = callback;
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 清空发送缓冲区 (中止进行中的DMA发送)
+ */
+void bsp_uart_flush_tx(uart_port_t port)
+{
+    switch (port) {
+#if BSP_UART1_ENABLE
+    case UART_PORT_1:
+#if BSP_UART_USE_DMA
+        USART_ITConfig(USART1, USART_IT_TC, DISABLE);
+        DMA_Cmd(UART1_TX_DMA_STREAM, DISABLE);
+        while (DMA_GetCmdStatus(UART1_TX_DMA_STREAM) != DISABLE);
+#endif
+        uart1_tx_busy = 0;
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 检查发送是否完成
+ */
+uint8_t bsp_uart_tx_complete(uart_port_t port)
+{
+    switch (port) {
+#if BSP_UART1_ENABLE
+    case UART_PORT_1:
+        return !uart1_tx_busy;
+#endif
+#if BSP_UART2_ENABLE
+    case UART_PORT_2:
+        return !uart2_tx_busy;
+#endif
+    default:
+        return 1;
+    }
+}
+
 /**
  * @brief 设置波特率
  */
@@ -373,6 +556,16 @@ int bsp_uart_set_baudrate(uart_port_t port, uint32_t baudrate)
     /* 重新配置波特率 */
     uart_config_t cfg = bsp_uart_get_default_config();
     cfg.baudrate = baudrate;
+#if BSP_UART_USE_DMA && BSP_UART1_ENABLE
+    if (port == UART_PORT_1) {
+        cfg.use_dma = uart1_rx_dma;
+    }
+#endif
+#if BSP_UART_USE_DMA && BSP_UART2_ENABLE
+    if (port == UART_PORT_2) {
+        cfg.use_dma = uart2_rx_dma;
+    }
+#endif
     bsp_uart_deinit(port);
     bsp_uart_init(port, &cfg);
 
@@ -449,7 +642,120 @@ static void ring_buffer_flush(ring_buffer_t *rb)
 {
     rb->head = 0;
     rb->tail = 0;
+    rb->notify = 0;
+}
+
+#if BSP_UART_USE_DMA
+/**
+ * @brief 接收DMA初始化 (循环模式, 直接写入环形缓冲区)
+ */
+static void uart_rx_dma_init(USART_TypeDef *uart, DMA_Stream_TypeDef *stream,
+                             uint32_t channel, uint32_t dma_clk,
+                             IRQn_Type dma_irq, ring_buffer_t *rb)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(dma_clk, ENABLE);
+
+    DMA_DeInit(stream);
+    DMA_InitStructure.DMA_Channel = channel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&uart->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)rb->buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = BSP_UART_RX_BUF_SIZE;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(stream, &DMA_InitStructure);
+
+    /* 半满/全满中断: 连续数据流没有空闲间隙时也能及时通知 */
+    DMA_ITConfig(stream, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = dma_irq;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    USART_DMACmd(uart, USART_DMAReq_Rx, ENABLE);
+    DMA_Cmd(stream, ENABLE);
+}
+
+/**
+ * @brief 根据DMA剩余计数更新写位置
+ * @note DMA模式下缓冲区满时旧数据会被覆盖, 需保证及时读取
+ */
+static void uart_rx_dma_sync(ring_buffer_t *rb, DMA_Stream_TypeDef *stream)
+{
+    rb->head = (BSP_UART_RX_BUF_SIZE - DMA_GetCurrDataCounter(stream)) % BSP_UART_RX_BUF_SIZE;
+}
+
+/**
+ * @brief 将新到达的数据以连续片段通知回调
+ */
+static void uart_rx_dma_notify(uart_port_t port, ring_buffer_t *rb,
+                               DMA_Stream_TypeDef *stream, uart_rx_callback_t cb)
+{
+    uint16_t head;
+    uint16_t pos = rb->notify;
+
+    uart_rx_dma_sync(rb, stream);
+    head = rb->head;
+
+    if (cb != NULL && head != pos) {
+        if (head > pos) {
+            cb(port, &rb->buffer[pos], head - pos);
+        } else {
+            /* 环形回绕: 分两段 */
+            cb(port, &rb->buffer[pos], BSP_UART_RX_BUF_SIZE - pos);
+            if (head > 0) {
+                cb(port, rb->buffer, head);
+            }
+        }
+    }
+
+    rb->notify = head;
+}
+
+/**
+ * @brief 发送DMA初始化 (单次模式, 从驱动发送缓冲区读取)
+ */
+static void uart_tx_dma_init(USART_TypeDef *uart, DMA_Stream_TypeDef *stream,
+                             uint32_t channel, uint32_t dma_clk, uint8_t *buf)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(dma_clk, ENABLE);
+
+    DMA_DeInit(stream);
+    DMA_InitStructure.DMA_Channel = channel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&uart->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStructure.DMA_BufferSize = BSP_UART_TX_BUF_SIZE;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(stream, &DMA_InitStructure);
+
+    USART_DMACmd(uart, USART_DMAReq_Tx, ENABLE);
 }
+#endif
 
 /*=============================================================================
  *                              中断服务函数
@@ -460,6 +766,15 @@ void USART1_IRQHandler(void)
 {
     uint8_t data;
 
+#if BSP_UART_USE_DMA
+    if (USART_GetITStatus(USART1, USART_IT_IDLE) != RESET) {
+        /* 先读SR再读DR清除IDLE标志 */
+        (void)USART1->SR;
+        (void)USART_ReceiveData(USART1);
+        uart_rx_dma_notify(UART_PORT_1, &uart1_rx_buf, UART1_RX_DMA_STREAM, uart1_rx_cb);
+    }
+#endif
+
     if (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET) {
         data = USART_ReceiveData(USART1);
         ring_buffer_put(&uart1_rx_buf, data);
@@ -471,6 +786,7 @@ void USART1_IRQHandler(void)
 
     if (USART_GetITStatus(USART1, USART_IT_TC) != RESET) {
         USART_ClearITPendingBit(USART1, USART_IT_TC);
+        USART_ITConfig(USART1, USART_IT_TC, DISABLE);
         uart1_tx_busy = 0;
         if (uart1_tx_cb != NULL) {
             uart1_tx_cb(UART_PORT_1);
@@ -484,6 +800,15 @@ void USART2_IRQHandler(void)
 {
     uint8_t data;
 
+#if BSP_UART_USE_DMA
+    if (USART_GetITStatus(USART2, USART_IT_IDLE) != RESET) {
+        /* 先读SR再读DR清除IDLE标志 */
+        (void)USART2->SR;
+        (void)USART_ReceiveData(USART2);
+        uart_rx_dma_notify(UART_PORT_2, &uart2_rx_buf, UART2_RX_DMA_STREAM, uart2_rx_cb);
+    }
+#endif
+
     if (USART_GetITStatus(USART2, USART_IT_RXNE) != RESET) {
         data = USART_ReceiveData(USART2);
         ring_buffer_put(&uart2_rx_buf, data);
@@ -503,6 +828,34 @@ void USART2_IRQHandler(void)
 }
 #endif
 
+#if BSP_UART_USE_DMA
+#if BSP_UART1_ENABLE
+void UART1_RX_DMA_IRQHandler(void)
+{
+    if (DMA_GetITStatus(UART1_RX_DMA_STREAM, UART1_RX_DMA_IT_HT) != RESET) {
+        DMA_ClearITPendingBit(UART1_RX_DMA_STREAM, UART1_RX_DMA_IT_HT);
+    }
+    if (DMA_GetITStatus(UART1_RX_DMA_STREAM, UART1_RX_DMA_IT_TC) != RESET) {
+        DMA_ClearITPendingBit(UART1_RX_DMA_STREAM, UART1_RX_DMA_IT_TC);
+    }
+    uart_rx_dma_notify(UART_PORT_1, &uart1_rx_buf, UART1_RX_DMA_STREAM, uart1_rx_cb);
+}
+#endif
+
+#if BSP_UART2_ENABLE
+void UART2_RX_DMA_IRQHandler(void)
+{
+    if (DMA_GetITStatus(UART2_RX_DMA_STREAM, UART2_RX_DMA_IT_HT) != RESET) {
+        DMA_ClearITPendingBit(UART2_RX_DMA_STREAM, UART2_RX_DMA_IT_HT);
+    }
+    if (DMA_GetITStatus(UART2_RX_DMA_STREAM, UART2_RX_DMA_IT_TC) != RESET) {
+        DMA_ClearITPendingBit(UART2_RX_DMA_STREAM, UART2_RX_DMA_IT_TC);
+    }
+    uart_rx_dma_notify(UART_PORT_2, &uart2_rx_buf, UART2_RX_DMA_STREAM, uart2_rx_cb);
+}
+#endif
+#endif
+
 /*=============================================================================
  *                              printf重定向
  *============================================================================*/
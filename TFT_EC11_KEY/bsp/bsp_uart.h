@@ -71,6 +71,13 @@ extern "C" {
 #define UART1_TX_DMA_CHANNEL    DMA_Channel_4
 #define UART1_RX_DMA_STREAM     DMA2_Stream2
 #define UART1_RX_DMA_CHANNEL    DMA_Channel_4
+#define UART1_RX_DMA_CLK        RCC_AHB1Periph_DMA2
+#define UART1_RX_DMA_IRQn       DMA2_Stream2_IRQn
+#define UART1_RX_DMA_IRQHandler DMA2_Stream2_IRQHandler
+#define UART1_RX_DMA_IT_HT      DMA_IT_HTIF2
+#define UART1_RX_DMA_IT_TC      DMA_IT_TCIF2
+#define UART1_TX_DMA_FLAGS      (DMA_FLAG_TCIF7 | DMA_FLAG_HTIF7 | DMA_FLAG_TEIF7 | \
+                                 DMA_FLAG_DMEIF7 | DMA_FLAG_FEIF7)
 
 #endif
 
@@ -93,6 +100,11 @@ extern "C" {
 #define UART2_TX_DMA_CHANNEL    DMA_Channel_4
 #define UART2_RX_DMA_STREAM     DMA1_Stream5
 #define UART2_RX_DMA_CHANNEL    DMA_Channel_4
+#define UART2_RX_DMA_CLK        RCC_AHB1Periph_DMA1
+#define UART2_RX_DMA_IRQn       DMA1_Stream5_IRQn
+#define UART2_RX_DMA_IRQHandler DMA1_Stream5_IRQHandler
+#define UART2_RX_DMA_IT_HT      DMA_IT_HTIF5
+#define UART2_RX_DMA_IT_TC      DMA_IT_TCIF5
 
 #endif
 
@@ -118,7 +130,7 @@ typedef struct {
     uint16_t word_length;                   /**< 数据位 */
     uint16_t stop_bits;                     /**< 停止位 */
     uint16_t parity;                        /**< 校验位 */
-    uint8_t use_dma;                        /**< 使用DMA */
+    uint8_t use_dma;                        /**< 接收使用循环DMA (需BSP_UART_USE_DMA) */
 } uart_config_t;
 
 /**
@@ -126,6 +138,8 @@ typedef struct {
  * @param port 串口端口
  * @param data 接收到的数据
  * @param len 数据长度
+ * @note 中断模式每字节回调一次; DMA模式在线路空闲/半满/全满时
+ *       以连续片段回调 (环形回绕时分两次), data直接指向接收缓冲区
  */
 typedef void (*uart_rx_callback_t)(uart_port_t port, uint8_t *data, uint16_t len);
 
@@ -187,8 +201,11 @@ void bsp_uart_printf(uart_port_t port, const char *fmt, ...);
  * @brief DMA发送
  * @param port 串口端口
  * @param data 数据缓冲区
- * @param len 数据长度
- * @retval 0:成功 -1:失败
+ * @param len 数据长度 (不超过 BSP_UART_TX_BUF_SIZE)
+ * @retval 0:成功 -1:失败 (上一次发送未完成或端口不支持)
+ * @note 数据先拷贝到驱动的发送缓冲区, 返回后调用者可立即复用data; 不等待发送
+ * @note 仅USART1支持 (DMA2_Stream7); USART2的发送流DMA1_Stream6与输入捕获/TIM4波形共用
+ * @note 发送期间不要再用阻塞函数 (bsp_uart_send等) 写同一端口
  */
 int bsp_uart_send_dma(uart_port_t port, const uint8_t *data, uint16_t len);
 
@@ -0,0 +1,240 @@
+/**
+ * @file bin_log.c
+ * @brief 二进制结构化日志模块实现 - 延迟格式化
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "bin_log.h"
+#include "scheduler.h"
+#include <stdarg.h>
+#include <string.h>
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define BIN_LOG_MASK                (BIN_LOG_BUFFER_SIZE - 1)
+
+/* 记录头: 同步字节 + 长度 */
+#define BIN_LOG_HEADER_SIZE         2
+
+/* 固定负载: 时间戳 + 格式串地址 */
+#define BIN_LOG_FIXED_SIZE          8
+
+#if (BIN_LOG_BUFFER_SIZE & BIN_LOG_MASK) != 0
+#error "BIN_LOG_BUFFER_SIZE must be a power of 2"
+#endif
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+static uint8_t log_buffer[BIN_LOG_BUFFER_SIZE];
+static volatile uint16_t log_head = 0;     /* 写位置 (自由递增) */
+static volatile uint16_t log_tail = 0;     /* 读位置 (自由递增) */
+
+static bin_log_output_t log_output = NULL;
+static bin_log_stats_t log_stats;
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static void ring_put(uint16_t pos, const uint8_t *data, uint16_t len);
+static void put_u32(uint8_t *p, uint32_t val);
+
+/*=============================================================================
+ *                              弱函数
+ *============================================================================*/
+
+/**
+ * @brief 获取记录时间戳
+ */
+__attribute__((weak)) uint32_t bin_log_get_timestamp(void)
+{
+    return scheduler_get_tick();
+}
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化二进制日志
+ */
+int bin_log_init(bin_log_output_t output)
+{
+    if (output == NULL) {
+        return -1;
+    }
+
+    scheduler_enter_critical();
+    log_head = 0;
+    log_tail = 0;
+    log_output = output;
+    memset(&log_stats, 0, sizeof(log_stats));
+    scheduler_exit_critical();
+
+    return 0;
+}
+
+/**
+ * @brief 写入一条日志记录
+ */
+int bin_log_write(const char *fmt, uint8_t nargs, ...)
+{
+    uint8_t record[BIN_LOG_HEADER_SIZE + BIN_LOG_FIXED_SIZE + BIN_LOG_MAX_ARGS * 4];
+    uint16_t size;
+    uint16_t used;
+    uint8_t i;
+    va_list ap;
+
+    if (nargs > BIN_LOG_MAX_ARGS) {
+        nargs = BIN_LOG_MAX_ARGS;
+    }
+
+    /* 在调用者栈上组装记录, 只有拷贝进环形缓冲区时才关中断 */
+    size = BIN_LOG_HEADER_SIZE + BIN_LOG_FIXED_SIZE + (uint16_t)nargs * 4;
+    record[0] = BIN_LOG_SYNC_BYTE;
+    record[1] = (uint8_t)(size - BIN_LOG_HEADER_SIZE);
+    put_u32(&record[2], bin_log_get_timestamp());
+    put_u32(&record[6], (uint32_t)(uintptr_t)fmt);
+
+    va_start(ap, nargs);
+    for (i = 0; i < nargs; i++) {
+        put_u32(&record[10 + i * 4], va_arg(ap, uint32_t));
+    }
+    va_end(ap);
+
+    scheduler_enter_critical();
+
+    used = (uint16_t)(log_head - log_tail);
+    if (used + size > BIN_LOG_BUFFER_SIZE) {
+        log_stats.dropped++;
+        scheduler_exit_critical();
+        return -1;
+    }
+
+    ring_put(log_head, record, size);
+    log_head += size;
+    log_stats.records++;
+
+    used += size;
+    if (used > log_stats.high_water) {
+        log_stats.high_water = used;
+    }
+
+    scheduler_exit_critical();
+
+    return 0;
+}
+
+/**
+ * @brief 输出缓冲区中的日志
+ */
+uint16_t bin_log_drain(uint16_t max_bytes)
+{
+    uint16_t total = 0;
+
+    if (log_output == NULL) {
+        return 0;
+    }
+
+    /* 只有本函数修改log_tail, 最多分两段输出 (环形回绕) */
+    while (total < max_bytes) {
+        uint16_t tail = log_tail;
+        uint16_t avail = (uint16_t)(log_head - tail);
+        uint16_t offset = tail & BIN_LOG_MASK;
+        uint16_t chunk;
+        uint16_t sent;
+
+        if (avail == 0) {
+            break;
+        }
+
+        chunk = BIN_LOG_BUFFER_SIZE - offset;
+        if (chunk > avail) {
+            chunk = avail;
+        }
+        if (chunk > max_bytes - total) {
+            chunk = max_bytes - total;
+        }
+
+        sent = log_output(&log_buffer[offset], chunk);
+        if (sent > chunk) {
+            sent = chunk;
+        }
+
+        scheduler_enter_critical();
+        log_tail = tail + sent;
+        scheduler_exit_critical();
+
+        total += sent;
+
+        /* 输出忙, 不等待 */
+        if (sent < chunk) {
+            break;
+        }
+    }
+
+    log_stats.bytes_sent += total;
+
+    return total;
+}
+
+/**
+ * @brief 空闲钩子
+ */
+void bin_log_idle_hook(void)
+{
+    bin_log_drain(BIN_LOG_DRAIN_CHUNK);
+}
+
+/**
+ * @brief 获取缓冲区中待发送的字节数
+ */
+uint16_t bin_log_pending(void)
+{
+    return (uint16_t)(log_head - log_tail);
+}
+
+/**
+ * @brief 获取统计信息
+ */
+const bin_log_stats_t* bin_log_get_stats(void)
+{
+    return &log_stats;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 写入环形缓冲区 (处理回绕)
+ */
+static void ring_put(uint16_t pos, const uint8_t *data, uint16_t len)
+{
+    uint16_t offset = pos & BIN_LOG_MASK;
+    uint16_t first = BIN_LOG_BUFFER_SIZE - offset;
+
+    if (first >= len) {
+        memcpy(&log_buffer[offset], data, len);
+    } else {
+        memcpy(&log_buffer[offset], data, first);
+        memcpy(log_buffer, data + first, len - first);
+    }
+}
+
+/**
+ * @brief 小端写入32位数
+ */
+static void put_u32(uint8_t *p, uint32_t val)
+{
+    p[0] = (uint8_t)val;
+    p[1] = (uint8_t)(val >> 8);
+    p[2] = (uint8_t)(val >> 16);
+    p[3] = (uint8_t)(val >> 24);
+}
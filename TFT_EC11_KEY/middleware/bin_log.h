@@ -0,0 +1,179 @@
+/**
+ * @file bin_log.h
+ * @brief 二进制结构化日志模块 - 延迟格式化
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 目标端不做printf格式化, 只记录格式串地址和原始参数
+ *       - 记录写入环形缓冲区, 单条记录写入为O(参数个数)
+ *       - 空闲时通过输出接口(如串口)批量发送
+ *       - 上位机工具根据ELF中的格式串还原文本 (tools/bin_log_decode.py)
+ *       - 缓冲区满时丢弃新记录并计数, 不阻塞调用者
+ *
+ * @note 记录格式 (小端):
+ *       | 0xA5 | len | timestamp(4) | fmt_addr(4) | arg0(4) ... argN(4) |
+ *       len 为 timestamp 之后的字节数 (8 + 4*N)
+ *
+ * @note 参数限制:
+ *       - 参数按32位整数记录, 支持 %d %u %x %c %p 等 (不支持 %s, 字符串内容不会被复制)
+ *       - 浮点参数需使用 BIN_LOG_FLOAT() 转换, 格式串中使用 %f 或 %.Nf
+ *       - 单条记录最多 BIN_LOG_MAX_ARGS 个参数
+ *
+ * @note 输出端口由本模块独占: 记录流中混入文本会使上位机失去帧同步,
+ *       使用本模块的应用不应再向同一端口发送 DEBUG_PRINT 文本
+ */
+
+#ifndef __BIN_LOG_H
+#define __BIN_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/**
+ * @brief 日志环形缓冲区大小 (必须为2的幂)
+ */
+#define BIN_LOG_BUFFER_SIZE         1024
+
+/**
+ * @brief 单条记录最大参数个数
+ */
+#define BIN_LOG_MAX_ARGS            8
+
+/**
+ * @brief 每次输出的最大字节数
+ * @note 限制单次空闲钩子占用CPU的时间
+ */
+#define BIN_LOG_DRAIN_CHUNK         64
+
+/**
+ * @brief 记录同步字节
+ */
+#define BIN_LOG_SYNC_BYTE           0xA5
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 日志输出接口
+ * @param data 数据指针 (返回后即失效, 异步发送需自行拷贝)
+ * @param len 数据长度
+ * @retval 本次接受的字节数, 0表示输出忙
+ * @note 不得等待发送完成, 只接受能立即交给硬件 (如DMA) 的部分
+ */
+typedef uint16_t (*bin_log_output_t)(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 日志统计信息
+ */
+typedef struct {
+    uint32_t records;           /**< 已写入记录数 */
+    uint32_t dropped;           /**< 缓冲区满丢弃的记录数 */
+    uint32_t bytes_sent;        /**< 已发送字节数 */
+    uint16_t high_water;        /**< 缓冲区最高占用 (字节) */
+} bin_log_stats_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 初始化二进制日志
+ * @param output 输出接口 (如串口发送函数)
+ * @retval 0:成功 -1:失败
+ */
+int bin_log_init(bin_log_output_t output);
+
+/**
+ * @brief 写入一条日志记录
+ * @param fmt 格式串 (必须位于只读存储区, 通常为字符串常量)
+ * @param nargs 参数个数
+ * @param ... 32位参数
+ * @retval 0:成功 -1:缓冲区已满
+ * @note 建议使用 BIN_LOG() 宏, 自动计算参数个数
+ * @note 可在中断中调用
+ */
+int bin_log_write(const char *fmt, uint8_t nargs, ...);
+
+/**
+ * @brief 输出缓冲区中的日志
+ * @param max_bytes 本次最多输出的字节数
+ * @retval 实际输出的字节数
+ * @note 输出接口接受的字节数不足时立即返回, 剩余数据留待下次
+ */
+uint16_t bin_log_drain(uint16_t max_bytes);
+
+/**
+ * @brief 空闲钩子 (可直接注册到调度器)
+ * @note 每次输出不超过 BIN_LOG_DRAIN_CHUNK 字节
+ */
+void bin_log_idle_hook(void);
+
+/**
+ * @brief 获取缓冲区中待发送的字节数
+ * @retval 待发送字节数
+ */
+uint16_t bin_log_pending(void);
+
+/**
+ * @brief 获取统计信息
+ * @retval 统计信息指针
+ */
+const bin_log_stats_t* bin_log_get_stats(void);
+
+/**
+ * @brief 获取记录时间戳 (弱函数, 用户可重新实现)
+ * @retval 时间戳, 默认使用调度器tick (ms)
+ */
+uint32_t bin_log_get_timestamp(void);
+
+/*=============================================================================
+ *                              便捷宏定义
+ *============================================================================*/
+
+/** @cond */
+#define BIN_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+/** @endcond */
+
+/**
+ * @brief 计算可变参数个数 (0 ~ 8)
+ */
+#define BIN_LOG_NARGS(...) \
+    BIN_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+/**
+ * @brief 写入二进制日志
+ * @note 用法与 DEBUG_PRINT 相同, 但格式化由上位机完成
+ */
+#define BIN_LOG(fmt, ...) \
+    bin_log_write(fmt, BIN_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+/**
+ * @brief 浮点参数转换 (按IEEE754单精度位模式记录)
+ */
+#define BIN_LOG_FLOAT(x)    bin_log_float_bits((float)(x))
+
+/**
+ * @brief 获取浮点数的位模式
+ */
+static inline uint32_t bin_log_float_bits(float f)
+{
+    union { float f; uint32_t u; } conv;
+    conv.f = f;
+    return conv.u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BIN_LOG_H */
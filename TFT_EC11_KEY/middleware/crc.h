@@ -0,0 +1,89 @@
+/**
+ * @file crc.h
+ * @brief 公共CRC模块 - 查表CRC-32/CRC-16, 目标板上使用STM32 CRC外设
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - CRC-32 (IEEE 802.3, 与zlib/以太网相同): slice-by-4 查表 (4KB), 可选 slice-by-8 (8KB)
+ *       - 定义 USE_STDPERIPH_DRIVER 时 (目标板工程), 较长的数据改用CRC外设按字计算,
+ *         输入和结果做位反转, 结果与软件实现一致
+ *       - CRC-16/CCITT (多项式0x1021) 字节查表, 初值决定变体:
+ *         0xFFFF 为 CCITT-FALSE, 0x0000 为 XMODEM
+ *       - 支持分段计算: 把上一段的结果作为下一段的初值
+ *
+ * @note 校验值 ("123456789"):
+ *       CRC-32 = 0xCBF43926, CRC-16/CCITT-FALSE = 0x29B1, CRC-16/XMODEM = 0x31C3
+ *
+ * @note 查找表由 tools/gen_crc_tables.py 生成
+ */
+
+#ifndef __CRC_H
+#define __CRC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/**
+ * @brief 使用 slice-by-8 (每次8字节, 表大小8KB); 0为 slice-by-4 (4KB)
+ */
+#ifndef CRC32_SLICE_BY_8
+#define CRC32_SLICE_BY_8            0
+#endif
+
+/**
+ * @brief 使用CRC外设 (目标板工程默认开启, 定义为0可关闭)
+ */
+#ifndef CRC_USE_HW
+#ifdef USE_STDPERIPH_DRIVER
+#define CRC_USE_HW                  1
+#else
+#define CRC_USE_HW                  0
+#endif
+#endif
+
+/**
+ * @brief 使用CRC外设的最小长度, 更短的数据查表更快
+ */
+#define CRC_HW_MIN_LEN              32
+
+/* CRC-16 初值 */
+#define CRC16_CCITT_INIT            0xFFFF  /**< CRC-16/CCITT-FALSE */
+#define CRC16_XMODEM_INIT           0x0000  /**< CRC-16/XMODEM */
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 计算CRC-32
+ * @param crc 上一段的结果, 首段传0
+ * @param data 数据
+ * @param len 长度
+ * @retval CRC值 (已取反, 可直接比较或作为下一段的初值)
+ * @note 中断中也可调用: 外设正被占用时自动改用查表
+ */
+uint32_t crc32_update(uint32_t crc, const void *data, uint32_t len);
+
+/**
+ * @brief 计算CRC-16/CCITT (高位在前, 无结果异或)
+ * @param crc 初值 (CRC16_CCITT_INIT / CRC16_XMODEM_INIT) 或上一段的结果
+ * @param data 数据
+ * @param len 长度
+ * @retval CRC值
+ */
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC_H */
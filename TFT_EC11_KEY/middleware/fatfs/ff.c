@@ -80,6 +80,7 @@
 #define FSI_Free_Count  488
 #define FSI_Nxt_Free    492
 #define MBR_Table       446
+#define BS_55AA         510
 
 /*=============================================================================
  *                              静态变量
@@ -219,7 +220,7 @@ static FRESULT check_fs(FATFS *fs, LBA_t sect)
 {
     fs->wflag = 0; fs->winsect = (LBA_t)0 - 1;
     if (move_window(fs, sect) != FR_OK) return FR_DISK_ERR;
-    if (LD_WORD(&fs->win[BS_BootSig - 2]) != 0xAA55) return FR_NO_FILESYSTEM;
+    if (LD_WORD(&fs->win[BS_55AA]) != 0xAA55) return FR_NO_FILESYSTEM;
     if ((LD_DWORD(&fs->win[BS_FilSysType]) & 0xFFFFFF) == 0x544146) return FR_OK;
     if ((LD_DWORD(&fs->win[BS_FilSysType32]) & 0xFFFFFF) == 0x544146) return FR_OK;
     return FR_NO_FILESYSTEM;
@@ -568,11 +569,15 @@ FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br)
         csect = (UINT)(fp->fptr / SS(fs)) % fs->csize;
         sect += csect;
 
-        /* 读取数据 */
-        cc = btr / SS(fs);
+        /* 读取数据: 扇区对齐的整扇区直接读入用户缓冲区 */
+        cc = (fp->fptr % SS(fs) == 0) ? btr / SS(fs) : 0;
         if (cc > 0) {
             if (csect + cc > fs->csize) cc = fs->csize - csect;
             if (disk_read(fs->pdrv, rbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
+            /* 窗口中尚未写回的扇区以窗口为准 */
+            if (fs->wflag && fs->winsect - sect < cc) {
+                memcpy(rbuff + (fs->winsect - sect) * SS(fs), fs->win, SS(fs));
+            }
             rcnt = cc * SS(fs);
             if (fp->fptr + rcnt > fp->obj_size) rcnt = (UINT)(fp->obj_size - fp->fptr);
         } else {
@@ -637,7 +642,7 @@ FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw)
             } else {
                 /* 需要新簇 */
                 clst = get_fat(fs, fp->clust);
-                if (clst < 2) {
+                if (clst < 2 || clst >= fs->n_fatent) {     /* 链尾 (或读FAT出错) */
                     /* 分配新簇 */
                     scl = fp->clust + 1;
                     if (scl >= fs->n_fatent) scl = 2;
@@ -670,11 +675,16 @@ FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw)
         csect = (UINT)(fp->fptr / SS(fs)) % fs->csize;
         sect += csect;
 
-        /* 写入数据 */
-        cc = btw / SS(fs);
+        /* 写入数据: 扇区对齐的整扇区直接写盘 */
+        cc = (fp->fptr % SS(fs) == 0) ? btw / SS(fs) : 0;
         if (cc > 0) {
             if (csect + cc > fs->csize) cc = fs->csize - csect;
             if (disk_write(fs->pdrv, wbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
+            /* 窗口中的同一扇区已过期 */
+            if (fs->winsect - sect < cc) {
+                memcpy(fs->win, wbuff + (fs->winsect - sect) * SS(fs), SS(fs));
+                fs->wflag = 0;
+            }
             wcnt = cc * SS(fs);
         } else {
             res = move_window(fs, sect);
@@ -973,12 +983,11 @@ int f_putc(TCHAR c, FIL *fp)
 
 int f_puts(const TCHAR *str, FIL *fp)
 {
-    int n = 0;
-    while (*str) {
-        if (f_putc(*str++, fp) == -1) return -1;
-        n++;
-    }
-    return n;
+    UINT bw, n = (UINT)strlen(str);
+
+    /* 整串一次写入; 大量文本请用 middleware/file_stream 缓冲 */
+    if (f_write(fp, str, n, &bw) != FR_OK || bw != n) return -1;
+    return (int)n;
 }
 
 TCHAR *f_gets(TCHAR *buff, int len, FIL *fp)
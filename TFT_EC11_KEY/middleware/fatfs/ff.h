@@ -30,6 +30,7 @@ typedef uint8_t     BYTE;
 typedef uint16_t    WORD;
 typedef uint32_t    DWORD;
 typedef uint64_t    QWORD;
+typedef unsigned int UINT;
 typedef WORD        WCHAR;
 
 #if FF_FS_EXFAT
@@ -40,6 +41,28 @@ typedef DWORD       FSIZE_t;
 typedef DWORD       LBA_t;
 #endif
 
+/*=============================================================================
+ *                              字符类型定义
+ *============================================================================*/
+
+#if FF_USE_LFN && FF_LFN_UNICODE == 1
+typedef WCHAR TCHAR;
+#define _T(x) L ## x
+#define _TEXT(x) L ## x
+#elif FF_USE_LFN && FF_LFN_UNICODE == 2
+typedef char TCHAR;
+#define _T(x) u8 ## x
+#define _TEXT(x) u8 ## x
+#elif FF_USE_LFN && FF_LFN_UNICODE == 3
+typedef DWORD TCHAR;
+#define _T(x) U ## x
+#define _TEXT(x) U ## x
+#else
+typedef char TCHAR;
+#define _T(x) x
+#define _TEXT(x) x
+#endif
+
 /* 文件系统对象结构 */
 typedef struct {
     BYTE    fs_type;        /* 文件系统类型 (0:未挂载) */
@@ -194,28 +217,6 @@ typedef enum {
 #define AM_DIR      0x10    /* 目录 */
 #define AM_ARC      0x20    /* 归档 */
 
-/*=============================================================================
- *                              字符类型定义
- *============================================================================*/
-
-#if FF_USE_LFN && FF_LFN_UNICODE == 1
-typedef WCHAR TCHAR;
-#define _T(x) L ## x
-#define _TEXT(x) L ## x
-#elif FF_USE_LFN && FF_LFN_UNICODE == 2
-typedef char TCHAR;
-#define _T(x) u8 ## x
-#define _TEXT(x) u8 ## x
-#elif FF_USE_LFN && FF_LFN_UNICODE == 3
-typedef DWORD TCHAR;
-#define _T(x) U ## x
-#define _TEXT(x) U ## x
-#else
-typedef char TCHAR;
-#define _T(x) x
-#define _TEXT(x) x
-#endif
-
 /*=============================================================================
  *                              函数声明
  *============================================================================*/
@@ -0,0 +1,515 @@
+/**
+ * @file file_stream.c
+ * @brief 缓冲文件流实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "file_stream.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define STREAM_IDLE         0
+#define STREAM_READ         1
+#define STREAM_WRITE        2
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static int set_error(file_stream_t *s, FRESULT res);
+static int to_write(file_stream_t *s);
+static int to_read(file_stream_t *s);
+static int fill(file_stream_t *s);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 在已打开的文件上建立文件流
+ */
+int file_stream_init(file_stream_t *s, FIL *fp, void *buf, UINT size, uint8_t flags)
+{
+    if (s == NULL || fp == NULL || buf == NULL || size < 2) {
+        return -1;
+    }
+
+    memset(s, 0, sizeof(file_stream_t));
+    s->fp = fp;
+    s->buf = (char *)buf;
+    s->size = size;
+    s->flags = flags;
+    s->mode = STREAM_IDLE;
+    s->err = FR_OK;
+
+    return 0;
+}
+
+/**
+ * @brief 写回缓冲数据并解除关联
+ */
+int file_stream_close(file_stream_t *s)
+{
+    int ret = file_stream_flush(s);
+
+    s->fp = NULL;
+    s->mode = STREAM_IDLE;
+    s->pos = 0;
+    s->len = 0;
+
+    return ret;
+}
+
+/**
+ * @brief 把缓冲的写入数据交给 f_write()
+ */
+int file_stream_flush(file_stream_t *s)
+{
+    UINT bw;
+    FRESULT res;
+
+    if (s->fp == NULL) {
+        return -1;
+    }
+
+    if (s->mode != STREAM_WRITE || s->pos == 0) {
+        return 0;
+    }
+
+    res = f_write(s->fp, s->buf, s->pos, &bw);
+    if (res == FR_OK && bw != s->pos) {
+        res = FR_DENIED;    /* 磁盘已满 */
+    }
+    s->pos = 0;
+
+    return set_error(s, res);
+}
+
+/**
+ * @brief 写回缓冲数据并 f_sync()
+ */
+int file_stream_sync(file_stream_t *s)
+{
+    if (file_stream_flush(s) != 0) {
+        return -1;
+    }
+
+    return set_error(s, f_sync(s->fp));
+}
+
+/**
+ * @brief 写入一个字符
+ */
+int file_stream_putc(file_stream_t *s, char c)
+{
+    if (to_write(s) != 0) {
+        return -1;
+    }
+
+    if (s->pos >= s->size && file_stream_flush(s) != 0) {
+        return -1;
+    }
+
+    s->buf[s->pos++] = c;
+
+    if (c == '\n' && (s->flags & FILE_STREAM_LINE_BUF)) {
+        if (file_stream_flush(s) != 0) {
+            return -1;
+        }
+    }
+
+    return (uint8_t)c;
+}
+
+/**
+ * @brief 写入字符串
+ */
+int file_stream_puts(file_stream_t *s, const char *str)
+{
+    return file_stream_write(s, str, (UINT)strlen(str));
+}
+
+/**
+ * @brief 写入数据
+ */
+int file_stream_write(file_stream_t *s, const void *data, UINT len)
+{
+    const char *src = (const char *)data;
+    UINT remain = len;
+    UINT chunk, bw;
+    FRESULT res;
+
+    if (to_write(s) != 0) {
+        return -1;
+    }
+
+    while (remain > 0) {
+        if (s->pos == 0 && remain >= s->size) {
+            /* 大块数据不经过缓冲区 */
+            res = f_write(s->fp, src, remain, &bw);
+            if (res == FR_OK && bw != remain) {
+                res = FR_DENIED;
+            }
+            if (set_error(s, res) != 0) {
+                return -1;
+            }
+            break;
+        }
+
+        chunk = s->size - s->pos;
+        if (chunk > remain) {
+            chunk = remain;
+        }
+
+        memcpy(s->buf + s->pos, src, chunk);
+        s->pos += chunk;
+        src += chunk;
+        remain -= chunk;
+
+        if (s->pos == s->size && file_stream_flush(s) != 0) {
+            return -1;
+        }
+    }
+
+    if ((s->flags & FILE_STREAM_LINE_BUF) && memchr(data, '\n', len) != NULL) {
+        if (file_stream_flush(s) != 0) {
+            return -1;
+        }
+    }
+
+    return (int)len;
+}
+
+/**
+ * @brief 格式化写入
+ */
+int file_stream_printf(file_stream_t *s, const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = file_stream_vprintf(s, fmt, args);
+    va_end(args);
+
+    return n;
+}
+
+/**
+ * @brief 格式化写入 (va_list版本)
+ * @note 先格式化到缓冲区空闲部分, 放不下时写回缓冲区后重新格式化一次
+ */
+int file_stream_vprintf(file_stream_t *s, const char *fmt, va_list args)
+{
+    va_list copy;
+    UINT start;
+    int n;
+
+    if (to_write(s) != 0) {
+        return -1;
+    }
+
+    va_copy(copy, args);
+    n = vsnprintf(s->buf + s->pos, s->size - s->pos, fmt, copy);
+    va_end(copy);
+
+    if (n < 0 || (UINT)n >= s->size) {
+        return -1;
+    }
+
+    if ((UINT)n >= s->size - s->pos) {
+        if (file_stream_flush(s) != 0) {
+            return -1;
+        }
+        vsnprintf(s->buf, s->size, fmt, args);
+    }
+
+    start = s->pos;
+    s->pos += (UINT)n;
+
+    if ((s->flags & FILE_STREAM_LINE_BUF) && memchr(s->buf + start, '\n', (UINT)n) != NULL) {
+        if (file_stream_flush(s) != 0) {
+            return -1;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief 读取一个字符
+ */
+int file_stream_getc(file_stream_t *s)
+{
+    if (to_read(s) != 0) {
+        return -1;
+    }
+
+    if (s->pos >= s->len && fill(s) <= 0) {
+        return -1;
+    }
+
+    return (uint8_t)s->buf[s->pos++];
+}
+
+/**
+ * @brief 读取一行
+ */
+char* file_stream_gets(file_stream_t *s, char *line, int len)
+{
+    UINT n = 0, max, chunk;
+    const char *nl;
+
+    if (line == NULL || len < 2 || to_read(s) != 0) {
+        return NULL;
+    }
+
+    max = (UINT)len - 1;
+
+    while (n < max) {
+        if (s->pos >= s->len && fill(s) <= 0) {
+            break;
+        }
+
+        chunk = s->len - s->pos;
+        if (chunk > max - n) {
+            chunk = max - n;
+        }
+
+        /* 整段查找换行, 找到后连同换行一起复制 */
+        nl = (const char *)memchr(s->buf + s->pos, '\n', chunk);
+        if (nl != NULL) {
+            chunk = (UINT)(nl - (s->buf + s->pos)) + 1;
+        }
+
+        memcpy(line + n, s->buf + s->pos, chunk);
+        s->pos += chunk;
+        n += chunk;
+
+        if (nl != NULL) {
+            /* CR可能在上一段的末尾, 在输出缓冲区中检查 */
+            if (n >= 2 && line[n - 2] == '\r') {
+                line[n - 2] = '\n';
+                n--;
+            }
+            break;
+        }
+    }
+
+    if (n == 0) {
+        return NULL;
+    }
+
+    line[n] = '\0';
+
+    return line;
+}
+
+/**
+ * @brief 读取数据
+ */
+int file_stream_read(file_stream_t *s, void *data, UINT len)
+{
+    char *dst = (char *)data;
+    UINT n = 0, chunk, br;
+
+    if (to_read(s) != 0) {
+        return -1;
+    }
+
+    while (n < len) {
+        if (s->pos >= s->len) {
+            if (s->eof) {
+                break;
+            }
+
+            if (len - n >= s->size) {
+                /* 大块数据不经过缓冲区 */
+                if (set_error(s, f_read(s->fp, dst + n, len - n, &br)) != 0) {
+                    return -1;
+                }
+                if (br < len - n) {
+                    s->eof = 1;
+                }
+                n += br;
+                break;
+            }
+
+            if (fill(s) < 0) {
+                return -1;
+            }
+            if (s->len == 0) {
+                break;
+            }
+        }
+
+        chunk = s->len - s->pos;
+        if (chunk > len - n) {
+            chunk = len - n;
+        }
+
+        memcpy(dst + n, s->buf + s->pos, chunk);
+        s->pos += chunk;
+        n += chunk;
+    }
+
+    return (int)n;
+}
+
+/**
+ * @brief 移动读写位置
+ */
+int file_stream_seek(file_stream_t *s, FSIZE_t ofs)
+{
+    if (file_stream_flush(s) != 0) {
+        return -1;
+    }
+
+    s->mode = STREAM_IDLE;
+    s->pos = 0;
+    s->len = 0;
+    s->eof = 0;
+
+    return set_error(s, f_lseek(s->fp, ofs));
+}
+
+/**
+ * @brief 当前逻辑读写位置
+ */
+FSIZE_t file_stream_tell(const file_stream_t *s)
+{
+    switch (s->mode) {
+    case STREAM_READ:
+        return f_tell(s->fp) - (s->len - s->pos);
+    case STREAM_WRITE:
+        return f_tell(s->fp) + s->pos;
+    default:
+        return f_tell(s->fp);
+    }
+}
+
+/**
+ * @brief 是否已读到文件末尾
+ */
+uint8_t file_stream_eof(const file_stream_t *s)
+{
+    return (uint8_t)(s->mode == STREAM_READ && s->eof && s->pos >= s->len);
+}
+
+/**
+ * @brief 第一次出错的FatFS返回值
+ */
+FRESULT file_stream_error(const file_stream_t *s)
+{
+    return s->err;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 记录第一次出错
+ * @retval 0:res为FR_OK -1:出错
+ */
+static int set_error(file_stream_t *s, FRESULT res)
+{
+    if (res == FR_OK) {
+        return 0;
+    }
+
+    if (s->err == FR_OK) {
+        s->err = res;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief 切换到写: 丢弃预读数据, 文件指针退回到逻辑位置
+ */
+static int to_write(file_stream_t *s)
+{
+    FSIZE_t ofs;
+    UINT ahead;
+
+    if (s->fp == NULL) {
+        return -1;
+    }
+
+    if (s->mode == STREAM_READ) {
+        ofs = file_stream_tell(s);
+        ahead = s->len - s->pos;
+        s->pos = 0;
+        s->len = 0;
+        s->eof = 0;
+        s->mode = STREAM_IDLE;
+        if (ahead != 0 && set_error(s, f_lseek(s->fp, ofs)) != 0) {
+            return -1;
+        }
+    }
+
+    if (s->mode == STREAM_IDLE) {
+        s->mode = STREAM_WRITE;
+        s->pos = 0;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 切换到读: 写回缓冲数据
+ */
+static int to_read(file_stream_t *s)
+{
+    if (s->fp == NULL) {
+        return -1;
+    }
+
+    if (s->mode == STREAM_WRITE && file_stream_flush(s) != 0) {
+        return -1;
+    }
+
+    if (s->mode != STREAM_READ) {
+        s->mode = STREAM_READ;
+        s->pos = 0;
+        s->len = 0;
+        s->eof = 0;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 从文件读满缓冲区
+ * @retval 读到的字节数, 0:文件末尾 -1:出错
+ */
+static int fill(file_stream_t *s)
+{
+    UINT br = 0;
+
+    s->pos = 0;
+    s->len = 0;
+
+    if (s->eof) {
+        return 0;
+    }
+
+    if (set_error(s, f_read(s->fp, s->buf, s->size, &br)) != 0) {
+        return -1;
+    }
+
+    s->len = br;
+    if (br < s->size) {
+        s->eof = 1;
+    }
+
+    return (int)br;
+}
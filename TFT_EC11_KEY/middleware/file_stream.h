@@ -0,0 +1,196 @@
+/**
+ * @file file_stream.h
+ * @brief 缓冲文件流 - FatFS文件的字符串读写
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 在已打开的FIL上加一层用户提供的缓冲区, 类似stdio的FILE
+ *       - 写: 字符和字符串先进缓冲区, 满了 (或行缓冲遇到换行) 才调用一次 f_write()
+ *       - 读: 一次 f_read() 填满缓冲区, 按行读取用 memchr 查找换行, 整段复制
+ *       - printf 直接格式化到缓冲区空闲部分, 不需要额外的行缓冲
+ *       - 读写可以交替, 切换时自动写回或把文件指针退回到逻辑位置
+ *       - f_putc()/f_gets() 每个字符都走一遍 f_write()/f_read() 的簇和扇区计算,
+ *         文本日志和CSV应使用本模块
+ *
+ * @note 使用方法:
+ *       1. f_open(&fil, "0:/log.csv", FA_WRITE | FA_OPEN_ALWAYS);
+ *       2. file_stream_init(&fs, &fil, buf, sizeof(buf), FILE_STREAM_LINE_BUF);
+ *       3. file_stream_printf(&fs, "%lu,%d\n", tick, value);
+ *       4. file_stream_close(&fs); f_close(&fil);
+ *
+ * @note 缓冲区用512的整数倍时 f_write() 可以整扇区直接写盘, 不经过扇区窗口
+ */
+
+#ifndef __FILE_STREAM_H
+#define __FILE_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdarg.h>
+#include "fatfs/ff.h"
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 标志 */
+#define FILE_STREAM_LINE_BUF        0x01    /**< 行缓冲: 写入换行后立即写回FIL (不含f_sync) */
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 文件流 (成员由模块维护)
+ */
+typedef struct {
+    FIL *fp;                    /**< 关联的文件 */
+    char *buf;                  /**< 缓冲区 */
+    UINT size;                  /**< 缓冲区大小 */
+    UINT pos;                   /**< 写: 缓冲数据长度; 读: 下一个要读的位置 */
+    UINT len;                   /**< 读: 缓冲区有效数据长度 */
+    uint8_t mode;               /**< 0:空闲 1:读 2:写 */
+    uint8_t flags;              /**< FILE_STREAM_x */
+    uint8_t eof;                /**< 已读到文件末尾 */
+    FRESULT err;                /**< 第一次出错的FatFS返回值 */
+} file_stream_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 在已打开的文件上建立文件流
+ * @param s 文件流
+ * @param fp 已打开的文件
+ * @param buf 缓冲区 (流使用期间保持有效)
+ * @param size 缓冲区大小, 至少2字节
+ * @param flags FILE_STREAM_x
+ * @retval 0:成功 -1:参数无效
+ */
+int file_stream_init(file_stream_t *s, FIL *fp, void *buf, UINT size, uint8_t flags);
+
+/**
+ * @brief 写回缓冲数据并解除关联 (不关闭文件)
+ * @param s 文件流
+ * @retval 0:成功 -1:出错
+ */
+int file_stream_close(file_stream_t *s);
+
+/**
+ * @brief 把缓冲的写入数据交给 f_write()
+ * @param s 文件流
+ * @retval 0:成功 -1:出错
+ */
+int file_stream_flush(file_stream_t *s);
+
+/**
+ * @brief 写回缓冲数据并 f_sync() (更新目录项, 掉电不丢失)
+ * @param s 文件流
+ * @retval 0:成功 -1:出错
+ */
+int file_stream_sync(file_stream_t *s);
+
+/**
+ * @brief 写入一个字符
+ * @param s 文件流
+ * @param c 字符
+ * @retval 写入的字符, -1:出错
+ */
+int file_stream_putc(file_stream_t *s, char c);
+
+/**
+ * @brief 写入字符串 (不附加换行)
+ * @param s 文件流
+ * @param str 字符串
+ * @retval 写入的字符数, -1:出错
+ */
+int file_stream_puts(file_stream_t *s, const char *str);
+
+/**
+ * @brief 写入数据
+ * @param s 文件流
+ * @param data 数据
+ * @param len 长度
+ * @retval 写入的字节数, -1:出错
+ * @note 不小于缓冲区的数据在写回缓冲区后直接交给 f_write()
+ */
+int file_stream_write(file_stream_t *s, const void *data, UINT len);
+
+/**
+ * @brief 格式化写入
+ * @param s 文件流
+ * @param fmt 格式字符串
+ * @retval 写入的字符数, -1:出错或一次输出超过缓冲区大小减1
+ */
+int file_stream_printf(file_stream_t *s, const char *fmt, ...);
+
+/**
+ * @brief 格式化写入 (va_list版本)
+ */
+int file_stream_vprintf(file_stream_t *s, const char *fmt, va_list args);
+
+/**
+ * @brief 读取一个字符
+ * @param s 文件流
+ * @retval 字符 (0~255), -1:文件末尾或出错
+ */
+int file_stream_getc(file_stream_t *s);
+
+/**
+ * @brief 读取一行 (与fgets相同: 保留换行, CRLF转为LF)
+ * @param s 文件流
+ * @param line 输出缓冲区
+ * @param len 输出缓冲区大小 (一行更长时分多次读出)
+ * @retval line, NULL:文件末尾 (没有读到任何字符) 或出错
+ */
+char* file_stream_gets(file_stream_t *s, char *line, int len);
+
+/**
+ * @brief 读取数据
+ * @param s 文件流
+ * @param data 输出缓冲区
+ * @param len 长度
+ * @retval 读取的字节数, -1:出错
+ */
+int file_stream_read(file_stream_t *s, void *data, UINT len);
+
+/**
+ * @brief 移动读写位置 (先写回或丢弃缓冲区)
+ * @param s 文件流
+ * @param ofs 距文件开头的字节数
+ * @retval 0:成功 -1:出错
+ */
+int file_stream_seek(file_stream_t *s, FSIZE_t ofs);
+
+/**
+ * @brief 当前逻辑读写位置
+ * @param s 文件流
+ * @retval 距文件开头的字节数
+ */
+FSIZE_t file_stream_tell(const file_stream_t *s);
+
+/**
+ * @brief 是否已读到文件末尾
+ * @param s 文件流
+ * @retval 1:是 0:否
+ */
+uint8_t file_stream_eof(const file_stream_t *s);
+
+/**
+ * @brief 第一次出错的FatFS返回值
+ * @param s 文件流
+ * @retval FR_OK:没有出错
+ */
+FRESULT file_stream_error(const file_stream_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FILE_STREAM_H */
@@ -0,0 +1,200 @@
+/**
+ * @file frame_codec.c
+ * @brief 数据帧编解码模块实现 - CRC16校验 + 字节填充 + 序号
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "frame_codec.h"
+#include "crc.h"
+#include <string.h>
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static void parser_finish(frame_codec_parser_t *parser);
+static uint16_t put_escaped(uint8_t *out, uint16_t pos, uint8_t byte);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化解析器
+ */
+void frame_codec_parser_init(frame_codec_parser_t *parser,
+                             frame_codec_callback_t callback, void *arg)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->callback = callback;
+    parser->arg = arg;
+}
+
+/**
+ * @brief 复位解析器状态
+ */
+void frame_codec_parser_reset(frame_codec_parser_t *parser)
+{
+    parser->in_frame = 0;
+    parser->escape = 0;
+    parser->pos = 0;
+}
+
+/**
+ * @brief 解析一段接收数据
+ */
+void frame_codec_parse(frame_codec_parser_t *parser, const uint8_t *data, uint16_t len)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+
+    while (p < end) {
+        uint8_t byte;
+
+        /* 帧外: 直接跳到下一个帧头 */
+        if (!parser->in_frame) {
+            const uint8_t *hdr = memchr(p, FRAME_CODEC_HEADER, (size_t)(end - p));
+            if (hdr == NULL) {
+                parser->stats.discarded += (uint32_t)(end - p);
+                return;
+            }
+            parser->stats.discarded += (uint32_t)(hdr - p);
+            p = hdr + 1;
+            parser->in_frame = 1;
+            parser->escape = 0;
+            parser->pos = 0;
+            continue;
+        }
+
+        byte = *p++;
+
+        if (byte == FRAME_CODEC_HEADER) {
+            /* 帧头只会出现在帧起始处, 说明上一帧不完整 */
+            parser->stats.resyncs++;
+            parser->escape = 0;
+            parser->pos = 0;
+            continue;
+        }
+
+        if (byte == FRAME_CODEC_TAIL) {
+            if (parser->escape) {
+                parser->stats.format_errors++;
+            } else {
+                parser_finish(parser);
+            }
+            frame_codec_parser_reset(parser);
+            continue;
+        }
+
+        if (byte == FRAME_CODEC_ESC) {
+            if (parser->escape) {
+                parser->stats.format_errors++;
+                frame_codec_parser_reset(parser);
+            } else {
+                parser->escape = 1;
+            }
+            continue;
+        }
+
+        if (parser->escape) {
+            byte ^= FRAME_CODEC_ESC_XOR;
+            parser->escape = 0;
+        }
+
+        if (parser->pos >= sizeof(parser->rx.body)) {
+            parser->stats.format_errors++;
+            frame_codec_parser_reset(parser);
+            continue;
+        }
+
+        parser->rx.body[parser->pos++] = byte;
+    }
+}
+
+/**
+ * @brief 编码一帧
+ */
+uint16_t frame_codec_encode(uint8_t seq, uint8_t cmd, const uint8_t *data, uint8_t len,
+                            uint8_t *out, uint16_t out_size)
+{
+    uint8_t head[3];
+    uint16_t crc;
+    uint16_t pos = 0;
+    uint16_t i;
+
+    if (len > FRAME_CODEC_MAX_DATA || (len > 0 && data == NULL)) {
+        return 0;
+    }
+
+    /* 先按最坏情况检查空间, 编码过程中不再逐字节判断 */
+    if (out_size < FRAME_CODEC_ENCODED_MAX(len)) {
+        return 0;
+    }
+
+    head[0] = seq;
+    head[1] = cmd;
+    head[2] = len;
+    crc = crc16_ccitt_update(CRC16_CCITT_INIT, head, 3);
+    crc = crc16_ccitt_update(crc, data, len);
+
+    out[pos++] = FRAME_CODEC_HEADER;
+    for (i = 0; i < 3; i++) {
+        pos = put_escaped(out, pos, head[i]);
+    }
+    for (i = 0; i < len; i++) {
+        pos = put_escaped(out, pos, data[i]);
+    }
+    pos = put_escaped(out, pos, (uint8_t)(crc >> 8));
+    pos = put_escaped(out, pos, (uint8_t)crc);
+    out[pos++] = FRAME_CODEC_TAIL;
+
+    return pos;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 帧尾到达, 校验并回调
+ */
+static void parser_finish(frame_codec_parser_t *parser)
+{
+    uint16_t pos = parser->pos;
+    uint16_t crc_calc;
+    uint16_t crc_recv;
+
+    if (pos < FRAME_CODEC_BODY_OVERHEAD ||
+        parser->rx.frame.len != pos - FRAME_CODEC_BODY_OVERHEAD) {
+        parser->stats.format_errors++;
+        return;
+    }
+
+    crc_calc = crc16_ccitt_update(CRC16_CCITT_INIT, parser->rx.body, pos - 2);
+    crc_recv = (uint16_t)((parser->rx.body[pos - 2] << 8) | parser->rx.body[pos - 1]);
+    if (crc_calc != crc_recv) {
+        parser->stats.crc_errors++;
+        return;
+    }
+
+    parser->stats.frames++;
+    if (parser->callback != NULL) {
+        parser->callback(&parser->rx.frame, parser->arg);
+    }
+}
+
+/**
+ * @brief 写入一个字节 (必要时转义)
+ */
+static uint16_t put_escaped(uint8_t *out, uint16_t pos, uint8_t byte)
+{
+    if (byte == FRAME_CODEC_HEADER || byte == FRAME_CODEC_TAIL || byte == FRAME_CODEC_ESC) {
+        out[pos++] = FRAME_CODEC_ESC;
+        out[pos++] = byte ^ FRAME_CODEC_ESC_XOR;
+    } else {
+        out[pos++] = byte;
+    }
+    return pos;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file frame_codec.h
+ * @brief 数据帧编解码模块 - CRC16校验 + 字节填充 + 序号
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 帧头/帧尾定界, 负载中的特殊字节经转义后不会出现在线路上
+ *       - 任意位置丢字节/错字节后, 在下一个帧头处自动重新同步
+ *       - CRC-16/CCITT-FALSE 校验 (多项式0x1021, 初值0xFFFF, 见 crc.h)
+ *       - 8位发送序号, 供上层检测丢帧/重传
+ *       - 解析器一次处理一段连续数据 (DMA缓冲区片段), 与硬件无关
+ *
+ * @note 线路格式:
+ *       | 0xAA | ESC( SEQ | CMD | LEN | DATA[0..LEN-1] | CRC_H | CRC_L ) | 0x55 |
+ *       ESC(): 0xAA/0x55/0x7D 替换为 0x7D, byte^0x20
+ *       CRC 覆盖 SEQ..DATA (转义前)
+ */
+
+#ifndef __FRAME_CODEC_H
+#define __FRAME_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 定界与转义字节 */
+#define FRAME_CODEC_HEADER          0xAA
+#define FRAME_CODEC_TAIL            0x55
+#define FRAME_CODEC_ESC             0x7D
+#define FRAME_CODEC_ESC_XOR         0x20
+
+/**
+ * @brief 最大负载长度
+ */
+#define FRAME_CODEC_MAX_DATA        200
+
+/**
+ * @brief 帧体固定开销 (SEQ + CMD + LEN + CRC16)
+ */
+#define FRAME_CODEC_BODY_OVERHEAD   5
+
+/**
+ * @brief 编码后最大长度 (最坏情况每字节都需转义)
+ */
+#define FRAME_CODEC_ENCODED_MAX(len) (2 + 2 * (FRAME_CODEC_BODY_OVERHEAD + (len)))
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 数据帧
+ */
+typedef struct {
+    uint8_t seq;                /**< 序号 */
+    uint8_t cmd;                /**< 命令码 */
+    uint8_t len;                /**< 数据长度 */
+    uint8_t data[FRAME_CODEC_MAX_DATA];  /**< 数据 */
+} frame_codec_frame_t;
+
+/**
+ * @brief 帧接收回调
+ * @param frame 校验通过的数据帧
+ * @param arg 用户参数
+ */
+typedef void (*frame_codec_callback_t)(const frame_codec_frame_t *frame, void *arg);
+
+/**
+ * @brief 解析统计
+ */
+typedef struct {
+    uint32_t frames;            /**< 有效帧数 */
+    uint32_t crc_errors;        /**< CRC错误 */
+    uint32_t format_errors;     /**< 长度/转义错误或超长 */
+    uint32_t resyncs;           /**< 帧中途遇到帧头重新同步次数 */
+    uint32_t discarded;         /**< 帧外丢弃的字节数 */
+} frame_codec_stats_t;
+
+/**
+ * @brief 解析器 (可多实例)
+ */
+typedef struct {
+    uint8_t in_frame;           /**< 正在接收帧体 */
+    uint8_t escape;             /**< 上一字节为转义符 */
+    uint16_t pos;               /**< 帧体已接收长度 */
+    union {
+        frame_codec_frame_t frame;  /**< 帧体布局与帧结构一致, 完成时无需拷贝 */
+        uint8_t body[FRAME_CODEC_MAX_DATA + FRAME_CODEC_BODY_OVERHEAD];
+    } rx;                       /**< 帧体缓冲 */
+    frame_codec_callback_t callback;  /**< 帧回调 */
+    void *arg;                  /**< 回调参数 */
+    frame_codec_stats_t stats;  /**< 统计 */
+} frame_codec_parser_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 初始化解析器
+ * @param parser 解析器
+ * @param callback 帧回调
+ * @param arg 回调参数
+ */
+void frame_codec_parser_init(frame_codec_parser_t *parser,
+                             frame_codec_callback_t callback, void *arg);
+
+/**
+ * @brief 复位解析器状态 (保留回调和统计)
+ * @param parser 解析器
+ */
+void frame_codec_parser_reset(frame_codec_parser_t *parser);
+
+/**
+ * @brief 解析一段接收数据
+ * @param parser 解析器
+ * @param data 数据
+ * @param len 长度
+ * @note 每解析出一帧调用一次回调, 回调中的帧指针仅在回调期间有效
+ */
+void frame_codec_parse(frame_codec_parser_t *parser, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 编码一帧
+ * @param seq 序号
+ * @param cmd 命令码
+ * @param data 负载 (len为0时可为NULL)
+ * @param len 负载长度
+ * @param out 输出缓冲区
+ * @param out_size 输出缓冲区大小, 建议 FRAME_CODEC_ENCODED_MAX(len)
+ * @retval 编码后长度, 失败返回0
+ */
+uint16_t frame_codec_encode(uint8_t seq, uint8_t cmd, const uint8_t *data, uint8_t len,
+                            uint8_t *out, uint16_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAME_CODEC_H */
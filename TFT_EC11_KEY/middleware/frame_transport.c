@@ -0,0 +1,448 @@
+/**
+ * @file frame_transport.c
+ * @brief 可靠传输层实现 - 滑动窗口 + 选择确认 + 流量控制
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "frame_transport.h"
+#include <string.h>
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define WIN                         FRAME_TRANSPORT_WINDOW
+#define SLOT(seq)                   ((uint8_t)(seq) & (WIN - 1))
+
+#if (WIN & (WIN - 1)) != 0 || WIN > 32
+#error "FRAME_TRANSPORT_WINDOW must be a power of 2 and not exceed 32"
+#endif
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static int enqueue(frame_transport_t *t, uint8_t cmd, const uint8_t *data, uint8_t len);
+static void transmit(frame_transport_t *t, uint8_t seq, frame_transport_tx_slot_t *slot);
+static void handle_ack(frame_transport_t *t, const frame_codec_frame_t *frame);
+static void handle_sync(frame_transport_t *t, const frame_codec_frame_t *frame);
+static void deliver_in_order(frame_transport_t *t);
+static void schedule_ack(frame_transport_t *t, uint8_t immediate);
+static void send_ack(frame_transport_t *t);
+static void link_fail(frame_transport_t *t);
+static uint32_t get_u32(const uint8_t *p);
+static void put_u32(uint8_t *p, uint32_t val);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化传输端点
+ */
+int frame_transport_init(frame_transport_t *t, frame_transport_output_t output,
+                         frame_transport_deliver_t deliver, void *ctx)
+{
+    if (t == NULL || output == NULL || deliver == NULL) {
+        return -1;
+    }
+
+    memset(t, 0, sizeof(*t));
+    t->output = output;
+    t->deliver = deliver;
+    t->ctx = ctx;
+    t->peer_window = WIN;
+
+    return 0;
+}
+
+/**
+ * @brief 设置链路失败回调
+ */
+void frame_transport_set_fail_callback(frame_transport_t *t, frame_transport_fail_t on_fail)
+{
+    t->on_fail = on_fail;
+}
+
+/**
+ * @brief 复位并发起同步
+ */
+void frame_transport_reset(frame_transport_t *t)
+{
+    uint8_t payload[4];
+
+    memset(t->tx, 0, sizeof(t->tx));
+    memset(t->rx, 0, sizeof(t->rx));
+    t->tx_base = t->tx_next;
+    t->peer_ack = t->tx_next;
+    t->peer_window = WIN;
+    t->rx_blocked = 0;
+    t->ack_pending = 0;
+
+    /* 会话号区分"对端复位"与"同步帧重传" */
+    t->session = (t->now << 8) | ((t->session + 1) & 0xFF);
+    put_u32(payload, t->session);
+    enqueue(t, FRAME_TRANSPORT_CMD_SYNC, payload, sizeof(payload));
+}
+
+/**
+ * @brief 可靠发送一帧
+ */
+int frame_transport_send(frame_transport_t *t, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    if (cmd == FRAME_TRANSPORT_CMD_ACK || cmd == FRAME_TRANSPORT_CMD_SYNC) {
+        return -1;
+    }
+
+    return enqueue(t, cmd, data, len);
+}
+
+/**
+ * @brief 输入一帧
+ */
+void frame_transport_input(frame_transport_t *t, const frame_codec_frame_t *frame)
+{
+    uint8_t offset;
+    frame_transport_rx_slot_t *slot;
+
+    if (frame->cmd == FRAME_TRANSPORT_CMD_ACK) {
+        handle_ack(t, frame);
+        return;
+    }
+
+    if (frame->cmd == FRAME_TRANSPORT_CMD_SYNC) {
+        handle_sync(t, frame);
+        return;
+    }
+
+    offset = (uint8_t)(frame->seq - t->rx_base);
+
+    if (offset >= WIN) {
+        if ((uint8_t)(t->rx_base - frame->seq) <= WIN) {
+            /* 已交付过的帧: 对端没收到应答, 立即补发 */
+            t->stats.duplicates++;
+            schedule_ack(t, 1);
+        } else {
+            t->stats.out_of_window++;
+        }
+        return;
+    }
+
+    slot = &t->rx[SLOT(frame->seq)];
+    if (slot->valid) {
+        t->stats.duplicates++;
+        schedule_ack(t, 1);
+        return;
+    }
+
+    slot->valid = 1;
+    slot->cmd = frame->cmd;
+    slot->len = frame->len;
+    memcpy(slot->data, frame->data, frame->len);
+
+    deliver_in_order(t);
+
+    /* 乱序到达说明前面有丢帧, 立即应答让对端尽快补发 */
+    schedule_ack(t, offset != 0);
+}
+
+/**
+ * @brief 轮询
+ */
+void frame_transport_poll(frame_transport_t *t, uint32_t now_ms)
+{
+    uint8_t seq;
+
+    t->now = now_ms;
+
+    /* 上层反压解除后继续交付 */
+    if (t->rx_blocked) {
+        uint8_t base = t->rx_base;
+        deliver_in_order(t);
+        if (t->rx_base != base) {
+            schedule_ack(t, 1);
+        }
+    }
+
+    /* 超时重传 */
+    for (seq = t->tx_base; seq != t->tx_next; seq++) {
+        frame_transport_tx_slot_t *slot = &t->tx[SLOT(seq)];
+
+        if (!slot->used || slot->acked) {
+            continue;
+        }
+        if ((int32_t)(now_ms - slot->deadline) < 0) {
+            continue;
+        }
+
+        if (slot->retries >= FRAME_TRANSPORT_MAX_RETRIES) {
+            link_fail(t);
+            return;
+        }
+
+        slot->retries++;
+        slot->rto = (slot->rto * 2 > FRAME_TRANSPORT_RTO_MAX_MS) ?
+                    FRAME_TRANSPORT_RTO_MAX_MS : (uint16_t)(slot->rto * 2);
+        t->stats.retransmits++;
+        transmit(t, seq, slot);
+    }
+
+    /* 延迟应答 */
+    if (t->ack_pending && (int32_t)(now_ms - t->ack_deadline) >= 0) {
+        send_ack(t);
+    }
+}
+
+/**
+ * @brief 获取可立即发送的帧数
+ */
+uint8_t frame_transport_tx_free(const frame_transport_t *t)
+{
+    int16_t by_window = WIN - (uint8_t)(t->tx_next - t->tx_base);
+    int16_t by_peer = (int16_t)(int8_t)(uint8_t)(t->peer_ack + t->peer_window - t->tx_next);
+
+    if (by_peer < by_window) {
+        by_window = by_peer;
+    }
+
+    return (by_window > 0) ? (uint8_t)by_window : 0;
+}
+
+/**
+ * @brief 所有已发送帧是否都已确认
+ */
+uint8_t frame_transport_tx_idle(const frame_transport_t *t)
+{
+    return (t->tx_base == t->tx_next) ? 1 : 0;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 放入发送窗口并立即发送
+ */
+static int enqueue(frame_transport_t *t, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    frame_transport_tx_slot_t *slot;
+    uint8_t seq;
+
+    if (len > FRAME_CODEC_MAX_DATA || (len > 0 && data == NULL)) {
+        return -1;
+    }
+
+    if (frame_transport_tx_free(t) == 0) {
+        return -1;
+    }
+
+    seq = t->tx_next++;
+    slot = &t->tx[SLOT(seq)];
+    slot->used = 1;
+    slot->acked = 0;
+    slot->fast = 0;
+    slot->retries = 0;
+    slot->rto = FRAME_TRANSPORT_RTO_MS;
+    slot->cmd = cmd;
+    slot->len = len;
+    if (len > 0) {
+        memcpy(slot->data, data, len);
+    }
+
+    t->stats.sent++;
+    transmit(t, seq, slot);
+
+    return 0;
+}
+
+/**
+ * @brief 发送 (首发或重传)
+ */
+static void transmit(frame_transport_t *t, uint8_t seq, frame_transport_tx_slot_t *slot)
+{
+    slot->deadline = t->now + slot->rto;
+    t->output(t->ctx, seq, slot->cmd, slot->data, slot->len);
+}
+
+/**
+ * @brief 处理应答
+ */
+static void handle_ack(frame_transport_t *t, const frame_codec_frame_t *frame)
+{
+    uint8_t next;
+    uint32_t bitmap;
+    uint8_t in_flight;
+    uint8_t i;
+
+    if (frame->len < FRAME_TRANSPORT_ACK_LEN) {
+        return;
+    }
+
+    next = frame->data[0];
+    bitmap = get_u32(&frame->data[1]);
+    in_flight = (uint8_t)(t->tx_next - t->tx_base);
+
+    /* 确认号必须落在 [tx_base, tx_next] 内, 否则为过期应答 */
+    if ((uint8_t)(next - t->tx_base) > in_flight) {
+        return;
+    }
+
+    t->stats.acks_received++;
+
+    /* 累计确认: 释放next之前的所有帧 */
+    while (t->tx_base != next) {
+        t->tx[SLOT(t->tx_base)].used = 0;
+        t->tx_base++;
+    }
+
+    /* 选择确认: 标记已收到的帧, 不再重传 */
+    in_flight = (uint8_t)(t->tx_next - t->tx_base);
+    for (i = 0; i < WIN - 1 && (uint8_t)(i + 1) < in_flight; i++) {
+        if (bitmap & (1UL << i)) {
+            t->tx[SLOT(next + 1 + i)].acked = 1;
+        }
+    }
+
+    t->peer_ack = next;
+    t->peer_window = frame->data[5];
+
+    /* 对端已收到后续帧而next缺失: 快速重传一次, 不必等超时 */
+    if (bitmap != 0 && in_flight > 0) {
+        frame_transport_tx_slot_t *slot = &t->tx[SLOT(next)];
+        if (slot->used && !slot->fast) {
+            slot->fast = 1;
+            t->stats.retransmits++;
+            transmit(t, next, slot);
+        }
+    }
+}
+
+/**
+ * @brief 处理同步帧
+ */
+static void handle_sync(frame_transport_t *t, const frame_codec_frame_t *frame)
+{
+    uint32_t session;
+
+    if (frame->len < 4) {
+        return;
+    }
+
+    session = get_u32(frame->data);
+
+    if (!t->rx_synced || session != t->rx_session) {
+        /* 新会话: 以同步帧的下一个序号为接收起点 */
+        memset(t->rx, 0, sizeof(t->rx));
+        t->rx_base = (uint8_t)(frame->seq + 1);
+        t->rx_session = session;
+        t->rx_synced = 1;
+        t->rx_blocked = 0;
+    } else {
+        t->stats.duplicates++;
+    }
+
+    schedule_ack(t, 1);
+}
+
+/**
+ * @brief 按序交付
+ */
+static void deliver_in_order(frame_transport_t *t)
+{
+    t->rx_blocked = 0;
+
+    while (t->rx[SLOT(t->rx_base)].valid) {
+        frame_transport_rx_slot_t *slot = &t->rx[SLOT(t->rx_base)];
+
+        if (t->deliver(t->ctx, slot->cmd, slot->data, slot->len) != 0) {
+            t->rx_blocked = 1;
+            break;
+        }
+
+        slot->valid = 0;
+        t->rx_base++;
+        t->stats.delivered++;
+    }
+}
+
+/**
+ * @brief 安排应答
+ */
+static void schedule_ack(frame_transport_t *t, uint8_t immediate)
+{
+    if (immediate) {
+        send_ack(t);
+        return;
+    }
+
+    if (!t->ack_pending) {
+        t->ack_pending = 1;
+        t->ack_deadline = t->now + FRAME_TRANSPORT_ACK_DELAY_MS;
+    }
+}
+
+/**
+ * @brief 发送应答
+ */
+static void send_ack(frame_transport_t *t)
+{
+    uint8_t payload[FRAME_TRANSPORT_ACK_LEN];
+    uint32_t bitmap = 0;
+    uint8_t held = 0;
+    uint8_t i;
+
+    for (i = 0; i < WIN; i++) {
+        if (t->rx[SLOT(t->rx_base + i)].valid) {
+            held++;
+            if (i > 0) {
+                bitmap |= 1UL << (i - 1);
+            }
+        }
+    }
+
+    payload[0] = t->rx_base;
+    put_u32(&payload[1], bitmap);
+    payload[5] = WIN - held;
+
+    t->ack_pending = 0;
+    t->stats.acks_sent++;
+    t->output(t->ctx, 0, FRAME_TRANSPORT_CMD_ACK, payload, sizeof(payload));
+}
+
+/**
+ * @brief 链路失败: 丢弃发送窗口并通知上层
+ */
+static void link_fail(frame_transport_t *t)
+{
+    memset(t->tx, 0, sizeof(t->tx));
+    t->tx_base = t->tx_next;
+    t->peer_ack = t->tx_next;
+    t->peer_window = WIN;
+    t->stats.link_failures++;
+
+    if (t->on_fail != NULL) {
+        t->on_fail(t->ctx);
+    }
+}
+
+/**
+ * @brief 小端读取32位数
+ */
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief 小端写入32位数
+ */
+static void put_u32(uint8_t *p, uint32_t val)
+{
+    p[0] = (uint8_t)val;
+    p[1] = (uint8_t)(val >> 8);
+    p[2] = (uint8_t)(val >> 16);
+    p[3] = (uint8_t)(val >> 24);
+}
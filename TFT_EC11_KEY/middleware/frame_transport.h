@@ -0,0 +1,252 @@
+/**
+ * @file frame_transport.h
+ * @brief 可靠传输层 - 滑动窗口 + 选择确认 + 流量控制
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 基于frame_codec的序号, 发送窗口内可连续发送多帧, 不必逐帧等待应答
+ *       - 选择确认(SACK): 应答携带累计确认号和位图, 只重传真正丢失的帧
+ *       - 超时重传, 指数退避, 超过重试次数判定链路失败
+ *       - 延迟应答: 短时间内收到的多帧合并为一个应答
+ *       - 流量控制: 应答中通告接收方空闲窗口, 上层暂不能接收时反压
+ *       - 与硬件无关, 收发通过回调, 时间由调用者传入 (可在PC端运行两个端点)
+ *
+ * @note 应答帧格式 (cmd = FRAME_TRANSPORT_CMD_ACK, 不占用序号):
+ *       | next_seq | sack_bitmap(4, 小端) | window |
+ *       next_seq: 期望的下一个序号 (之前的帧均已收到)
+ *       sack_bitmap: bit i 表示 next_seq+1+i 已收到
+ *       window: 接收方还能接收的帧数
+ *
+ * @note 同步帧 (cmd = FRAME_TRANSPORT_CMD_SYNC) 本身可靠发送,
+ *       接收方收到后以其序号为新起点, 用于连接建立或对端复位后重新同步
+ */
+
+#ifndef __FRAME_TRANSPORT_H
+#define __FRAME_TRANSPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "frame_codec.h"
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/**
+ * @brief 窗口大小 (帧数, 不超过32)
+ */
+#define FRAME_TRANSPORT_WINDOW          8
+
+/**
+ * @brief 初始重传超时 (ms)
+ */
+#define FRAME_TRANSPORT_RTO_MS          300
+
+/**
+ * @brief 最大重传超时 (ms)
+ */
+#define FRAME_TRANSPORT_RTO_MAX_MS      3000
+
+/**
+ * @brief 最大重传次数, 超过后判定链路失败
+ */
+#define FRAME_TRANSPORT_MAX_RETRIES     8
+
+/**
+ * @brief 延迟应答时间 (ms)
+ */
+#define FRAME_TRANSPORT_ACK_DELAY_MS    20
+
+/**
+ * @brief 建议的轮询周期 (ms)
+ */
+#define FRAME_TRANSPORT_POLL_MS         10
+
+/* 传输层保留命令码 */
+#define FRAME_TRANSPORT_CMD_ACK         0x01
+#define FRAME_TRANSPORT_CMD_SYNC        0x03
+
+/* 应答负载长度 */
+#define FRAME_TRANSPORT_ACK_LEN         6
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 帧输出接口
+ * @param ctx 用户上下文
+ * @param seq 序号
+ * @param cmd 命令码
+ * @param data 数据
+ * @param len 长度
+ * @retval 0:成功 -1:失败
+ */
+typedef int (*frame_transport_output_t)(void *ctx, uint8_t seq, uint8_t cmd,
+                                        const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 按序交付接口
+ * @param ctx 用户上下文
+ * @param cmd 命令码
+ * @param data 数据
+ * @param len 长度
+ * @retval 0:已接收 -1:暂不能接收 (帧保留在窗口中, 稍后重试交付)
+ */
+typedef int (*frame_transport_deliver_t)(void *ctx, uint8_t cmd,
+                                         const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 链路失败回调
+ * @param ctx 用户上下文
+ */
+typedef void (*frame_transport_fail_t)(void *ctx);
+
+/**
+ * @brief 发送槽
+ */
+typedef struct {
+    uint8_t used;               /**< 占用 */
+    uint8_t acked;              /**< 已被选择确认 */
+    uint8_t cmd;                /**< 命令码 */
+    uint8_t len;                /**< 数据长度 */
+    uint8_t retries;            /**< 已重传次数 */
+    uint8_t fast;               /**< 已执行过快速重传 */
+    uint16_t rto;               /**< 当前超时 (ms) */
+    uint32_t deadline;          /**< 重传时间点 */
+    uint8_t data[FRAME_CODEC_MAX_DATA];  /**< 数据 */
+} frame_transport_tx_slot_t;
+
+/**
+ * @brief 接收槽
+ */
+typedef struct {
+    uint8_t valid;              /**< 已收到, 等待按序交付 */
+    uint8_t cmd;                /**< 命令码 */
+    uint8_t len;                /**< 数据长度 */
+    uint8_t data[FRAME_CODEC_MAX_DATA];  /**< 数据 */
+} frame_transport_rx_slot_t;
+
+/**
+ * @brief 传输统计
+ */
+typedef struct {
+    uint32_t sent;              /**< 首次发送帧数 */
+    uint32_t retransmits;       /**< 重传帧数 */
+    uint32_t delivered;         /**< 按序交付帧数 */
+    uint32_t duplicates;        /**< 重复帧 */
+    uint32_t out_of_window;     /**< 窗口外丢弃 */
+    uint32_t acks_sent;         /**< 发送应答数 */
+    uint32_t acks_received;     /**< 收到应答数 */
+    uint32_t link_failures;     /**< 链路失败次数 */
+} frame_transport_stats_t;
+
+/**
+ * @brief 传输端点
+ */
+typedef struct {
+    frame_transport_output_t output;    /**< 帧输出 */
+    frame_transport_deliver_t deliver;  /**< 按序交付 */
+    frame_transport_fail_t on_fail;     /**< 链路失败 */
+    void *ctx;                  /**< 用户上下文 */
+
+    uint32_t now;               /**< 最近一次轮询时间 (ms) */
+    uint32_t session;           /**< 本端会话号 (同步帧携带) */
+
+    /* 发送方向 */
+    uint8_t tx_base;            /**< 最早未确认序号 */
+    uint8_t tx_next;            /**< 下一个待分配序号 */
+    uint8_t peer_ack;           /**< 对端最近的累计确认号 */
+    uint8_t peer_window;        /**< 对端通告的接收窗口 */
+    frame_transport_tx_slot_t tx[FRAME_TRANSPORT_WINDOW];
+
+    /* 接收方向 */
+    uint8_t rx_base;            /**< 期望的下一个序号 */
+    uint8_t rx_synced;          /**< 已收到同步帧 */
+    uint8_t rx_blocked;         /**< 上层反压, 等待重试交付 */
+    uint32_t rx_session;        /**< 对端会话号 */
+    uint8_t ack_pending;        /**< 待发送应答 */
+    uint32_t ack_deadline;      /**< 应答发送时间点 */
+    frame_transport_rx_slot_t rx[FRAME_TRANSPORT_WINDOW];
+
+    frame_transport_stats_t stats;  /**< 统计 */
+} frame_transport_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 初始化传输端点
+ * @param t 端点
+ * @param output 帧输出
+ * @param deliver 按序交付
+ * @param ctx 用户上下文
+ * @retval 0:成功 -1:失败
+ */
+int frame_transport_init(frame_transport_t *t, frame_transport_output_t output,
+                         frame_transport_deliver_t deliver, void *ctx);
+
+/**
+ * @brief 设置链路失败回调
+ * @param t 端点
+ * @param on_fail 回调
+ */
+void frame_transport_set_fail_callback(frame_transport_t *t, frame_transport_fail_t on_fail);
+
+/**
+ * @brief 复位并发起同步
+ * @param t 端点
+ * @note 清空收发窗口, 并可靠发送一个同步帧通知对端
+ */
+void frame_transport_reset(frame_transport_t *t);
+
+/**
+ * @brief 可靠发送一帧
+ * @param t 端点
+ * @param cmd 命令码 (不能为传输层保留命令码)
+ * @param data 数据
+ * @param len 长度
+ * @retval 0:已进入发送窗口 -1:窗口已满或参数错误
+ */
+int frame_transport_send(frame_transport_t *t, uint8_t cmd, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 输入一帧 (帧解析器回调中调用)
+ * @param t 端点
+ * @param frame 收到的帧
+ */
+void frame_transport_input(frame_transport_t *t, const frame_codec_frame_t *frame);
+
+/**
+ * @brief 轮询: 重传超时帧, 发送延迟应答, 重试被反压的交付
+ * @param t 端点
+ * @param now_ms 当前时间 (ms)
+ * @note 建议每 FRAME_TRANSPORT_POLL_MS 调用一次
+ */
+void frame_transport_poll(frame_transport_t *t, uint32_t now_ms);
+
+/**
+ * @brief 获取可立即发送的帧数
+ * @param t 端点
+ * @retval 帧数
+ */
+uint8_t frame_transport_tx_free(const frame_transport_t *t);
+
+/**
+ * @brief 所有已发送帧是否都已确认
+ * @param t 端点
+ * @retval 1:是 0:否
+ */
+uint8_t frame_transport_tx_idle(const frame_transport_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAME_TRANSPORT_H */
@@ -0,0 +1,206 @@
+/**
+ * @file freq_meter.c
+ * @brief 频率计实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "freq_meter.h"
+#include <stddef.h>
+#include <string.h>
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static void window_clear(freq_meter_t *fm);
+static int accumulate(freq_meter_t *fm, uint32_t interval, uint32_t high, uint32_t cycles);
+static void publish(freq_meter_t *fm);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化频率计
+ */
+void freq_meter_init(freq_meter_t *fm, uint32_t clock_hz, uint32_t gate_us)
+{
+    memset(fm, 0, sizeof(freq_meter_t));
+    fm->clock_hz = clock_hz;
+    fm->edges_per_stamp = 1;
+    window_clear(fm);
+    freq_meter_set_gate(fm, gate_us);
+}
+
+/**
+ * @brief 设置闸门时间
+ * @note 限制在2^32个时钟以内, 保证窗口累计值的乘法不溢出
+ */
+void freq_meter_set_gate(freq_meter_t *fm, uint32_t gate_us)
+{
+    uint64_t ticks = (uint64_t)gate_us * fm->clock_hz / 1000000;
+
+    if (ticks == 0) {
+        ticks = 1;
+    } else if (ticks > 0xFFFFFFFFULL) {
+        ticks = 0xFFFFFFFFULL;
+    }
+
+    fm->gate_ticks = ticks;
+}
+
+/**
+ * @brief 设置每个时间戳代表的周期数
+ */
+void freq_meter_set_prescaler(freq_meter_t *fm, uint8_t edges)
+{
+    fm->edges_per_stamp = (edges != 0) ? edges : 1;
+    freq_meter_reset(fm);
+}
+
+/**
+ * @brief 丢弃当前窗口和结果
+ */
+void freq_meter_reset(freq_meter_t *fm)
+{
+    fm->started = 0;
+    window_clear(fm);
+    memset(&fm->result, 0, sizeof(freq_result_t));
+}
+
+/**
+ * @brief 输入上升沿时间戳
+ */
+int freq_meter_feed_stamps(freq_meter_t *fm, const uint32_t *stamps, uint16_t count)
+{
+    uint16_t i;
+    int updated = 0;
+
+    fm->has_duty = 0;
+
+    for (i = 0; i < count; i++) {
+        if (!fm->started) {
+            fm->started = 1;
+            fm->last = stamps[i];
+            continue;
+        }
+
+        /* 无符号减法处理计数器回绕 */
+        updated |= accumulate(fm, stamps[i] - fm->last, 0, fm->edges_per_stamp);
+        fm->last = stamps[i];
+    }
+
+    return updated;
+}
+
+/**
+ * @brief 输入一个完整周期
+ */
+int freq_meter_feed_pwm(freq_meter_t *fm, uint32_t period, uint32_t high)
+{
+    if (period == 0) {
+        return 0;
+    }
+
+    fm->has_duty = 1;
+
+    return accumulate(fm, period, (high < period) ? high : period, 1);
+}
+
+/**
+ * @brief 输入闸门时间内的脉冲数
+ */
+int freq_meter_feed_count(freq_meter_t *fm, uint32_t pulses, uint32_t gate_us)
+{
+    freq_result_t *r = &fm->result;
+    uint64_t period_ns;
+
+    if (gate_us == 0) {
+        return 0;
+    }
+
+    r->freq_mhz = (uint64_t)pulses * 1000000000ULL / gate_us;
+    period_ns = (pulses != 0) ? (uint64_t)gate_us * 1000 / pulses : 0;
+    r->period_ns = (period_ns > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32_t)period_ns;
+    r->duty_permille = FREQ_METER_DUTY_UNKNOWN;
+    r->jitter_ns = 0;
+    r->cycles = pulses;
+    r->valid = 1;
+
+    return 1;
+}
+
+/**
+ * @brief 读取最近一次结果
+ */
+const freq_result_t* freq_meter_get(const freq_meter_t *fm)
+{
+    return &fm->result;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 开始新窗口 (保留起始时间戳, 窗口首尾相接)
+ */
+static void window_clear(freq_meter_t *fm)
+{
+    fm->ticks = 0;
+    fm->high = 0;
+    fm->cycles = 0;
+    fm->min_interval = 0xFFFFFFFF;
+    fm->max_interval = 0;
+}
+
+/**
+ * @brief 累计一个间隔, 达到闸门时间时输出结果
+ */
+static int accumulate(freq_meter_t *fm, uint32_t interval, uint32_t high, uint32_t cycles)
+{
+    fm->ticks += interval;
+    fm->high += high;
+    fm->cycles += cycles;
+
+    if (interval < fm->min_interval) {
+        fm->min_interval = interval;
+    }
+    if (interval > fm->max_interval) {
+        fm->max_interval = interval;
+    }
+
+    if (fm->ticks < fm->gate_ticks || fm->ticks == 0) {
+        return 0;
+    }
+
+    publish(fm);
+    window_clear(fm);
+
+    return 1;
+}
+
+/**
+ * @brief 由窗口累计值计算结果
+ * @note ticks < 2^33 (闸门 + 一个间隔), cycles * clock_hz < 2^64, 各乘法均不溢出
+ */
+static void publish(freq_meter_t *fm)
+{
+    freq_result_t *r = &fm->result;
+    uint64_t num = (uint64_t)fm->cycles * fm->clock_hz;
+    uint64_t period_ns, jitter_ns;
+
+    /* 商和余数分开放大, 避免 num * 1000 溢出 */
+    r->freq_mhz = num / fm->ticks * 1000 + num % fm->ticks * 1000 / fm->ticks;
+
+    period_ns = fm->ticks * 1000000000ULL / num;
+    r->period_ns = (period_ns > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32_t)period_ns;
+
+    r->duty_permille = fm->has_duty ? (uint16_t)(fm->high * 1000 / fm->ticks) : FREQ_METER_DUTY_UNKNOWN;
+    jitter_ns = (uint64_t)(fm->max_interval - fm->min_interval) * 1000000000ULL / fm->clock_hz;
+    r->jitter_ns = (jitter_ns > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32_t)jitter_ns;
+    r->cycles = fm->cycles;
+    r->valid = 1;
+}
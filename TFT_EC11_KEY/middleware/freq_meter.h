@@ -0,0 +1,147 @@
+/**
+ * @file freq_meter.h
+ * @brief 频率计 - 由捕获数据计算频率、周期、占空比和抖动
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 倒数法 (时间戳/PWM输入): 统计闸门时间内整数个周期的总计数时钟数,
+ *         频率 = 周期数 * 计数时钟 / 时钟数, 相对误差约 1/时钟数, 与信号频率无关;
+ *         闸门从边沿开始到边沿结束, 低频信号每个周期都能出结果
+ *       - 闸门计数法 (脉冲计数): 频率 = 脉冲数 / 闸门时间, 适合超过捕获DMA能力的高频信号
+ *       - 频率以mHz为单位的整数给出, 不用浮点
+ *       - 与硬件无关, 数据可以来自 bsp_capture 或其他来源
+ *
+ * @note 使用方法:
+ *       1. freq_meter_init(&fm, CAPTURE_CLOCK_HZ, 100000);   闸门100ms
+ *       2. 按捕获模式调用 freq_meter_feed_stamps / feed_pwm / feed_count, 返回1时有新结果
+ *       3. freq_meter_get(&fm) 读取结果
+ *       4. 信号中断后调用 freq_meter_reset(), 避免把停顿时间算作一个周期
+ */
+
+#ifndef __FREQ_METER_H
+#define __FREQ_METER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 占空比未知 (时间戳和计数模式只有上升沿) */
+#define FREQ_METER_DUTY_UNKNOWN     0xFFFF
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 测量结果
+ */
+typedef struct {
+    uint64_t freq_mhz;          /**< 频率 (mHz) */
+    uint32_t period_ns;         /**< 平均周期 (ns) */
+    uint16_t duty_permille;     /**< 占空比 (0.1%), FREQ_METER_DUTY_UNKNOWN 为未知 */
+    uint32_t jitter_ns;         /**< 窗口内采样间隔的峰峰值抖动 (ns, 超过约4.29s时为0xFFFFFFFF), 计数模式为0 */
+    uint32_t cycles;            /**< 窗口内的周期数 (计数模式为脉冲数) */
+    uint8_t valid;              /**< 1:结果有效 */
+} freq_result_t;
+
+/**
+ * @brief 频率计状态 (成员由模块维护)
+ */
+typedef struct {
+    uint32_t clock_hz;          /**< 计数时钟 */
+    uint64_t gate_ticks;        /**< 闸门时间 (计数时钟数) */
+    uint8_t edges_per_stamp;    /**< 每个时间戳间隔的周期数 (捕获预分频) */
+
+    /* 当前窗口 */
+    uint8_t started;            /**< 已有起始时间戳 */
+    uint32_t last;              /**< 上一个时间戳 */
+    uint64_t ticks;             /**< 累计时钟数 */
+    uint64_t high;              /**< 累计高电平时钟数 */
+    uint32_t cycles;            /**< 累计周期数 */
+    uint32_t min_interval;      /**< 最短间隔 */
+    uint32_t max_interval;      /**< 最长间隔 */
+    uint8_t has_duty;           /**< 窗口数据带高电平时间 */
+
+    freq_result_t result;
+} freq_meter_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 初始化频率计
+ * @param fm 频率计
+ * @param clock_hz 时间戳/周期的计数时钟 (Hz)
+ * @param gate_us 闸门时间 (us), 窗口至少这么长才出结果
+ */
+void freq_meter_init(freq_meter_t *fm, uint32_t clock_hz, uint32_t gate_us);
+
+/**
+ * @brief 设置闸门时间 (下一个窗口生效)
+ * @param fm 频率计
+ * @param gate_us 闸门时间 (us)
+ */
+void freq_meter_set_gate(freq_meter_t *fm, uint32_t gate_us);
+
+/**
+ * @brief 设置每个时间戳代表的周期数 (与捕获预分频一致), 并重新开始窗口
+ * @param fm 频率计
+ * @param edges 1/2/4/8
+ */
+void freq_meter_set_prescaler(freq_meter_t *fm, uint8_t edges);
+
+/**
+ * @brief 丢弃当前窗口和结果 (信号中断或切换模式后调用)
+ * @param fm 频率计
+ */
+void freq_meter_reset(freq_meter_t *fm);
+
+/**
+ * @brief 输入上升沿时间戳 (倒数法)
+ * @param fm 频率计
+ * @param stamps 计数值 (32位回绕, 相邻两个的间隔必须小于2^32个时钟)
+ * @param count 个数
+ * @retval 1:产生了新结果 0:窗口未满
+ */
+int freq_meter_feed_stamps(freq_meter_t *fm, const uint32_t *stamps, uint16_t count);
+
+/**
+ * @brief 输入一个完整周期 (PWM输入模式)
+ * @param fm 频率计
+ * @param period 周期 (时钟数)
+ * @param high 高电平时间 (时钟数)
+ * @retval 1:产生了新结果 0:窗口未满
+ * @note 样本不需要连续, 窗口结果是各样本的平均
+ */
+int freq_meter_feed_pwm(freq_meter_t *fm, uint32_t period, uint32_t high);
+
+/**
+ * @brief 输入闸门时间内的脉冲数 (闸门计数法)
+ * @param fm 频率计
+ * @param pulses 脉冲数
+ * @param gate_us 实际闸门时间 (us)
+ * @retval 1:产生了新结果 0:闸门时间为0
+ */
+int freq_meter_feed_count(freq_meter_t *fm, uint32_t pulses, uint32_t gate_us);
+
+/**
+ * @brief 读取最近一次结果
+ * @param fm 频率计
+ * @retval 结果 (valid为0表示还没有结果)
+ */
+const freq_result_t* freq_meter_get(const freq_meter_t *fm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FREQ_METER_H */
@@ -0,0 +1,217 @@
+/**
+ * @file input_queue.c
+ * @brief 输入事件队列实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "input_queue.h"
+#include <stddef.h>
+#include <string.h>
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define LANE_MASK                   (INPUT_LANE_SIZE - 1)
+
+/* 编译器屏障: 事件内容写完后才发布下标 (单核Cortex-M不需要硬件屏障) */
+#if defined(__CC_ARM)
+#define QUEUE_BARRIER()             __schedule_barrier()
+#else
+#define QUEUE_BARRIER()             __asm volatile ("" ::: "memory")
+#endif
+
+/**
+ * @brief 单生产者/单消费者通道
+ *        head只由生产者写, tail只由消费者写, 下标自由递增, 差值即事件数
+ */
+typedef struct {
+    input_event_t buf[INPUT_LANE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint32_t dropped;      /**< 只由生产者写 */
+} input_lane_t;
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+static input_lane_t lanes[INPUT_LANE_COUNT];
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static const input_event_t* oldest(uint8_t *lane);
+static void consume(uint8_t lane);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 清空队列
+ */
+void input_queue_init(void)
+{
+    memset(lanes, 0, sizeof(lanes));
+}
+
+/**
+ * @brief 入队
+ */
+int input_queue_push(uint8_t lane, const input_event_t *event)
+{
+    input_lane_t *l;
+    uint8_t head;
+
+    if (lane >= INPUT_LANE_COUNT) {
+        return -1;
+    }
+
+    l = &lanes[lane];
+    head = l->head;
+
+    if ((uint8_t)(head - l->tail) >= INPUT_LANE_SIZE) {
+        l->dropped++;
+        return -1;
+    }
+
+    l->buf[head & LANE_MASK] = *event;
+    QUEUE_BARRIER();
+    l->head = (uint8_t)(head + 1);
+
+    return 0;
+}
+
+/**
+ * @brief 取出最早的一个事件
+ */
+int input_queue_pop(input_event_t *event)
+{
+    uint8_t lane;
+    const input_event_t *ev = oldest(&lane);
+
+    if (ev == NULL) {
+        return -1;
+    }
+
+    *event = *ev;
+    consume(lane);
+
+    return 0;
+}
+
+/**
+ * @brief 交付当前所有事件
+ */
+uint16_t input_queue_poll(input_handler_t handler)
+{
+    uint16_t budget = input_queue_count();
+    uint16_t calls = 0;
+    input_event_t event;
+
+    if (handler == NULL) {
+        return 0;
+    }
+
+    while (budget > 0 && input_queue_pop(&event) == 0) {
+        budget--;
+
+        /* 合并紧随其后的同源旋转事件 */
+        if (event.type == INPUT_TYPE_ROTATE) {
+            uint8_t lane;
+            const input_event_t *next;
+
+            while (budget > 0 && (next = oldest(&lane)) != NULL &&
+                   next->type == INPUT_TYPE_ROTATE &&
+                   next->source == event.source && next->id == event.id) {
+                event.delta += next->delta;
+                event.steps += next->steps;
+                consume(lane);
+                budget--;
+            }
+
+            if (event.delta == 0 && event.steps == 0) {
+                continue;   /* 来回抵消 */
+            }
+        }
+
+        handler(&event);
+        calls++;
+    }
+
+    return calls;
+}
+
+/**
+ * @brief 队列中的事件数
+ */
+uint16_t input_queue_count(void)
+{
+    uint16_t count = 0;
+    uint8_t i;
+
+    for (i = 0; i < INPUT_LANE_COUNT; i++) {
+        count += (uint8_t)(lanes[i].head - lanes[i].tail);
+    }
+
+    return count;
+}
+
+/**
+ * @brief 丢弃的事件总数
+ */
+uint32_t input_queue_dropped(void)
+{
+    uint32_t dropped = 0;
+    uint8_t i;
+
+    for (i = 0; i < INPUT_LANE_COUNT; i++) {
+        dropped += lanes[i].dropped;
+    }
+
+    return dropped;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 找出各通道队首中时间最早的事件 (时间相同时通道号小的优先)
+ */
+static const input_event_t* oldest(uint8_t *lane)
+{
+    const input_event_t *best = NULL;
+    uint8_t i;
+
+    for (i = 0; i < INPUT_LANE_COUNT; i++) {
+        input_lane_t *l = &lanes[i];
+        const input_event_t *ev;
+
+        if (l->head == l->tail) {
+            continue;
+        }
+        QUEUE_BARRIER();
+
+        ev = &l->buf[l->tail & LANE_MASK];
+        if (best == NULL || (int32_t)(ev->time - best->time) < 0) {
+            best = ev;
+            *lane = i;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief 释放通道队首 (事件读完后才归还槽位)
+ */
+static void consume(uint8_t lane)
+{
+    QUEUE_BARRIER();
+    lanes[lane].tail = (uint8_t)(lanes[lane].tail + 1);
+}
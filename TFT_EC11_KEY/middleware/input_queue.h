@@ -0,0 +1,126 @@
+/**
+ * @file input_queue.h
+ * @brief 输入事件队列 - 带时间戳, 中断安全, 无锁
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 每个生产者上下文 (一个中断优先级或主循环) 独占一条单生产者/单消费者环形通道,
+ *         入队和出队都不关中断
+ *       - 消费者按时间戳从各通道中取最早的事件, 不同来源的事件按发生顺序交付
+ *       - 交付时合并相邻的同源旋转事件 (格数和步数相加), 处理慢时不会积压重绘
+ *       - 通道满时丢弃新事件并计数
+ *
+ * @note 使用方法:
+ *       1. 编码器中断中 input_queue_push(INPUT_LANE_ISR, &ev) (旋转事件)
+ *       2. 扫描任务中 input_queue_push(INPUT_LANE_TASK, &ev) (按键事件)
+ *       3. 输入任务中 input_queue_poll(handler), 菜单和显示在任务中处理, 不在中断中运行
+ *       同一通道只能由一个上下文写入; 优先级不同的中断需各用一条通道
+ */
+
+#ifndef __INPUT_QUEUE_H
+#define __INPUT_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/**
+ * @brief 每条通道的事件数 (2的幂, 不超过128)
+ */
+#define INPUT_LANE_SIZE             32
+
+/* 通道 (生产者上下文) */
+#define INPUT_LANE_ISR              0   /**< 编码器EXTI中断 */
+#define INPUT_LANE_TASK             1   /**< 扫描任务 (主循环) */
+#define INPUT_LANE_COUNT            2
+
+/* 事件源 */
+#define INPUT_SRC_EC11              0
+#define INPUT_SRC_KEY               1
+#define INPUT_SRC_KEYPAD            2
+
+/* 事件类型 */
+#define INPUT_TYPE_ROTATE           0   /**< 旋转, delta/steps有效, 相邻的可合并 */
+#define INPUT_TYPE_KEY              1   /**< 按键, code为事件源自己的事件码 */
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 输入事件
+ */
+typedef struct {
+    uint32_t time;              /**< 发生时间 (ms) */
+    uint8_t source;             /**< 事件源 INPUT_SRC_x */
+    uint8_t id;                 /**< 源内编号 (按键ID) */
+    uint8_t type;               /**< INPUT_TYPE_x */
+    uint8_t code;               /**< 按键事件码 (ec11_event_t / key_event_t / keypad_event_t) */
+    int16_t delta;              /**< 旋转格数, 右旋为正 */
+    int16_t steps;              /**< 加速后的步数, 右旋为正 */
+} input_event_t;
+
+/**
+ * @brief 事件处理回调
+ * @param event 事件 (合并后的旋转事件时间为第一格的时间)
+ */
+typedef void (*input_handler_t)(const input_event_t *event);
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 清空队列
+ * @note 调用时不能有生产者在入队
+ */
+void input_queue_init(void);
+
+/**
+ * @brief 入队 (生产者)
+ * @param lane 通道 INPUT_LANE_x
+ * @param event 事件
+ * @retval 0:成功 -1:通道满或通道号无效
+ */
+int input_queue_push(uint8_t lane, const input_event_t *event);
+
+/**
+ * @brief 取出最早的一个事件 (消费者, 不合并)
+ * @param event 输出事件
+ * @retval 0:成功 -1:队列空
+ */
+int input_queue_pop(input_event_t *event);
+
+/**
+ * @brief 交付当前所有事件 (消费者, 合并相邻的同源旋转事件)
+ * @param handler 处理回调
+ * @retval 回调次数
+ * @note 最多处理调用时已在队列中的事件数, 中断持续入队也不会一直停留在这里
+ */
+uint16_t input_queue_poll(input_handler_t handler);
+
+/**
+ * @brief 队列中的事件数
+ * @retval 事件数
+ */
+uint16_t input_queue_count(void);
+
+/**
+ * @brief 因通道满丢弃的事件总数
+ * @retval 丢弃数
+ */
+uint32_t input_queue_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INPUT_QUEUE_H */
@@ -0,0 +1,680 @@
+/**
+ * @file kv_store.c
+ * @brief 日志结构键值存储实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "kv_store.h"
+#include "crc.h"
+#include <stddef.h>
+#include <string.h>
+
+/*=============================================================================
+ *                              私有定义
+ *============================================================================*/
+
+#define KV_MAGIC            0x3153564BUL    /* "KVS1" */
+#define KV_HEADER_SIZE      8               /* 扇区头 */
+#define KV_RECORD_HEADER    8               /* 记录头 */
+#define KV_ERASED_WORD      0xFFFFFFFFUL
+
+#define RECORD_SIZE(len)    (KV_RECORD_HEADER + (((uint32_t)(len) + 3UL) & ~3UL))
+#define SECTOR_BASE(s)      ((uint32_t)(s) * KV_SECTOR_SIZE)
+
+/* 索引条目标志 */
+#define ENTRY_MOVED         0x01    /* 整理中: 最新值已搬到新扇区 */
+#define ENTRY_COPIED        0x02    /* 整理中: 新扇区中有该键的记录 */
+#define ENTRY_DELETED       0x04    /* 整理中被删除, 整理完成后移除 */
+
+/* 后台状态 */
+typedef enum {
+    KV_STATE_IDLE = 0,
+    KV_STATE_COMPACT
+} kv_state_t;
+
+/* 记录头 */
+typedef struct {
+    uint32_t key;
+    uint8_t len;
+    uint8_t type;
+    uint16_t crc;
+} kv_record_t;
+
+/* 索引条目 */
+typedef struct {
+    uint32_t key;
+    uint32_t off;           /**< 活动扇区内最新记录的偏移 */
+    uint32_t new_off;       /**< 整理中: 新扇区内的偏移 */
+    uint8_t flags;
+} kv_entry_t;
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+static struct {
+    uint8_t mounted;
+    uint8_t active;                 /**< 活动扇区 */
+    uint8_t state;                  /**< kv_state_t */
+    uint8_t erase_pending;          /**< 非活动扇区待擦除 */
+    uint32_t generation;            /**< 活动扇区代数 */
+    uint32_t write_off;             /**< 活动扇区写指针 */
+    uint32_t new_write_off;         /**< 整理中: 新扇区写指针 */
+    uint8_t count;
+    kv_entry_t entries[KV_MAX_KEYS];
+} kv;
+
+/* 记录缓冲区 (按字对齐) */
+static uint32_t record_buf[RECORD_SIZE(KV_MAX_VALUE) / 4];
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static uint16_t record_crc(const kv_record_t *rec, const uint8_t *data);
+static kv_entry_t* find_entry(uint32_t key);
+static void remove_entry(kv_entry_t *e);
+static int read_record(uint32_t addr, kv_record_t *rec, uint8_t load_data);
+static int append_record(uint8_t sector, uint32_t off, uint32_t key, uint8_t type,
+                         const void *data, uint8_t len);
+static int write_header(uint8_t sector, uint32_t generation);
+static uint8_t sector_blank(uint8_t sector);
+static void scan_sector(void);
+static void start_compact(void);
+static void compact_step(void);
+static void finish_compact(void);
+
+/*=============================================================================
+ *                              移植接口 (弱定义)
+ *============================================================================*/
+
+/**
+ * @brief 读Flash
+ */
+__attribute__((weak)) int kv_port_read(uint32_t addr, void *buf, uint32_t len)
+{
+    (void)addr;
+    (void)buf;
+    (void)len;
+    return -1;
+}
+
+/**
+ * @brief 写Flash
+ */
+__attribute__((weak)) int kv_port_program(uint32_t addr, const void *buf, uint32_t len)
+{
+    (void)addr;
+    (void)buf;
+    (void)len;
+    return -1;
+}
+
+/**
+ * @brief 擦除扇区
+ */
+__attribute__((weak)) int kv_port_erase(uint8_t sector)
+{
+    (void)sector;
+    return -1;
+}
+
+/**
+ * @brief 直接访问指针 (默认不支持)
+ */
+__attribute__((weak)) const void* kv_port_map(uint32_t addr)
+{
+    (void)addr;
+    return NULL;
+}
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 挂载存储
+ */
+int kv_store_init(void)
+{
+    uint32_t head[2][2];
+    uint8_t valid0;
+    uint8_t valid1;
+
+    if (kv.mounted) {
+        return 0;
+    }
+
+    memset(&kv, 0, sizeof(kv));
+
+    if (kv_port_read(SECTOR_BASE(0), head[0], KV_HEADER_SIZE) != 0 ||
+        kv_port_read(SECTOR_BASE(1), head[1], KV_HEADER_SIZE) != 0) {
+        return -1;
+    }
+
+    valid0 = (head[0][0] == KV_MAGIC);
+    valid1 = (head[1][0] == KV_MAGIC);
+
+    if (!valid0 && !valid1) {
+        return kv_store_format();
+    }
+
+    if (valid0 && valid1) {
+        /* 整理完成但旧扇区未擦除: 代数较新的为活动扇区 */
+        kv.active = ((int32_t)(head[1][1] - head[0][1]) > 0) ? 1 : 0;
+        kv.erase_pending = 1;
+    } else {
+        kv.active = valid1 ? 1 : 0;
+        kv.erase_pending = !sector_blank(1 - kv.active);
+    }
+
+    kv.generation = head[kv.active][1];
+    scan_sector();
+    kv.mounted = 1;
+
+    if (kv_store_free() < KV_COMPACT_RESERVE) {
+        start_compact();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 读取值
+ */
+int kv_get(uint32_t key, void *buf, uint8_t size, uint8_t *type)
+{
+    kv_entry_t *e = find_entry(key);
+    kv_record_t rec;
+
+    if (e == NULL || (e->flags & ENTRY_DELETED)) {
+        return -1;
+    }
+
+    if (read_record(SECTOR_BASE(kv.active) + e->off, &rec, 0) != 0) {
+        return -1;
+    }
+
+    if (size > rec.len) {
+        size = rec.len;
+    }
+    if (size > 0 &&
+        kv_port_read(SECTOR_BASE(kv.active) + e->off + KV_RECORD_HEADER, buf, size) != 0) {
+        return -1;
+    }
+
+    if (type != NULL) {
+        *type = rec.type;
+    }
+
+    return rec.len;
+}
+
+/**
+ * @brief 写入值
+ */
+int kv_set(uint32_t key, uint8_t type, const void *data, uint8_t len)
+{
+    kv_entry_t *e;
+    kv_record_t rec;
+    uint8_t added = 0;
+
+    if (!kv.mounted || key == KV_ERASED_WORD || type == KV_TYPE_DELETED) {
+        return -1;
+    }
+
+    e = find_entry(key);
+    if (e != NULL && !(e->flags & ENTRY_DELETED)) {
+        /* 与已保存的值相同则不写 */
+        if (read_record(SECTOR_BASE(kv.active) + e->off, &rec, 1) == 0 &&
+            rec.len == len && rec.type == type &&
+            (len == 0 || memcmp((uint8_t *)record_buf + KV_RECORD_HEADER, data, len) == 0)) {
+            return 0;
+        }
+    }
+
+    if (e == NULL) {
+        if (kv.count >= KV_MAX_KEYS) {
+            return -1;
+        }
+        e = &kv.entries[kv.count++];
+        e->key = key;
+        e->flags = 0;
+        added = 1;
+    }
+
+    if (kv.write_off + RECORD_SIZE(len) > KV_SECTOR_SIZE ||
+        append_record(kv.active, kv.write_off, key, type, data, len) != 0) {
+        if (added) {
+            kv.count--;
+        }
+        start_compact();
+        return -1;
+    }
+
+    e->off = kv.write_off;
+    e->flags &= (uint8_t)~(ENTRY_MOVED | ENTRY_DELETED);    /* 整理中需重新搬移 */
+    kv.write_off += RECORD_SIZE(len);
+
+    if (kv_store_free() < KV_COMPACT_RESERVE) {
+        start_compact();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 遍历所有键的最新值
+ */
+int kv_foreach(kv_visit_t visit, void *ctx)
+{
+    uint32_t base = SECTOR_BASE(kv.active);
+    kv_record_t rec;
+    int visited = 0;
+    uint8_t i;
+
+    for (i = 0; i < kv.count; i++) {
+        const kv_entry_t *e = &kv.entries[i];
+        const uint8_t *p;
+
+        if (e->flags & ENTRY_DELETED) {
+            continue;
+        }
+
+        p = (const uint8_t *)kv_port_map(base + e->off);
+        if (p != NULL) {
+            memcpy(&rec, p, KV_RECORD_HEADER);
+            p += KV_RECORD_HEADER;
+        } else {
+            if (read_record(base + e->off, &rec, 1) != 0) {
+                return -1;
+            }
+            p = (const uint8_t *)record_buf + KV_RECORD_HEADER;
+        }
+
+        visit(ctx, rec.key, rec.type, p, rec.len);
+        visited++;
+    }
+
+    return visited;
+}
+
+/**
+ * @brief 删除键
+ */
+int kv_delete(uint32_t key)
+{
+    kv_entry_t *e = find_entry(key);
+
+    if (!kv.mounted) {
+        return -1;
+    }
+
+    if (e == NULL || (e->flags & ENTRY_DELETED)) {
+        return 0;
+    }
+
+    if (kv.write_off + RECORD_SIZE(0) > KV_SECTOR_SIZE ||
+        append_record(kv.active, kv.write_off, key, KV_TYPE_DELETED, NULL, 0) != 0) {
+        start_compact();
+        return -1;
+    }
+    kv.write_off += RECORD_SIZE(0);
+
+    if (kv.state == KV_STATE_COMPACT) {
+        /* 已搬到新扇区的键需在新扇区补写删除标记 */
+        e->flags = (uint8_t)((e->flags & ~ENTRY_MOVED) | ENTRY_DELETED);
+    } else {
+        remove_entry(e);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 后台处理
+ */
+void kv_store_poll(void)
+{
+    if (!kv.mounted) {
+        return;
+    }
+
+    /* 先擦除, 整理的目标扇区必须是空白的 */
+    if (kv.erase_pending) {
+        if (kv_port_erase(1 - kv.active) == 0) {
+            kv.erase_pending = 0;
+        }
+        return;
+    }
+
+    if (kv.state == KV_STATE_COMPACT) {
+        compact_step();
+    }
+}
+
+/**
+ * @brief 是否有后台工作未完成
+ */
+uint8_t kv_store_busy(void)
+{
+    return (kv.erase_pending || kv.state != KV_STATE_IDLE) ? 1 : 0;
+}
+
+/**
+ * @brief 活动扇区剩余字节数
+ */
+uint32_t kv_store_free(void)
+{
+    return KV_SECTOR_SIZE - kv.write_off;
+}
+
+/**
+ * @brief 擦除全部数据
+ */
+int kv_store_format(void)
+{
+    memset(&kv, 0, sizeof(kv));
+
+    if (kv_port_erase(0) != 0 || kv_port_erase(1) != 0 || write_header(0, 1) != 0) {
+        return -1;
+    }
+
+    kv.active = 0;
+    kv.generation = 1;
+    kv.write_off = KV_HEADER_SIZE;
+    kv.mounted = 1;
+
+    return 0;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 计算记录CRC (key, len, type, data)
+ */
+static uint16_t record_crc(const kv_record_t *rec, const uint8_t *data)
+{
+    uint8_t head[6];
+
+    head[0] = (uint8_t)rec->key;
+    head[1] = (uint8_t)(rec->key >> 8);
+    head[2] = (uint8_t)(rec->key >> 16);
+    head[3] = (uint8_t)(rec->key >> 24);
+    head[4] = rec->len;
+    head[5] = rec->type;
+
+    return crc16_ccitt_update(crc16_ccitt_update(CRC16_CCITT_INIT, head, 6), data, rec->len);
+}
+
+/**
+ * @brief 查找索引条目
+ */
+static kv_entry_t* find_entry(uint32_t key)
+{
+    uint8_t i;
+
+    for (i = 0; i < kv.count; i++) {
+        if (kv.entries[i].key == key) {
+            return &kv.entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 移除索引条目 (与最后一条交换)
+ */
+static void remove_entry(kv_entry_t *e)
+{
+    *e = kv.entries[--kv.count];
+}
+
+/**
+ * @brief 读记录头, 可选读入数据到record_buf
+ */
+static int read_record(uint32_t addr, kv_record_t *rec, uint8_t load_data)
+{
+    if (kv_port_read(addr, rec, KV_RECORD_HEADER) != 0) {
+        return -1;
+    }
+
+    if (load_data) {
+        memcpy(record_buf, rec, KV_RECORD_HEADER);
+        if (rec->len > 0 &&
+            kv_port_read(addr + KV_RECORD_HEADER, (uint8_t *)record_buf + KV_RECORD_HEADER,
+                         rec->len) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 追加一条记录: 先写第二个字和数据, 最后写键字提交
+ */
+static int append_record(uint8_t sector, uint32_t off, uint32_t key, uint8_t type,
+                         const void *data, uint8_t len)
+{
+    uint32_t addr = SECTOR_BASE(sector) + off;
+    uint32_t size = RECORD_SIZE(len);
+    kv_record_t *rec = (kv_record_t *)record_buf;
+    uint8_t *payload = (uint8_t *)record_buf + KV_RECORD_HEADER;
+
+    rec->key = key;
+    rec->len = len;
+    rec->type = type;
+    if (len > 0 && data != payload) {   /* 整理时数据已在缓冲区中 */
+        memcpy(payload, data, len);
+    }
+    memset(payload + len, 0xFF, size - KV_RECORD_HEADER - len);
+    rec->crc = record_crc(rec, (const uint8_t *)record_buf + KV_RECORD_HEADER);
+
+    if (kv_port_program(addr + 4, &record_buf[1], size - 4) != 0) {
+        return -1;
+    }
+
+    return kv_port_program(addr, &record_buf[0], 4);
+}
+
+/**
+ * @brief 写扇区头
+ */
+static int write_header(uint8_t sector, uint32_t generation)
+{
+    uint32_t head[2];
+
+    head[0] = KV_MAGIC;
+    head[1] = generation;
+
+    return kv_port_program(SECTOR_BASE(sector), head, KV_HEADER_SIZE);
+}
+
+/**
+ * @brief 检查扇区是否空白 (整理总是从扇区开头写, 检查开头即可)
+ */
+static uint8_t sector_blank(uint8_t sector)
+{
+    uint32_t words[(KV_HEADER_SIZE + KV_RECORD_HEADER) / 4];
+    uint8_t i;
+
+    if (kv_port_read(SECTOR_BASE(sector), words, sizeof(words)) != 0) {
+        return 0;
+    }
+
+    for (i = 0; i < sizeof(words) / 4; i++) {
+        if (words[i] != KV_ERASED_WORD) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief 扫描活动扇区, 建立索引并定位写指针
+ */
+static void scan_sector(void)
+{
+    uint32_t base = SECTOR_BASE(kv.active);
+    uint32_t off = KV_HEADER_SIZE;
+    kv_record_t rec;
+
+    kv.count = 0;
+
+    while (off + KV_RECORD_HEADER <= KV_SECTOR_SIZE) {
+        kv_entry_t *e;
+
+        if (read_record(base + off, &rec, 0) != 0) {
+            break;
+        }
+
+        /* 两个字都是擦除值: 日志结束 */
+        if (rec.key == KV_ERASED_WORD && ((uint32_t *)&rec)[1] == KV_ERASED_WORD) {
+            break;
+        }
+
+        if (off + RECORD_SIZE(rec.len) > KV_SECTOR_SIZE) {
+            off = KV_SECTOR_SIZE;   /* 损坏, 不再向该扇区追加 */
+            break;
+        }
+
+        /* 键字未写入的是掉电时未提交的记录, CRC错误的记录同样跳过 */
+        if (rec.key != KV_ERASED_WORD && read_record(base + off, &rec, 1) == 0 &&
+            record_crc(&rec, (const uint8_t *)record_buf + KV_RECORD_HEADER) == rec.crc) {
+            e = find_entry(rec.key);
+            if (rec.type == KV_TYPE_DELETED) {
+                if (e != NULL) {
+                    remove_entry(e);
+                }
+            } else {
+                if (e == NULL && kv.count < KV_MAX_KEYS) {
+                    e = &kv.entries[kv.count++];
+                    e->key = rec.key;
+                }
+                if (e != NULL) {
+                    e->off = off;
+                    e->flags = 0;
+                }
+            }
+        }
+
+        off += RECORD_SIZE(rec.len);
+    }
+
+    kv.write_off = off;
+}
+
+/**
+ * @brief 开始整理
+ */
+static void start_compact(void)
+{
+    uint8_t i;
+
+    if (kv.state == KV_STATE_COMPACT) {
+        return;
+    }
+
+    for (i = 0; i < kv.count; i++) {
+        kv.entries[i].flags = 0;
+    }
+
+    kv.new_write_off = KV_HEADER_SIZE;
+    kv.state = KV_STATE_COMPACT;
+}
+
+/**
+ * @brief 整理一步: 搬移最多KV_COMPACT_STEP条记录
+ */
+static void compact_step(void)
+{
+    uint8_t other = 1 - kv.active;
+    uint8_t budget = KV_COMPACT_STEP;
+    uint8_t i;
+    kv_record_t rec;
+
+    for (i = 0; i < kv.count && budget > 0; i++) {
+        kv_entry_t *e = &kv.entries[i];
+        int ret;
+
+        if (e->flags & ENTRY_MOVED) {
+            continue;
+        }
+
+        if (e->flags & ENTRY_DELETED) {
+            /* 新扇区已有旧值时补写删除标记 */
+            ret = 0;
+            if (e->flags & ENTRY_COPIED) {
+                ret = append_record(other, kv.new_write_off, e->key, KV_TYPE_DELETED, NULL, 0);
+                kv.new_write_off += RECORD_SIZE(0);
+            }
+        } else {
+            ret = read_record(SECTOR_BASE(kv.active) + e->off, &rec, 1);
+            if (ret == 0) {
+                ret = append_record(other, kv.new_write_off, rec.key, rec.type,
+                                    (uint8_t *)record_buf + KV_RECORD_HEADER, rec.len);
+                e->new_off = kv.new_write_off;
+                kv.new_write_off += RECORD_SIZE(rec.len);
+                e->flags |= ENTRY_COPIED;
+            }
+        }
+
+        if (ret != 0 || kv.new_write_off > KV_SECTOR_SIZE) {
+            /* Flash错误: 放弃本次整理, 擦除后重来 */
+            kv.state = KV_STATE_IDLE;
+            kv.erase_pending = 1;
+            return;
+        }
+
+        e->flags |= ENTRY_MOVED;
+        budget--;
+    }
+
+    for (i = 0; i < kv.count; i++) {
+        if (!(kv.entries[i].flags & ENTRY_MOVED)) {
+            return;
+        }
+    }
+
+    finish_compact();
+}
+
+/**
+ * @brief 整理完成: 写扇区头切换活动扇区, 旧扇区待擦除
+ */
+static void finish_compact(void)
+{
+    uint8_t other = 1 - kv.active;
+    uint8_t i;
+
+    if (write_header(other, kv.generation + 1) != 0) {
+        kv.state = KV_STATE_IDLE;
+        kv.erase_pending = 1;
+        return;
+    }
+
+    kv.active = other;
+    kv.generation++;
+    kv.write_off = kv.new_write_off;
+
+    i = 0;
+    while (i < kv.count) {
+        if (kv.entries[i].flags & ENTRY_DELETED) {
+            remove_entry(&kv.entries[i]);
+            continue;
+        }
+        kv.entries[i].off = kv.entries[i].new_off;
+        kv.entries[i].flags = 0;
+        i++;
+    }
+
+    kv.state = KV_STATE_IDLE;
+    kv.erase_pending = 1;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file kv_store.h
+ * @brief 日志结构键值存储 - 双扇区Flash磨损均衡
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 两个Flash扇区轮换使用, 修改只追加一条记录, 不擦除扇区
+ *       - 值与已保存的相同时不写入
+ *       - 上电扫描一次活动扇区即恢复每个键的最新值 (RAM中只保存键到偏移的索引)
+ *       - 剩余空间不足时在后台分步整理: 把最新记录搬到另一扇区, 完成后切换并擦除旧扇区
+ *       - 掉电安全: 记录的键字最后写入, 未写完的记录上电时被跳过;
+ *         整理未完成时新扇区没有扇区头, 上电仍使用旧扇区
+ *
+ * @note 扇区布局:
+ *       | magic(4) | generation(4) | 记录... | 空白(0xFF) |
+ *       generation较大的有效扇区为活动扇区
+ *
+ * @note 记录格式 (4字节对齐):
+ *       | key(4) | len(1) | type(1) | crc16(2) | data(len) | 填充0xFF |
+ *       crc16 (CCITT) 覆盖 key, len, type 和 data
+ *       写入顺序: 第二个字 -> data -> key, key为0xFFFFFFFF表示记录未提交
+ *
+ * @note 需实现 kv_port_read/program/erase (弱定义默认返回失败),
+ *       地址为存储区内的偏移, 扇区n占用 [n*KV_SECTOR_SIZE, (n+1)*KV_SECTOR_SIZE);
+ *       存储区可直接按地址访问时 (内部Flash) 再实现 kv_port_map, kv_foreach 即直接读取Flash, 不复制
+ */
+
+#ifndef __KV_STORE_H
+#define __KV_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/**
+ * @brief 扇区大小 (STM32F407 扇区10/11为128KB)
+ */
+#define KV_SECTOR_SIZE              (128UL * 1024UL)
+
+/**
+ * @brief 最多键数
+ */
+#define KV_MAX_KEYS                 64
+
+/**
+ * @brief 单值最大长度
+ */
+#define KV_MAX_VALUE                255
+
+/**
+ * @brief 每次 kv_store_poll() 最多搬移的记录数 (限制单次耗时)
+ */
+#define KV_COMPACT_STEP             4
+
+/**
+ * @brief 剩余空间低于该值时开始整理, 需能容纳整理期间的写入
+ */
+#define KV_COMPACT_RESERVE          (KV_MAX_KEYS * (8UL + KV_MAX_VALUE + 1UL))
+
+/* 值类型 (由使用者解释, 存储层只保存) */
+#define KV_TYPE_RAW                 0x00
+#define KV_TYPE_DELETED             0xFE    /**< 删除标记, 内部使用 */
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 遍历回调
+ * @param ctx 用户上下文
+ * @param key 键
+ * @param type 类型
+ * @param data 值 (实现了 kv_port_map 时直接指向Flash, 否则指向内部缓冲区; 仅在回调内有效)
+ * @param len 长度
+ */
+typedef void (*kv_visit_t)(void *ctx, uint32_t key, uint8_t type, const void *data, uint8_t len);
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 挂载存储 (扫描活动扇区, 建立索引; 已挂载时直接返回)
+ * @retval 0:成功 -1:Flash访问失败
+ * @note 两个扇区都无效时格式化 (擦除扇区0)
+ */
+int kv_store_init(void);
+
+/**
+ * @brief 读取值
+ * @param key 键
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @param type 输出类型 (可为NULL)
+ * @retval 值长度 (可能大于size, 只复制size字节), -1表示不存在
+ */
+int kv_get(uint32_t key, void *buf, uint8_t size, uint8_t *type);
+
+/**
+ * @brief 写入值 (与已保存的值相同时不写入)
+ * @param key 键 (不能为0xFFFFFFFF)
+ * @param type 类型
+ * @param data 值
+ * @param len 长度
+ * @retval 0:成功 -1:空间不足(整理中)、键表满或Flash错误
+ */
+int kv_set(uint32_t key, uint8_t type, const void *data, uint8_t len);
+
+/**
+ * @brief 遍历所有键的最新值 (顺序不定)
+ * @param visit 回调
+ * @param ctx 用户上下文
+ * @retval 遍历的键数, -1表示Flash访问失败
+ * @note 回调中不能调用 kv_set/kv_delete
+ */
+int kv_foreach(kv_visit_t visit, void *ctx);
+
+/**
+ * @brief 删除键
+ * @param key 键
+ * @retval 0:成功 (不存在也返回0) -1:失败
+ */
+int kv_delete(uint32_t key);
+
+/**
+ * @brief 后台处理: 分步整理和擦除
+ * @note 周期调用; 擦除扇区本身不可分割, 耗时取决于Flash
+ */
+void kv_store_poll(void);
+
+/**
+ * @brief 是否有后台工作未完成
+ * @retval 1:整理或擦除中 0:空闲
+ */
+uint8_t kv_store_busy(void);
+
+/**
+ * @brief 活动扇区剩余字节数
+ * @retval 剩余字节数
+ */
+uint32_t kv_store_free(void);
+
+/**
+ * @brief 擦除全部数据
+ * @retval 0:成功 -1:失败
+ */
+int kv_store_format(void);
+
+/*----------------------- 移植接口 (弱定义) -----------------------*/
+
+/**
+ * @brief 读Flash
+ * @param addr 存储区内偏移
+ * @param buf 缓冲区
+ * @param len 长度
+ * @retval 0:成功 -1:失败
+ */
+int kv_port_read(uint32_t addr, void *buf, uint32_t len);
+
+/**
+ * @brief 写Flash (addr和len均为4的倍数, 目标区域已擦除)
+ * @param addr 存储区内偏移
+ * @param buf 数据
+ * @param len 长度
+ * @retval 0:成功 -1:失败
+ */
+int kv_port_program(uint32_t addr, const void *buf, uint32_t len);
+
+/**
+ * @brief 擦除扇区
+ * @param sector 扇区号 (0或1)
+ * @retval 0:成功 -1:失败
+ */
+int kv_port_erase(uint8_t sector);
+
+/**
+ * @brief 取存储区地址的直接访问指针 (可选)
+ * @param addr 存储区内偏移
+ * @retval 指针, 不支持直接访问时返回NULL (默认)
+ */
+const void* kv_port_map(uint32_t addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __KV_STORE_H */
@@ -8,111 +8,142 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "menu_animation.h"
-#include <math.h>
+#include <stddef.h>
 
 /* 外部时间戳函数 */
 extern uint32_t bsp_ec11_get_tick(void);
 
-/* Private variables ---------------------------------------------------------*/
-static menu_animation_t current_anim = {0};
-
-/* Private functions ---------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#define LEGACY_SLOT         0      /* 旧API使用的槽位 */
+#define LUT_FRAC_BITS       10     /* 16 - log2(MENU_ANIM_LUT_SEGMENTS) */
+#define LUT_FRAC_MASK       ((1UL << LUT_FRAC_BITS) - 1)
 
-/**
- * @brief  线性插值
- * @param  progress: 进度 (0.0-1.0)
- * @retval 插值结果
- */
-static float easing_linear(float progress)
-{
-    return progress;
-}
+/* Private variables ---------------------------------------------------------*/
+static menu_tween_t tweens[MENU_ANIM_MAX_TWEENS];
 
 /**
- * @brief  加速插值 (Ease In)
- * @param  progress: 进度 (0.0-1.0)
- * @retval 插值结果
+ * 缓动曲线查找表 (Q16, 1.0 = 65536), 每条曲线 MENU_ANIM_LUT_SEGMENTS+1 个点
+ * 由 tools/gen_easing_lut.py 生成, 修改曲线后请重新生成, 不要手工编辑
  */
-static float easing_ease_in(float progress)
-{
-    return progress * progress;
-}
+static const int32_t easing_lut[MENU_EASING_COUNT][MENU_ANIM_LUT_SEGMENTS + 1] = {
+    /* MENU_EASING_LINEAR */
+    {
+             0,   1024,   2048,   3072,   4096,   5120,   6144,   7168,
+          8192,   9216,  10240,  11264,  12288,  13312,  14336,  15360,
+         16384,  17408,  18432,  19456,  20480,  21504,  22528,  23552,
+         24576,  25600,  26624,  27648,  28672,  29696,  30720,  31744,
+         32768,  33792,  34816,  35840,  36864,  37888,  38912,  39936,
+         40960,  41984,  43008,  44032,  45056,  46080,  47104,  48128,
+         49152,  50176,  51200,  52224,  53248,  54272,  55296,  56320,
+         57344,  58368,  59392,  60416,  61440,  62464,  63488,  64512,
+         65536,
+    },
+    /* MENU_EASING_EASE_IN */
+    {
+             0,     16,     64,    144,    256,    400,    576,    784,
+          1024,   1296,   1600,   1936,   2304,   2704,   3136,   3600,
+          4096,   4624,   5184,   5776,   6400,   7056,   7744,   8464,
+          9216,  10000,  10816,  11664,  12544,  13456,  14400,  15376,
+         16384,  17424,  18496,  19600,  20736,  21904,  23104,  24336,
+         25600,  26896,  28224,  29584,  30976,  32400,  33856,  35344,
+         36864,  38416,  40000,  41616,  43264,  44944,  46656,  48400,
+         50176,  51984,  53824,  55696,  57600,  59536,  61504,  63504,
+         65536,
+    },
+    /* MENU_EASING_EASE_OUT */
+    {
+             0,   2032,   4032,   6000,   7936,   9840,  11712,  13552,
+         15360,  17136,  18880,  20592,  22272,  23920,  25536,  27120,
+         28672,  30192,  31680,  33136,  34560,  35952,  37312,  38640,
+         39936,  41200,  42432,  43632,  44800,  45936,  47040,  48112,
+         49152,  50160,  51136,  52080,  52992,  53872,  54720,  55536,
+         56320,  57072,  57792,  58480,  59136,  59760,  60352,  60912,
+         61440,  61936,  62400,  62832,  63232,  63600,  63936,  64240,
+         64512,  64752,  64960,  65136,  65280,  65392,  65472,  65520,
+         65536,
+    },
+    /* MENU_EASING_EASE_IN_OUT */
+    {
+             0,     32,    128,    288,    512,    800,   1152,   1568,
+          2048,   2592,   3200,   3872,   4608,   5408,   6272,   7200,
+          8192,   9248,  10368,  11552,  12800,  14112,  15488,  16928,
+         18432,  20000,  21632,  23328,  25088,  26912,  28800,  30752,
+         32768,  34784,  36736,  38624,  40448,  42208,  43904,  45536,
+         47104,  48608,  50048,  51424,  52736,  53984,  55168,  56288,
+         57344,  58336,  59264,  60128,  60928,  61664,  62336,  62944,
+         63488,  63968,  64384,  64736,  65024,  65248,  65408,  65504,
+         65536,
+    },
+    /* MENU_EASING_BOUNCE */
+    {
+             0,    121,    484,   1089,   1936,   3025,   4356,   5929,
+          7744,   9801,  12100,  14641,  17424,  20449,  23716,  27225,
+         30976,  34969,  39204,  43681,  48400,  53361,  58564,  64009,
+         63552,  61033,  58756,  56721,  54928,  53377,  52068,  51001,
+         50176,  49593,  49252,  49153,  49296,  49681,  50308,  51177,
+         52288,  53641,  55236,  57073,  59152,  61473,  64036,  64921,
+         63744,  62809,  62116,  61665,  61456,  61489,  61764,  62281,
+         63040,  64041,  65284,  65041,  64656,  64513,  64612,  64953,
+         65536,
+    },
+};
 
-/**
- * @brief  减速插值 (Ease Out)
- * @param  progress: 进度 (0.0-1.0)
- * @retval 插值结果
- */
-static float easing_ease_out(float progress)
-{
-    return 1.0f - (1.0f - progress) * (1.0f - progress);
-}
+/* Private functions ---------------------------------------------------------*/
 
 /**
- * @brief  先加速后减速 (Ease In Out)
- * @param  progress: 进度 (0.0-1.0)
- * @retval 插值结果
+ * @brief  计算线性进度
+ * @param  elapsed: 已播放时间(ms), 需小于duration
+ * @param  duration: 持续时间(ms)
+ * @retval 进度 (Q16)
  */
-static float easing_ease_in_out(float progress)
+static uint32_t calc_progress(uint32_t elapsed, uint32_t duration)
 {
-    if (progress < 0.5f) {
-        return 2.0f * progress * progress;
-    } else {
-        float temp = -2.0f * progress + 2.0f;
-        return 1.0f - temp * temp / 2.0f;
+    if (elapsed < 0x10000UL) {
+        return (elapsed << 16) / duration;
     }
+
+    return (uint32_t)(((uint64_t)elapsed << 16) / duration);
 }
 
 /**
- * @brief  弹跳插值
- * @param  progress: 进度 (0.0-1.0)
+ * @brief  计算动画在某一时刻的值
+ * @param  anim: 动画参数
+ * @param  elapsed: 已播放时间(ms), 需小于duration
  * @retval 插值结果
  */
-static float easing_bounce(float progress)
+static int16_t sample_value(const menu_animation_t *anim, uint32_t elapsed)
 {
-    const float n1 = 7.5625f;
-    const float d1 = 2.75f;
-
-    if (progress < 1.0f / d1) {
-        return n1 * progress * progress;
-    } else if (progress < 2.0f / d1) {
-        progress -= 1.5f / d1;
-        return n1 * progress * progress + 0.75f;
-    } else if (progress < 2.5f / d1) {
-        progress -= 2.25f / d1;
-        return n1 * progress * progress + 0.9375f;
-    } else {
-        progress -= 2.625f / d1;
-        return n1 * progress * progress + 0.984375f;
-    }
+    int32_t eased = menu_anim_ease_q16(anim->easing, calc_progress(elapsed, anim->duration));
+    int32_t delta = (int32_t)anim->end_value - anim->start_value;
+
+    /* 四舍五入到最近整数 */
+    return (int16_t)(anim->start_value +
+                     (int32_t)(((int64_t)delta * eased + 0x8000) >> 16));
 }
 
 /**
- * @brief  应用缓动函数
- * @param  progress: 原始进度 (0.0-1.0)
- * @param  easing: 缓动类型
- * @retval 处理后的进度
+ * @brief  初始化槽位并开始播放
+ * @param  tween: 槽位
+ * @retval None
  */
-static float apply_easing(float progress, menu_easing_type_t easing)
+static void tween_setup(menu_tween_t *tween, menu_anim_type_t type, menu_easing_type_t easing,
+                        uint32_t duration, int16_t start_val, int16_t end_val)
 {
-    switch (easing) {
-        case MENU_EASING_LINEAR:
-            return easing_linear(progress);
-
-        case MENU_EASING_EASE_IN:
-            return easing_ease_in(progress);
-
-        case MENU_EASING_EASE_OUT:
-            return easing_ease_out(progress);
-
-        case MENU_EASING_EASE_IN_OUT:
-            return easing_ease_in_out(progress);
-
-        case MENU_EASING_BOUNCE:
-            return easing_bounce(progress);
+    if ((uint32_t)easing >= MENU_EASING_COUNT) {
+        easing = MENU_EASING_LINEAR;
+    }
 
-        default:
-            return progress;
+    tween->anim.type = type;
+    tween->anim.easing = easing;
+    tween->anim.start_time = bsp_ec11_get_tick();
+    tween->anim.duration = duration;
+    tween->anim.start_value = start_val;
+    tween->anim.end_value = end_val;
+    tween->anim.is_playing = 1;
+    tween->value = start_val;
+
+    if (tween->target != NULL) {
+        *tween->target = start_val;
     }
 }
 
@@ -123,13 +154,21 @@ static float apply_easing(float progress, menu_easing_type_t easing)
  */
 void menu_anim_init(void)
 {
-    current_anim.type = MENU_ANIM_NONE;
-    current_anim.easing = MENU_EASING_LINEAR;
-    current_anim.start_time = 0;
-    current_anim.duration = 0;
-    current_anim.start_value = 0;
-    current_anim.end_value = 0;
-    current_anim.is_playing = 0;
+    uint8_t i;
+
+    for (i = 0; i < MENU_ANIM_MAX_TWEENS; i++) {
+        tweens[i].anim.type = MENU_ANIM_NONE;
+        tweens[i].anim.easing = MENU_EASING_LINEAR;
+        tweens[i].anim.start_time = 0;
+        tweens[i].anim.duration = 0;
+        tweens[i].anim.start_value = 0;
+        tweens[i].anim.end_value = 0;
+        tweens[i].anim.is_playing = 0;
+        tweens[i].target = NULL;
+        tweens[i].value = 0;
+        tweens[i].on_done = NULL;
+        tweens[i].arg = NULL;
+    }
 }
 
 /**
@@ -138,46 +177,62 @@ void menu_anim_init(void)
 void menu_anim_start(menu_anim_type_t type, menu_easing_type_t easing,
                      uint32_t duration, int16_t start_val, int16_t end_val)
 {
-    current_anim.type = type;
-    current_anim.easing = easing;
-    current_anim.start_time = bsp_ec11_get_tick();
-    current_anim.duration = duration;
-    current_anim.start_value = start_val;
-    current_anim.end_value = end_val;
-    current_anim.is_playing = 1;
+    menu_tween_t *tween = &tweens[LEGACY_SLOT];
+
+    tween->target = NULL;
+    tween->on_done = NULL;
+    tween_setup(tween, type, easing, duration, start_val, end_val);
 }
 
 /**
- * @brief  更新动画
+ * @brief  更新所有补间
  */
-void menu_anim_update(void)
+uint8_t menu_anim_update(void)
 {
-    uint32_t current_time;
-    uint32_t elapsed;
-    float progress;
-    float eased_progress;
-
-    if (!current_anim.is_playing) {
-        return;
+    uint32_t now = bsp_ec11_get_tick();
+    uint8_t playing = 0;
+    uint8_t i;
+
+    for (i = 0; i < MENU_ANIM_MAX_TWEENS; i++) {
+        menu_tween_t *tween = &tweens[i];
+        uint32_t elapsed;
+
+        if (!tween->anim.is_playing) {
+            continue;
+        }
+
+        elapsed = now - tween->anim.start_time;
+
+        if (elapsed >= tween->anim.duration) {
+            /* 结束: 落在终值上, 再通知 (回调中可以启动新补间) */
+            tween->value = tween->anim.end_value;
+            tween->anim.is_playing = 0;
+            if (tween->target != NULL) {
+                *tween->target = tween->value;
+            }
+            if (tween->on_done != NULL) {
+                tween->on_done(i, tween->arg);
+            }
+            continue;
+        }
+
+        tween->value = sample_value(&tween->anim, elapsed);
+        if (tween->target != NULL) {
+            *tween->target = tween->value;
+        }
+        playing++;
     }
 
-    current_time = bsp_ec11_get_tick();
-    elapsed = current_time - current_anim.start_time;
-
-    /* 检查动画是否结束 */
-    if (elapsed >= current_anim.duration) {
-        current_anim.is_playing = 0;
-        return;
-    }
-
-    /* 计算进度 (0.0-1.0) */
-    progress = (float)elapsed / (float)current_anim.duration;
-
-    /* 应用缓动函数 */
-    eased_progress = apply_easing(progress, current_anim.easing);
+    return playing;
+}
 
-    /* 进度被用于menu_anim_get_value()计算当前值 */
-    (void)eased_progress;  /* 避免未使用警告 */
+/**
+ * @brief  动画调度任务
+ */
+void menu_anim_task(void *arg)
+{
+    (void)arg;
+    menu_anim_update();
 }
 
 /**
@@ -185,7 +240,7 @@ void menu_anim_update(void)
  */
 void menu_anim_stop(void)
 {
-    current_anim.is_playing = 0;
+    tweens[LEGACY_SLOT].anim.is_playing = 0;
 }
 
 /**
@@ -193,35 +248,21 @@ void menu_anim_stop(void)
  */
 int16_t menu_anim_get_value(void)
 {
-    uint32_t current_time;
+    const menu_animation_t *anim = &tweens[LEGACY_SLOT].anim;
     uint32_t elapsed;
-    float progress;
-    float eased_progress;
-    int16_t value;
 
-    if (!current_anim.is_playing) {
-        return current_anim.end_value;
+    if (!anim->is_playing) {
+        return anim->end_value;
     }
 
-    current_time = bsp_ec11_get_tick();
-    elapsed = current_time - current_anim.start_time;
+    elapsed = bsp_ec11_get_tick() - anim->start_time;
 
     /* 检查动画是否结束 */
-    if (elapsed >= current_anim.duration) {
-        return current_anim.end_value;
+    if (elapsed >= anim->duration) {
+        return anim->end_value;
     }
 
-    /* 计算进度 */
-    progress = (float)elapsed / (float)current_anim.duration;
-
-    /* 应用缓动 */
-    eased_progress = apply_easing(progress, current_anim.easing);
-
-    /* 计算当前值 */
-    value = current_anim.start_value +
-            (int16_t)((current_anim.end_value - current_anim.start_value) * eased_progress);
-
-    return value;
+    return sample_value(anim, elapsed);
 }
 
 /**
@@ -229,24 +270,20 @@ int16_t menu_anim_get_value(void)
  */
 uint8_t menu_anim_get_progress(void)
 {
-    uint32_t current_time;
+    const menu_animation_t *anim = &tweens[LEGACY_SLOT].anim;
     uint32_t elapsed;
-    uint8_t progress;
 
-    if (!current_anim.is_playing) {
+    if (!anim->is_playing) {
         return 100;
     }
 
-    current_time = bsp_ec11_get_tick();
-    elapsed = current_time - current_anim.start_time;
+    elapsed = bsp_ec11_get_tick() - anim->start_time;
 
-    if (elapsed >= current_anim.duration) {
+    if (elapsed >= anim->duration) {
         return 100;
     }
 
-    progress = (uint8_t)((elapsed * 100) / current_anim.duration);
-
-    return progress;
+    return (uint8_t)((calc_progress(elapsed, anim->duration) * 100) >> 16);
 }
 
 /**
@@ -254,7 +291,7 @@ uint8_t menu_anim_get_progress(void)
  */
 uint8_t menu_anim_is_playing(void)
 {
-    return current_anim.is_playing;
+    return tweens[LEGACY_SLOT].anim.is_playing;
 }
 
 /**
@@ -284,3 +321,121 @@ uint8_t menu_anim_get_scale(void)
 
     return (uint8_t)value;
 }
+
+/**
+ * @brief  启动一个补间
+ */
+menu_tween_id_t menu_tween_start(menu_anim_type_t type, menu_easing_type_t easing,
+                                 uint32_t duration, int16_t start_val, int16_t end_val,
+                                 int16_t *target)
+{
+    menu_tween_id_t free_id = MENU_TWEEN_INVALID;
+    menu_tween_id_t id;
+
+    for (id = LEGACY_SLOT + 1; id < MENU_ANIM_MAX_TWEENS; id++) {
+        if (target != NULL && tweens[id].target == target && tweens[id].anim.is_playing) {
+            free_id = id;   /* 同一属性只保留一个补间 */
+            break;
+        }
+        if (free_id == MENU_TWEEN_INVALID && !tweens[id].anim.is_playing) {
+            free_id = id;
+        }
+    }
+
+    if (free_id == MENU_TWEEN_INVALID) {
+        return MENU_TWEEN_INVALID;
+    }
+
+    tweens[free_id].target = target;
+    tweens[free_id].on_done = NULL;
+    tweens[free_id].arg = NULL;
+    tween_setup(&tweens[free_id], type, easing, duration, start_val, end_val);
+
+    return free_id;
+}
+
+/**
+ * @brief  设置补间结束回调
+ */
+void menu_tween_set_callback(menu_tween_id_t id, menu_tween_done_t on_done, void *arg)
+{
+    if (id >= MENU_ANIM_MAX_TWEENS) {
+        return;
+    }
+
+    tweens[id].on_done = on_done;
+    tweens[id].arg = arg;
+}
+
+/**
+ * @brief  停止补间
+ */
+void menu_tween_stop(menu_tween_id_t id)
+{
+    if (id >= MENU_ANIM_MAX_TWEENS) {
+        return;
+    }
+
+    tweens[id].anim.is_playing = 0;
+}
+
+/**
+ * @brief  停止所有补间
+ */
+void menu_tween_stop_all(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MENU_ANIM_MAX_TWEENS; i++) {
+        tweens[i].anim.is_playing = 0;
+    }
+}
+
+/**
+ * @brief  获取补间最近一帧的值
+ */
+int16_t menu_tween_get_value(menu_tween_id_t id)
+{
+    if (id >= MENU_ANIM_MAX_TWEENS) {
+        return 0;
+    }
+
+    return tweens[id].value;
+}
+
+/**
+ * @brief  检查补间是否在播放
+ */
+uint8_t menu_tween_is_playing(menu_tween_id_t id)
+{
+    if (id >= MENU_ANIM_MAX_TWEENS) {
+        return 0;
+    }
+
+    return tweens[id].anim.is_playing;
+}
+
+/**
+ * @brief  Q16定点缓动: 查表 + 段内线性插值
+ */
+int32_t menu_anim_ease_q16(menu_easing_type_t easing, uint32_t progress)
+{
+    const int32_t *lut;
+    uint32_t index;
+    int32_t frac;
+
+    if ((uint32_t)easing >= MENU_EASING_COUNT) {
+        easing = MENU_EASING_LINEAR;
+    }
+
+    lut = easing_lut[easing];
+
+    if (progress >= MENU_ANIM_Q16_ONE) {
+        return lut[MENU_ANIM_LUT_SEGMENTS];
+    }
+
+    index = progress >> LUT_FRAC_BITS;
+    frac = (int32_t)(progress & LUT_FRAC_MASK);
+
+    return lut[index] + (((lut[index + 1] - lut[index]) * frac) >> LUT_FRAC_BITS);
+}
@@ -12,6 +12,14 @@
   * - 缩放动画 (选中项放大效果)
   * - 弹跳动画 (确认操作时的反馈)
   *
+  * 实现说明:
+  * - 补间池: 最多 MENU_ANIM_MAX_TWEENS 个补间同时运行, 每个补间可绑定一个
+  *   int16_t 属性 (位置/透明度/缩放等), 每帧直接写入新值
+  * - 缓动曲线使用Q16定点查找表 (tools/gen_easing_lut.py 生成), 段间线性插值,
+  *   运行时无浮点运算
+  * - 所有补间由一个周期为 MENU_ANIM_PERIOD_MS 的调度任务 menu_anim_task() 驱动
+  * - 原单动画API (menu_anim_start/get_value等) 固定使用0号槽位, 行为不变
+  *
   ******************************************************************************
   */
 
@@ -30,6 +38,13 @@ extern "C" {
 #define MENU_ANIM_SLIDE_DURATION    300    /* 滑动动画时长(ms) */
 #define MENU_ANIM_FADE_DURATION     200    /* 淡入淡出时长(ms) */
 #define MENU_ANIM_BOUNCE_DURATION   150    /* 弹跳动画时长(ms) */
+#define MENU_ANIM_MAX_TWEENS        8      /* 补间池大小 (含旧API使用的0号槽位) */
+#define MENU_ANIM_PERIOD_MS         (1000 / MENU_ANIM_FPS)  /* 动画任务周期 */
+
+/* 定点数 --------------------------------------------------------------------*/
+#define MENU_ANIM_Q16_ONE           65536  /* Q16格式的1.0 */
+#define MENU_ANIM_LUT_SEGMENTS      64     /* 每条缓动曲线的查找表段数 */
+#define MENU_TWEEN_INVALID          0xFF   /* 无效补间ID */
 
 /* 动画类型 ------------------------------------------------------------------*/
 typedef enum {
@@ -51,7 +66,8 @@ typedef enum {
     MENU_EASING_EASE_IN,       /* 加速 */
     MENU_EASING_EASE_OUT,      /* 减速 */
     MENU_EASING_EASE_IN_OUT,   /* 先加速后减速 */
-    MENU_EASING_BOUNCE         /* 弹跳效果 */
+    MENU_EASING_BOUNCE,        /* 弹跳效果 */
+    MENU_EASING_COUNT          /* 缓动类型数量 */
 } menu_easing_type_t;
 
 /* 动画状态结构体 ------------------------------------------------------------*/
@@ -65,6 +81,21 @@ typedef struct {
     uint8_t            is_playing;     /* 是否正在播放 */
 } menu_animation_t;
 
+/* 补间ID --------------------------------------------------------------------*/
+typedef uint8_t menu_tween_id_t;
+
+/* 补间结束回调 --------------------------------------------------------------*/
+typedef void (*menu_tween_done_t)(menu_tween_id_t id, void *arg);
+
+/* 补间结构体 ----------------------------------------------------------------*/
+typedef struct {
+    menu_animation_t   anim;           /* 动画参数 */
+    int16_t           *target;         /* 绑定的属性 (可为NULL) */
+    int16_t            value;          /* 最近一帧的值 */
+    menu_tween_done_t  on_done;        /* 结束回调 (可为NULL) */
+    void              *arg;            /* 回调参数 */
+} menu_tween_t;
+
 /* API函数声明 ---------------------------------------------------------------*/
 
 /**
@@ -87,11 +118,19 @@ void menu_anim_start(menu_anim_type_t type, menu_easing_type_t easing,
                      uint32_t duration, int16_t start_val, int16_t end_val);
 
 /**
- * @brief  更新动画(需要周期调用)
+ * @brief  更新所有补间(需要周期调用)
  * @param  None
+ * @retval 仍在播放的补间数量
+ * @note   一般由 menu_anim_task() 调用, 也可在主循环中直接调用
+ */
+uint8_t menu_anim_update(void);
+
+/**
+ * @brief  动画调度任务, 以 MENU_ANIM_PERIOD_MS 周期注册到调度器
+ * @param  arg: 未使用
  * @retval None
  */
-void menu_anim_update(void);
+void menu_anim_task(void *arg);
 
 /**
  * @brief  停止动画
@@ -135,6 +174,66 @@ uint8_t menu_anim_get_alpha(void);
  */
 uint8_t menu_anim_get_scale(void);
 
+/**
+ * @brief  启动一个补间 (从1号槽位开始分配)
+ * @param  type: 动画类型
+ * @param  easing: 缓动函数
+ * @param  duration: 持续时间(ms)
+ * @param  start_val: 起始值
+ * @param  end_val: 结束值
+ * @param  target: 绑定的属性, 每帧写入当前值 (可为NULL)
+ * @retval 补间ID, 池满返回 MENU_TWEEN_INVALID
+ * @note   同一属性已有补间时复用该槽位, 新补间从头开始
+ */
+menu_tween_id_t menu_tween_start(menu_anim_type_t type, menu_easing_type_t easing,
+                                 uint32_t duration, int16_t start_val, int16_t end_val,
+                                 int16_t *target);
+
+/**
+ * @brief  设置补间结束回调 (自然结束时调用, 停止时不调用)
+ * @param  id: 补间ID
+ * @param  on_done: 回调函数
+ * @param  arg: 回调参数
+ * @retval None
+ */
+void menu_tween_set_callback(menu_tween_id_t id, menu_tween_done_t on_done, void *arg);
+
+/**
+ * @brief  停止补间 (属性保持当前值)
+ * @param  id: 补间ID
+ * @retval None
+ */
+void menu_tween_stop(menu_tween_id_t id);
+
+/**
+ * @brief  停止所有补间
+ * @param  None
+ * @retval None
+ */
+void menu_tween_stop_all(void);
+
+/**
+ * @brief  获取补间最近一帧的值
+ * @param  id: 补间ID
+ * @retval 当前值
+ */
+int16_t menu_tween_get_value(menu_tween_id_t id);
+
+/**
+ * @brief  检查补间是否在播放
+ * @param  id: 补间ID
+ * @retval 1-播放中, 0-已停止
+ */
+uint8_t menu_tween_is_playing(menu_tween_id_t id);
+
+/**
+ * @brief  Q16定点缓动
+ * @param  easing: 缓动类型
+ * @param  progress: 线性进度 (Q16, 0 ~ MENU_ANIM_Q16_ONE)
+ * @retval 缓动后的进度 (Q16)
+ */
+int32_t menu_anim_ease_q16(menu_easing_type_t easing, uint32_t progress);
+
 /* 辅助宏定义 ----------------------------------------------------------------*/
 
 /* 启动菜单切换滑动动画 */
@@ -8,96 +8,378 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "menu_config.h"
+#include "name_index.h"
+#include "kv_store.h"
+#include "crc.h"
 #include <string.h>
 
+/* Private defines -----------------------------------------------------------*/
+#define PARAM_INDEX_SLOTS   32     /* 名称索引槽位数: 不小于2倍参数数的2的幂 */
+#define VERSION_KEY         MENU_CONFIG_MAGIC   /* 版本记录的键 */
+
+#if PARAM_INDEX_SLOTS < NAME_INDEX_SLOTS_FOR(MENU_CONFIG_MAX_PARAMS)
+#error "PARAM_INDEX_SLOTS too small for MENU_CONFIG_MAX_PARAMS"
+#endif
+
+/* 参数脏位图 */
+#define DIRTY_WORDS         ((MENU_CONFIG_MAX_PARAMS + 31) / 32)
+#define DIRTY_TEST(i)       (dirty_bits[(i) >> 5] & (1UL << ((i) & 31)))
+#define DIRTY_SET(i)        (dirty_bits[(i) >> 5] |= (1UL << ((i) & 31)))
+#define DIRTY_CLEAR(i)      (dirty_bits[(i) >> 5] &= ~(1UL << ((i) & 31)))
+
 /* Private variables ---------------------------------------------------------*/
 static menu_param_config_t param_configs[MENU_CONFIG_MAX_PARAMS];
 static uint8_t param_count = 0;
-static menu_config_data_t config_data = {0};
-static uint8_t config_dirty = 0;          /* 配置脏标志 */
+static name_index_t param_index;
+static name_index_slot_t param_slots[PARAM_INDEX_SLOTS];
+static menu_config_data_t config_data = {0};   /* 参数描述与影子 */
+static uint32_t seen_crc[MENU_CONFIG_MAX_PARAMS];  /* 上次检查时值的CRC, 变化时重新计时 */
+static uint32_t dirty_bits[DIRTY_WORDS];    /* 与影子不同、待保存的参数 */
+static uint8_t version_saved = 0;         /* 版本记录已写入 */
+static uint8_t version_stale = 0;         /* 旧版本记录待删除 (恢复出厂设置) */
 static uint32_t last_modify_time = 0;     /* 上次修改时间 */
+static const menu_config_migration_t *migrations = NULL;
+static uint8_t migration_count = 0;
 
 /* 外部时间戳函数 */
 extern uint32_t bsp_ec11_get_tick(void);
+extern uint32_t scheduler_get_us(void);
 
 /* Private functions ---------------------------------------------------------*/
 
 /**
- * @brief  计算CRC32校验和
- * @param  data: 数据指针
- * @param  len: 数据长度
- * @retval CRC32值
+ * @brief  名称索引回调: 取参数名称
+ * @param  ctx: 未使用
+ * @param  index: 参数索引
+ * @retval 参数名称
  */
-static uint32_t calculate_crc32(const uint8_t *data, uint32_t len)
+static const char* param_index_name(void *ctx, uint16_t index)
 {
-    uint32_t crc = 0xFFFFFFFF;
-    uint32_t i, j;
-
-    for (i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (j = 0; j < 8; j++) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xEDB88320;
-            } else {
-                crc >>= 1;
-            }
-        }
+    (void)ctx;
+    return param_configs[index].name;
+}
+
+/**
+ * @brief  按类型取值大小
+ * @param  cfg: 参数配置
+ * @retval 字节数, 0表示无效
+ */
+static uint8_t param_size(const menu_param_config_t *cfg)
+{
+    switch (cfg->type) {
+        case MENU_PARAM_TYPE_INT32:
+        case MENU_PARAM_TYPE_FLOAT:
+            return 4;
+
+        case MENU_PARAM_TYPE_UINT8:
+            return 1;
+
+        case MENU_PARAM_TYPE_INT64:
+            return 8;
+
+        case MENU_PARAM_TYPE_STRING:
+        case MENU_PARAM_TYPE_BLOB:
+            return cfg->size;
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief  参数当前值的有效长度 (字符串不含'\0'及其后的内容)
+ * @param  index: 参数索引
+ * @retval 字节数
+ */
+static uint8_t value_len(uint8_t index)
+{
+    const char *str = (const char*)param_configs[index].ptr;
+    uint8_t n = 0;
+
+    if (param_configs[index].type != MENU_PARAM_TYPE_STRING) {
+        return config_data.params[index].size;
     }
 
-    return ~crc;
+    while (n < config_data.params[index].size - 1 && str[n] != '\0') {
+        n++;
+    }
+
+    return n;
 }
 
 /**
- * @brief  验证配置数据有效性
- * @param  data: 配置数据指针
- * @retval 1-有效, 0-无效
+ * @brief  参数的影子
+ * @param  index: 参数索引
+ * @retval 影子指针
  */
-static uint8_t validate_config_data(const menu_config_data_t *data)
+static uint8_t* shadow_of(uint8_t index)
 {
-    uint32_t crc_calc;
+    return &config_data.shadow[config_data.params[index].offset];
+}
 
-    /* 检查魔术字 */
-    if (data->magic != MENU_CONFIG_MAGIC) {
+/**
+ * @brief  当前值是否与影子相同
+ * @param  index: 参数索引
+ * @retval 1-相同, 0-不同
+ */
+static uint8_t equals_shadow(uint8_t index)
+{
+    uint8_t len = value_len(index);
+
+    /* 影子中字符串之后补0, 长度不同时第len个字节不为0 */
+    if (memcmp(param_configs[index].ptr, shadow_of(index), len) != 0) {
         return 0;
     }
 
-    /* 检查版本号 */
-    if (data->version != MENU_CONFIG_VERSION) {
-        return 0;
+    return (len == config_data.params[index].size || shadow_of(index)[len] == 0) ? 1 : 0;
+}
+
+/**
+ * @brief  用当前值更新影子
+ * @param  index: 参数索引
+ * @retval None
+ */
+static void sync_shadow(uint8_t index)
+{
+    uint8_t len = value_len(index);
+
+    memcpy(shadow_of(index), param_configs[index].ptr, len);
+    memset(shadow_of(index) + len, 0, config_data.params[index].size - len);
+    seen_crc[index] = crc32_update(0, param_configs[index].ptr, len);
+}
+
+/**
+ * @brief  写入参数变量 (不改变影子)
+ * @param  index: 参数索引
+ * @param  data: 值
+ * @param  len: 长度
+ * @retval 0-成功, -1-长度与类型不符
+ */
+static int set_value(uint8_t index, const void *data, uint8_t len)
+{
+    uint8_t *dst = (uint8_t*)param_configs[index].ptr;
+    uint8_t size = config_data.params[index].size;
+
+    switch (param_configs[index].type) {
+        case MENU_PARAM_TYPE_STRING:
+            if (len > size - 1) {
+                len = size - 1;
+            }
+            memcpy(dst, data, len);
+            dst[len] = '\0';
+            return 0;
+
+        case MENU_PARAM_TYPE_BLOB:
+            if (len > size) {
+                len = size;
+            }
+            memcpy(dst, data, len);
+            memset(dst + len, 0, size - len);
+            return 0;
+
+        default:
+            if (len != size) {
+                return -1;
+            }
+            memcpy(dst, data, size);
+            return 0;
     }
+}
 
-    /* 检查参数数量 */
-    if (data->param_count > MENU_CONFIG_MAX_PARAMS) {
-        return 0;
+/**
+ * @brief  写入默认值
+ * @param  index: 参数索引
+ * @retval None
+ */
+static void apply_default(uint8_t index)
+{
+    const menu_param_config_t *cfg = &param_configs[index];
+    int32_t i32 = cfg->default_val;
+    uint8_t u8 = (uint8_t)cfg->default_val;
+    uint8_t len;
+
+    switch (cfg->type) {
+        case MENU_PARAM_TYPE_INT32:
+            set_value(index, &i32, sizeof(i32));
+            break;
+
+        case MENU_PARAM_TYPE_UINT8:
+            set_value(index, &u8, sizeof(u8));
+            break;
+
+        case MENU_PARAM_TYPE_STRING:
+            len = 0;
+            if (cfg->default_ptr != NULL) {
+                while (len < cfg->size - 1 && ((const char*)cfg->default_ptr)[len] != '\0') {
+                    len++;
+                }
+            }
+            set_value(index, cfg->default_ptr, len);
+            break;
+
+        default:
+            if (cfg->default_ptr != NULL) {
+                set_value(index, cfg->default_ptr, config_data.params[index].size);
+            } else {
+                memset(cfg->ptr, 0, config_data.params[index].size);
+            }
+            break;
     }
+}
 
-    /* 计算并验证CRC */
-    crc_calc = calculate_crc32((const uint8_t*)data,
-                               sizeof(menu_config_data_t) - sizeof(uint32_t));
+/**
+ * @brief  影子比较: 更新脏位, 值仍在变化时重新计时
+ * @param  now: 当前时间(ms)
+ * @retval None
+ */
+static void scan_changes(uint32_t now)
+{
+    uint8_t i;
 
-    if (crc_calc != data->crc32) {
-        return 0;
+    for (i = 0; i < param_count; i++) {
+        uint32_t crc = crc32_update(0, param_configs[i].ptr, value_len(i));
+
+        if (crc != seen_crc[i]) {
+            seen_crc[i] = crc;
+            last_modify_time = now;
+        }
+
+        /* 只置位不清除: 强制重写的参数不受影响, 改回已保存的值时由 kv_set 跳过 */
+        if (!equals_shadow(i)) {
+            DIRTY_SET(i);
+        }
+    }
+}
+
+/**
+ * @brief  是否有待保存的参数
+ * @retval 1-有, 0-无
+ */
+static uint8_t any_dirty(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < DIRTY_WORDS; i++) {
+        if (dirty_bits[i] != 0) {
+            return 1;
+        }
     }
 
-    return 1;
+    return 0;
 }
 
 /**
- * @brief  查找参数配置
- * @param  name: 参数名称
- * @retval 参数索引, -1表示未找到
+ * @brief  写入脏参数, 超过时间片后返回, 剩余的下次继续
+ * @param  slice_us: 时间片(us), 0表示全部写完
+ * @retval 0-全部写完, 1-还有剩余, -1-写入失败(脏位保留, 稍后重试)
+ * @note   每个参数一条记录, 中途复位时每个参数为旧值或新值之一
  */
-static int find_param_index(const char *name)
+static int save_chunk(uint32_t slice_us)
 {
+    uint32_t start = scheduler_get_us();
+    uint16_t version = MENU_CONFIG_VERSION;
     uint8_t i;
 
+    /* 先删除旧版本记录, 重写中途复位时上电按无有效配置处理, 不会新旧值混用 */
+    if (version_stale) {
+        if (kv_delete(VERSION_KEY) != 0) {
+            return -1;
+        }
+        version_stale = 0;
+    }
+
     for (i = 0; i < param_count; i++) {
-        if (strcmp(param_configs[i].name, name) == 0) {
-            return i;
+        if (!DIRTY_TEST(i)) {
+            continue;
+        }
+
+        if (kv_set(config_data.params[i].id, (uint8_t)param_configs[i].type,
+                   param_configs[i].ptr, value_len(i)) != 0) {
+            return -1;
+        }
+        sync_shadow(i);
+        DIRTY_CLEAR(i);
+
+        /* 至少写一个参数, 保证进度 */
+        if (slice_us != 0 && (scheduler_get_us() - start) >= slice_us) {
+            break;
         }
     }
 
-    return -1;
+    if (any_dirty()) {
+        return 1;
+    }
+
+    /* 版本记录最后写入: 没有版本记录时, 全部参数重写完成前复位, 上电仍按无有效配置处理 */
+    if (!version_saved) {
+        if (kv_set(VERSION_KEY, KV_TYPE_RAW, &version, sizeof(version)) != 0) {
+            return -1;
+        }
+        version_saved = 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  执行迁移, 把已存数据升级到当前版本
+ * @param  version: 已存版本, 返回升级后的版本
+ * @retval 0-成功, -1-失败
+ */
+static int run_migrations(uint16_t *version)
+{
+    while (*version < MENU_CONFIG_VERSION) {
+        const menu_config_migration_t *step = NULL;
+        uint8_t i;
+
+        for (i = 0; i < migration_count; i++) {
+            if (migrations[i].from_version == *version) {
+                step = &migrations[i];
+                break;
+            }
+        }
+
+        if (step == NULL) {
+            break;      /* 此后的修改无需迁移, 按字段ID加载 */
+        }
+
+        if (step->to_version <= *version || step->to_version > MENU_CONFIG_VERSION ||
+            step->migrate() != 0) {
+            return -1;
+        }
+
+        /* 每步完成后记录版本, 中途复位从下一步继续 */
+        *version = step->to_version;
+        if (kv_set(VERSION_KEY, KV_TYPE_RAW, version, sizeof(*version)) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  加载遍历回调: 按字段ID和类型匹配参数
+ */
+static void load_visit(void *ctx, uint32_t key, uint8_t type, const void *data, uint8_t len)
+{
+    int index = menu_config_find_param_id(key);
+
+    (void)ctx;
+
+    if (index >= 0 && (uint8_t)param_configs[index].type == type) {
+        set_value((uint8_t)index, data, len);
+    }
+}
+
+/**
+ * @brief  查找参数配置
+ * @param  name: 参数名称
+ * @retval 参数索引, -1表示未找到
+ */
+static int find_param_index(const char *name)
+{
+    return name_index_find(&param_index, name);
 }
 
 /* Public functions ----------------------------------------------------------*/
@@ -107,131 +389,116 @@ static int find_param_index(const char *name)
  */
 int menu_config_init(const menu_param_config_t *params, uint8_t count)
 {
-    uint8_t i;
+    uint16_t offset = 0;
+    uint8_t i, j;
 
     if (count > MENU_CONFIG_MAX_PARAMS) {
         return -1;
     }
 
-    /* 保存参数配置 */
-    param_count = count;
-    for (i = 0; i < count; i++) {
-        param_configs[i] = params[i];
-    }
-
-    /* 初始化配置数据结构 */
     memset(&config_data, 0, sizeof(config_data));
     config_data.magic = MENU_CONFIG_MAGIC;
     config_data.version = MENU_CONFIG_VERSION;
-    config_data.param_count = count;
+    param_count = 0;
 
-    /* 设置默认值 */
+    /* 保存参数配置并建立名称索引 (重名或名称ID冲突时失败) */
+    name_index_init(&param_index, param_slots, PARAM_INDEX_SLOTS, param_index_name, NULL);
     for (i = 0; i < count; i++) {
-        strncpy(config_data.params[i].name, param_configs[i].name, 15);
-        config_data.params[i].name[15] = '\0';
-        config_data.params[i].value = param_configs[i].default_val;
+        menu_param_config_t *cfg = &param_configs[i];
+        uint8_t size;
+
+        *cfg = params[i];
+        cfg->name[sizeof(cfg->name) - 1] = '\0';
+        size = param_size(cfg);
+
+        if (cfg->ptr == NULL || size == 0 || offset + size > MENU_CONFIG_SHADOW_SIZE ||
+            name_index_add(&param_index, cfg->name, i) != 0) {
+            return -1;
+        }
+
+        strncpy(config_data.params[i].name, cfg->name, 15);
+        config_data.params[i].id = (cfg->id != 0) ? cfg->id : name_index_hash(cfg->name);
+        config_data.params[i].offset = offset;
+        config_data.params[i].size = size;
+        offset += size;
+
+        /* 字段ID同时作为存储键, 不能重复, 也不能与版本记录或空白Flash冲突 */
+        if (config_data.params[i].id == VERSION_KEY || config_data.params[i].id == 0xFFFFFFFF) {
+            return -1;
+        }
+        for (j = 0; j < i; j++) {
+            if (config_data.params[j].id == config_data.params[i].id) {
+                return -1;
+            }
+        }
     }
+    param_count = count;
+    config_data.param_count = count;
 
-    /* 尝试从EEPROM加载 */
+    /* 挂载键值存储并加载 */
     if (menu_config_load() != 0) {
         /* 加载失败，使用默认值 */
         menu_config_reset_to_default();
     }
 
-    config_dirty = 0;
-
     return 0;
 }
 
 /**
- * @brief  从EEPROM加载配置
+ * @brief  从Flash键值存储加载配置
  */
 int menu_config_load(void)
 {
-    menu_config_data_t temp_data;
+    uint16_t version;
     uint8_t i;
-    int param_idx;
 
-    /* 从EEPROM读取 */
-    if (menu_config_eeprom_read(0, (uint8_t*)&temp_data, sizeof(temp_data)) != 0) {
+    version_saved = 0;
+
+    if (kv_store_init() != 0) {
         return -1;
     }
 
-    /* 验证数据 */
-    if (!validate_config_data(&temp_data)) {
+    /* 版本记录不存在(首次上电)、高于当前版本或迁移失败时使用默认值 */
+    if (kv_get(VERSION_KEY, &version, sizeof(version), NULL) != sizeof(version) ||
+        version > MENU_CONFIG_VERSION || run_migrations(&version) != 0) {
         return -1;
     }
 
-    /* 应用配置到内存 */
-    for (i = 0; i < temp_data.param_count; i++) {
-        param_idx = find_param_index(temp_data.params[i].name);
-
-        if (param_idx >= 0) {
-            /* 根据类型赋值 */
-            switch (param_configs[param_idx].type) {
-                case MENU_PARAM_TYPE_INT32:
-                    *(int32_t*)param_configs[param_idx].ptr = temp_data.params[i].value;
-                    break;
+    /* 先写默认值, 再遍历存储区一次覆盖已保存的参数 */
+    for (i = 0; i < param_count; i++) {
+        apply_default(i);
+    }
 
-                case MENU_PARAM_TYPE_UINT8:
-                    *(uint8_t*)param_configs[param_idx].ptr = (uint8_t)temp_data.params[i].value;
-                    break;
+    if (kv_foreach(load_visit, NULL) < 0) {
+        return -1;
+    }
 
-                case MENU_PARAM_TYPE_FLOAT:
-                    /* 浮点数暂不支持 */
-                    break;
-            }
-        }
+    for (i = 0; i < param_count; i++) {
+        sync_shadow(i);
     }
 
-    /* 保存到本地副本 */
-    config_data = temp_data;
+    /* 未经迁移步骤升级的版本由 save_chunk 补写 */
+    version_saved = (version == MENU_CONFIG_VERSION) ? 1 : 0;
+    memset(dirty_bits, 0, sizeof(dirty_bits));
 
     return 0;
 }
 
 /**
- * @brief  保存配置到EEPROM
+ * @brief  保存配置到Flash键值存储
  */
 int menu_config_save(uint8_t immediate)
 {
-    uint8_t i;
-
     if (!immediate) {
         /* 延迟保存 */
         menu_config_mark_dirty();
         return 0;
     }
 
-    /* 从内存中读取当前值 */
-    for (i = 0; i < param_count; i++) {
-        switch (param_configs[i].type) {
-            case MENU_PARAM_TYPE_INT32:
-                config_data.params[i].value = *(int32_t*)param_configs[i].ptr;
-                break;
-
-            case MENU_PARAM_TYPE_UINT8:
-                config_data.params[i].value = *(uint8_t*)param_configs[i].ptr;
-                break;
-
-            case MENU_PARAM_TYPE_FLOAT:
-                /* 浮点数暂不支持 */
-                break;
-        }
-    }
-
-    /* 计算CRC */
-    config_data.crc32 = calculate_crc32((const uint8_t*)&config_data,
-                                        sizeof(menu_config_data_t) - sizeof(uint32_t));
-
-    /* 写入EEPROM */
-    if (menu_config_eeprom_write(0, (const uint8_t*)&config_data, sizeof(config_data)) != 0) {
-        return -1;
-    }
-
-    config_dirty = 0;
+    /* 只写入与影子不同的参数 */
+    scan_changes(bsp_ec11_get_tick());
 
-    return 0;
+    return (save_chunk(0) == 0) ? 0 : -1;
 }
 
 /**
@@ -241,27 +508,17 @@ void menu_config_reset_to_default(void)
 {
     uint8_t i;
 
-    /* 应用默认值 */
+    /* 应用默认值, 并重写全部参数 (Flash中可能有其他版本的记录) */
     for (i = 0; i < param_count; i++) {
-        switch (param_configs[i].type) {
-            case MENU_PARAM_TYPE_INT32:
-                *(int32_t*)param_configs[i].ptr = param_configs[i].default_val;
-                break;
-
-            case MENU_PARAM_TYPE_UINT8:
-                *(uint8_t*)param_configs[i].ptr = (uint8_t)param_configs[i].default_val;
-                break;
-
-            case MENU_PARAM_TYPE_FLOAT:
-                /* 浮点数暂不支持 */
-                break;
-        }
-
-        config_data.params[i].value = param_configs[i].default_val;
+        apply_default(i);
+        seen_crc[i] = crc32_update(0, param_configs[i].ptr, value_len(i));
+        DIRTY_SET(i);
     }
+    version_saved = 0;
+    version_stale = 1;
 
     /* 立即保存 */
-    menu_config_save(1);
+    save_chunk(0);
 }
 
 /**
@@ -269,7 +526,6 @@ void menu_config_reset_to_default(void)
  */
 void menu_config_mark_dirty(void)
 {
-    config_dirty = 1;
     last_modify_time = bsp_ec11_get_tick();
 }
 
@@ -280,35 +536,113 @@ void menu_config_task(void)
 {
     uint32_t current_time = bsp_ec11_get_tick();
 
-    /* 检查是否需要延迟保存 */
-    if (config_dirty) {
-        if ((current_time - last_modify_time) >= MENU_CONFIG_SAVE_DELAY_MS) {
-            /* 触发保存 */
-            menu_config_save(1);
+    /* 后台整理/擦除Flash扇区 */
+    kv_store_poll();
+
+    /* 影子比较找出变化的参数 */
+    scan_changes(current_time);
+
+    /* 停止修改超过延迟时间后, 每次写入一个时间片 */
+    if ((any_dirty() || !version_saved) &&
+        (current_time - last_modify_time) >= MENU_CONFIG_SAVE_DELAY_MS) {
+        save_chunk(MENU_CONFIG_SAVE_SLICE_US);
+    }
+}
+
+/**
+ * @brief  是否有未保存的修改
+ */
+uint8_t menu_config_pending(void)
+{
+    return (any_dirty() || !version_saved) ? 1 : 0;
+}
+
+/**
+ * @brief  按名称查找参数
+ */
+int menu_config_find_param(const char *name)
+{
+    if (name == NULL) {
+        return -1;
+    }
+
+    return find_param_index(name);
+}
+
+/**
+ * @brief  按字段ID查找参数
+ */
+int menu_config_find_param_id(uint32_t id)
+{
+    int index = name_index_find_id(&param_index, id);
+    uint8_t i;
+
+    /* 名称哈希命中且该参数未显式指定ID */
+    if (index >= 0 && param_configs[index].id == 0) {
+        return index;
+    }
+
+    for (i = 0; i < param_count; i++) {
+        if (param_configs[i].id != 0 && param_configs[i].id == id) {
+            return i;
         }
     }
+
+    return -1;
 }
 
 /**
- * @brief  获取配置数据指针
+ * @brief  获取参数的字段ID
  */
-menu_config_data_t* menu_config_get_data(void)
+uint32_t menu_config_param_id(uint8_t index)
 {
-    return &config_data;
+    if (index >= param_count) {
+        return 0;
+    }
+
+    return config_data.params[index].id;
 }
 
-/* 弱定义的EEPROM接口(用户需要实现) ----------------------------------------*/
+/**
+ * @brief  设置迁移步骤表
+ */
+int menu_config_set_migrations(const menu_config_migration_t *steps, uint8_t count)
+{
+    if (count > MENU_CONFIG_MAX_MIGRATIONS || (steps == NULL && count > 0)) {
+        return -1;
+    }
+
+    migrations = steps;
+    migration_count = count;
+
+    return 0;
+}
 
-__weak int menu_config_eeprom_read(uint32_t addr, uint8_t *buf, uint32_t len)
+/**
+ * @brief  迁移辅助: 把已存值从旧字段ID移到新字段ID
+ */
+int menu_config_migrate_rename(uint32_t old_id, uint32_t new_id)
 {
-    /* 默认实现：从STM32内部Flash模拟EEPROM */
-    /* 用户需要根据实际硬件实现此函数 */
-    return -1;  /* 返回失败 */
+    uint8_t buf[KV_MAX_VALUE];
+    uint8_t type;
+    int len = kv_get(old_id, buf, sizeof(buf), &type);
+
+    if (len < 0) {
+        return 0;
+    }
+
+    /* 先写新键再删旧键, 中途复位后重复执行结果相同 */
+    if (kv_set(new_id, type, buf, (uint8_t)len) != 0) {
+        return -1;
+    }
+
+    return kv_delete(old_id);
 }
 
-__weak int menu_config_eeprom_write(uint32_t addr, const uint8_t *buf, uint32_t len)
+/**
+ * @brief  获取配置数据指针
+ */
+menu_config_data_t* menu_config_get_data(void)
 {
-    /* 默认实现：写入STM32内部Flash模拟EEPROM */
-    /* 用户需要根据实际硬件实现此函数 */
-    return -1;  /* 返回失败 */
+    return &config_data;
 }
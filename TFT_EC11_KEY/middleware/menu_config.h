@@ -2,15 +2,23 @@
   ******************************************************************************
   * @file    menu_config.h
   * @author  TFT_EC11_KEY Project
-  * @brief   菜单配置参数保存/加载模块 - 支持EEPROM持久化
+  * @brief   菜单配置参数保存/加载模块 - Flash键值存储持久化
   ******************************************************************************
   * @attention
   *
   * 功能特性:
-  * - 自动保存菜单配置到EEPROM/Flash
-  * - 支持数值型和开关型参数
-  * - 自动CRC校验，防止数据损坏
-  * - 延迟写入机制，减少Flash擦写次数
+  * - 自动保存菜单配置到内部Flash (见 kv_store.h)
+  * - 参数类型: 整数(8/32/64位)、浮点、字符串、二进制块
+  * - 每个参数以字段ID为键单独保存, 只追加值有变化的参数, 不擦除扇区
+  * - 字段按ID和类型匹配: 增删参数不需要迁移; 改名/改单位等通过版本迁移函数逐级升级
+  * - 加载时遍历存储区一次, 可直接从Flash读取(kv_port_map), 不复制整块配置
+  * - 每条记录CRC校验, 掉电不丢失已保存的值
+  * - 延迟写入机制，减少Flash写入次数
+  * - 影子比较检测变化, 每个参数一个脏位, 只保存变化的参数
+  * - 后台分片保存: 每次任务调用写入不超过一个时间片, 不阻塞调度
+  * - 参数名称哈希索引，按名称或稳定ID查找为O(1) (见 name_index.h)
+  *
+  * 移植: 实现 kv_port_read/program/erase (见 kv_store.h)
   *
   ******************************************************************************
   */
@@ -30,14 +38,21 @@ extern "C" {
 /* 配置选项 ------------------------------------------------------------------*/
 #define MENU_CONFIG_MAX_PARAMS      16    /* 最多支持的配置参数数量 */
 #define MENU_CONFIG_MAGIC           0x4D434647  /* "MCFG" 魔术字 */
-#define MENU_CONFIG_VERSION         0x0100      /* 版本号 v1.0 */
+#define MENU_CONFIG_VERSION         0x0100      /* 当前模式版本, 需迁移的修改后递增 */
 #define MENU_CONFIG_SAVE_DELAY_MS   3000  /* 延迟保存时间(毫秒) */
+#define MENU_CONFIG_SAVE_SLICE_US   500   /* 每次任务调用的保存时间片(微秒), 至少写一个参数 */
+#define MENU_CONFIG_SHADOW_SIZE     256   /* 影子区字节数: 不小于全部参数大小之和 */
+#define MENU_CONFIG_MAX_MIGRATIONS  8     /* 最多迁移步骤数 */
 
 /* 参数类型 ------------------------------------------------------------------*/
+/* 取值与已保存的记录编号一致, 不要改变已有类型的值 */
 typedef enum {
     MENU_PARAM_TYPE_INT32 = 0,   /* 32位整数 */
     MENU_PARAM_TYPE_UINT8,       /* 8位无符号整数(用于开关) */
-    MENU_PARAM_TYPE_FLOAT        /* 浮点数(预留) */
+    MENU_PARAM_TYPE_FLOAT,       /* 单精度浮点 */
+    MENU_PARAM_TYPE_INT64,       /* 64位整数 */
+    MENU_PARAM_TYPE_STRING,      /* 字符串, size为缓冲区大小(含'\0') */
+    MENU_PARAM_TYPE_BLOB         /* 二进制块, size为字节数 */
 } menu_param_type_t;
 
 /* 参数配置结构体 ------------------------------------------------------------*/
@@ -45,22 +60,35 @@ typedef struct {
     char              name[16];    /* 参数名称 */
     menu_param_type_t type;        /* 参数类型 */
     void             *ptr;         /* 参数指针 */
-    int32_t           default_val; /* 默认值 */
+    int32_t           default_val; /* 默认值 (INT32/UINT8) */
+    uint32_t          id;          /* 字段ID, 0表示使用名称哈希 (改名时填旧名称的哈希可保留已存值) */
+    uint8_t           size;        /* STRING/BLOB的大小, 其他类型忽略 */
+    const void       *default_ptr; /* FLOAT/INT64/STRING/BLOB 的默认值, NULL为全0 */
 } menu_param_config_t;
 
-/* 存储在EEPROM中的数据结构 ------------------------------------------------*/
+/* 迁移步骤 ------------------------------------------------------------------*/
+typedef struct {
+    uint16_t from_version;         /* 适用的已存版本 */
+    uint16_t to_version;           /* 迁移后的版本 */
+    int    (*migrate)(void);       /* 用 kv_get/kv_set/kv_delete 或 menu_config_migrate_* 改写已存数据,
+                                      返回0成功; 需可重复执行 (中途复位后会再次执行) */
+} menu_config_migration_t;
+
+/* 配置数据RAM镜像 (影子: 最近一次加载/保存的值) --------------------------*/
 typedef struct {
-    uint32_t magic;                /* 魔术字，用于验证数据有效性 */
-    uint16_t version;              /* 配置版本号 */
+    uint32_t magic;                /* 魔术字 */
+    uint16_t version;              /* 模式版本号 */
     uint16_t param_count;          /* 参数数量 */
 
-    /* 参数数据 */
+    /* 参数描述 */
     struct {
-        char    name[16];
-        int32_t value;
+        char     name[16];
+        uint32_t id;               /* 字段ID */
+        uint16_t offset;           /* 影子在shadow中的偏移 */
+        uint8_t  size;             /* 值大小 */
     } params[MENU_CONFIG_MAX_PARAMS];
 
-    uint32_t crc32;               /* CRC32校验和 */
+    uint8_t shadow[MENU_CONFIG_SHADOW_SIZE];  /* 已保存的值 */
 } menu_config_data_t;
 
 /* API函数声明 ---------------------------------------------------------------*/
@@ -69,21 +97,24 @@ typedef struct {
  * @brief  初始化菜单配置系统
  * @param  params: 参数配置数组
  * @param  count: 参数数量
- * @retval 0-成功, -1-失败
+ * @retval 0-成功, -1-失败(参数过多、重名/ID冲突、大小无效或影子区不足)
+ * @note   需先调用 menu_config_set_migrations() 才会在加载时执行迁移
  */
 int menu_config_init(const menu_param_config_t *params, uint8_t count);
 
 /**
- * @brief  从EEPROM加载配置
+ * @brief  从Flash键值存储加载配置
  * @param  None
- * @retval 0-成功, -1-失败(使用默认值)
+ * @retval 0-成功(未保存过或类型不符的参数使用默认值), -1-失败(无有效配置、迁移失败或版本高于当前)
+ * @note   已存版本低于当前版本时依次执行迁移步骤, 没有对应步骤的版本直接按字段ID加载
  */
 int menu_config_load(void);
 
 /**
- * @brief  保存配置到EEPROM
- * @param  immediate: 1-立即保存, 0-延迟保存
- * @retval 0-成功, -1-失败
+ * @brief  保存配置到Flash键值存储
+ * @param  immediate: 1-立即写入全部变化的参数(阻塞), 0-延迟保存(由 menu_config_task 分片写入)
+ * @retval 0-成功, -1-失败(后台整理中空间不足或Flash错误, 保留脏位稍后重试)
+ * @note   只写入与影子不同的参数, 每个参数一条记录, 不擦除扇区
  */
 int menu_config_save(uint8_t immediate);
 
@@ -95,9 +126,10 @@ int menu_config_save(uint8_t immediate);
 void menu_config_reset_to_default(void);
 
 /**
- * @brief  标记参数已修改(触发延迟保存)
+ * @brief  标记参数已修改(重新开始延迟计时)
  * @param  None
  * @retval None
+ * @note   变化由 menu_config_task 的影子比较自动发现, 不调用也会保存
  */
 void menu_config_mark_dirty(void);
 
@@ -105,36 +137,63 @@ void menu_config_mark_dirty(void);
  * @brief  周期性任务(需要在主循环中调用)
  * @param  None
  * @retval None
- * @note   处理延迟保存逻辑
+ * @note   影子比较找出变化的参数; 停止修改 MENU_CONFIG_SAVE_DELAY_MS 后,
+ *         每次调用写入不超过 MENU_CONFIG_SAVE_SLICE_US; 并推进键值存储的后台整理 (kv_store_poll)
  */
 void menu_config_task(void);
 
 /**
- * @brief  获取配置数据指针(用于调试)
+ * @brief  是否有未保存的修改
  * @param  None
- * @retval 配置数据指针
+ * @retval 1-有(关机前可调用 menu_config_save(1)), 0-无
+ * @note   以最近一次 menu_config_task/menu_config_save 的影子比较为准
  */
-menu_config_data_t* menu_config_get_data(void);
+uint8_t menu_config_pending(void);
 
-/* 用户需要实现的底层接口 ---------------------------------------------------*/
+/**
+ * @brief  按名称查找参数
+ * @param  name: 参数名称
+ * @retval 参数索引, -1表示未找到
+ */
+int menu_config_find_param(const char *name);
+
+/**
+ * @brief  按字段ID查找参数
+ * @param  id: 字段ID (见 menu_config_param_id)
+ * @retval 参数索引, -1表示未找到
+ * @note   使用名称哈希的字段O(1), 显式指定ID的字段逐个比较
+ */
+int menu_config_find_param_id(uint32_t id);
 
 /**
- * @brief  从EEPROM读取数据
- * @param  addr: 地址偏移
- * @param  buf: 数据缓冲区
- * @param  len: 数据长度
- * @retval 0-成功, -1-失败
+ * @brief  获取参数的字段ID
+ * @param  index: 参数索引
+ * @retval 配置中的id, 为0时为名称的FNV-1a哈希; 可用于远程协议; 索引无效返回0
  */
-int menu_config_eeprom_read(uint32_t addr, uint8_t *buf, uint32_t len);
+uint32_t menu_config_param_id(uint8_t index);
 
 /**
- * @brief  向EEPROM写入数据
- * @param  addr: 地址偏移
- * @param  buf: 数据缓冲区
- * @param  len: 数据长度
- * @retval 0-成功, -1-失败
+ * @brief  设置迁移步骤表
+ * @param  steps: 迁移步骤 (需静态存储)
+ * @param  count: 步骤数
+ * @retval 0-成功, -1-步骤过多
  */
-int menu_config_eeprom_write(uint32_t addr, const uint8_t *buf, uint32_t len);
+int menu_config_set_migrations(const menu_config_migration_t *steps, uint8_t count);
+
+/**
+ * @brief  迁移辅助: 把已存值从旧字段ID移到新字段ID
+ * @param  old_id: 旧字段ID
+ * @param  new_id: 新字段ID
+ * @retval 0-成功(旧ID不存在也返回0), -1-失败
+ */
+int menu_config_migrate_rename(uint32_t old_id, uint32_t new_id);
+
+/**
+ * @brief  获取配置数据指针(用于调试)
+ * @param  None
+ * @retval 配置数据指针
+ */
+menu_config_data_t* menu_config_get_data(void);
 
 #ifdef __cplusplus
 }
@@ -13,6 +13,15 @@
 /* Private variables ---------------------------------------------------------*/
 static menu_state_t menu_state = {0};
 static menu_display_callback_t display_callback = NULL;
+static uint8_t  menu_dirty = 0;          /* 需要重绘 */
+static uint8_t  frame_started = 0;       /* 已按帧重绘过 */
+static uint32_t last_frame_time = 0;     /* 上次按帧重绘的时间 */
+
+/* 虚拟列表页缓存 (只保存当前层的可见页) */
+static menu_list_entry_t list_page[MENU_MAX_ITEMS_PER_PAGE];
+static uint16_t list_page_first = 0;     /* 缓存页的首条索引 */
+static uint8_t  list_page_count = 0;     /* 缓存页的有效条目数 */
+static uint8_t  list_page_valid = 0;     /* 缓存页有效 */
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -35,7 +44,7 @@ static menu_item_t** menu_get_current_items(void)
  * @param  None
  * @retval 当前菜单项数量
  */
-static uint8_t menu_get_current_count(void)
+static uint16_t menu_get_current_count(void)
 {
     if (menu_state.depth >= MENU_MAX_DEPTH) {
         return 0;
@@ -49,7 +58,7 @@ static uint8_t menu_get_current_count(void)
  * @param  None
  * @retval 当前选中索引
  */
-static uint8_t menu_get_current_index(void)
+static uint16_t menu_get_current_index(void)
 {
     if (menu_state.depth >= MENU_MAX_DEPTH) {
         return 0;
@@ -63,13 +72,41 @@ static uint8_t menu_get_current_index(void)
  * @param  index: 索引值
  * @retval None
  */
-static void menu_set_current_index(uint8_t index)
+static void menu_set_current_index(uint16_t index)
 {
     if (menu_state.depth < MENU_MAX_DEPTH) {
         menu_state.index_stack[menu_state.depth] = index;
     }
 }
 
+/**
+ * @brief  进入下一级菜单
+ * @param  items: 菜单项数组 (虚拟列表为NULL)
+ * @param  count: 菜单项数量
+ * @param  provider: 虚拟列表数据源 (普通菜单为NULL)
+ * @retval None
+ */
+static void menu_push_level(menu_item_t **items, uint16_t count,
+                            const menu_list_provider_t *provider)
+{
+    if (menu_state.depth >= MENU_MAX_DEPTH - 1) {
+        return;
+    }
+
+    if (provider != NULL) {
+        count = provider->get_count(provider->ctx);
+    }
+
+    menu_state.depth++;
+    menu_state.stack[menu_state.depth] = items;
+    menu_state.provider_stack[menu_state.depth] = provider;
+    menu_state.count_stack[menu_state.depth] = count;
+    menu_state.index_stack[menu_state.depth] = 0;
+    menu_state.scroll_offset = 0;
+    list_page_valid = 0;
+    menu_invalidate();
+}
+
 /* Public functions ----------------------------------------------------------*/
 
 /**
@@ -83,6 +120,7 @@ void menu_init(menu_item_t **root_items, uint8_t root_count,
                menu_display_callback_t disp_callback)
 {
     memset(&menu_state, 0, sizeof(menu_state_t));
+    list_page_valid = 0;
 
     menu_state.stack[0] = root_items;
     menu_state.count_stack[0] = root_count;
@@ -92,11 +130,10 @@ void menu_init(menu_item_t **root_items, uint8_t root_count,
     menu_state.edit_mode = 0;
 
     display_callback = disp_callback;
+    frame_started = 0;
 
     /* 初始刷新显示 */
-    if (display_callback != NULL) {
-        display_callback(&menu_state);
-    }
+    menu_refresh();
 }
 
 /**
@@ -106,7 +143,7 @@ void menu_init(menu_item_t **root_items, uint8_t root_count,
  */
 void menu_move_up(void)
 {
-    uint8_t current_index = menu_get_current_index();
+    uint16_t current_index = menu_get_current_index();
 
     if (current_index > 0) {
         menu_set_current_index(current_index - 1);
@@ -116,7 +153,7 @@ void menu_move_up(void)
             menu_state.scroll_offset = current_index - 1;
         }
 
-        menu_refresh();
+        menu_invalidate();
     }
 }
 
@@ -127,10 +164,10 @@ void menu_move_up(void)
  */
 void menu_move_down(void)
 {
-    uint8_t current_index = menu_get_current_index();
-    uint8_t current_count = menu_get_current_count();
+    uint16_t current_index = menu_get_current_index();
+    uint16_t current_count = menu_get_current_count();
 
-    if (current_index < current_count - 1) {
+    if (current_index + 1 < current_count) {
         menu_set_current_index(current_index + 1);
 
         /* 更新滚动偏移 */
@@ -138,7 +175,7 @@ void menu_move_down(void)
             menu_state.scroll_offset = current_index + 2 - MENU_MAX_ITEMS_PER_PAGE;
         }
 
-        menu_refresh();
+        menu_invalidate();
     }
 }
 
@@ -150,9 +187,21 @@ void menu_move_down(void)
 void menu_enter(void)
 {
     menu_item_t **current_items = menu_get_current_items();
-    uint8_t current_index = menu_get_current_index();
+    uint16_t current_index = menu_get_current_index();
+    const menu_list_provider_t *provider = menu_state.provider_stack[menu_state.depth];
+
+    /* 虚拟列表层: 由数据源决定是否进入下一级 */
+    if (provider != NULL) {
+        if (current_index < menu_get_current_count() && provider->select != NULL) {
+            const menu_list_provider_t *child = provider->select(provider->ctx, current_index);
+            if (child != NULL) {
+                menu_push_level(NULL, 0, child);
+            }
+        }
+        return;
+    }
 
-    if (current_items == NULL) {
+    if (current_items == NULL || current_index >= menu_get_current_count()) {
         return;
     }
 
@@ -169,20 +218,20 @@ void menu_enter(void)
 
         case MENU_ITEM_TYPE_SUBMENU:
             /* 进入子菜单 */
-            if (menu_state.depth < MENU_MAX_DEPTH - 1) {
-                menu_state.depth++;
-                menu_state.stack[menu_state.depth] = item->data.submenu.items;
-                menu_state.count_stack[menu_state.depth] = item->data.submenu.count;
-                menu_state.index_stack[menu_state.depth] = 0;
-                menu_state.scroll_offset = 0;
-                menu_refresh();
+            menu_push_level(item->data.submenu.items, item->data.submenu.count, NULL);
+            break;
+
+        case MENU_ITEM_TYPE_LIST:
+            /* 进入虚拟列表 */
+            if (item->data.list.provider != NULL) {
+                menu_push_level(NULL, 0, item->data.list.provider);
             }
             break;
 
         case MENU_ITEM_TYPE_VALUE:
             /* 进入编辑模式 */
             menu_state.edit_mode = 1;
-            menu_refresh();
+            menu_invalidate();
             break;
 
         case MENU_ITEM_TYPE_SWITCH:
@@ -195,7 +244,7 @@ void menu_enter(void)
                     item->data.switch_item.callback(item, *item->data.switch_item.state);
                 }
 
-                menu_refresh();
+                menu_invalidate();
             }
             break;
 
@@ -214,12 +263,23 @@ void menu_back(void)
     if (menu_state.edit_mode) {
         /* 退出编辑模式 */
         menu_state.edit_mode = 0;
-        menu_refresh();
+        menu_invalidate();
     } else if (menu_state.depth > 0) {
-        /* 返回上一级菜单 */
+        const menu_list_provider_t *provider = menu_state.provider_stack[menu_state.depth];
+        uint16_t index;
+
+        if (provider != NULL && provider->leave != NULL) {
+            provider->leave(provider->ctx);
+        }
+
+        /* 返回上一级菜单, 滚动到原选中项所在页 */
+        menu_state.provider_stack[menu_state.depth] = NULL;
         menu_state.depth--;
-        menu_state.scroll_offset = 0;
-        menu_refresh();
+        index = menu_get_current_index();
+        menu_state.scroll_offset = (index < MENU_MAX_ITEMS_PER_PAGE) ?
+                                   0 : index + 1 - MENU_MAX_ITEMS_PER_PAGE;
+        list_page_valid = 0;
+        menu_invalidate();
     }
 }
 
@@ -230,34 +290,7 @@ void menu_back(void)
  */
 void menu_value_increase(void)
 {
-    if (!menu_state.edit_mode) {
-        return;
-    }
-
-    menu_item_t **current_items = menu_get_current_items();
-    uint8_t current_index = menu_get_current_index();
-
-    if (current_items == NULL) {
-        return;
-    }
-
-    menu_item_t *item = current_items[current_index];
-
-    if (item->type == MENU_ITEM_TYPE_VALUE && item->data.value.value != NULL) {
-        int32_t *val = item->data.value.value;
-        int32_t new_val = *val + item->data.value.step;
-
-        if (new_val <= item->data.value.max) {
-            *val = new_val;
-
-            /* 触发回调 */
-            if (item->data.value.callback != NULL) {
-                item->data.value.callback(item, *val);
-            }
-
-            menu_refresh();
-        }
-    }
+    menu_value_adjust(1);
 }
 
 /**
@@ -267,14 +300,25 @@ void menu_value_increase(void)
  */
 void menu_value_decrease(void)
 {
-    if (!menu_state.edit_mode) {
+    menu_value_adjust(-1);
+}
+
+/**
+ * @brief  按步数调整数值
+ * @param  steps: 步数 (正数增加, 负数减小), 每步为菜单项的step
+ * @retval None
+ * @note   结果限制在 [min, max] 内
+ */
+void menu_value_adjust(int32_t steps)
+{
+    if (!menu_state.edit_mode || steps == 0) {
         return;
     }
 
     menu_item_t **current_items = menu_get_current_items();
-    uint8_t current_index = menu_get_current_index();
+    uint16_t current_index = menu_get_current_index();
 
-    if (current_items == NULL) {
+    if (current_items == NULL || current_index >= menu_get_current_count()) {
         return;
     }
 
@@ -282,17 +326,23 @@ void menu_value_decrease(void)
 
     if (item->type == MENU_ITEM_TYPE_VALUE && item->data.value.value != NULL) {
         int32_t *val = item->data.value.value;
-        int32_t new_val = *val - item->data.value.step;
+        int64_t new_val = (int64_t)*val + (int64_t)steps * item->data.value.step;
 
-        if (new_val >= item->data.value.min) {
-            *val = new_val;
+        if (new_val > item->data.value.max) {
+            new_val = item->data.value.max;
+        } else if (new_val < item->data.value.min) {
+            new_val = item->data.value.min;
+        }
+
+        if (new_val != *val) {
+            *val = (int32_t)new_val;
 
             /* 触发回调 */
             if (item->data.value.callback != NULL) {
                 item->data.value.callback(item, *val);
             }
 
-            menu_refresh();
+            menu_invalidate();
         }
     }
 }
@@ -315,9 +365,9 @@ menu_state_t* menu_get_state(void)
 menu_item_t* menu_get_current_item(void)
 {
     menu_item_t **current_items = menu_get_current_items();
-    uint8_t current_index = menu_get_current_index();
+    uint16_t current_index = menu_get_current_index();
 
-    if (current_items == NULL) {
+    if (current_items == NULL || current_index >= menu_get_current_count()) {
         return NULL;
     }
 
@@ -331,11 +381,56 @@ menu_item_t* menu_get_current_item(void)
  */
 void menu_refresh(void)
 {
+    menu_dirty = 0;
+
     if (display_callback != NULL) {
         display_callback(&menu_state);
     }
 }
 
+/**
+ * @brief  标记菜单需要重绘
+ * @param  None
+ * @retval None
+ */
+void menu_invalidate(void)
+{
+    menu_dirty = 1;
+}
+
+/**
+ * @brief  检查菜单是否需要重绘
+ * @param  None
+ * @retval 1-需要, 0-不需要
+ */
+uint8_t menu_is_dirty(void)
+{
+    return menu_dirty;
+}
+
+/**
+ * @brief  按帧预算重绘菜单
+ * @param  now: 当前时间(ms)
+ * @retval 1-本次进行了重绘, 0-无需重绘或未到帧间隔
+ */
+uint8_t menu_render_frame(uint32_t now)
+{
+    if (!menu_dirty) {
+        return 0;
+    }
+
+    /* 距上一帧不足帧间隔时推迟, 期间的事件合并到下一帧 */
+    if (frame_started && (uint32_t)(now - last_frame_time) < MENU_FRAME_PERIOD_MS) {
+        return 0;
+    }
+
+    frame_started = 1;
+    last_frame_time = now;
+    menu_refresh();
+
+    return 1;
+}
+
 /**
  * @brief  获取当前菜单层级
  * @param  None
@@ -345,3 +440,81 @@ uint8_t menu_get_depth(void)
 {
     return menu_state.depth;
 }
+
+/**
+ * @brief  获取虚拟列表可见页中的条目
+ * @param  row: 页内行号
+ * @retval 条目指针, NULL表示不是虚拟列表或超出范围
+ */
+const menu_list_entry_t* menu_list_get_row(uint8_t row)
+{
+    const menu_list_provider_t *provider;
+    uint16_t first = menu_state.scroll_offset;
+    uint16_t count;
+
+    if (menu_state.depth >= MENU_MAX_DEPTH || row >= MENU_MAX_ITEMS_PER_PAGE) {
+        return NULL;
+    }
+
+    provider = menu_state.provider_stack[menu_state.depth];
+    if (provider == NULL) {
+        return NULL;
+    }
+
+    /* 滚动后首次访问时整页重取 */
+    if (!list_page_valid || list_page_first != first) {
+        count = menu_get_current_count();
+        count = (first < count) ? count - first : 0;
+        if (count > MENU_MAX_ITEMS_PER_PAGE) {
+            count = MENU_MAX_ITEMS_PER_PAGE;
+        }
+
+        list_page_count = (count > 0) ?
+                          (uint8_t)provider->fetch(provider->ctx, first, count, list_page) : 0;
+        list_page_first = first;
+        list_page_valid = 1;
+    }
+
+    if (row >= list_page_count) {
+        return NULL;
+    }
+
+    return &list_page[row];
+}
+
+/**
+ * @brief  重新查询当前虚拟列表的条目数
+ * @param  None
+ * @retval None
+ */
+void menu_list_reload(void)
+{
+    const menu_list_provider_t *provider;
+    uint16_t count;
+    uint16_t index;
+
+    if (menu_state.depth >= MENU_MAX_DEPTH) {
+        return;
+    }
+
+    provider = menu_state.provider_stack[menu_state.depth];
+    if (provider == NULL) {
+        return;
+    }
+
+    count = provider->get_count(provider->ctx);
+    index = menu_get_current_index();
+
+    /* 条目减少时把选中项和滚动位置收回到范围内 */
+    if (index >= count) {
+        index = (count > 0) ? count - 1 : 0;
+        menu_set_current_index(index);
+    }
+    if (menu_state.scroll_offset > index) {
+        menu_state.scroll_offset = index;
+    }
+
+    menu_state.count_stack[menu_state.depth] = count;
+    list_page_valid = 0;
+    menu_invalidate();
+}
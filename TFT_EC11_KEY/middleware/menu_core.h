@@ -5,6 +5,17 @@
   * @brief   通用菜单系统核心 - 硬件无关层
   *          支持多级菜单、回调函数、可配置菜单项
   ******************************************************************************
+  * @attention
+  *
+  * 显示刷新采用失效标记方式: 导航/编辑操作只调用 menu_invalidate() 标记需要重绘,
+  * 显示任务周期调用 menu_render_frame(), 每 MENU_FRAME_PERIOD_MS 最多重绘一次。
+  * 一帧内的多次旋转只产生一次重绘, 无变化时不重绘。
+  *
+  * 虚拟列表: MENU_ITEM_TYPE_LIST 类型的菜单项不保存子项数组, 条目由数据源
+  * (menu_list_provider_t) 按需提供, 适合SD卡目录等成千上万条的列表。
+  * 导航只修改索引, 与条目数无关; 只有可见页的条目被取到页缓存中。
+  *
+  ******************************************************************************
   */
 
 #ifndef __MENU_CORE_H
@@ -20,18 +31,49 @@ extern "C" {
 
 /* 菜单配置 ------------------------------------------------------------------*/
 #define MENU_MAX_ITEMS_PER_PAGE   6    /* 每页最多显示菜单项数 */
-#define MENU_MAX_DEPTH            4    /* 最大菜单层级深度 */
+#define MENU_MAX_DEPTH            8    /* 最大菜单层级深度 */
+#define MENU_LIST_NAME_MAX        32   /* 虚拟列表条目名称最大长度(含结束符) */
+#define MENU_FRAME_PERIOD_MS      33   /* 最短重绘间隔(ms), 即帧预算 */
 
 /* 菜单项类型 ----------------------------------------------------------------*/
 typedef enum {
     MENU_ITEM_TYPE_ACTION = 0,  /* 执行动作(调用回调函数) */
     MENU_ITEM_TYPE_SUBMENU,     /* 进入子菜单 */
     MENU_ITEM_TYPE_VALUE,       /* 数值调节项 */
-    MENU_ITEM_TYPE_SWITCH       /* 开关项 */
+    MENU_ITEM_TYPE_SWITCH,      /* 开关项 */
+    MENU_ITEM_TYPE_LIST         /* 虚拟列表(条目由数据源提供) */
 } menu_item_type_t;
 
+/* 虚拟列表条目标志 ----------------------------------------------------------*/
+#define MENU_LIST_FLAG_BRANCH     (1 << 0)  /* 可进入(如目录) */
+
 /* 前向声明 ------------------------------------------------------------------*/
 typedef struct menu_item_s menu_item_t;
+typedef struct menu_list_provider_s menu_list_provider_t;
+
+/* 虚拟列表条目 --------------------------------------------------------------*/
+typedef struct {
+    char     name[MENU_LIST_NAME_MAX];  /* 显示名称 */
+    uint8_t  flags;                     /* MENU_LIST_FLAG_xxx */
+    uint32_t value;                     /* 用户数据(如文件大小) */
+} menu_list_entry_t;
+
+/* 虚拟列表数据源 ------------------------------------------------------------*/
+struct menu_list_provider_s {
+    /* 条目总数, 进入列表和调用 menu_list_reload() 时查询 */
+    uint16_t (*get_count)(void *ctx);
+
+    /* 取 [first, first + count) 范围的条目, 返回实际取到的数量 */
+    uint16_t (*fetch)(void *ctx, uint16_t first, uint16_t count, menu_list_entry_t *out);
+
+    /* 确认条目: 返回要进入的下一级数据源, NULL表示不进入 (可为NULL) */
+    const menu_list_provider_t* (*select)(void *ctx, uint16_t index);
+
+    /* 从该层返回上一级时调用 (可为NULL) */
+    void (*leave)(void *ctx);
+
+    void *ctx;                          /* 数据源上下文 */
+};
 
 /* 菜单项回调函数类型 --------------------------------------------------------*/
 typedef void (*menu_action_callback_t)(menu_item_t *item);
@@ -68,6 +110,11 @@ struct menu_item_s {
             uint8_t *state;        /* 开关状态指针 (0/1) */
             menu_value_changed_callback_t callback;
         } switch_item;
+
+        /* LIST类型 */
+        struct {
+            const menu_list_provider_t *provider;
+        } list;
     } data;
 
     void *user_data;  /* 用户自定义数据 */
@@ -75,11 +122,12 @@ struct menu_item_s {
 
 /* 菜单状态结构体 ------------------------------------------------------------*/
 typedef struct {
-    menu_item_t **stack[MENU_MAX_DEPTH];  /* 菜单栈(保存各层菜单项数组) */
-    uint8_t       count_stack[MENU_MAX_DEPTH]; /* 各层菜单项数量 */
-    uint8_t       index_stack[MENU_MAX_DEPTH]; /* 各层当前选中索引 */
+    menu_item_t **stack[MENU_MAX_DEPTH];  /* 菜单栈(保存各层菜单项数组, 虚拟列表层为NULL) */
+    const menu_list_provider_t *provider_stack[MENU_MAX_DEPTH]; /* 各层数据源(普通层为NULL) */
+    uint16_t      count_stack[MENU_MAX_DEPTH]; /* 各层菜单项数量 */
+    uint16_t      index_stack[MENU_MAX_DEPTH]; /* 各层当前选中索引 */
     uint8_t       depth;                  /* 当前菜单深度 */
-    uint8_t       scroll_offset;          /* 滚动偏移 */
+    uint16_t      scroll_offset;          /* 滚动偏移 */
     uint8_t       edit_mode;              /* 编辑模式标志 (用于数值调节) */
 } menu_state_t;
 
@@ -140,6 +188,14 @@ void menu_value_increase(void);
  */
 void menu_value_decrease(void);
 
+/**
+ * @brief  按步数调整数值 (仅在编辑模式有效)
+ * @param  steps: 步数 (正数增加, 负数减小), 每步为菜单项的step
+ * @retval None
+ * @note   配合编码器加速使用, 结果限制在 [min, max] 内
+ */
+void menu_value_adjust(int32_t steps);
+
 /**
  * @brief  获取当前菜单状态
  * @param  None
@@ -155,12 +211,35 @@ menu_state_t* menu_get_state(void);
 menu_item_t* menu_get_current_item(void);
 
 /**
- * @brief  刷新菜单显示
+ * @brief  立即刷新菜单显示 (同时清除失效标记)
  * @param  None
  * @retval None
+ * @note   一般应使用 menu_invalidate(), 由 menu_render_frame() 统一重绘
  */
 void menu_refresh(void);
 
+/**
+ * @brief  标记菜单需要重绘
+ * @param  None
+ * @retval None
+ * @note   菜单显示的数据在外部被修改时(如远程设置参数)也应调用
+ */
+void menu_invalidate(void);
+
+/**
+ * @brief  检查菜单是否需要重绘
+ * @param  None
+ * @retval 1-需要, 0-不需要
+ */
+uint8_t menu_is_dirty(void);
+
+/**
+ * @brief  按帧预算重绘菜单(需要周期调用)
+ * @param  now: 当前时间(ms)
+ * @retval 1-本次进行了重绘, 0-无需重绘或未到帧间隔
+ */
+uint8_t menu_render_frame(uint32_t now);
+
 /**
  * @brief  获取当前菜单层级
  * @param  None
@@ -168,6 +247,21 @@ void menu_refresh(void);
  */
 uint8_t menu_get_depth(void);
 
+/**
+ * @brief  获取虚拟列表可见页中的条目
+ * @param  row: 页内行号 (0 ~ MENU_MAX_ITEMS_PER_PAGE-1, 对应索引 scroll_offset+row)
+ * @retval 条目指针, 当前层不是虚拟列表或超出范围返回NULL
+ * @note   页缓存在滚动后的首次访问时从数据源整页重取, 同一页内不重复取
+ */
+const menu_list_entry_t* menu_list_get_row(uint8_t row);
+
+/**
+ * @brief  重新查询当前虚拟列表的条目数 (数据源内容变化后调用)
+ * @param  None
+ * @retval None
+ */
+void menu_list_reload(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,80 +8,300 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "menu_dynamic.h"
+#include "name_index.h"
+#include <stddef.h>
 #include <string.h>
-#include <stdlib.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define ARENA_ALIGN         sizeof(void*)   /* 存储区分配对齐 */
+#define ITEM_INDEX_SLOTS    64              /* 名称索引槽位数: 不小于2倍池大小的2的幂 */
+
+#if ITEM_INDEX_SLOTS < NAME_INDEX_SLOTS_FOR(MENU_DYNAMIC_POOL_SIZE)
+#error "ITEM_INDEX_SLOTS too small for MENU_DYNAMIC_POOL_SIZE"
+#endif
+
+/* Private types -------------------------------------------------------------*/
+
+/* 池节点: 空闲时挂在空闲链表, 使用中按分配顺序挂在使用链表 */
+typedef struct pool_node_s {
+    menu_item_ex_t      item;
+    struct pool_node_s *prev;
+    struct pool_node_s *next;
+    uint32_t            seq;      /* 分配序号, 0表示空闲 */
+    uint32_t            id;       /* 名称ID */
+} pool_node_t;
+
+/* 驻留名称记录 (位于存储区) */
+typedef struct {
+    uint16_t next;                /* 同桶下一条的偏移+1, 0表示结束 */
+    char     name[1];             /* 名称 (按实际长度分配) */
+} name_rec_t;
 
 /* Private variables ---------------------------------------------------------*/
-static menu_item_ex_t item_pool[MENU_DYNAMIC_POOL_SIZE];
-static uint8_t pool_used[MENU_DYNAMIC_POOL_SIZE] = {0};
+static pool_node_t item_pool[MENU_DYNAMIC_POOL_SIZE];
+static pool_node_t *free_list = NULL;     /* 空闲链表 (单向) */
+static pool_node_t *used_head = NULL;     /* 使用链表 (双向, 按分配顺序) */
+static pool_node_t *used_tail = NULL;
+static uint8_t free_count = 0;
+static uint32_t alloc_seq = 0;
+
+/* 存储区 (按指针对齐) */
+static union {
+    void    *align;
+    uint8_t  bytes[MENU_DYNAMIC_ARENA_SIZE];
+} arena;
+static uint16_t arena_top = 0;
+
+/* 名称驻留哈希桶: 记录偏移+1, 新记录插在链头 */
+static uint16_t name_buckets[MENU_DYNAMIC_NAME_BUCKETS];
+
+/* 菜单项名称索引 (同名项只索引最先创建的一个) */
+static name_index_t item_index;
+static name_index_slot_t item_slots[ITEM_INDEX_SLOTS];
 
 /* Private functions ---------------------------------------------------------*/
 
+/**
+ * @brief  从存储区分配
+ * @param  size: 字节数
+ * @retval 内存指针, NULL表示存储区已满
+ */
+static void* arena_alloc(uint16_t size)
+{
+    uint32_t aligned = ((uint32_t)size + ARENA_ALIGN - 1) & ~(uint32_t)(ARENA_ALIGN - 1);
+    void *p;
+
+    if (arena_top + aligned > MENU_DYNAMIC_ARENA_SIZE) {
+        return NULL;
+    }
+
+    p = &arena.bytes[arena_top];
+    arena_top += (uint16_t)aligned;
+
+    return p;
+}
+
+/**
+ * @brief  判断指针是否位于存储区已分配部分
+ * @param  p: 指针
+ * @retval 1-是, 0-否
+ */
+static uint8_t arena_contains(const void *p)
+{
+    const uint8_t *b = (const uint8_t*)p;
+
+    return (b >= arena.bytes && b < &arena.bytes[arena_top]) ? 1 : 0;
+}
+
+/**
+ * @brief  查找已驻留的名称
+ * @param  name: 名称
+ * @param  id: 名称ID
+ * @retval 驻留的名称, NULL表示未驻留
+ */
+static char* intern_find(const char *name, uint32_t id)
+{
+    uint16_t off = name_buckets[id & (MENU_DYNAMIC_NAME_BUCKETS - 1)];
+    name_rec_t *rec;
+
+    while (off != 0) {
+        rec = (name_rec_t*)&arena.bytes[off - 1];
+        if (strcmp(rec->name, name) == 0) {
+            return rec->name;
+        }
+        off = rec->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief  驻留名称: 已存在则复用, 否则复制到存储区
+ * @param  name: 名称
+ * @param  id: 名称ID
+ * @retval 驻留后的名称, NULL表示存储区已满
+ */
+static char* intern_name(const char *name, uint32_t id)
+{
+    uint16_t *head = &name_buckets[id & (MENU_DYNAMIC_NAME_BUCKETS - 1)];
+    size_t len = strlen(name);
+    name_rec_t *rec;
+    char *found = intern_find(name, id);
+
+    if (found != NULL) {
+        return found;
+    }
+
+    if (len > MENU_DYNAMIC_ARENA_SIZE) {
+        return NULL;
+    }
+
+    rec = (name_rec_t*)arena_alloc((uint16_t)(offsetof(name_rec_t, name) + len + 1));
+    if (rec == NULL) {
+        return NULL;
+    }
+
+    memcpy(rec->name, name, len + 1);
+    rec->next = *head;
+    *head = (uint16_t)((uint8_t*)rec - arena.bytes + 1);
+
+    return rec->name;
+}
+
+/**
+ * @brief  获取子项数组容量
+ * @param  items: 子项数组
+ * @param  count: 当前数量
+ * @retval 容量 (不在存储区的数组不能原地扩展, 容量视为当前数量)
+ */
+static uint8_t array_capacity(menu_item_t **items, uint8_t count)
+{
+    if (items == NULL || !arena_contains(items)) {
+        return count;
+    }
+
+    /* 数组前一个槽位保存容量 */
+    return (uint8_t)(uintptr_t)items[-1];
+}
+
+/**
+ * @brief  为父菜单分配新的子项数组并复制原有子项
+ * @param  parent: 父菜单项
+ * @param  capacity: 新容量
+ * @retval 0-成功, -1-存储区已满
+ */
+static int array_grow(menu_item_t *parent, uint8_t capacity)
+{
+    menu_item_t **slots;
+    uint8_t count = parent->data.submenu.count;
+
+    slots = (menu_item_t**)arena_alloc((uint16_t)((capacity + 1) * sizeof(menu_item_t*)));
+    if (slots == NULL) {
+        return -1;
+    }
+
+    slots[0] = (menu_item_t*)(uintptr_t)capacity;
+    if (count > 0) {
+        memcpy(&slots[1], parent->data.submenu.items, count * sizeof(menu_item_t*));
+    }
+
+    /* 旧数组留在存储区, 随作用域一起释放 */
+    parent->data.submenu.items = &slots[1];
+
+    return 0;
+}
+
 /**
  * @brief  从池中分配菜单项
  * @param  None
- * @retval 菜单项指针, NULL表示池已满
+ * @retval 池节点指针, NULL表示池已满
  */
-static menu_item_ex_t* alloc_item_from_pool(void)
+static pool_node_t* alloc_item_from_pool(void)
 {
-    uint8_t i;
+    pool_node_t *node = free_list;
 
-    for (i = 0; i < MENU_DYNAMIC_POOL_SIZE; i++) {
-        if (!pool_used[i]) {
-            pool_used[i] = 1;
-            memset(&item_pool[i], 0, sizeof(menu_item_ex_t));
-            item_pool[i].flags = MENU_ITEM_FLAG_VISIBLE | MENU_ITEM_FLAG_ENABLED | MENU_ITEM_FLAG_DYNAMIC;
-            return &item_pool[i];
-        }
+    if (node == NULL) {
+        return NULL;  /* 池已满 */
+    }
+
+    free_list = node->next;
+    free_count--;
+
+    memset(&node->item, 0, sizeof(menu_item_ex_t));
+    node->item.flags = MENU_ITEM_FLAG_VISIBLE | MENU_ITEM_FLAG_ENABLED | MENU_ITEM_FLAG_DYNAMIC;
+    node->seq = ++alloc_seq;
+
+    /* 挂到使用链表尾部 */
+    node->prev = used_tail;
+    node->next = NULL;
+    if (used_tail != NULL) {
+        used_tail->next = node;
+    } else {
+        used_head = node;
     }
+    used_tail = node;
 
-    return NULL;  /* 池已满 */
+    return node;
 }
 
 /**
  * @brief  释放菜单项到池
- * @param  item: 菜单项指针
+ * @param  node: 池节点指针
  * @retval None
  */
-static void free_item_to_pool(menu_item_ex_t *item)
+static void free_item_to_pool(pool_node_t *node)
 {
-    uint32_t index = item - item_pool;
+    /* 从使用链表摘下 */
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        used_head = node->next;
+    }
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    } else {
+        used_tail = node->prev;
+    }
 
-    if (index < MENU_DYNAMIC_POOL_SIZE) {
-        /* 释放动态分配的名称 */
-        if (item->base.name != NULL) {
-            free(item->base.name);
-        }
+    name_index_remove(&item_index, node->id, (uint16_t)(node - item_pool));
 
-        pool_used[index] = 0;
-    }
+    /* 名称和子项数组留在存储区, 由作用域释放 */
+    node->seq = 0;
+    node->prev = NULL;
+    node->next = free_list;
+    free_list = node;
+    free_count++;
 }
 
 /**
- * @brief  获取扩展菜单项
+ * @brief  获取池节点
  * @param  item: 基础菜单项指针
- * @retval 扩展菜单项指针, NULL表示不是动态菜单项
+ * @retval 池节点指针, NULL表示不是动态菜单项
  */
-static menu_item_ex_t* get_ex_item(menu_item_t *item)
+static pool_node_t* get_node(menu_item_t *item)
 {
+    uintptr_t addr = (uintptr_t)item;
+    uintptr_t base = (uintptr_t)&item_pool[0].item.base;
     uint32_t index;
-    menu_item_ex_t *ex_item;
 
-    if (item == NULL) {
+    if (item == NULL || addr < base) {
         return NULL;
     }
 
     /* 检查是否在池中 */
-    ex_item = (menu_item_ex_t*)((char*)item - offsetof(menu_item_ex_t, base));
-    index = ex_item - item_pool;
-
-    if (index < MENU_DYNAMIC_POOL_SIZE && pool_used[index]) {
-        return ex_item;
+    index = (uint32_t)((addr - base) / sizeof(pool_node_t));
+    if (index < MENU_DYNAMIC_POOL_SIZE && &item_pool[index].item.base == item &&
+        item_pool[index].seq != 0) {
+        return &item_pool[index];
     }
 
     return NULL;
 }
 
+/**
+ * @brief  获取扩展菜单项
+ * @param  item: 基础菜单项指针
+ * @retval 扩展菜单项指针, NULL表示不是动态菜单项
+ */
+static menu_item_ex_t* get_ex_item(menu_item_t *item)
+{
+    pool_node_t *node = get_node(item);
+
+    return (node != NULL) ? &node->item : NULL;
+}
+
+/**
+ * @brief  名称索引回调: 取菜单项名称
+ * @param  ctx: 未使用
+ * @param  index: 池节点序号
+ * @retval 名称
+ */
+static const char* item_index_name(void *ctx, uint16_t index)
+{
+    (void)ctx;
+    return item_pool[index].item.base.name;
+}
+
 /* Public functions ----------------------------------------------------------*/
 
 /**
@@ -89,8 +309,22 @@ static menu_item_ex_t* get_ex_item(menu_item_t *item)
  */
 void menu_dynamic_init(void)
 {
+    uint8_t i;
+
     memset(item_pool, 0, sizeof(item_pool));
-    memset(pool_used, 0, sizeof(pool_used));
+    memset(name_buckets, 0, sizeof(name_buckets));
+    name_index_init(&item_index, item_slots, ITEM_INDEX_SLOTS, item_index_name, NULL);
+
+    /* 所有节点串成空闲链表 */
+    for (i = 0; i < MENU_DYNAMIC_POOL_SIZE; i++) {
+        item_pool[i].next = (i + 1 < MENU_DYNAMIC_POOL_SIZE) ? &item_pool[i + 1] : NULL;
+    }
+
+    free_list = &item_pool[0];
+    used_head = NULL;
+    used_tail = NULL;
+    free_count = MENU_DYNAMIC_POOL_SIZE;
+    arena_top = 0;
 }
 
 /**
@@ -98,28 +332,38 @@ void menu_dynamic_init(void)
  */
 menu_item_t* menu_dynamic_create_item(const char *name, menu_item_type_t type)
 {
-    menu_item_ex_t *ex_item;
-    char *name_copy;
+    pool_node_t *node;
+    char *name_ref;
+    uint32_t id;
+
+    if (name == NULL) {
+        return NULL;
+    }
+
+    id = name_index_hash(name);
 
     /* 从池中分配 */
-    ex_item = alloc_item_from_pool();
-    if (ex_item == NULL) {
+    node = alloc_item_from_pool();
+    if (node == NULL) {
         return NULL;
     }
 
-    /* 复制名称 */
-    name_copy = (char*)malloc(strlen(name) + 1);
-    if (name_copy == NULL) {
-        free_item_to_pool(ex_item);
+    /* 驻留名称 */
+    node->id = id;
+    name_ref = intern_name(name, id);
+    if (name_ref == NULL) {
+        free_item_to_pool(node);
         return NULL;
     }
-    strcpy(name_copy, name);
 
     /* 初始化基础菜单项 */
-    ex_item->base.name = name_copy;
-    ex_item->base.type = type;
+    node->item.base.name = name_ref;
+    node->item.base.type = type;
+
+    /* 加入名称索引 (同名项已存在时不索引) */
+    name_index_add(&item_index, name_ref, (uint16_t)(node - item_pool));
 
-    return &ex_item->base;
+    return &node->item.base;
 }
 
 /**
@@ -127,19 +371,19 @@ menu_item_t* menu_dynamic_create_item(const char *name, menu_item_type_t type)
  */
 int menu_dynamic_delete_item(menu_item_t *item)
 {
-    menu_item_ex_t *ex_item;
+    pool_node_t *node;
 
-    ex_item = get_ex_item(item);
-    if (ex_item == NULL) {
+    node = get_node(item);
+    if (node == NULL) {
         return -1;  /* 不是动态菜单项 */
     }
 
-    if (!(ex_item->flags & MENU_ITEM_FLAG_DYNAMIC)) {
+    if (!(node->item.flags & MENU_ITEM_FLAG_DYNAMIC)) {
         return -1;  /* 不可删除 */
     }
 
     /* 释放到池 */
-    free_item_to_pool(ex_item);
+    free_item_to_pool(node);
 
     return 0;
 }
@@ -149,8 +393,8 @@ int menu_dynamic_delete_item(menu_item_t *item)
  */
 int menu_dynamic_add_item(menu_item_t *parent, menu_item_t *item, int index)
 {
-    menu_item_t **new_items;
-    uint8_t old_count, new_count;
+    menu_item_t **items;
+    uint8_t count;
     uint8_t i;
 
     if (parent == NULL || item == NULL) {
@@ -161,41 +405,37 @@ int menu_dynamic_add_item(menu_item_t *parent, menu_item_t *item, int index)
         return -1;  /* 父菜单必须是SUBMENU类型 */
     }
 
-    old_count = parent->data.submenu.count;
-    new_count = old_count + 1;
-
-    /* 重新分配菜单项数组 */
-    new_items = (menu_item_t**)malloc(new_count * sizeof(menu_item_t*));
-    if (new_items == NULL) {
+    count = parent->data.submenu.count;
+    if (count == 0xFF) {
         return -1;
     }
 
-    /* 复制现有项 */
-    if (index < 0 || index >= old_count) {
-        /* 添加到末尾 */
-        if (old_count > 0) {
-            memcpy(new_items, parent->data.submenu.items, old_count * sizeof(menu_item_t*));
-        }
-        new_items[old_count] = item;
-    } else {
-        /* 插入到指定位置 */
-        for (i = 0; i < index; i++) {
-            new_items[i] = parent->data.submenu.items[i];
+    /* 容量不足时按倍数扩展 */
+    if (count >= array_capacity(parent->data.submenu.items, count)) {
+        uint16_t capacity = (count < MENU_DYNAMIC_SUBMENU_CAP / 2) ?
+                            MENU_DYNAMIC_SUBMENU_CAP : (uint16_t)count * 2;
+        if (capacity > 0xFF) {
+            capacity = 0xFF;
         }
-        new_items[index] = item;
-        for (i = index; i < old_count; i++) {
-            new_items[i + 1] = parent->data.submenu.items[i];
+        if (array_grow(parent, (uint8_t)capacity) != 0) {
+            return -1;
         }
     }
 
-    /* 释放旧数组 */
-    if (parent->data.submenu.items != NULL) {
-        free(parent->data.submenu.items);
+    items = parent->data.submenu.items;
+
+    if (index < 0 || index >= count) {
+        /* 添加到末尾 */
+        items[count] = item;
+    } else {
+        /* 插入到指定位置 */
+        for (i = count; i > index; i--) {
+            items[i] = items[i - 1];
+        }
+        items[index] = item;
     }
 
-    /* 更新父菜单 */
-    parent->data.submenu.items = new_items;
-    parent->data.submenu.count = new_count;
+    parent->data.submenu.count = count + 1;
 
     return 0;
 }
@@ -205,10 +445,9 @@ int menu_dynamic_add_item(menu_item_t *parent, menu_item_t *item, int index)
  */
 int menu_dynamic_remove_item(menu_item_t *parent, menu_item_t *item)
 {
-    menu_item_t **new_items;
-    uint8_t old_count, new_count;
-    uint8_t i, j;
-    int found_index = -1;
+    menu_item_t **items;
+    uint8_t count;
+    uint8_t i;
 
     if (parent == NULL || item == NULL) {
         return -1;
@@ -218,49 +457,26 @@ int menu_dynamic_remove_item(menu_item_t *parent, menu_item_t *item)
         return -1;
     }
 
-    old_count = parent->data.submenu.count;
+    items = parent->data.submenu.items;
+    count = parent->data.submenu.count;
 
     /* 查找项 */
-    for (i = 0; i < old_count; i++) {
-        if (parent->data.submenu.items[i] == item) {
-            found_index = i;
+    for (i = 0; i < count; i++) {
+        if (items[i] == item) {
             break;
         }
     }
 
-    if (found_index < 0) {
+    if (i >= count) {
         return -1;  /* 未找到 */
     }
 
-    new_count = old_count - 1;
-
-    if (new_count == 0) {
-        /* 移除所有项 */
-        free(parent->data.submenu.items);
-        parent->data.submenu.items = NULL;
-        parent->data.submenu.count = 0;
-        return 0;
-    }
-
-    /* 分配新数组 */
-    new_items = (menu_item_t**)malloc(new_count * sizeof(menu_item_t*));
-    if (new_items == NULL) {
-        return -1;
-    }
-
-    /* 复制项(跳过要删除的) */
-    for (i = 0, j = 0; i < old_count; i++) {
-        if (i != found_index) {
-            new_items[j++] = parent->data.submenu.items[i];
-        }
+    /* 原地前移 (不在存储区的数组也可以原地修改) */
+    for (; i + 1 < count; i++) {
+        items[i] = items[i + 1];
     }
 
-    /* 释放旧数组 */
-    free(parent->data.submenu.items);
-
-    /* 更新父菜单 */
-    parent->data.submenu.items = new_items;
-    parent->data.submenu.count = new_count;
+    parent->data.submenu.count = count - 1;
 
     return 0;
 }
@@ -330,6 +546,8 @@ uint8_t menu_dynamic_is_enabled(menu_item_t *item)
  */
 menu_item_t* menu_dynamic_find_item(menu_item_t *parent, const char *name)
 {
+    menu_item_t *item;
+    const char *interned;
     uint8_t i;
 
     if (parent == NULL || name == NULL) {
@@ -340,15 +558,60 @@ menu_item_t* menu_dynamic_find_item(menu_item_t *parent, const char *name)
         return NULL;
     }
 
+    /* 动态菜单项的名称已驻留, 只需比较指针; 静态菜单项才比较字符串 */
+    interned = intern_find(name, name_index_hash(name));
+
     for (i = 0; i < parent->data.submenu.count; i++) {
-        if (strcmp(parent->data.submenu.items[i]->name, name) == 0) {
-            return parent->data.submenu.items[i];
+        item = parent->data.submenu.items[i];
+        if ((interned != NULL && item->name == interned) ||
+            (!arena_contains(item->name) && strcmp(item->name, name) == 0)) {
+            return item;
         }
     }
 
     return NULL;
 }
 
+/**
+ * @brief  按名称查找动态菜单项
+ */
+menu_item_t* menu_dynamic_lookup(const char *name)
+{
+    int index;
+
+    if (name == NULL) {
+        return NULL;
+    }
+
+    index = name_index_find(&item_index, name);
+
+    return (index < 0) ? NULL : &item_pool[index].item.base;
+}
+
+/**
+ * @brief  按稳定ID查找动态菜单项
+ */
+menu_item_t* menu_dynamic_lookup_id(uint32_t id)
+{
+    int index = name_index_find_id(&item_index, id);
+
+    return (index < 0) ? NULL : &item_pool[index].item.base;
+}
+
+/**
+ * @brief  获取菜单项的稳定ID
+ */
+uint32_t menu_dynamic_item_id(menu_item_t *item)
+{
+    pool_node_t *node = get_node(item);
+
+    if (node != NULL) {
+        return node->id;
+    }
+
+    return (item != NULL && item->name != NULL) ? name_index_hash(item->name) : 0;
+}
+
 /**
  * @brief  获取菜单项数量
  */
@@ -378,12 +641,77 @@ uint8_t menu_dynamic_get_item_count(menu_item_t *parent)
  * @brief  清空动态菜单池
  */
 void menu_dynamic_clear_pool(void)
+{
+    menu_dynamic_init();
+}
+
+/**
+ * @brief  开始一个作用域
+ */
+menu_dynamic_mark_t menu_dynamic_mark(void)
+{
+    menu_dynamic_mark_t mark;
+
+    mark.arena_top = arena_top;
+    mark.seq = alloc_seq;
+
+    return mark;
+}
+
+/**
+ * @brief  释放作用域
+ */
+void menu_dynamic_release(menu_dynamic_mark_t mark)
 {
     uint8_t i;
 
-    for (i = 0; i < MENU_DYNAMIC_POOL_SIZE; i++) {
-        if (pool_used[i]) {
-            free_item_to_pool(&item_pool[i]);
+    if (mark.arena_top > arena_top) {
+        return;  /* 标记已失效 (作用域未按顺序释放) */
+    }
+
+    /* 作用域内分配的菜单项都在使用链表尾部 */
+    while (used_tail != NULL && used_tail->seq > mark.seq) {
+        free_item_to_pool(used_tail);
+    }
+
+    /* 作用域内驻留的名称都在各桶链头 */
+    for (i = 0; i < MENU_DYNAMIC_NAME_BUCKETS; i++) {
+        while (name_buckets[i] != 0 && name_buckets[i] - 1 >= mark.arena_top) {
+            name_buckets[i] = ((name_rec_t*)&arena.bytes[name_buckets[i] - 1])->next;
         }
     }
+
+    arena_top = mark.arena_top;
+}
+
+/**
+ * @brief  为父菜单预留子项数组容量
+ */
+int menu_dynamic_reserve(menu_item_t *parent, uint8_t capacity)
+{
+    if (parent == NULL || parent->type != MENU_ITEM_TYPE_SUBMENU) {
+        return -1;
+    }
+
+    if (capacity <= array_capacity(parent->data.submenu.items, parent->data.submenu.count)) {
+        return 0;
+    }
+
+    return array_grow(parent, capacity);
+}
+
+/**
+ * @brief  获取存储区已用字节数
+ */
+uint16_t menu_dynamic_arena_used(void)
+{
+    return arena_top;
+}
+
+/**
+ * @brief  获取池中空闲菜单项数
+ */
+uint8_t menu_dynamic_pool_free(void)
+{
+    return free_count;
 }
@@ -11,7 +11,17 @@
   * - 运行时动态删除菜单项
   * - 菜单项显示/隐藏控制
   * - 菜单项启用/禁用控制
-  * - 自动内存管理
+  * - 自动内存管理 (不使用malloc)
+  *
+  * 内存管理:
+  * - 菜单项来自固定池, 空闲项用链表管理, 分配/释放均为O(1)
+  * - 名称和子项数组从静态存储区(arena)顺序分配; 名称驻留, 相同名称只存一份
+  * - menu_dynamic_mark()/menu_dynamic_release() 划定作用域, 释放作用域内创建的
+  *   全部菜单项、名称和子项数组, 适合整棵子菜单的创建和销毁
+  * - 作用域规则: 作用域内挂到外部父菜单的子树, 释放前需先 menu_dynamic_remove_item();
+  *   外部父菜单的子项数组应在作用域外用 menu_dynamic_reserve() 预留容量
+  * - 名称为共享只读存储, 不要修改菜单项的 name 内容
+  * - 动态菜单项按名称建立哈希索引 (name_index), 可按名称或稳定ID直接查找
   *
   ******************************************************************************
   */
@@ -28,6 +38,9 @@ extern "C" {
 
 /* 配置选项 ------------------------------------------------------------------*/
 #define MENU_DYNAMIC_POOL_SIZE    32   /* 动态菜单项池大小 */
+#define MENU_DYNAMIC_ARENA_SIZE   2048 /* 名称和子项数组存储区大小(字节, 不超过65535) */
+#define MENU_DYNAMIC_NAME_BUCKETS 32   /* 名称驻留哈希桶数 (2的幂) */
+#define MENU_DYNAMIC_SUBMENU_CAP  8    /* 子项数组首次分配的容量 */
 
 /* 菜单项属性标志 ------------------------------------------------------------*/
 #define MENU_ITEM_FLAG_VISIBLE    (1 << 0)  /* 可见 */
@@ -41,6 +54,12 @@ typedef struct {
     void        *user_data;   /* 用户自定义数据 */
 } menu_item_ex_t;
 
+/* 作用域标记 --------------------------------------------------------------*/
+typedef struct {
+    uint16_t arena_top;       /* 存储区位置 */
+    uint32_t seq;             /* 菜单项分配序号 */
+} menu_dynamic_mark_t;
+
 /* API函数声明 ---------------------------------------------------------------*/
 
 /**
@@ -120,6 +139,28 @@ uint8_t menu_dynamic_is_enabled(menu_item_t *item);
  */
 menu_item_t* menu_dynamic_find_item(menu_item_t *parent, const char *name);
 
+/**
+ * @brief  按名称查找动态菜单项 (不限父菜单, 哈希索引O(1))
+ * @param  name: 菜单项名称
+ * @retval 菜单项指针, NULL表示未找到
+ * @note   同名菜单项只索引最先创建的一个
+ */
+menu_item_t* menu_dynamic_lookup(const char *name);
+
+/**
+ * @brief  按稳定ID查找动态菜单项
+ * @param  id: 名称ID (见 menu_dynamic_item_id)
+ * @retval 菜单项指针, NULL表示未找到
+ */
+menu_item_t* menu_dynamic_lookup_id(uint32_t id);
+
+/**
+ * @brief  获取菜单项的稳定ID
+ * @param  item: 菜单项指针
+ * @retval 名称的FNV-1a哈希, 只取决于名称, 可用于远程协议
+ */
+uint32_t menu_dynamic_item_id(menu_item_t *item);
+
 /**
  * @brief  获取菜单项数量(仅统计可见项)
  * @param  parent: 父菜单项
@@ -128,12 +169,49 @@ menu_item_t* menu_dynamic_find_item(menu_item_t *parent, const char *name);
 uint8_t menu_dynamic_get_item_count(menu_item_t *parent);
 
 /**
- * @brief  清空动态菜单池
+ * @brief  清空动态菜单池 (同时清空存储区)
  * @param  None
  * @retval None
  */
 void menu_dynamic_clear_pool(void);
 
+/**
+ * @brief  记录当前分配位置, 开始一个作用域
+ * @param  None
+ * @retval 作用域标记
+ */
+menu_dynamic_mark_t menu_dynamic_mark(void);
+
+/**
+ * @brief  释放作用域内创建的全部菜单项、名称和子项数组
+ * @param  mark: menu_dynamic_mark() 的返回值
+ * @retval None
+ * @note   作用域需按后进先出嵌套使用
+ */
+void menu_dynamic_release(menu_dynamic_mark_t mark);
+
+/**
+ * @brief  为父菜单预留子项数组容量
+ * @param  parent: 父菜单项(SUBMENU类型)
+ * @param  capacity: 需要的容量
+ * @retval 0-成功, -1-失败
+ */
+int menu_dynamic_reserve(menu_item_t *parent, uint8_t capacity);
+
+/**
+ * @brief  获取存储区已用字节数
+ * @param  None
+ * @retval 已用字节数
+ */
+uint16_t menu_dynamic_arena_used(void);
+
+/**
+ * @brief  获取池中空闲菜单项数
+ * @param  None
+ * @retval 空闲数量
+ */
+uint8_t menu_dynamic_pool_free(void);
+
 /* 便捷宏定义 ----------------------------------------------------------------*/
 
 /* 快速创建ACTION类型菜单项 */
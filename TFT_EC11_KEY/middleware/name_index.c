@@ -0,0 +1,190 @@
+/**
+ * @file name_index.c
+ * @brief 名称索引实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "name_index.h"
+#include <stddef.h>
+#include <string.h>
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static int probe(const name_index_t *idx, uint32_t id);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 计算名称的稳定ID
+ */
+uint32_t name_index_hash(const char *name)
+{
+    uint32_t hash = 2166136261UL;
+
+    while (*name != '\0') {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief 初始化索引
+ */
+int name_index_init(name_index_t *idx, name_index_slot_t *slots, uint16_t slot_count,
+                    name_index_get_t get_name, void *ctx)
+{
+    if (idx == NULL || slots == NULL || get_name == NULL ||
+        slot_count == 0 || (slot_count & (slot_count - 1)) != 0) {
+        return -1;
+    }
+
+    idx->slots = slots;
+    idx->mask = slot_count - 1;
+    idx->get_name = get_name;
+    idx->ctx = ctx;
+    name_index_clear(idx);
+
+    return 0;
+}
+
+/**
+ * @brief 清空索引
+ */
+void name_index_clear(name_index_t *idx)
+{
+    uint32_t i;
+
+    for (i = 0; i <= idx->mask; i++) {
+        idx->slots[i].index = NAME_INDEX_EMPTY;
+    }
+    idx->count = 0;
+}
+
+/**
+ * @brief 注册条目
+ */
+int name_index_add(name_index_t *idx, const char *name, uint16_t index)
+{
+    uint32_t id = name_index_hash(name);
+    uint16_t pos;
+
+    /* 至少保留一个空槽, 保证查找能结束 */
+    if (index == NAME_INDEX_EMPTY || idx->count >= idx->mask) {
+        return -1;
+    }
+
+    /* 同ID已存在: 重名或哈希冲突, 都不允许 */
+    if (probe(idx, id) >= 0) {
+        return -1;
+    }
+
+    pos = (uint16_t)(id & idx->mask);
+    while (idx->slots[pos].index != NAME_INDEX_EMPTY) {
+        pos = (pos + 1) & idx->mask;
+    }
+
+    idx->slots[pos].id = id;
+    idx->slots[pos].index = index;
+    idx->count++;
+
+    return 0;
+}
+
+/**
+ * @brief 注销条目
+ */
+int name_index_remove(name_index_t *idx, uint32_t id, uint16_t index)
+{
+    int found = probe(idx, id);
+    uint16_t hole;
+    uint16_t pos;
+
+    if (found < 0 || idx->slots[found].index != index) {
+        return -1;
+    }
+
+    /* 后移删除: 把后续探测链上的条目前移填洞, 不使用墓碑 */
+    hole = (uint16_t)found;
+    pos = hole;
+    for (;;) {
+        uint16_t home;
+
+        pos = (pos + 1) & idx->mask;
+        if (idx->slots[pos].index == NAME_INDEX_EMPTY) {
+            break;
+        }
+
+        /* 该条目的起始位置不在 (hole, pos] 之间时可以移到洞里 */
+        home = (uint16_t)(idx->slots[pos].id & idx->mask);
+        if (((pos - home) & idx->mask) >= ((pos - hole) & idx->mask)) {
+            idx->slots[hole] = idx->slots[pos];
+            hole = pos;
+        }
+    }
+
+    idx->slots[hole].index = NAME_INDEX_EMPTY;
+    idx->count--;
+
+    return 0;
+}
+
+/**
+ * @brief 按名称查找
+ */
+int name_index_find(const name_index_t *idx, const char *name)
+{
+    int pos = probe(idx, name_index_hash(name));
+
+    if (pos < 0) {
+        return -1;
+    }
+
+    /* ID唯一, 但未注册的名称也可能碰上同一ID, 需比较一次名称 */
+    if (strcmp(idx->get_name(idx->ctx, idx->slots[pos].index), name) != 0) {
+        return -1;
+    }
+
+    return idx->slots[pos].index;
+}
+
+/**
+ * @brief 按ID查找
+ */
+int name_index_find_id(const name_index_t *idx, uint32_t id)
+{
+    int pos = probe(idx, id);
+
+    return (pos < 0) ? -1 : idx->slots[pos].index;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 线性探测查找ID所在槽位
+ * @param idx 索引
+ * @param id 名称ID
+ * @retval 槽位号, -1表示不存在
+ */
+static int probe(const name_index_t *idx, uint32_t id)
+{
+    uint16_t pos = (uint16_t)(id & idx->mask);
+
+    while (idx->slots[pos].index != NAME_INDEX_EMPTY) {
+        if (idx->slots[pos].id == id) {
+            return pos;
+        }
+        pos = (pos + 1) & idx->mask;
+    }
+
+    return -1;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file name_index.h
+ * @brief 名称索引 - 字符串名称到条目序号的哈希表
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 开放定址哈希表, 初始化时建立, 查找平均O(1), 不再逐个strcmp
+ *       - 名称的FNV-1a哈希作为稳定数字ID: 只取决于名称本身, 与注册顺序、固件版本无关,
+ *         可直接用于远程协议或持久化键
+ *       - 注册时检查ID冲突 (不同名称哈希相同), 冲突时注册失败, 保证ID唯一
+ *       - 不保存名称, 比较时通过回调向使用者取名称; 槽位数组由使用者提供 (静态分配)
+ */
+
+#ifndef __NAME_INDEX_H
+#define __NAME_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/**
+ * @brief 空槽位标记
+ */
+#define NAME_INDEX_EMPTY            0xFFFF
+
+/**
+ * @brief 按条目数计算槽位数 (负载不超过1/2), 结果需再取不小于它的2的幂
+ */
+#define NAME_INDEX_SLOTS_FOR(n)     ((n) * 2)
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 取条目名称
+ * @param ctx 用户上下文
+ * @param index 条目序号
+ * @retval 名称
+ */
+typedef const char* (*name_index_get_t)(void *ctx, uint16_t index);
+
+/**
+ * @brief 槽位
+ */
+typedef struct {
+    uint32_t id;                /**< 名称哈希 (稳定ID) */
+    uint16_t index;             /**< 条目序号, NAME_INDEX_EMPTY表示空 */
+} name_index_slot_t;
+
+/**
+ * @brief 索引
+ */
+typedef struct {
+    name_index_slot_t *slots;   /**< 槽位数组 */
+    uint16_t mask;              /**< 槽位数-1 */
+    uint16_t count;             /**< 已注册条目数 */
+    name_index_get_t get_name;  /**< 取名称回调 */
+    void *ctx;                  /**< 回调上下文 */
+} name_index_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 计算名称的稳定ID (FNV-1a 32位)
+ * @param name 名称
+ * @retval ID
+ */
+uint32_t name_index_hash(const char *name);
+
+/**
+ * @brief 初始化索引
+ * @param idx 索引
+ * @param slots 槽位数组
+ * @param slot_count 槽位数 (2的幂)
+ * @param get_name 取名称回调
+ * @param ctx 回调上下文
+ * @retval 0:成功 -1:参数错误
+ */
+int name_index_init(name_index_t *idx, name_index_slot_t *slots, uint16_t slot_count,
+                    name_index_get_t get_name, void *ctx);
+
+/**
+ * @brief 清空索引
+ * @param idx 索引
+ */
+void name_index_clear(name_index_t *idx);
+
+/**
+ * @brief 注册条目
+ * @param idx 索引
+ * @param name 名称
+ * @param index 条目序号
+ * @retval 0:成功 -1:表满、重名或ID冲突
+ */
+int name_index_add(name_index_t *idx, const char *name, uint16_t index);
+
+/**
+ * @brief 注销条目
+ * @param idx 索引
+ * @param id 名称ID
+ * @param index 条目序号 (ID相同但序号不同时不删除)
+ * @retval 0:成功 -1:未注册
+ */
+int name_index_remove(name_index_t *idx, uint32_t id, uint16_t index);
+
+/**
+ * @brief 按名称查找
+ * @param idx 索引
+ * @param name 名称
+ * @retval 条目序号, -1表示未找到
+ */
+int name_index_find(const name_index_t *idx, const char *name);
+
+/**
+ * @brief 按ID查找
+ * @param idx 索引
+ * @param id 名称ID
+ * @retval 条目序号, -1表示未找到
+ */
+int name_index_find_id(const name_index_t *idx, uint32_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NAME_INDEX_H */
@@ -0,0 +1,476 @@
+/**
+ * @file param_registry.c
+ * @brief 参数注册表与远程参数协议实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "param_registry.h"
+#include <string.h>
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+/* 参数表 */
+static const param_desc_t *param_table = NULL;
+static uint8_t param_count = 0;
+
+/* 协议服务端 */
+static struct {
+    param_send_t send;
+    void *ctx;
+    uint8_t sub_ids[PARAM_SUB_MAX];     /**< 订阅的参数ID */
+    uint32_t shadow[PARAM_SUB_MAX];     /**< 上次推送的值 */
+    uint8_t sub_count;
+    uint8_t keyframe;                   /**< 下次推送全部订阅参数 */
+    uint16_t period_ms;
+    uint32_t next_due;
+} server;
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static param_value_t read_value(const param_desc_t *desc);
+static void write_value(const param_desc_t *desc, param_value_t value);
+static param_status_t check_range(const param_desc_t *desc, param_value_t value);
+static int handle_get(const uint8_t *data, uint8_t len);
+static int handle_set(const uint8_t *data, uint8_t len);
+static void handle_subscribe(const uint8_t *data, uint8_t len);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化注册表
+ */
+int param_registry_init(const param_desc_t *table, uint8_t count)
+{
+    uint8_t i;
+
+    if (table == NULL && count > 0) {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (param_type_size(table[i].type) == 0 || table[i].ptr == NULL) {
+            return -1;
+        }
+    }
+
+    param_table = table;
+    param_count = count;
+
+    return 0;
+}
+
+/**
+ * @brief 按ID查找参数
+ */
+const param_desc_t* param_find(uint8_t id)
+{
+    uint8_t i;
+
+    for (i = 0; i < param_count; i++) {
+        if (param_table[i].id == id) {
+            return &param_table[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 读取参数
+ */
+int param_get(uint8_t id, param_value_t *value)
+{
+    const param_desc_t *desc = param_find(id);
+
+    if (desc == NULL) {
+        return -1;
+    }
+
+    *value = read_value(desc);
+    return 0;
+}
+
+/**
+ * @brief 写入参数
+ */
+param_status_t param_set(uint8_t id, param_value_t value)
+{
+    const param_desc_t *desc = param_find(id);
+    param_status_t status;
+
+    if (desc == NULL) {
+        return PARAM_STATUS_UNKNOWN;
+    }
+
+    status = check_range(desc, value);
+    if (status != PARAM_STATUS_OK) {
+        return status;
+    }
+
+    if (read_value(desc).raw == value.raw) {
+        return PARAM_STATUS_OK;
+    }
+
+    write_value(desc, value);
+
+    if (desc->on_change != NULL) {
+        desc->on_change(id, value);
+    }
+
+    return PARAM_STATUS_OK;
+}
+
+/**
+ * @brief 初始化协议服务端
+ */
+void param_server_init(param_send_t send, void *ctx)
+{
+    memset(&server, 0, sizeof(server));
+    server.send = send;
+    server.ctx = ctx;
+}
+
+/**
+ * @brief 处理一帧协议请求
+ */
+int param_server_handle(uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    switch (cmd) {
+    case PARAM_CMD_GET:
+        return handle_get(data, len);
+
+    case PARAM_CMD_SET:
+        return handle_set(data, len);
+
+    case PARAM_CMD_SUBSCRIBE:
+        handle_subscribe(data, len);
+        return 0;
+
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief 周期处理
+ */
+void param_server_poll(uint32_t now_ms)
+{
+    uint8_t frame[PARAM_FRAME_MAX];
+    uint32_t values[PARAM_SUB_MAX];
+    uint8_t pos = 0;
+    uint8_t i;
+
+    if (server.sub_count == 0 || server.send == NULL) {
+        return;
+    }
+
+    if (!server.keyframe && (int32_t)(now_ms - server.next_due) < 0) {
+        return;
+    }
+
+    for (i = 0; i < server.sub_count; i++) {
+        const param_desc_t *desc = param_find(server.sub_ids[i]);
+        param_value_t value = read_value(desc);
+
+        values[i] = value.raw;
+        if (server.keyframe || value.raw != server.shadow[i]) {
+            pos += param_entry_encode(&frame[pos], sizeof(frame) - pos,
+                                      desc->id, desc->type, value);
+        }
+    }
+
+    if (pos > 0 || server.keyframe) {
+        /* 发送失败时影子值不更新, 下次轮询重试 */
+        if (server.send(server.ctx, PARAM_CMD_TELEMETRY, frame, pos) != 0) {
+            return;
+        }
+        memcpy(server.shadow, values, server.sub_count * sizeof(uint32_t));
+        server.keyframe = 0;
+    }
+
+    server.next_due = now_ms + server.period_ms;
+}
+
+/**
+ * @brief 取消所有订阅
+ */
+void param_server_unsubscribe(void)
+{
+    server.sub_count = 0;
+    server.keyframe = 0;
+}
+
+/**
+ * @brief 获取类型的数值字节数
+ */
+uint8_t param_type_size(uint8_t type)
+{
+    switch (type) {
+    case PARAM_TYPE_BOOL:
+    case PARAM_TYPE_U8:
+        return 1;
+    case PARAM_TYPE_U16:
+        return 2;
+    case PARAM_TYPE_I32:
+    case PARAM_TYPE_FLOAT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief 写入一个条目
+ */
+uint8_t param_entry_encode(uint8_t *buf, uint8_t size, uint8_t id, uint8_t type,
+                           param_value_t value)
+{
+    uint8_t n = param_type_size(type);
+    uint8_t i;
+
+    if (size < 2 + n) {
+        return 0;
+    }
+
+    buf[0] = id;
+    buf[1] = type;
+    for (i = 0; i < n; i++) {
+        buf[2 + i] = (uint8_t)(value.raw >> (8 * i));
+    }
+
+    return 2 + n;
+}
+
+/**
+ * @brief 解析一个条目
+ */
+uint8_t param_entry_decode(const uint8_t *buf, uint8_t size, uint8_t *id, uint8_t *type,
+                           param_value_t *value)
+{
+    uint8_t n;
+    uint8_t i;
+
+    if (size < 2) {
+        return 0;
+    }
+
+    *id = buf[0];
+    *type = buf[1];
+    value->raw = 0;
+
+    if (*type == PARAM_TYPE_NONE) {
+        return 2;
+    }
+
+    n = param_type_size(*type);
+    if (n == 0 || size < 2 + n) {
+        return 0;
+    }
+
+    for (i = 0; i < n; i++) {
+        value->raw |= (uint32_t)buf[2 + i] << (8 * i);
+    }
+
+    return 2 + n;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 按类型读取变量
+ */
+static param_value_t read_value(const param_desc_t *desc)
+{
+    param_value_t value;
+
+    switch (desc->type) {
+    case PARAM_TYPE_BOOL:
+    case PARAM_TYPE_U8:
+        value.i = *(const uint8_t *)desc->ptr;
+        break;
+    case PARAM_TYPE_U16:
+        value.i = *(const uint16_t *)desc->ptr;
+        break;
+    case PARAM_TYPE_FLOAT:
+        value.f = *(const float *)desc->ptr;
+        break;
+    default:
+        value.i = *(const int32_t *)desc->ptr;
+        break;
+    }
+
+    return value;
+}
+
+/**
+ * @brief 按类型写入变量
+ */
+static void write_value(const param_desc_t *desc, param_value_t value)
+{
+    switch (desc->type) {
+    case PARAM_TYPE_BOOL:
+    case PARAM_TYPE_U8:
+        *(uint8_t *)desc->ptr = (uint8_t)value.i;
+        break;
+    case PARAM_TYPE_U16:
+        *(uint16_t *)desc->ptr = (uint16_t)value.i;
+        break;
+    case PARAM_TYPE_FLOAT:
+        *(float *)desc->ptr = value.f;
+        break;
+    default:
+        *(int32_t *)desc->ptr = value.i;
+        break;
+    }
+}
+
+/**
+ * @brief 范围检查 (min == max 时只检查类型本身的范围)
+ */
+static param_status_t check_range(const param_desc_t *desc, param_value_t value)
+{
+    int32_t lo = desc->min;
+    int32_t hi = desc->max;
+
+    if (desc->type == PARAM_TYPE_FLOAT) {
+        if (value.f != value.f) {
+            return PARAM_STATUS_RANGE;  /* NaN */
+        }
+        if (lo != hi && (value.f < (float)lo || value.f > (float)hi)) {
+            return PARAM_STATUS_RANGE;
+        }
+        return PARAM_STATUS_OK;
+    }
+
+    if (lo == hi) {
+        switch (desc->type) {
+        case PARAM_TYPE_BOOL:
+            lo = 0;
+            hi = 1;
+            break;
+        case PARAM_TYPE_U8:
+            lo = 0;
+            hi = 0xFF;
+            break;
+        case PARAM_TYPE_U16:
+            lo = 0;
+            hi = 0xFFFF;
+            break;
+        default:
+            return PARAM_STATUS_OK;
+        }
+    }
+
+    return (value.i < lo || value.i > hi) ? PARAM_STATUS_RANGE : PARAM_STATUS_OK;
+}
+
+/**
+ * @brief GET: 按请求顺序返回条目
+ */
+static int handle_get(const uint8_t *data, uint8_t len)
+{
+    uint8_t resp[PARAM_FRAME_MAX];
+    uint8_t pos = 0;
+    uint8_t i;
+
+    for (i = 0; i < len; i++) {
+        const param_desc_t *desc = param_find(data[i]);
+        param_value_t value;
+        uint8_t n;
+
+        value.raw = 0;
+        if (desc != NULL) {
+            value = read_value(desc);
+        }
+
+        n = param_entry_encode(&resp[pos], sizeof(resp) - pos, data[i],
+                               (desc != NULL) ? desc->type : PARAM_TYPE_NONE, value);
+        if (n == 0) {
+            break;  /* 一帧放不下, 其余忽略 */
+        }
+        pos += n;
+    }
+
+    return server.send(server.ctx, PARAM_CMD_GET, resp, pos);
+}
+
+/**
+ * @brief SET: 逐条写入, 返回 (id, status)
+ */
+static int handle_set(const uint8_t *data, uint8_t len)
+{
+    uint8_t resp[PARAM_FRAME_MAX];
+    uint8_t pos = 0;
+    uint8_t off = 0;
+
+    while (off < len && pos <= sizeof(resp) - 2) {
+        uint8_t id;
+        uint8_t type;
+        param_value_t value;
+        const param_desc_t *desc;
+        param_status_t status;
+        uint8_t n = param_entry_decode(&data[off], len - off, &id, &type, &value);
+
+        if (n == 0) {
+            break;
+        }
+        off += n;
+
+        desc = param_find(id);
+        if (desc == NULL) {
+            status = PARAM_STATUS_UNKNOWN;
+        } else if (desc->flags & PARAM_FLAG_READONLY) {
+            status = PARAM_STATUS_READONLY;
+        } else if (desc->type != type) {
+            status = PARAM_STATUS_TYPE;
+        } else {
+            status = param_set(id, value);
+        }
+
+        resp[pos++] = id;
+        resp[pos++] = (uint8_t)status;
+    }
+
+    return server.send(server.ctx, PARAM_CMD_SET, resp, pos);
+}
+
+/**
+ * @brief SUBSCRIBE: 替换订阅列表, 下次轮询推送全量
+ */
+static void handle_subscribe(const uint8_t *data, uint8_t len)
+{
+    uint16_t period;
+    uint8_t i;
+
+    server.sub_count = 0;
+    server.keyframe = 0;
+
+    if (len < 2) {
+        return;
+    }
+
+    period = (uint16_t)(data[0] | (data[1] << 8));
+    if (period == 0) {
+        return;
+    }
+
+    for (i = 2; i < len && server.sub_count < PARAM_SUB_MAX; i++) {
+        if (param_find(data[i]) != NULL) {
+            server.sub_ids[server.sub_count++] = data[i];
+        }
+    }
+
+    server.period_ms = (period < PARAM_SUB_MIN_PERIOD_MS) ? PARAM_SUB_MIN_PERIOD_MS : period;
+    server.keyframe = (server.sub_count > 0) ? 1 : 0;
+}
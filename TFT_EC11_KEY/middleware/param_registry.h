@@ -0,0 +1,230 @@
+/**
+ * @file param_registry.h
+ * @brief 参数注册表与远程参数协议 - 批量读写 + 订阅 + 增量遥测
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 带类型的参数表, 参数直接指向应用变量 (与菜单项共用同一变量)
+ *       - 一帧读写多个参数, 写入时做范围检查并调用变更回调
+ *       - 订阅: 按设定周期比较影子值, 只推送变化的参数 (增量遥测)
+ *       - 与硬件和传输无关, 帧的发送通过回调; 编解码函数可在PC端复用
+ *
+ * @note 协议 (多字节数值均为小端):
+ *       GET       请求: id...                       应答 GET: 条目...
+ *       SET       请求: 条目...                     应答 SET: (id, status)...
+ *       SUBSCRIBE 请求: period_ms(2) id...          应答: 全量TELEMETRY, 之后只发变化
+ *       TELEMETRY 设备主动: 条目...
+ *       条目 = id(1) | type(1) | value(按type 1/2/4字节); 未知参数 type = PARAM_TYPE_NONE, 无value
+ */
+
+#ifndef __PARAM_REGISTRY_H
+#define __PARAM_REGISTRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/**
+ * @brief 最大订阅参数数
+ */
+#define PARAM_SUB_MAX               32
+
+/**
+ * @brief 最小订阅周期 (ms)
+ */
+#define PARAM_SUB_MIN_PERIOD_MS     20
+
+/**
+ * @brief 单帧最大负载 (与frame_codec一致)
+ */
+#define PARAM_FRAME_MAX             200
+
+/* 协议命令码 */
+#define PARAM_CMD_GET               0x24
+#define PARAM_CMD_SET               0x25
+#define PARAM_CMD_SUBSCRIBE         0x26
+#define PARAM_CMD_TELEMETRY         0x27
+
+/* 参数标志 */
+#define PARAM_FLAG_READONLY         0x01    /**< 远程只读 */
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 参数类型
+ */
+typedef enum {
+    PARAM_TYPE_NONE = 0,        /**< 无 (未知参数) */
+    PARAM_TYPE_BOOL,            /**< uint8_t, 0/1 */
+    PARAM_TYPE_U8,              /**< uint8_t */
+    PARAM_TYPE_U16,             /**< uint16_t */
+    PARAM_TYPE_I32,             /**< int32_t */
+    PARAM_TYPE_FLOAT            /**< float (按IEEE754位传输) */
+} param_type_t;
+
+/**
+ * @brief SET应答状态
+ */
+typedef enum {
+    PARAM_STATUS_OK = 0,        /**< 成功 */
+    PARAM_STATUS_UNKNOWN,       /**< 未知参数 */
+    PARAM_STATUS_READONLY,      /**< 只读 */
+    PARAM_STATUS_RANGE,         /**< 超出范围 */
+    PARAM_STATUS_TYPE           /**< 类型不符 */
+} param_status_t;
+
+/**
+ * @brief 参数值 (整数类型用i, 浮点类型用f)
+ */
+typedef union {
+    int32_t i;
+    float f;
+    uint32_t raw;
+} param_value_t;
+
+/**
+ * @brief 参数变更回调
+ * @param id 参数ID
+ * @param value 新值
+ */
+typedef void (*param_changed_callback_t)(uint8_t id, param_value_t value);
+
+/**
+ * @brief 参数描述
+ */
+typedef struct {
+    uint8_t id;                 /**< 参数ID (协议中使用) */
+    uint8_t type;               /**< 类型 (param_type_t) */
+    uint8_t flags;              /**< 标志 (PARAM_FLAG_xxx) */
+    const char *name;           /**< 名称 */
+    void *ptr;                  /**< 变量指针 (与菜单项共用) */
+    int32_t min;                /**< 最小值 (浮点类型按整数比较) */
+    int32_t max;                /**< 最大值 */
+    param_changed_callback_t on_change;  /**< 变更回调 (可为NULL) */
+} param_desc_t;
+
+/**
+ * @brief 协议帧发送接口
+ * @param ctx 用户上下文
+ * @param cmd 命令码
+ * @param data 负载
+ * @param len 长度
+ * @retval 0:成功 -1:暂不能发送
+ */
+typedef int (*param_send_t)(void *ctx, uint8_t cmd, const uint8_t *data, uint8_t len);
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/*----------------------- 注册表 -----------------------*/
+
+/**
+ * @brief 初始化注册表
+ * @param table 参数表 (需静态存在)
+ * @param count 参数数量
+ * @retval 0:成功 -1:失败
+ */
+int param_registry_init(const param_desc_t *table, uint8_t count);
+
+/**
+ * @brief 按ID查找参数
+ * @param id 参数ID
+ * @retval 参数描述, 未找到返回NULL
+ */
+const param_desc_t* param_find(uint8_t id);
+
+/**
+ * @brief 读取参数
+ * @param id 参数ID
+ * @param value 输出值
+ * @retval 0:成功 -1:未知参数
+ */
+int param_get(uint8_t id, param_value_t *value);
+
+/**
+ * @brief 写入参数 (本地调用, 不检查只读标志)
+ * @param id 参数ID
+ * @param value 新值
+ * @retval param_status_t
+ * @note 值有变化时调用变更回调
+ */
+param_status_t param_set(uint8_t id, param_value_t value);
+
+/*----------------------- 协议服务端 -----------------------*/
+
+/**
+ * @brief 初始化协议服务端
+ * @param send 帧发送接口
+ * @param ctx 用户上下文
+ */
+void param_server_init(param_send_t send, void *ctx);
+
+/**
+ * @brief 处理一帧协议请求
+ * @param cmd 命令码 (PARAM_CMD_xxx)
+ * @param data 负载
+ * @param len 长度
+ * @retval 0:已处理 -1:应答发送失败 (请求可稍后重试, 重复处理结果相同)
+ */
+int param_server_handle(uint8_t cmd, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 周期处理: 到达订阅周期时推送变化的参数
+ * @param now_ms 当前时间 (ms)
+ */
+void param_server_poll(uint32_t now_ms);
+
+/**
+ * @brief 取消所有订阅 (断开连接时调用)
+ */
+void param_server_unsubscribe(void);
+
+/*----------------------- 编解码 (设备端与PC端共用) -----------------------*/
+
+/**
+ * @brief 获取类型的数值字节数
+ * @param type 类型
+ * @retval 字节数, 未知类型返回0
+ */
+uint8_t param_type_size(uint8_t type);
+
+/**
+ * @brief 写入一个条目
+ * @param buf 缓冲区
+ * @param size 缓冲区剩余空间
+ * @param id 参数ID
+ * @param type 类型
+ * @param value 值
+ * @retval 写入长度, 空间不足返回0
+ */
+uint8_t param_entry_encode(uint8_t *buf, uint8_t size, uint8_t id, uint8_t type,
+                           param_value_t value);
+
+/**
+ * @brief 解析一个条目
+ * @param buf 缓冲区
+ * @param size 剩余长度
+ * @param id 输出参数ID
+ * @param type 输出类型
+ * @param value 输出值
+ * @retval 条目长度, 格式错误返回0
+ */
+uint8_t param_entry_decode(const uint8_t *buf, uint8_t size, uint8_t *id, uint8_t *type,
+                           param_value_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_REGISTRY_H */
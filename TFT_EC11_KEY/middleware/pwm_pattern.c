@@ -0,0 +1,157 @@
+/**
+ * @file pwm_pattern.c
+ * @brief 多通道PWM关键帧图案 - 渲染 (不依赖硬件)
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "pwm_pattern.h"
+#include "bsp_pwm_gamma.h"
+#include <stddef.h>
+#include <string.h>
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static uint32_t segment_frames(const pwm_pattern_player_t *player, uint16_t index);
+static void next_segment(pwm_pattern_player_t *player);
+static uint16_t level_to_duty(const pwm_pattern_player_t *player, uint32_t level);
+static uint16_t interpolate(const pwm_pattern_player_t *player, uint8_t interp,
+                            int32_t from, int32_t to, uint32_t num, uint32_t den);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 单次播放是否已结束
+ */
+uint8_t pwm_pattern_finished(const pwm_pattern_player_t *player)
+{
+    return (player != NULL) ? player->finished : 0;
+}
+
+/**
+ * @brief 渲染位置回到开头
+ */
+void pwm_pattern_rewind(pwm_pattern_player_t *player)
+{
+    player->index = 0;
+    player->pos = 0;
+    player->finished = 0;
+    memset(player->from, 0, sizeof(player->from));
+    player->len = segment_frames(player, 0);
+}
+
+/**
+ * @brief 渲染后续帧
+ * @note 每帧是本段第 pos+1 个采样, 段的最后一帧恰好等于目标关键帧
+ */
+void pwm_pattern_render(pwm_pattern_player_t *player, uint16_t *frames, uint16_t count)
+{
+    const pwm_pattern_t *pattern = player->pattern;
+    uint8_t channels = pattern->channels;
+    uint16_t f;
+    uint8_t ch;
+
+    for (f = 0; f < count; f++, frames += channels) {
+        const pwm_keyframe_t *kf;
+        uint16_t guard = pattern->count;
+
+        /* 跳过时长为0的关键帧 (立即到达) */
+        while (player->len == 0 && !player->finished && guard-- > 0) {
+            next_segment(player);
+        }
+
+        kf = &pattern->frames[player->index];
+
+        if (player->finished || player->len == 0) {
+            /* 保持最后一帧 */
+            for (ch = 0; ch < channels; ch++) {
+                frames[ch] = interpolate(player, kf->interp, kf->level[ch], kf->level[ch], 1, 1);
+            }
+            continue;
+        }
+
+        for (ch = 0; ch < channels; ch++) {
+            frames[ch] = interpolate(player, kf->interp, player->from[ch], kf->level[ch],
+                                     player->pos + 1, player->len);
+        }
+
+        if (++player->pos >= player->len) {
+            next_segment(player);
+        }
+    }
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 过渡到第index个关键帧所需的帧数
+ */
+static uint32_t segment_frames(const pwm_pattern_player_t *player, uint16_t index)
+{
+    return (uint32_t)((uint64_t)player->pattern->frames[index].time_ms * player->frequency / 1000);
+}
+
+/**
+ * @brief 当前关键帧到达, 开始下一段
+ */
+static void next_segment(pwm_pattern_player_t *player)
+{
+    const pwm_pattern_t *pattern = player->pattern;
+
+    memcpy(player->from, pattern->frames[player->index].level, sizeof(player->from));
+    player->pos = 0;
+
+    if (player->index + 1 < pattern->count) {
+        player->index++;
+    } else if (pattern->loop) {
+        player->index = 0;
+    } else {
+        player->finished = 1;
+        return;
+    }
+
+    player->len = segment_frames(player, player->index);
+}
+
+/**
+ * @brief 千分比换算为占空比 (四舍五入)
+ */
+static uint16_t level_to_duty(const pwm_pattern_player_t *player, uint32_t level)
+{
+    if (level > PWM_PATTERN_LEVEL_MAX) {
+        level = PWM_PATTERN_LEVEL_MAX;
+    }
+
+    return (uint16_t)((level * player->resolution + PWM_PATTERN_LEVEL_MAX / 2) / PWM_PATTERN_LEVEL_MAX);
+}
+
+/**
+ * @brief 段内第 num/den 处的占空比
+ */
+static uint16_t interpolate(const pwm_pattern_player_t *player, uint8_t interp,
+                            int32_t from, int32_t to, uint32_t num, uint32_t den)
+{
+    int32_t level;
+
+    switch (interp) {
+    case PWM_PATTERN_LINEAR:
+        from = level_to_duty(player, (uint32_t)from);
+        to = level_to_duty(player, (uint32_t)to);
+        return (uint16_t)(from + (int32_t)((int64_t)(to - from) * num / den));
+
+    case PWM_PATTERN_GAMMA:
+        level = from + (int32_t)((int64_t)(to - from) * num / den);
+        return (uint16_t)((bsp_pwm_gamma(((uint32_t)level << 16) / PWM_PATTERN_LEVEL_MAX) *
+                           player->resolution + 32768) >> 16);
+
+    default:
+        return level_to_duty(player, (uint32_t)to);
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file pwm_pattern.h
+ * @brief 多通道PWM关键帧图案 - RGB灯效、步进电机波形等
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 图案由关键帧组成, 每帧给出各通道的目标值和过渡时间, 可放在Flash中
+ *       - 过渡方式: 阶跃 (步进电机)、线性 (电机/占空比)、伽马 (LED感知亮度)
+ *       - 通过 bsp_pwm_seq_start() 的DMA突发播放, 同一定时器的各通道在同一PWM周期更新
+ *       - 播放器在DMA半满/全满中断中逐段渲染, 缓冲区只需 PWM_PATTERN_BUF_FRAMES 帧
+ *       - 关键帧表可由 tools/pwm_pattern.py 从文本描述编译, 该工具也能逐周期仿真输出
+ *       - 渲染 (pwm_pattern.c + bsp_pwm_gamma.c) 不依赖标准库, 可在PC上与仿真逐位对照;
+ *         播放 (pwm_pattern_player.c) 调用 bsp_pwm 的序列接口
+ *
+ * @note 使用方法:
+ *       1. 用 bsp_pwm_init() 初始化同一定时器上连续的几个通道并 bsp_pwm_start()
+ *       2. pwm_pattern_play(&player, &pattern, first_channel)
+ *       3. pwm_pattern_stop(&player) 停止, 各通道停在当前值
+ */
+
+#ifndef __PWM_PATTERN_H
+#define __PWM_PATTERN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "bsp_pwm_types.h"
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 每个图案最多通道数 (一个定时器) */
+#define PWM_PATTERN_MAX_CH          4
+
+/* 播放缓冲区帧数 (偶数); 每半区对应一次中断, 1kHz时32帧约16ms中断一次 */
+#define PWM_PATTERN_BUF_FRAMES      32
+
+/* 关键帧数值满量程 (千分比), 渲染时换算到通道分辨率 */
+#define PWM_PATTERN_LEVEL_MAX       1000
+
+/* 过渡方式 */
+#define PWM_PATTERN_STEP            0   /**< 阶跃: 本段开始即为目标值并保持 */
+#define PWM_PATTERN_LINEAR          1   /**< 占空比线性变化 */
+#define PWM_PATTERN_GAMMA           2   /**< 感知亮度线性变化, 输出经伽马校正 */
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 关键帧
+ */
+typedef struct {
+    uint16_t time_ms;                       /**< 从上一关键帧过渡到本帧的时间 */
+    uint8_t interp;                         /**< 过渡方式 PWM_PATTERN_x */
+    uint16_t level[PWM_PATTERN_MAX_CH];     /**< 各通道目标值 (0~PWM_PATTERN_LEVEL_MAX) */
+} pwm_keyframe_t;
+
+/**
+ * @brief 图案
+ * @note 播放从全0开始过渡到第一个关键帧; 循环播放时最后一帧过渡回第一帧
+ */
+typedef struct {
+    const pwm_keyframe_t *frames;           /**< 关键帧表 */
+    uint16_t count;                         /**< 关键帧数 */
+    uint8_t channels;                       /**< 通道数 (1~PWM_PATTERN_MAX_CH) */
+    uint8_t loop;                           /**< 1:循环 0:播放一遍后保持最后一帧 */
+} pwm_pattern_t;
+
+/**
+ * @brief 播放器 (渲染状态和DMA缓冲区, 不能放在CCM RAM中)
+ */
+typedef struct {
+    const pwm_pattern_t *pattern;
+    pwm_channel_t first;                    /**< 第一个PWM通道 */
+    uint16_t resolution;                    /**< 通道分辨率 */
+    uint32_t frequency;                     /**< PWM频率 (每秒帧数) */
+    uint16_t index;                         /**< 当前过渡的目标关键帧 */
+    uint32_t pos;                           /**< 本段已渲染的帧数 */
+    uint32_t len;                           /**< 本段总帧数 */
+    uint16_t from[PWM_PATTERN_MAX_CH];      /**< 本段起点 */
+    volatile uint8_t finished;              /**< 单次播放已到最后一帧 */
+    uint16_t buffer[PWM_PATTERN_BUF_FRAMES * PWM_PATTERN_MAX_CH];
+} pwm_pattern_player_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 开始播放图案
+ * @param player 播放器
+ * @param pattern 图案 (播放期间必须保持有效)
+ * @param first 第一个PWM通道, 图案占用同一定时器上从它开始的 pattern->channels 个通道
+ * @retval 0:成功 -1:参数无效或定时器被占用
+ */
+int pwm_pattern_play(pwm_pattern_player_t *player, const pwm_pattern_t *pattern, pwm_channel_t first);
+
+/**
+ * @brief 停止播放
+ * @param player 播放器
+ */
+void pwm_pattern_stop(pwm_pattern_player_t *player);
+
+/**
+ * @brief 单次播放是否已结束
+ * @param player 播放器
+ * @retval 1:已到最后一帧 (仍保持输出, 需 pwm_pattern_stop) 0:播放中或循环
+ */
+uint8_t pwm_pattern_finished(const pwm_pattern_player_t *player);
+
+/**
+ * @brief 渲染后续帧 (播放器内部在DMA中断中调用, 也可用于离线生成)
+ * @param player 播放器 (pattern/resolution/frequency须已设置, 首次调用前用 pwm_pattern_rewind 复位)
+ * @param frames 输出, count帧, 每帧 pattern->channels 个占空比
+ * @param count 帧数
+ */
+void pwm_pattern_render(pwm_pattern_player_t *player, uint16_t *frames, uint16_t count);
+
+/**
+ * @brief 渲染位置回到开头 (全0开始过渡到第一个关键帧)
+ * @param player 播放器
+ */
+void pwm_pattern_rewind(pwm_pattern_player_t *player);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PWM_PATTERN_H */
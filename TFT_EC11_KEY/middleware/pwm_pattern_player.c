@@ -0,0 +1,82 @@
+/**
+ * @file pwm_pattern_player.c
+ * @brief 多通道PWM关键帧图案 - DMA突发播放
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "pwm_pattern.h"
+#include "bsp_pwm.h"
+#include <stddef.h>
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static void refill(uint16_t *frames, uint16_t count, void *user_data);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 开始播放图案
+ */
+int pwm_pattern_play(pwm_pattern_player_t *player, const pwm_pattern_t *pattern, pwm_channel_t first)
+{
+    uint32_t total = 0;
+    uint16_t i;
+
+    if (player == NULL || pattern == NULL || pattern->frames == NULL || pattern->count == 0 ||
+        pattern->channels == 0 || pattern->channels > PWM_PATTERN_MAX_CH) {
+        return -1;
+    }
+
+    /* 循环图案总时长为0会在渲染中空转 */
+    for (i = 0; i < pattern->count; i++) {
+        total += pattern->frames[i].time_ms;
+    }
+    if (pattern->loop && total == 0) {
+        return -1;
+    }
+
+    player->pattern = pattern;
+    player->first = first;
+    player->resolution = bsp_pwm_get_resolution(first);
+    player->frequency = bsp_pwm_get_frequency(first);
+
+    if (player->resolution == 0) {
+        return -1;
+    }
+
+    pwm_pattern_rewind(player);
+
+    return bsp_pwm_seq_start(first, pattern->channels, player->buffer, PWM_PATTERN_BUF_FRAMES,
+                             refill, player);
+}
+
+/**
+ * @brief 停止播放
+ */
+void pwm_pattern_stop(pwm_pattern_player_t *player)
+{
+    if (player == NULL || player->pattern == NULL) {
+        return;
+    }
+
+    bsp_pwm_seq_stop(player->first);
+    player->pattern = NULL;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief DMA半区补充回调 (中断上下文)
+ */
+static void refill(uint16_t *frames, uint16_t count, void *user_data)
+{
+    pwm_pattern_render((pwm_pattern_player_t *)user_data, frames, count);
+}
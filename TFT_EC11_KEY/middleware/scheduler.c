@@ -23,6 +23,7 @@ static watchdog_callback_t watchdog_cb = NULL;
 
 static volatile uint32_t tick_count = 0;
 static volatile uint8_t critical_nesting = 0;
+static scheduler_clock_t clock_source = NULL;
 
 /* CPU占用率计算 */
 static uint32_t idle_start_tick = 0;
@@ -39,7 +40,7 @@ static uint32_t sample_start_tick = 0;
  */
 __attribute__((weak)) uint32_t scheduler_get_us(void)
 {
-    return tick_count * 1000;
+    return (uint32_t)scheduler_get_us64();
 }
 
 /**
@@ -80,7 +81,7 @@ __attribute__((weak)) void scheduler_enter_sleep(void)
 
 static task_id_t find_free_task_slot(void);
 static timer_id_t find_free_timer_slot(void);
-static void process_timers(void);
+static void soft_timer_expired(timer_entry_t *entry, void *arg);
 static void check_watchdog(void);
 static void update_cpu_usage(void);
 
@@ -101,8 +102,9 @@ int scheduler_init(void)
         task_list[i].state = TASK_STATE_INVALID;
     }
 
-    /* 清空定时器列表 */
+    /* 清空定时器列表, 软件定时器由定时服务按调度器时钟管理 */
     memset(timer_list, 0, sizeof(timer_list));
+    timer_service_init(scheduler_get_us64);
 
     /* 初始化调度器状态 */
     memset(&scheduler_state, 0, sizeof(scheduler_state));
@@ -122,7 +124,12 @@ int scheduler_init(void)
  */
 void scheduler_deinit(void)
 {
+    uint8_t i;
+
     scheduler_stop();
+    for (i = 0; i < SCHEDULER_MAX_TIMERS; i++) {
+        timer_service_stop(&timer_list[i].entry);
+    }
     memset(task_list, 0, sizeof(task_list));
     memset(timer_list, 0, sizeof(timer_list));
 }
@@ -133,7 +140,7 @@ void scheduler_deinit(void)
 void scheduler_start(void)
 {
     scheduler_state.is_running = 1;
-    sample_start_tick = tick_count;
+    sample_start_tick = scheduler_get_tick();
 
     while (scheduler_state.is_running) {
         scheduler_run();
@@ -156,15 +163,17 @@ void scheduler_run(void)
     uint8_t i;
     task_id_t highest_prio_task = INVALID_ID;
     task_priority_t highest_prio = TASK_PRIORITY_IDLE;
-    uint32_t current_tick = tick_count;
+    uint32_t current_tick = scheduler_get_tick();
     uint8_t task_executed = 0;
 
 #if SCHEDULER_ENABLE_STATS
     uint32_t start_us, end_us;
 #endif
 
-    /* 处理软件定时器 */
-    process_timers();
+    scheduler_state.tick_count = current_tick;
+
+    /* 执行到期的软件定时器 */
+    timer_service_process();
 
     /* 查找最高优先级就绪任务 */
     for (i = 0; i < SCHEDULER_MAX_TASKS; i++) {
@@ -206,7 +215,7 @@ void scheduler_run(void)
             if (exec_time > tcb->stats.max_time_us) {
                 tcb->stats.max_time_us = exec_time;
             }
-            tcb->stats.avg_time_us = tcb->stats.total_time_us / tcb->stats.run_count;
+            tcb->stats.avg_time_us = (uint32_t)(tcb->stats.total_time_us / tcb->stats.run_count);
             tcb->stats.last_run_tick = current_tick;
 
             /* 检查是否超时 */
@@ -272,14 +281,38 @@ void scheduler_tick(void)
     scheduler_state.tick_count = tick_count;
 }
 
+/**
+ * @brief 设置时钟源
+ */
+void scheduler_set_clock(scheduler_clock_t clock)
+{
+    clock_source = clock;
+}
+
 /**
  * @brief 获取当前tick计数
  */
 uint32_t scheduler_get_tick(void)
 {
+    if (clock_source != NULL) {
+        return (uint32_t)(clock_source() / (1000 * SCHEDULER_TICK_MS));
+    }
+
     return tick_count;
 }
 
+/**
+ * @brief 获取64位时间 (us)
+ */
+uint64_t scheduler_get_us64(void)
+{
+    if (clock_source != NULL) {
+        return clock_source();
+    }
+
+    return (uint64_t)tick_count * SCHEDULER_TICK_MS * 1000;
+}
+
 /**
  * @brief 获取调度器状态
  */
@@ -311,7 +344,7 @@ task_id_t scheduler_task_create(const task_config_t *config)
     /* 填充任务控制块 */
     tcb->config = *config;
     tcb->state = TASK_STATE_READY;
-    tcb->next_run_tick = tick_count + config->delay_ms;
+    tcb->next_run_tick = scheduler_get_tick() + config->delay_ms;
 
 #if SCHEDULER_ENABLE_STATS
     memset(&tcb->stats, 0, sizeof(tcb->stats));
@@ -378,7 +411,7 @@ int scheduler_task_resume(task_id_t task_id)
     }
 
     task_list[task_id].state = TASK_STATE_READY;
-    task_list[task_id].next_run_tick = tick_count;
+    task_list[task_id].next_run_tick = scheduler_get_tick();
     return 0;
 }
 
@@ -505,12 +538,11 @@ timer_id_t scheduler_timer_create(uint32_t period_ms,
         return INVALID_ID;
     }
 
+    timer_entry_init(&timer_list[id].entry, soft_timer_expired, &timer_list[id], TIMER_MODE_DEFERRED);
     timer_list[id].period_ms = period_ms;
     timer_list[id].callback = callback;
     timer_list[id].arg = arg;
     timer_list[id].is_periodic = is_periodic;
-    timer_list[id].is_active = 0;
-    timer_list[id].expire_tick = 0;
 
     scheduler_state.timer_count++;
 
@@ -530,6 +562,7 @@ int scheduler_timer_delete(timer_id_t timer_id)
         return -1;
     }
 
+    timer_service_stop(&timer_list[timer_id].entry);
     memset(&timer_list[timer_id], 0, sizeof(soft_timer_t));
     scheduler_state.timer_count--;
 
@@ -549,10 +582,8 @@ int scheduler_timer_start(timer_id_t timer_id)
         return -1;
     }
 
-    timer_list[timer_id].expire_tick = tick_count + timer_list[timer_id].period_ms;
-    timer_list[timer_id].is_active = 1;
-
-    return 0;
+    return timer_service_start(&timer_list[timer_id].entry, timer_list[timer_id].period_ms * 1000,
+                               timer_list[timer_id].is_periodic ? timer_list[timer_id].period_ms * 1000 : 0);
 }
 
 /**
@@ -564,7 +595,7 @@ int scheduler_timer_stop(timer_id_t timer_id)
         return -1;
     }
 
-    timer_list[timer_id].is_active = 0;
+    timer_service_stop(&timer_list[timer_id].entry);
 
     return 0;
 }
@@ -582,7 +613,9 @@ int scheduler_timer_reset(timer_id_t timer_id)
         return -1;
     }
 
-    timer_list[timer_id].expire_tick = tick_count + timer_list[timer_id].period_ms;
+    if (timer_service_active(&timer_list[timer_id].entry)) {
+        return scheduler_timer_start(timer_id);
+    }
 
     return 0;
 }
@@ -597,6 +630,9 @@ int scheduler_timer_set_period(timer_id_t timer_id, uint32_t period_ms)
     }
 
     timer_list[timer_id].period_ms = period_ms;
+    if (timer_list[timer_id].is_periodic) {
+        timer_service_set_period(&timer_list[timer_id].entry, period_ms * 1000);
+    }
 
     return 0;
 }
@@ -606,9 +642,9 @@ int scheduler_timer_set_period(timer_id_t timer_id, uint32_t period_ms)
  */
 void scheduler_delay(uint32_t ms)
 {
-    uint32_t start = tick_count;
+    uint32_t start = scheduler_get_tick();
 
-    while ((tick_count - start) < ms) {
+    while ((scheduler_get_tick() - start) < ms) {
         scheduler_run();
     }
 }
@@ -618,9 +654,9 @@ void scheduler_delay(uint32_t ms)
  */
 void scheduler_delay_blocking(uint32_t ms)
 {
-    uint32_t start = tick_count;
+    uint32_t start = scheduler_get_tick();
 
-    while ((tick_count - start) < ms) {
+    while ((scheduler_get_tick() - start) < ms) {
         /* 空等待 */
     }
 }
@@ -666,7 +702,7 @@ void scheduler_exit_critical(void)
  */
 uint32_t scheduler_get_runtime_ms(void)
 {
-    return tick_count * SCHEDULER_TICK_MS;
+    return scheduler_get_tick() * SCHEDULER_TICK_MS;
 }
 
 /**
@@ -757,31 +793,14 @@ static timer_id_t find_free_timer_slot(void)
 }
 
 /**
- * @brief 处理软件定时器
+ * @brief 软件定时器到期 (定时服务延迟回调)
  */
-static void process_timers(void)
+static void soft_timer_expired(timer_entry_t *entry, void *arg)
 {
-    uint8_t i;
-    uint32_t current_tick = tick_count;
+    soft_timer_t *timer = (soft_timer_t *)arg;
 
-    for (i = 0; i < SCHEDULER_MAX_TIMERS; i++) {
-        if (timer_list[i].is_active &&
-            timer_list[i].callback != NULL) {
-
-            if ((int32_t)(current_tick - timer_list[i].expire_tick) >= 0) {
-                /* 调用回调 */
-                timer_list[i].callback(i, timer_list[i].arg);
-
-                if (timer_list[i].is_periodic) {
-                    /* 重新计算下次到期时间 */
-                    timer_list[i].expire_tick = current_tick + timer_list[i].period_ms;
-                } else {
-                    /* 一次性定时器，停止 */
-                    timer_list[i].is_active = 0;
-                }
-            }
-        }
-    }
+    (void)entry;
+    timer->callback((timer_id_t)(timer - timer_list), timer->arg);
 }
 
 /**
@@ -791,7 +810,7 @@ static void check_watchdog(void)
 {
 #if SCHEDULER_ENABLE_WATCHDOG
     uint8_t i;
-    uint32_t current_tick = tick_count;
+    uint32_t current_tick = scheduler_get_tick();
 
     for (i = 0; i < SCHEDULER_MAX_TASKS; i++) {
         if (task_list[i].state == TASK_STATE_READY &&
@@ -816,12 +835,12 @@ static void check_watchdog(void)
  */
 static void update_cpu_usage(void)
 {
-    uint32_t sample_time = tick_count - sample_start_tick;
+    uint32_t sample_time = scheduler_get_tick() - sample_start_tick;
 
     /* 每1000ms计算一次CPU占用率 */
     if (sample_time >= 1000) {
         scheduler_state.cpu_usage = (float)busy_time * 100.0f / (float)sample_time;
         busy_time = 0;
-        sample_start_tick = tick_count;
+        sample_start_tick = scheduler_get_tick();
     }
 }
@@ -28,6 +28,7 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include "timer_service.h"
 
 /*=============================================================================
  *                              宏定义配置
@@ -144,6 +145,12 @@ typedef void (*idle_hook_t)(void);
  */
 typedef void (*watchdog_callback_t)(task_id_t task_id);
 
+/**
+ * @brief 时钟源类型
+ * @retval 64位单调时间 (us), 不回绕
+ */
+typedef uint64_t (*scheduler_clock_t)(void);
+
 /**
  * @brief 任务配置结构体
  */
@@ -162,7 +169,7 @@ typedef struct {
  */
 typedef struct {
     uint32_t run_count;         /**< 执行次数 */
-    uint32_t total_time_us;     /**< 总执行时间 (us) */
+    uint64_t total_time_us;     /**< 总执行时间 (us), 长时间运行不溢出 */
     uint32_t max_time_us;       /**< 最大执行时间 (us) */
     uint32_t avg_time_us;       /**< 平均执行时间 (us) */
     uint32_t last_run_tick;     /**< 上次执行时间 */
@@ -184,12 +191,12 @@ typedef struct {
 
 /**
  * @brief 软件定时器结构体
+ * @note 到期由定时服务 (timer_service) 管理, 回调在 scheduler_run() 中执行
  */
 typedef struct {
-    uint8_t is_active;          /**< 激活状态 */
+    timer_entry_t entry;        /**< 定时服务节点 */
     uint8_t is_periodic;        /**< 是否周期性 */
-    uint32_t period_ms;         /**< 周期/延时 (ms) */
-    uint32_t expire_tick;       /**< 到期时间 */
+    uint32_t period_ms;         /**< 周期/延时 (ms), 不超过约71分钟 */
     timer_callback_t callback;  /**< 回调函数 */
     void *arg;                  /**< 用户参数 */
 } soft_timer_t;
@@ -243,15 +250,30 @@ void scheduler_run(void);
 
 /**
  * @brief 时基更新 (在SysTick中断中调用)
+ * @note 用 scheduler_set_clock() 注册时钟源后不再需要
  */
 void scheduler_tick(void);
 
+/**
+ * @brief 设置时钟源
+ * @param clock 64位微秒时钟 (如 bsp_timer_get_us64), NULL恢复使用 scheduler_tick() 计数
+ * @note 设置后tick、延时、软件定时器和任务耗时统计都由该时钟派生,
+ *       与其他模块的时间戳是同一个时间基准
+ */
+void scheduler_set_clock(scheduler_clock_t clock);
+
 /**
  * @brief 获取当前tick计数
  * @retval 当前tick值
  */
 uint32_t scheduler_get_tick(void);
 
+/**
+ * @brief 获取64位时间 (us)
+ * @retval 时钟源的当前值; 未设置时钟源时为tick换算的微秒数
+ */
+uint64_t scheduler_get_us64(void);
+
 /**
  * @brief 获取调度器状态
  * @retval 调度器状态指针
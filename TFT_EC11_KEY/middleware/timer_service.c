@@ -0,0 +1,505 @@
+/**
+ * @file timer_service.c
+ * @brief 定时服务实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "timer_service.h"
+#include <stddef.h>
+#include <string.h>
+
+/*=============================================================================
+ *                              私有变量
+ *============================================================================*/
+
+static timer_service_clock_t service_clock = NULL;
+static timer_service_alarm_t service_alarm = NULL;
+
+static timer_entry_t *heap_root = NULL;     /**< 配对堆根, 即最早到期的定时器 */
+static uint32_t start_seq = 0;
+static uint64_t armed_at = TIMER_SERVICE_NEVER;
+
+/* 延迟回调队列 (先进先出) */
+static timer_entry_t *pending_head = NULL;
+static timer_entry_t *pending_tail = NULL;
+static volatile uint16_t pending_count = 0;
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static uint8_t before(const timer_entry_t *a, const timer_entry_t *b);
+static timer_entry_t* meld(timer_entry_t *a, timer_entry_t *b);
+static timer_entry_t* merge_pairs(timer_entry_t *first);
+static void heap_insert(timer_entry_t *timer);
+static void heap_remove(timer_entry_t *timer);
+static void pending_remove(timer_entry_t *timer);
+static void rearm(uint8_t force);
+static void expire(void);
+
+/*=============================================================================
+ *                              外部函数声明 (可由用户重新实现)
+ *============================================================================*/
+
+/**
+ * @brief 进入临界区
+ * @retval 进入前的中断屏蔽状态
+ */
+__attribute__((weak)) uint32_t timer_service_lock(void)
+{
+    uint32_t primask;
+
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+    return primask;
+}
+
+/**
+ * @brief 退出临界区
+ * @param state timer_service_lock() 的返回值
+ */
+__attribute__((weak)) void timer_service_unlock(uint32_t state)
+{
+    __asm volatile ("msr primask, %0" :: "r" (state) : "memory");
+}
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化定时服务
+ */
+void timer_service_init(timer_service_clock_t clock)
+{
+    uint32_t lock = timer_service_lock();
+
+    if (service_alarm != NULL) {
+        service_alarm(TIMER_SERVICE_NEVER);
+    }
+
+    service_clock = clock;
+    service_alarm = NULL;
+    heap_root = NULL;
+    armed_at = TIMER_SERVICE_NEVER;
+    pending_head = NULL;
+    pending_tail = NULL;
+    pending_count = 0;
+
+    timer_service_unlock(lock);
+}
+
+/**
+ * @brief 设置硬件比较
+ */
+void timer_service_set_alarm(timer_service_alarm_t alarm)
+{
+    uint32_t lock = timer_service_lock();
+
+    if (service_alarm != NULL) {
+        service_alarm(TIMER_SERVICE_NEVER);
+    }
+
+    service_alarm = alarm;
+    armed_at = TIMER_SERVICE_NEVER;
+    rearm(0);
+
+    timer_service_unlock(lock);
+}
+
+/**
+ * @brief 初始化定时器节点
+ */
+void timer_entry_init(timer_entry_t *timer, timer_entry_cb_t callback, void *arg, uint8_t mode)
+{
+    memset(timer, 0, sizeof(timer_entry_t));
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->mode = mode;
+}
+
+/**
+ * @brief 启动定时器
+ */
+int timer_service_start(timer_entry_t *timer, uint32_t delay_us, uint32_t period_us)
+{
+    if (service_clock == NULL) {
+        return -1;
+    }
+
+    return timer_service_start_at(timer, service_clock() + delay_us, period_us);
+}
+
+/**
+ * @brief 在绝对时间启动定时器
+ */
+int timer_service_start_at(timer_entry_t *timer, uint64_t at_us, uint32_t period_us)
+{
+    uint32_t lock;
+
+    if (timer == NULL || timer->callback == NULL || service_clock == NULL) {
+        return -1;
+    }
+
+    lock = timer_service_lock();
+
+    if (timer->active) {
+        heap_remove(timer);
+    }
+
+    timer->expire_us = at_us;
+    timer->period_us = period_us;
+    timer->seq = start_seq++;
+    timer->fire = 0;
+    heap_insert(timer);
+    rearm(0);
+
+    timer_service_unlock(lock);
+
+    return 0;
+}
+
+/**
+ * @brief 停止定时器
+ */
+void timer_service_stop(timer_entry_t *timer)
+{
+    uint32_t lock;
+
+    if (timer == NULL) {
+        return;
+    }
+
+    lock = timer_service_lock();
+
+    if (timer->active) {
+        heap_remove(timer);
+        rearm(0);
+    }
+
+    /* 从延迟队列摘除, 之后调用者可以清零或重新初始化节点 */
+    if (timer->queued) {
+        pending_remove(timer);
+    }
+    timer->fire = 0;
+
+    timer_service_unlock(lock);
+}
+
+/**
+ * @brief 修改周期
+ */
+void timer_service_set_period(timer_entry_t *timer, uint32_t period_us)
+{
+    if (timer != NULL) {
+        timer->period_us = period_us;
+    }
+}
+
+/**
+ * @brief 定时器是否在运行
+ */
+uint8_t timer_service_active(const timer_entry_t *timer)
+{
+    return (timer != NULL) ? timer->active : 0;
+}
+
+/**
+ * @brief 最早的到期时间
+ */
+uint64_t timer_service_next(void)
+{
+    uint64_t next;
+    uint32_t lock = timer_service_lock();
+
+    next = (heap_root != NULL) ? heap_root->expire_us : TIMER_SERVICE_NEVER;
+
+    timer_service_unlock(lock);
+
+    return next;
+}
+
+/**
+ * @brief 处理到期定时器
+ */
+void timer_service_isr(void)
+{
+    if (service_clock != NULL) {
+        expire();
+    }
+}
+
+/**
+ * @brief 执行延迟回调
+ */
+uint16_t timer_service_process(void)
+{
+    uint16_t limit, count = 0;
+    timer_entry_t *timer;
+    uint8_t fire;
+    uint32_t lock;
+
+    if (service_alarm == NULL) {
+        timer_service_isr();
+    }
+
+    limit = pending_count;
+
+    while (count < limit) {
+        lock = timer_service_lock();
+
+        timer = pending_head;
+        if (timer == NULL) {
+            timer_service_unlock(lock);
+            break;
+        }
+
+        pending_head = timer->pending_next;
+        if (pending_head == NULL) {
+            pending_tail = NULL;
+        }
+        pending_count--;
+        timer->queued = 0;
+        fire = timer->fire;
+        timer->fire = 0;
+
+        timer_service_unlock(lock);
+
+        if (fire) {
+            timer->callback(timer, timer->arg);
+        }
+        count++;
+    }
+
+    return count;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief a是否先于b到期
+ */
+static uint8_t before(const timer_entry_t *a, const timer_entry_t *b)
+{
+    if (a->expire_us != b->expire_us) {
+        return a->expire_us < b->expire_us;
+    }
+
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+/**
+ * @brief 合并两个堆 (参数为根或NULL), 后到期的根成为先到期的根的第一个子节点
+ */
+static timer_entry_t* meld(timer_entry_t *a, timer_entry_t *b)
+{
+    timer_entry_t *t;
+
+    if (a == NULL) {
+        return b;
+    }
+    if (b == NULL) {
+        return a;
+    }
+
+    if (before(b, a)) {
+        t = a;
+        a = b;
+        b = t;
+    }
+
+    b->prev = a;
+    b->next = a->child;
+    if (a->child != NULL) {
+        a->child->prev = b;
+    }
+    a->child = b;
+
+    a->prev = NULL;
+    a->next = NULL;
+
+    return a;
+}
+
+/**
+ * @brief 两遍合并兄弟链表 (删除根后重建堆)
+ * @note 第一遍从左到右两两合并, 结果逆序串起; 第二遍从右到左依次合并. 不递归
+ */
+static timer_entry_t* merge_pairs(timer_entry_t *first)
+{
+    timer_entry_t *list = NULL;
+    timer_entry_t *result = NULL;
+    timer_entry_t *a, *b;
+
+    while (first != NULL) {
+        a = first;
+        b = a->next;
+        if (b == NULL) {
+            a->next = list;
+            list = a;
+            break;
+        }
+
+        first = b->next;
+        a->next = NULL;
+        b->next = NULL;
+        a = meld(a, b);
+        a->next = list;
+        list = a;
+    }
+
+    while (list != NULL) {
+        a = list;
+        list = list->next;
+        a->next = NULL;
+        result = meld(result, a);
+    }
+
+    if (result != NULL) {
+        result->prev = NULL;
+    }
+
+    return result;
+}
+
+/**
+ * @brief 插入堆
+ */
+static void heap_insert(timer_entry_t *timer)
+{
+    timer->child = NULL;
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->active = 1;
+    heap_root = meld(heap_root, timer);
+}
+
+/**
+ * @brief 从堆中删除任意节点
+ */
+static void heap_remove(timer_entry_t *timer)
+{
+    if (timer == heap_root) {
+        heap_root = merge_pairs(timer->child);
+    } else {
+        /* 从父节点或左兄弟处摘下整棵子树, 子节点重新合并后并回根 */
+        if (timer->prev->child == timer) {
+            timer->prev->child = timer->next;
+        } else {
+            timer->prev->next = timer->next;
+        }
+        if (timer->next != NULL) {
+            timer->next->prev = timer->prev;
+        }
+        heap_root = meld(heap_root, merge_pairs(timer->child));
+    }
+
+    timer->child = NULL;
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->active = 0;
+}
+
+/**
+ * @brief 从延迟队列中摘除节点 (临界区内调用)
+ */
+static void pending_remove(timer_entry_t *timer)
+{
+    timer_entry_t *prev = NULL;
+    timer_entry_t *node = pending_head;
+
+    while (node != NULL && node != timer) {
+        prev = node;
+        node = node->pending_next;
+    }
+
+    if (node == NULL) {
+        return;
+    }
+
+    if (prev != NULL) {
+        prev->pending_next = timer->pending_next;
+    } else {
+        pending_head = timer->pending_next;
+    }
+    if (pending_tail == timer) {
+        pending_tail = prev;
+    }
+
+    timer->pending_next = NULL;
+    timer->queued = 0;
+    pending_count--;
+}
+
+/**
+ * @brief 最早到期时间变化时重新编程硬件比较 (临界区内调用)
+ * @param force 1:比较已触发, 无论是否变化都重新编程
+ */
+static void rearm(uint8_t force)
+{
+    uint64_t next = (heap_root != NULL) ? heap_root->expire_us : TIMER_SERVICE_NEVER;
+
+    if (service_alarm != NULL && (force || next != armed_at)) {
+        armed_at = next;
+        service_alarm(next);
+    }
+}
+
+/**
+ * @brief 取出所有已到期的定时器并分派
+ * @note 每取一个重新读一次时钟, 回调执行期间到期的定时器在同一次调用中处理;
+ *       中断方式的回调在临界区外执行, 可以启动和停止定时器
+ */
+static void expire(void)
+{
+    timer_entry_t *timer;
+    uint64_t now;
+    uint32_t lock;
+
+    lock = timer_service_lock();
+
+    while ((timer = heap_root) != NULL) {
+        now = service_clock();
+        if (timer->expire_us > now) {
+            break;
+        }
+
+        heap_remove(timer);
+
+        if (timer->period_us != 0) {
+            /* 从理论到期时间重装; 落后超过一个周期时跳过错过的周期 */
+            timer->expire_us += timer->period_us;
+            if (timer->expire_us <= now) {
+                timer->expire_us += ((now - timer->expire_us) / timer->period_us + 1) * timer->period_us;
+            }
+            heap_insert(timer);
+        }
+
+        if (timer->mode == TIMER_MODE_ISR) {
+            timer_service_unlock(lock);
+            timer->callback(timer, timer->arg);
+            lock = timer_service_lock();
+        } else {
+            timer->fire = 1;
+            if (!timer->queued) {
+                timer->queued = 1;
+                timer->pending_next = NULL;
+                if (pending_tail != NULL) {
+                    pending_tail->pending_next = timer;
+                } else {
+                    pending_head = timer;
+                }
+                pending_tail = timer;
+                pending_count++;
+            }
+        }
+    }
+
+    /* 比较已触发 (可能是超过32位计数范围的提前唤醒), 按当前最早到期时间重新编程 */
+    rearm(1);
+
+    timer_service_unlock(lock);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file timer_service.h
+ * @brief 定时服务 - 配对堆 + 硬件比较唤醒, 微秒精度
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 功能特性:
+ *       - 所有定时器按到期时间放在一个配对堆中: 插入O(1), 取最早/删除均摊O(log n)
+ *       - 定时器节点由调用者提供 (静态或嵌在模块结构体中), 数量不受池大小限制
+ *       - 只给最早到期的定时器编程硬件比较 (bsp_timer_alarm_set), 无需轮询扫描
+ *       - 周期定时器按 "上次到期时间 + 周期" 重装, 不累积回调延迟
+ *       - 两种回调方式: 在比较中断中立即执行, 或入队后由主循环 timer_service_process() 执行
+ *       - 同一到期时间按启动顺序触发
+ *
+ * @note 使用方法:
+ *       1. timer_service_init(bsp_timer_get_us64) (调度器初始化时已用自己的时钟调用)
+ *       2. bsp_timer_alarm_set_callback(timer_service_isr);
+ *          timer_service_set_alarm(bsp_timer_alarm_set); 不设置时由 timer_service_process() 轮询
+ *       3. timer_entry_init(&t, callback, arg, TIMER_MODE_DEFERRED);
+ *          timer_service_start(&t, delay_us, period_us);
+ *       4. 主循环调用 timer_service_process() (调度器每次运行都会调用)
+ */
+
+#ifndef __TIMER_SERVICE_H
+#define __TIMER_SERVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*=============================================================================
+ *                              宏定义配置
+ *============================================================================*/
+
+/* 回调方式 */
+#define TIMER_MODE_ISR              0   /**< 在比较中断中执行 (最高优先级, 回调必须很短) */
+#define TIMER_MODE_DEFERRED         1   /**< 在 timer_service_process() 中执行 */
+
+/* 没有待到期的定时器时传给硬件比较的时间 */
+#define TIMER_SERVICE_NEVER         0xFFFFFFFFFFFFFFFFULL
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+typedef struct timer_entry timer_entry_t;
+
+/**
+ * @brief 到期回调
+ * @param timer 到期的定时器 (回调中可以重新启动或停止它)
+ * @param arg 用户参数
+ */
+typedef void (*timer_entry_cb_t)(timer_entry_t *timer, void *arg);
+
+/**
+ * @brief 时钟源
+ * @retval 64位单调时间 (us)
+ */
+typedef uint64_t (*timer_service_clock_t)(void);
+
+/**
+ * @brief 硬件比较编程
+ * @param at_us 到这个时间调用 timer_service_isr(); TIMER_SERVICE_NEVER 表示关闭
+ * @note 时间已过时须立即触发; 提前触发没有问题 (服务会重新编程)
+ */
+typedef void (*timer_service_alarm_t)(uint64_t at_us);
+
+/**
+ * @brief 定时器节点 (成员由服务维护, 调用者不要直接修改)
+ */
+struct timer_entry {
+    timer_entry_t *child;           /**< 配对堆: 第一个子节点 */
+    timer_entry_t *next;            /**< 下一个兄弟 */
+    timer_entry_t *prev;            /**< 上一个兄弟, 第一个子节点指向父节点 */
+    timer_entry_t *pending_next;    /**< 延迟回调队列 */
+    uint64_t expire_us;             /**< 到期时间 */
+    uint32_t period_us;             /**< 周期, 0为单次 */
+    uint32_t seq;                   /**< 启动序号, 到期时间相同时先启动的先触发 */
+    timer_entry_cb_t callback;
+    void *arg;
+    uint8_t mode;                   /**< TIMER_MODE_x */
+    volatile uint8_t active;        /**< 在堆中 */
+    volatile uint8_t fire;          /**< 延迟回调待执行 */
+    volatile uint8_t queued;        /**< 在延迟回调队列中 */
+};
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 初始化定时服务 (清空所有定时器, 关闭硬件比较)
+ * @param clock 64位微秒时钟
+ */
+void timer_service_init(timer_service_clock_t clock);
+
+/**
+ * @brief 设置硬件比较
+ * @param alarm 比较编程函数, NULL为轮询模式 (到期检查在 timer_service_process() 中进行)
+ */
+void timer_service_set_alarm(timer_service_alarm_t alarm);
+
+/**
+ * @brief 初始化定时器节点
+ * @param timer 节点
+ * @param callback 到期回调
+ * @param arg 用户参数
+ * @param mode TIMER_MODE_x
+ * @note 节点清零; 正在运行或已入队的节点先 timer_service_stop()
+ */
+void timer_entry_init(timer_entry_t *timer, timer_entry_cb_t callback, void *arg, uint8_t mode);
+
+/**
+ * @brief 启动定时器 (已启动则按新参数重新开始)
+ * @param timer 节点
+ * @param delay_us 距首次到期的时间
+ * @param period_us 周期, 0为单次
+ * @retval 0:成功 -1:参数无效或服务未初始化
+ */
+int timer_service_start(timer_entry_t *timer, uint32_t delay_us, uint32_t period_us);
+
+/**
+ * @brief 在绝对时间启动定时器
+ * @param timer 节点
+ * @param at_us 首次到期时间 (时钟源的时间)
+ * @param period_us 周期, 0为单次
+ * @retval 0:成功 -1:参数无效或服务未初始化
+ */
+int timer_service_start_at(timer_entry_t *timer, uint64_t at_us, uint32_t period_us);
+
+/**
+ * @brief 停止定时器 (已入队未执行的延迟回调一并取消)
+ * @param timer 节点
+ */
+void timer_service_stop(timer_entry_t *timer);
+
+/**
+ * @brief 修改周期 (下次重装时生效)
+ * @param timer 节点
+ * @param period_us 周期, 0为单次
+ */
+void timer_service_set_period(timer_entry_t *timer, uint32_t period_us);
+
+/**
+ * @brief 定时器是否在运行
+ * @param timer 节点
+ * @retval 1:等待到期 0:已停止或单次已到期
+ */
+uint8_t timer_service_active(const timer_entry_t *timer);
+
+/**
+ * @brief 最早的到期时间
+ * @retval 到期时间 (us), 没有运行的定时器时为 TIMER_SERVICE_NEVER
+ */
+uint64_t timer_service_next(void);
+
+/**
+ * @brief 处理到期定时器 (在硬件比较中断中调用)
+ * @note 执行中断方式的回调, 延迟方式的入队, 然后为下一个到期时间编程硬件比较
+ */
+void timer_service_isr(void);
+
+/**
+ * @brief 执行延迟回调 (主循环调用)
+ * @retval 执行的回调数
+ * @note 轮询模式下先检查到期; 最多执行调用时已入队的回调数
+ */
+uint16_t timer_service_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMER_SERVICE_H */
@@ -81,6 +81,7 @@ static uint8_t stored_valid[WAVEFORM_MAX_STORED] = {0};
 
 static const waveform_data_source_t *data_src = NULL;
 static const waveform_display_interface_t *disp = NULL;
+static waveform_freq_source_t freq_source = NULL;
 
 static uint8_t need_refresh = 0;
 static uint16_t auto_voltage_div_mv = 1000;
@@ -441,6 +442,15 @@ void waveform_force_refresh(void)
     need_refresh = 1;
 }
 
+/**
+ * @brief 设置外部频率测量
+ */
+void waveform_set_freq_source(waveform_freq_source_t source)
+{
+    freq_source = source;
+    need_refresh = 1;
+}
+
 /**
  * @brief 切换显示网格
  */
@@ -567,6 +577,11 @@ static void calculate_measurement(void)
         state.measurement.vrms = (uint16_t)root;
     }
 
+    /* 优先使用外部频率计 */
+    if (freq_source != NULL && freq_source(&state.measurement) == 0) {
+        return;
+    }
+
     /* 计算频率 */
     state.measurement.frequency = calculate_frequency();
     if (state.measurement.frequency > 0) {
@@ -834,8 +849,12 @@ static void draw_measurement(void)
     disp->draw_string(0, 58, str);
 
     if (state.measurement.frequency > 0) {
-        if (state.measurement.frequency >= 1000) {
-            snprintf(str, sizeof(str), "F:%dkHz", (int)(state.measurement.frequency / 1000));
+        if (state.measurement.frequency >= 1000000) {
+            snprintf(str, sizeof(str), "F:%d.%03dMHz", (int)(state.measurement.frequency / 1000000),
+                     (int)(state.measurement.frequency % 1000000 / 1000));
+        } else if (state.measurement.frequency >= 1000) {
+            snprintf(str, sizeof(str), "F:%d.%02dkHz", (int)(state.measurement.frequency / 1000),
+                     (int)(state.measurement.frequency % 1000 / 10));
         } else {
             snprintf(str, sizeof(str), "F:%dHz", (int)state.measurement.frequency);
         }
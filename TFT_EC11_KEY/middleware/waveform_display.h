@@ -10,7 +10,7 @@
  *       - 自动量程调整
  *       - 触发功能
  *       - 时基调整
- *       - 电压/频率测量
+ *       - 电压/频率测量 (可接入外部频率计, 如输入捕获)
  *       - 波形存储与回放
  *       - 支持U8G2和TFT显示
  */
@@ -167,6 +167,13 @@ typedef struct {
     void (*set_sample_rate)(uint32_t rate);
 } waveform_data_source_t;
 
+/**
+ * @brief 外部频率测量
+ * @param m 填写 frequency / period / duty_cycle, 其他成员已由采样计算
+ * @retval 0:已填写 -1:没有有效结果 (使用采样波形的过零检测)
+ */
+typedef int (*waveform_freq_source_t)(waveform_measurement_t *m);
+
 /**
  * @brief 显示接口
  */
@@ -330,6 +337,13 @@ uint16_t waveform_get_buffer_length(void);
  */
 void waveform_force_refresh(void);
 
+/**
+ * @brief 设置外部频率测量
+ * @param source 测量函数, NULL为只用采样波形计算
+ * @note 采样率受时基限制, 过零检测只有几个周期的分辨率; 外部频率计 (输入捕获) 精度高得多
+ */
+void waveform_set_freq_source(waveform_freq_source_t source);
+
 /**
  * @brief 切换显示网格
  */
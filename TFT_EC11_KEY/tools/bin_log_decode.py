@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+bin_log_decode.py - 二进制日志上位机解码工具
+
+目标端 middleware/bin_log.c 只记录格式串地址和32位原始参数,
+本工具从固件ELF文件中取出格式串, 在PC端完成printf格式化。
+
+用法:
+    python bin_log_decode.py firmware.axf capture.bin
+    python bin_log_decode.py firmware.axf --port COM3 --baud 115200
+
+记录格式 (小端):
+    | 0xA5 | len | timestamp(4) | fmt_addr(4) | arg0(4) ... |
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC_BYTE = 0xA5
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# printf转换说明: %[flags][width][.precision][length]type
+FMT_SPEC = re.compile(r'%([-+ #0]*)(\d+|\*)?(?:\.(\d+))?(hh|h|ll|l|z|t|j)?([diouxXcpfFeEgGs%])')
+
+
+class ElfImage:
+    """最小ELF解析器: 仅用于按地址读取只读区中的字符串"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('not an ELF file: %s' % path)
+        is64 = self.data[4] == 2
+        endian = '<' if self.data[5] == 1 else '>'
+        if is64:
+            (shoff,) = struct.unpack_from(endian + 'Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x3A)
+            shfmt = endian + 'IIQQQQ'
+        else:
+            (shoff,) = struct.unpack_from(endian + 'I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x2E)
+            shfmt = endian + 'IIIIII'
+        self.sections = []
+        for i in range(shnum):
+            fields = struct.unpack_from(shfmt, self.data, shoff + i * shentsize)
+            sh_type, sh_flags, sh_addr, sh_offset, sh_size = fields[1:6]
+            if sh_flags & SHF_ALLOC and sh_type != SHT_NOBITS and sh_size:
+                self.sections.append((sh_addr, sh_offset, sh_size))
+        self.cache = {}
+
+    def string_at(self, addr):
+        if addr in self.cache:
+            return self.cache[addr]
+        for base, offset, size in self.sections:
+            if base <= addr < base + size:
+                start = offset + (addr - base)
+                end = self.data.index(b'\x00', start, offset + size)
+                text = self.data[start:end].decode('utf-8', errors='replace')
+                self.cache[addr] = text
+                return text
+        return None
+
+
+def format_record(fmt, args):
+    """按格式串解释32位参数, 再交给Python完成格式化"""
+    out = []
+    pos = 0
+    idx = 0
+    for m in FMT_SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, _length, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        raw = args[idx] if idx < len(args) else 0
+        idx += 1
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        if conv in 'di':
+            value = struct.unpack('<i', struct.pack('<I', raw))[0]
+            out.append((spec + 'd') % value)
+        elif conv in 'fFeEgG':
+            value = struct.unpack('<f', struct.pack('<I', raw))[0]
+            out.append((spec + conv) % value)
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(raw & 0xFF))
+        elif conv == 'p':
+            out.append('0x%08x' % raw)
+        elif conv == 's':
+            out.append('<str@0x%08x>' % raw)
+        else:
+            out.append((spec + conv) % raw)
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def decode_stream(elf, stream, sink):
+    """逐条解析记录; 同步字节或格式串地址无效时丢弃1字节重新同步"""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buf.extend(chunk)
+        while len(buf) >= 2:
+            if buf[0] != SYNC_BYTE:
+                del buf[0]
+                continue
+            length = buf[1]
+            if length < 8 or (length - 8) % 4:
+                del buf[0]
+                continue
+            if len(buf) < 2 + length:
+                break
+            ts, fmt_addr = struct.unpack_from('<II', buf, 2)
+            fmt = elf.string_at(fmt_addr)
+            if fmt is None:
+                del buf[0]
+                continue
+            args = struct.unpack_from('<%dI' % ((length - 8) // 4), buf, 10)
+            sink.write('[%10u] %s' % (ts, format_record(fmt, args)))
+            if not fmt.endswith('\n'):
+                sink.write('\n')
+            sink.flush()
+            del buf[:2 + length]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode bin_log records using firmware ELF')
+    parser.add_argument('elf', help='firmware ELF/AXF file')
+    parser.add_argument('input', nargs='?', help='captured binary file (default: stdin)')
+    parser.add_argument('--port', help='serial port, requires pyserial')
+    parser.add_argument('--baud', type=int, default=115200)
+    opts = parser.parse_args()
+
+    elf = ElfImage(opts.elf)
+
+    if opts.port:
+        import serial
+        stream = serial.Serial(opts.port, opts.baud, timeout=0.1)
+        # 串口读超时返回空, 包装成阻塞读
+        class _Blocking:
+            def read(self, n):
+                while True:
+                    data = stream.read(n)
+                    if data:
+                        return data
+        decode_stream(elf, _Blocking(), sys.stdout)
+    elif opts.input:
+        with open(opts.input, 'rb') as f:
+            decode_stream(elf, f, sys.stdout)
+    else:
+        decode_stream(elf, sys.stdin.buffer, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+gen_crc_tables.py - 生成 middleware/crc.c 中的CRC查找表
+
+- crc32_table[8][256]: CRC-32 (反射多项式0xEDB88320) 的 slice-by-8 表,
+  第k张表为第k-1张表再经过一个零字节的结果; slice-by-4 只用前4张
+- crc16_table[256]: CRC-16/CCITT (多项式0x1021, 高位在前) 的字节表
+
+修改多项式后重新运行, 将输出粘贴回源文件。
+
+用法:
+    python gen_crc_tables.py
+"""
+
+CRC32_POLY = 0xEDB88320
+CRC16_POLY = 0x1021
+
+
+def crc32_base():
+    table = []
+    for i in range(256):
+        c = i
+        for _ in range(8):
+            c = (c >> 1) ^ CRC32_POLY if c & 1 else c >> 1
+        table.append(c)
+    return table
+
+
+def crc16_base():
+    table = []
+    for i in range(256):
+        c = i << 8
+        for _ in range(8):
+            c = ((c << 1) ^ CRC16_POLY) if c & 0x8000 else (c << 1)
+        table.append(c & 0xFFFF)
+    return table
+
+
+def print_rows(values, fmt, per_row, indent):
+    for i in range(0, len(values), per_row):
+        print('%s%s,' % (indent, ', '.join(fmt % v for v in values[i:i + per_row])))
+
+
+def main():
+    tables = [crc32_base()]
+    for _ in range(7):
+        prev = tables[-1]
+        tables.append([(v >> 8) ^ tables[0][v & 0xFF] for v in prev])
+
+    print('static const uint32_t crc32_table[CRC32_SLICES][256] = {')
+    for k, table in enumerate(tables):
+        if k == 4:
+            print('#if CRC32_SLICE_BY_8')
+        print('    {')
+        print_rows(table, '0x%08XUL', 6, '        ')
+        print('    },')
+    print('#endif')
+    print('};')
+    print()
+    print('static const uint16_t crc16_table[256] = {')
+    print_rows(crc16_base(), '0x%04X', 8, '    ')
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
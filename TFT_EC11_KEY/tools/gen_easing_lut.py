@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+gen_easing_lut.py - 生成 middleware/menu_animation.c 中的Q16缓动查找表
+
+每条曲线在 [0, 1] 上均匀取 MENU_ANIM_LUT_SEGMENTS+1 个点, 按Q16 (1.0 = 65536) 四舍五入,
+运行时在相邻两点间线性插值。修改曲线或段数后重新运行, 将输出粘贴回源文件。
+
+用法:
+    python gen_easing_lut.py [segments]
+"""
+
+import sys
+
+
+def linear(t):
+    return t
+
+
+def ease_in(t):
+    return t * t
+
+
+def ease_out(t):
+    return 1.0 - (1.0 - t) * (1.0 - t)
+
+
+def ease_in_out(t):
+    if t < 0.5:
+        return 2.0 * t * t
+    u = -2.0 * t + 2.0
+    return 1.0 - u * u / 2.0
+
+
+def bounce(t):
+    n1, d1 = 7.5625, 2.75
+    if t < 1.0 / d1:
+        return n1 * t * t
+    if t < 2.0 / d1:
+        t -= 1.5 / d1
+        return n1 * t * t + 0.75
+    if t < 2.5 / d1:
+        t -= 2.25 / d1
+        return n1 * t * t + 0.9375
+    t -= 2.625 / d1
+    return n1 * t * t + 0.984375
+
+
+CURVES = [
+    ('LINEAR', linear),
+    ('EASE_IN', ease_in),
+    ('EASE_OUT', ease_out),
+    ('EASE_IN_OUT', ease_in_out),
+    ('BOUNCE', bounce),
+]
+
+
+def main():
+    segments = int(sys.argv[1]) if len(sys.argv) > 1 else 64
+    print('static const int32_t easing_lut[MENU_EASING_COUNT][MENU_ANIM_LUT_SEGMENTS + 1] = {')
+    for name, func in CURVES:
+        values = [int(round(func(i / segments) * 65536)) for i in range(segments + 1)]
+        print('    /* MENU_EASING_%s */' % name)
+        print('    {')
+        for i in range(0, len(values), 8):
+            row = ', '.join('%6d' % v for v in values[i:i + 8])
+            print('        %s,' % row)
+        print('    },')
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+gen_gamma_lut.py - 生成 bsp/bsp_pwm_gamma.c 中的Q16伽马校正查找表
+
+亮度 (感知) 到占空比的映射 duty = level ^ gamma, 在 [0, 1] 上均匀取 PWM_GAMMA_LUT_SEGMENTS+1 个点,
+按Q16 (1.0 = 65536) 四舍五入, 运行时在相邻两点间线性插值。修改gamma或段数后重新运行,
+将输出粘贴回源文件。
+
+用法:
+    python gen_gamma_lut.py [gamma] [segments]
+"""
+
+import sys
+
+
+def main():
+    gamma = float(sys.argv[1]) if len(sys.argv) > 1 else 2.2
+    segments = int(sys.argv[2]) if len(sys.argv) > 2 else 64
+    values = [int(round((i / segments) ** gamma * 65536)) for i in range(segments + 1)]
+
+    print('/* gamma = %.2f */' % gamma)
+    print('static const uint32_t pwm_gamma_lut[PWM_GAMMA_LUT_SEGMENTS + 1] = {')
+    for i in range(0, len(values), 8):
+        row = ', '.join('%5d' % v for v in values[i:i + 8])
+        print('    %s,' % row)
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
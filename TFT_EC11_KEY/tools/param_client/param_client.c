@@ -0,0 +1,232 @@
+/**
+ * @file param_client.c
+ * @brief 远程参数协议PC端客户端库实现
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ */
+
+#include "param_client.h"
+#include <string.h>
+
+/*=============================================================================
+ *                              私有函数声明
+ *============================================================================*/
+
+static int link_output(void *ctx, uint8_t seq, uint8_t cmd, const uint8_t *data, uint8_t len);
+static int link_deliver(void *ctx, uint8_t cmd, const uint8_t *data, uint8_t len);
+static void on_frame(const frame_codec_frame_t *frame, void *arg);
+static void handle_values(param_client_t *c, const uint8_t *data, uint8_t len);
+
+/*=============================================================================
+ *                              公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化客户端
+ */
+int param_client_init(param_client_t *c, param_client_write_t write, void *ctx)
+{
+    if (c == NULL || write == NULL) {
+        return -1;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->write = write;
+    c->ctx = ctx;
+
+    frame_codec_parser_init(&c->parser, on_frame, c);
+    return frame_transport_init(&c->link, link_output, link_deliver, c);
+}
+
+/**
+ * @brief 设置回调
+ */
+void param_client_set_callbacks(param_client_t *c, param_client_value_t on_value,
+                                param_client_status_t on_status)
+{
+    c->on_value = on_value;
+    c->on_status = on_status;
+}
+
+/**
+ * @brief 与设备同步传输层
+ */
+void param_client_connect(param_client_t *c)
+{
+    frame_transport_reset(&c->link);
+}
+
+/**
+ * @brief 输入串口收到的字节
+ */
+void param_client_input(param_client_t *c, const uint8_t *data, uint16_t len)
+{
+    frame_codec_parse(&c->parser, data, len);
+}
+
+/**
+ * @brief 轮询
+ */
+void param_client_poll(param_client_t *c, uint32_t now_ms)
+{
+    frame_transport_poll(&c->link, now_ms);
+}
+
+/**
+ * @brief 批量读取
+ */
+int param_client_get(param_client_t *c, const uint8_t *ids, uint8_t count)
+{
+    if (count > PARAM_FRAME_MAX) {
+        return -1;
+    }
+
+    return frame_transport_send(&c->link, PARAM_CMD_GET, ids, count);
+}
+
+/**
+ * @brief 批量写入
+ */
+int param_client_set(param_client_t *c, const param_client_entry_t *entries, uint8_t count)
+{
+    uint8_t buf[PARAM_FRAME_MAX];
+    uint8_t pos = 0;
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        uint8_t n = param_entry_encode(&buf[pos], sizeof(buf) - pos, entries[i].id,
+                                       entries[i].type, entries[i].value);
+        if (n == 0) {
+            return -1;
+        }
+        pos += n;
+    }
+
+    return frame_transport_send(&c->link, PARAM_CMD_SET, buf, pos);
+}
+
+/**
+ * @brief 订阅
+ */
+int param_client_subscribe(param_client_t *c, uint16_t period_ms,
+                           const uint8_t *ids, uint8_t count)
+{
+    uint8_t buf[PARAM_FRAME_MAX];
+
+    if (count > PARAM_FRAME_MAX - 2) {
+        return -1;
+    }
+
+    buf[0] = (uint8_t)period_ms;
+    buf[1] = (uint8_t)(period_ms >> 8);
+    if (count > 0) {
+        memcpy(&buf[2], ids, count);
+    }
+
+    return frame_transport_send(&c->link, PARAM_CMD_SUBSCRIBE, buf, (uint8_t)(count + 2));
+}
+
+/**
+ * @brief 查询最近收到的值
+ */
+uint8_t param_client_lookup(const param_client_t *c, uint8_t id, param_value_t *value)
+{
+    if (!c->cache[id].valid) {
+        return PARAM_TYPE_NONE;
+    }
+
+    *value = c->cache[id].value;
+    return c->cache[id].type;
+}
+
+/*=============================================================================
+ *                              私有函数实现
+ *============================================================================*/
+
+/**
+ * @brief 传输层输出: 编码后写串口
+ */
+static int link_output(void *ctx, uint8_t seq, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    param_client_t *c = (param_client_t *)ctx;
+    uint8_t buf[FRAME_CODEC_ENCODED_MAX(FRAME_CODEC_MAX_DATA)];
+    uint16_t n = frame_codec_encode(seq, cmd, data, len, buf, sizeof(buf));
+
+    if (n == 0) {
+        return -1;
+    }
+
+    c->write(c->ctx, buf, n);
+    return 0;
+}
+
+/**
+ * @brief 传输层按序交付
+ */
+static int link_deliver(void *ctx, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    param_client_t *c = (param_client_t *)ctx;
+    uint8_t i;
+
+    switch (cmd) {
+    case PARAM_CMD_TELEMETRY:
+        c->telemetry_frames++;
+        handle_values(c, data, len);
+        break;
+
+    case PARAM_CMD_GET:
+        handle_values(c, data, len);
+        break;
+
+    case PARAM_CMD_SET:
+        for (i = 0; i + 1 < len; i += 2) {
+            if (c->on_status != NULL) {
+                c->on_status(c->ctx, data[i], (param_status_t)data[i + 1]);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 帧解析回调
+ */
+static void on_frame(const frame_codec_frame_t *frame, void *arg)
+{
+    param_client_t *c = (param_client_t *)arg;
+    frame_transport_input(&c->link, frame);
+}
+
+/**
+ * @brief 解析条目列表, 更新缓存并回调
+ */
+static void handle_values(param_client_t *c, const uint8_t *data, uint8_t len)
+{
+    uint8_t off = 0;
+
+    while (off < len) {
+        uint8_t id;
+        uint8_t type;
+        param_value_t value;
+        uint8_t n = param_entry_decode(&data[off], len - off, &id, &type, &value);
+
+        if (n == 0) {
+            break;
+        }
+        off += n;
+
+        c->cache[id].valid = (type != PARAM_TYPE_NONE);
+        c->cache[id].type = type;
+        c->cache[id].value = value;
+
+        if (c->on_value != NULL) {
+            c->on_value(c->ctx, id, type, value);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+/**
+ * @file param_client.h
+ * @brief 远程参数协议PC端客户端库
+ * @author Claude Code
+ * @version 1.0.0
+ * @date 2025-12-12
+ *
+ * @note 与固件共用 middleware/crc, frame_codec, frame_transport, param_registry 的源码,
+ *       串口读写由调用者提供, 本库只做协议处理, 不依赖操作系统.
+ *
+ * @note 编译示例:
+ *       gcc -I../../middleware -c param_client.c ../../middleware/crc.c \
+ *           ../../middleware/frame_codec.c ../../middleware/frame_transport.c \
+ *           ../../middleware/param_registry.c
+ *
+ * @note 使用流程:
+ *       1. param_client_init() 设置串口写函数
+ *       2. 串口收到的字节交给 param_client_input()
+ *       3. 每10ms左右调用 param_client_poll()
+ *       4. param_client_connect() 后即可 get/set/subscribe, 结果通过回调返回
+ */
+
+#ifndef __PARAM_CLIENT_H
+#define __PARAM_CLIENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "frame_codec.h"
+#include "frame_transport.h"
+#include "param_registry.h"
+
+/*=============================================================================
+ *                              类型定义
+ *============================================================================*/
+
+/**
+ * @brief 串口写接口
+ * @param ctx 用户上下文
+ * @param data 数据
+ * @param len 长度
+ */
+typedef void (*param_client_write_t)(void *ctx, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 收到参数值 (GET应答或遥测)
+ * @param ctx 用户上下文
+ * @param id 参数ID
+ * @param type 类型, PARAM_TYPE_NONE表示设备上无此参数
+ * @param value 值
+ */
+typedef void (*param_client_value_t)(void *ctx, uint8_t id, uint8_t type, param_value_t value);
+
+/**
+ * @brief 收到SET结果
+ * @param ctx 用户上下文
+ * @param id 参数ID
+ * @param status 状态
+ */
+typedef void (*param_client_status_t)(void *ctx, uint8_t id, param_status_t status);
+
+/**
+ * @brief SET条目
+ */
+typedef struct {
+    uint8_t id;
+    uint8_t type;
+    param_value_t value;
+} param_client_entry_t;
+
+/**
+ * @brief 客户端
+ */
+typedef struct {
+    frame_transport_t link;             /**< 可靠传输端点 */
+    frame_codec_parser_t parser;        /**< 帧解析器 */
+    param_client_write_t write;         /**< 串口写 */
+    param_client_value_t on_value;      /**< 值回调 */
+    param_client_status_t on_status;    /**< SET结果回调 */
+    void *ctx;                          /**< 用户上下文 */
+
+    /* 最近收到的参数值 */
+    struct {
+        uint8_t valid;
+        uint8_t type;
+        param_value_t value;
+    } cache[256];
+
+    uint32_t telemetry_frames;          /**< 收到的遥测帧数 */
+} param_client_t;
+
+/*=============================================================================
+ *                              函数声明
+ *============================================================================*/
+
+/**
+ * @brief 初始化客户端
+ * @param c 客户端
+ * @param write 串口写接口
+ * @param ctx 用户上下文
+ * @retval 0:成功 -1:失败
+ */
+int param_client_init(param_client_t *c, param_client_write_t write, void *ctx);
+
+/**
+ * @brief 设置回调
+ * @param c 客户端
+ * @param on_value 值回调 (可为NULL)
+ * @param on_status SET结果回调 (可为NULL)
+ */
+void param_client_set_callbacks(param_client_t *c, param_client_value_t on_value,
+                                param_client_status_t on_status);
+
+/**
+ * @brief 与设备同步传输层 (连接建立后调用)
+ * @param c 客户端
+ */
+void param_client_connect(param_client_t *c);
+
+/**
+ * @brief 输入串口收到的字节
+ * @param c 客户端
+ * @param data 数据
+ * @param len 长度
+ */
+void param_client_input(param_client_t *c, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 轮询 (重传/应答)
+ * @param c 客户端
+ * @param now_ms 单调时间 (ms)
+ */
+void param_client_poll(param_client_t *c, uint32_t now_ms);
+
+/**
+ * @brief 批量读取
+ * @param c 客户端
+ * @param ids 参数ID
+ * @param count 数量
+ * @retval 0:已发送 -1:发送窗口满或参数过多
+ */
+int param_client_get(param_client_t *c, const uint8_t *ids, uint8_t count);
+
+/**
+ * @brief 批量写入
+ * @param c 客户端
+ * @param entries 条目
+ * @param count 数量
+ * @retval 0:已发送 -1:发送窗口满或一帧放不下
+ */
+int param_client_set(param_client_t *c, const param_client_entry_t *entries, uint8_t count);
+
+/**
+ * @brief 订阅
+ * @param c 客户端
+ * @param period_ms 推送周期, 0表示取消订阅
+ * @param ids 参数ID
+ * @param count 数量
+ * @retval 0:已发送 -1:失败
+ */
+int param_client_subscribe(param_client_t *c, uint16_t period_ms,
+                           const uint8_t *ids, uint8_t count);
+
+/**
+ * @brief 查询最近收到的值
+ * @param c 客户端
+ * @param id 参数ID
+ * @param value 输出值
+ * @retval 类型, 尚未收到返回PARAM_TYPE_NONE
+ */
+uint8_t param_client_lookup(const param_client_t *c, uint8_t id, param_value_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_CLIENT_H */
@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+pwm_pattern.py - PWM关键帧图案编译与时序仿真
+
+把文本描述的多通道图案编译成 middleware/pwm_pattern.h 的 pwm_keyframe_t 表,
+或按固件 pwm_pattern_render() 的整数算法逐个PWM周期仿真输出, 检查关键帧到达时间和每周期跳变。
+
+图案文件格式 (# 开头为注释):
+    name     rainbow            # C标识符前缀
+    channels 3                  # 通道数 1~4
+    loop     1                  # 1:循环 0:单次
+    # time_ms  interp  ch0   ch1   ch2      (interp: step / linear / gamma, 数值0~1000)
+    0          step    1000  0     0
+    1000       gamma   0     1000  0
+    1000       gamma   0     0     1000
+    1000       gamma   1000  0     0
+
+用法:
+    python pwm_pattern.py compile rainbow.txt [-o rainbow_pattern.c]
+    python pwm_pattern.py simulate rainbow.txt [--freq 1000] [--resolution 1000]
+                                               [--periods N] [--csv out.csv]
+"""
+
+import argparse
+import sys
+
+LEVEL_MAX = 1000
+MAX_CH = 4
+BUF_FRAMES = 32                 # PWM_PATTERN_BUF_FRAMES
+GAMMA = 2.2                     # 与 tools/gen_gamma_lut.py 默认值一致
+GAMMA_SEGMENTS = 64
+GAMMA_LUT = [int(round((i / GAMMA_SEGMENTS) ** GAMMA * 65536)) for i in range(GAMMA_SEGMENTS + 1)]
+
+INTERP = {'step': 0, 'linear': 1, 'gamma': 2}
+INTERP_C = ['PWM_PATTERN_STEP', 'PWM_PATTERN_LINEAR', 'PWM_PATTERN_GAMMA']
+
+
+class Pattern:
+    def __init__(self):
+        self.name = 'pattern'
+        self.channels = 0
+        self.loop = 1
+        self.frames = []        # (time_ms, interp, [levels])
+
+
+def parse(path):
+    pat = Pattern()
+    with open(path, encoding='utf-8') as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.split('#', 1)[0].split()
+            if not line:
+                continue
+            try:
+                key = line[0].lower()
+                if key == 'name':
+                    pat.name = line[1]
+                elif key == 'channels':
+                    pat.channels = int(line[1])
+                elif key == 'loop':
+                    pat.loop = int(line[1])
+                else:
+                    time_ms = int(line[0])
+                    interp = INTERP[line[1].lower()]
+                    levels = [int(v) for v in line[2:]]
+                    if pat.channels == 0:
+                        pat.channels = len(levels)
+                    if len(levels) != pat.channels:
+                        raise ValueError('expected %d levels' % pat.channels)
+                    if not 0 <= time_ms <= 0xFFFF:
+                        raise ValueError('time_ms out of range')
+                    if any(v < 0 or v > LEVEL_MAX for v in levels):
+                        raise ValueError('level out of range 0~%d' % LEVEL_MAX)
+                    pat.frames.append((time_ms, interp, levels))
+            except (IndexError, KeyError, ValueError) as e:
+                sys.exit('%s:%d: %s' % (path, lineno, e or 'syntax error'))
+
+    if not 1 <= pat.channels <= MAX_CH:
+        sys.exit('%s: channels must be 1~%d' % (path, MAX_CH))
+    if not pat.frames:
+        sys.exit('%s: no keyframes' % path)
+    if pat.loop and sum(f[0] for f in pat.frames) == 0:
+        sys.exit('%s: looping pattern has zero total time' % path)
+    return pat
+
+
+def compile_c(pat, source):
+    out = ['/* 由 tools/pwm_pattern.py 从 %s 生成, 请修改源文件后重新生成 */' % source,
+           '#include "pwm_pattern.h"',
+           '',
+           'static const pwm_keyframe_t %s_frames[] = {' % pat.name]
+    for time_ms, interp, levels in pat.frames:
+        padded = levels + [0] * (MAX_CH - len(levels))
+        out.append('    { %5d, %-20s { %s } },' % (time_ms, INTERP_C[interp] + ',',
+                                                   ', '.join('%4d' % v for v in padded)))
+    out.append('};')
+    out.append('')
+    out.append('const pwm_pattern_t %s_pattern = {' % pat.name)
+    out.append('    %s_frames, %d, %d, %d' % (pat.name, len(pat.frames), pat.channels, pat.loop))
+    out.append('};')
+    return '\n'.join(out) + '\n'
+
+
+def cdiv(a, b):
+    """C语言整数除法 (向零取整)"""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b > 0) else -q
+
+
+def gamma(level):
+    """bsp_pwm_gamma() 的同一算法"""
+    if level >= 65536:
+        return 65536
+    idx, frac = level >> 10, level & 1023
+    return GAMMA_LUT[idx] + (((GAMMA_LUT[idx + 1] - GAMMA_LUT[idx]) * frac) >> 10)
+
+
+class Renderer:
+    """pwm_pattern_render() 的逐帧等价实现"""
+
+    def __init__(self, pat, freq, resolution):
+        self.pat, self.freq, self.res = pat, freq, resolution
+        self.index, self.pos, self.finished = 0, 0, False
+        self.src = [0] * MAX_CH
+        self.len = self.seg(0)
+        self.arrivals = []      # (帧号, 关键帧号)
+
+    def seg(self, i):
+        return self.pat.frames[i][0] * self.freq // 1000
+
+    def duty(self, level):
+        level = min(level, LEVEL_MAX)
+        return (level * self.res + LEVEL_MAX // 2) // LEVEL_MAX
+
+    def interp(self, mode, a, b, num, den):
+        if mode == 1:
+            a, b = self.duty(a), self.duty(b)
+            return a + cdiv((b - a) * num, den)
+        if mode == 2:
+            level = a + cdiv((b - a) * num, den)
+            return (gamma((level << 16) // LEVEL_MAX) * self.res + 32768) >> 16
+        return self.duty(b)
+
+    def next_segment(self, n):
+        frames = self.pat.frames
+        self.arrivals.append((n, self.index))
+        self.src = list(frames[self.index][2]) + [0] * (MAX_CH - self.pat.channels)
+        self.pos = 0
+        if self.index + 1 < len(frames):
+            self.index += 1
+        elif self.pat.loop:
+            self.index = 0
+        else:
+            self.finished = True
+            return
+        self.len = self.seg(self.index)
+
+    def frame(self, n):
+        guard = len(self.pat.frames)
+        while self.len == 0 and not self.finished and guard > 0:
+            guard -= 1
+            self.next_segment(n)
+        _, mode, levels = self.pat.frames[self.index]
+        if self.finished or self.len == 0:
+            return [self.interp(mode, v, v, 1, 1) for v in levels]
+        out = [self.interp(mode, self.src[c], levels[c], self.pos + 1, self.len)
+               for c in range(self.pat.channels)]
+        self.pos += 1
+        if self.pos >= self.len:
+            self.next_segment(n)
+        return out
+
+
+def simulate(pat, args):
+    r = Renderer(pat, args.freq, args.resolution)
+    cycle_frames = sum(r.seg(i) for i in range(len(pat.frames)))
+    periods = args.periods or (cycle_frames * (2 if pat.loop else 1) + BUF_FRAMES)
+    period_us = 1e6 / args.freq
+
+    # 第n帧在第n个更新事件由DMA写入CCR预装载, 第n+1个PWM周期输出
+    frames = [r.frame(n) for n in range(periods)]
+
+    print('pattern %s: %d keyframes, %d channels, %s' %
+          (pat.name, len(pat.frames), pat.channels, 'loop' if pat.loop else 'once'))
+    print('PWM %d Hz, resolution %d, period %.1f us' % (args.freq, args.resolution, period_us))
+    print('cycle %d periods = %.3f ms' % (cycle_frames, cycle_frames * period_us / 1000))
+    print('refill every %d periods (%.2f ms), %d frames per refill' %
+          (BUF_FRAMES // 2, BUF_FRAMES // 2 * period_us / 1000, BUF_FRAMES // 2))
+
+    for n, k in r.arrivals[:4 * len(pat.frames)]:
+        print('  keyframe %d reached: output period %d, t = %.3f ms' %
+              (k, n + 1, (n + 1) * period_us / 1000))
+
+    for c in range(pat.channels):
+        steps = [abs(frames[i][c] - frames[i - 1][c]) for i in range(1, len(frames))]
+        print('ch%d: min %d max %d, max step per period %d' %
+              (c, min(f[c] for f in frames), max(f[c] for f in frames), max(steps or [0])))
+
+    if args.csv:
+        with open(args.csv, 'w', encoding='utf-8') as f:
+            f.write('period,time_us,' + ','.join('ch%d' % c for c in range(pat.channels)) + '\n')
+            for n, duty in enumerate(frames):
+                f.write('%d,%.1f,%s\n' % (n + 1, (n + 1) * period_us, ','.join(str(v) for v in duty)))
+        print('wrote %s' % args.csv)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='PWM keyframe pattern compiler / simulator')
+    sub = ap.add_subparsers(dest='cmd', required=True)
+
+    c = sub.add_parser('compile', help='emit C keyframe table')
+    c.add_argument('pattern')
+    c.add_argument('-o', '--output')
+
+    s = sub.add_parser('simulate', help='per-period timing simulation')
+    s.add_argument('pattern')
+    s.add_argument('--freq', type=int, default=1000, help='PWM frequency (Hz)')
+    s.add_argument('--resolution', type=int, default=1000, help='PWM resolution')
+    s.add_argument('--periods', type=int, default=0, help='periods to simulate')
+    s.add_argument('--csv', help='write per-period duty values')
+
+    args = ap.parse_args()
+    pat = parse(args.pattern)
+
+    if args.cmd == 'compile':
+        text = compile_c(pat, args.pattern)
+        if args.output:
+            with open(args.output, 'w', encoding='utf-8') as f:
+                f.write(text)
+        else:
+            sys.stdout.write(text)
+    else:
+        simulate(pat, args)
+
+
+if __name__ == '__main__':
+    main()